@@ -28,5 +28,6 @@ void main()
     );
     
     // FragColor = vec4(albedo * 0.4 + color * 0.6, 1.0);
-    FragColor = vec4(albedo * 0.4 + color * 0.6, 1.0);
+    // alpha marks front faces: probes that mostly see backfaces are inside geometry
+    FragColor = vec4(albedo * 0.4 + color * 0.6, gl_FrontFacing ? 1.0 : 0.0);
 }
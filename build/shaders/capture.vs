@@ -3,6 +3,12 @@ layout (location = 0) in vec3 pos;
 layout (location = 1) in vec2 texCoords;
 layout (location = 2) in vec3 normal;
 
+#ifdef LAYERED
+// projected per cube face by cube_layered.gs
+#define TexCoords vTexCoords
+#define FragPos   vFragPos
+#define Normal    vNormal
+#endif
 out vec2 TexCoords;
 out vec3 FragPos;
 out vec3 Normal;
@@ -11,11 +17,17 @@ uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
 
+#include common/vertex.glsl
+
 void main()
 {
 	TexCoords = texCoords;
-	FragPos   = vec3(model * vec4(pos, 1.0f));
-	Normal    = mat3(model) * normal;
+	FragPos   = vec3(model * vec4(DecodePosition(pos), 1.0f));
+	Normal    = mat3(model) * DecodeNormal(normal);
 	
+#ifdef LAYERED
+	gl_Position = vec4(FragPos, 1.0);
+#else
 	gl_Position =  projection * view * vec4(FragPos, 1.0);
+#endif
 }
\ No newline at end of file
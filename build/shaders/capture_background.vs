@@ -4,12 +4,20 @@ layout (location = 0) in vec3 aPos;
 uniform mat4 projection;
 uniform mat4 view;
 
+#ifdef LAYERED
+// projected per cube face by cube_layered.gs
+#define LocalPos vLocalPos
+#endif
 out vec3 LocalPos;
 
 void main()
 {
     LocalPos = aPos;
 
+#ifdef LAYERED
+	gl_Position = vec4(LocalPos, 1.0);
+	return;
+#endif
 	mat4 rotView = mat4(mat3(view));
 	vec4 clipPos = projection * rotView * vec4(LocalPos, 1.0);
 
@@ -0,0 +1,18 @@
+#ifndef SPHERICAL_HARMONICS_H
+#define SPHERICAL_HARMONICS_H
+// evaluates L2 spherical harmonics (9 RGB coefficients, see math::sh9) in direction n; for
+// irradiance probes the coefficients are pre-convolved s.t. the result is the diffuse lighting
+// of a white surface w/ normal n (see math::shConvolveLambert).
+vec3 EvaluateSH9(vec3 sh[9], vec3 n)
+{
+    return sh[0] * 0.282095
+         + sh[1] * 0.488603 * n.y
+         + sh[2] * 0.488603 * n.z
+         + sh[3] * 0.488603 * n.x
+         + sh[4] * 1.092548 * n.x * n.y
+         + sh[5] * 1.092548 * n.y * n.z
+         + sh[6] * 0.315392 * (3.0 * n.z * n.z - 1.0)
+         + sh[7] * 1.092548 * n.x * n.z
+         + sh[8] * 0.546274 * (n.x * n.x - n.y * n.y);
+}
+#endif
@@ -37,5 +37,8 @@ layout (std140, binding = 0) uniform Global
     vec4 pointLight6_Col;
     vec4 pointLight7_Pos;
     vec4 pointLight7_Col;
+    // dynamic resolution: xy is the internal render size relative to the size of the targets
+    // rendered to (s.t. screen-space lookups scale by it), zw the TAA jitter (NDC)
+    vec4 renderScale;
 };
 #endif
\ No newline at end of file
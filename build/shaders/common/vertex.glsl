@@ -0,0 +1,42 @@
+#ifndef VERTEX_GLSL
+#define VERTEX_GLSL
+// vertex attribute decoding of the compact vertex formats (see Mesh's VERTEX_FORMAT); float
+// vertex data passes through unchanged. Set by the renderer for each draw call.
+uniform int  VertexFormat; // 0: float, 1: compact, 2: compact w/ quantized positions
+uniform vec3 VertexOffset;
+uniform vec3 VertexScale;
+
+vec3 OctahedralDecode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0)
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(v);
+}
+
+vec3 DecodePosition(vec3 position)
+{
+    return VertexFormat == 2 ? VertexOffset + position * VertexScale : position;
+}
+
+vec3 DecodeNormal(vec3 normal)
+{
+    return VertexFormat == 0 ? normal : OctahedralDecode(normal.xy);
+}
+
+// tangent.w holds the bitangent's sign for compact vertices (and defaults to 1.0 for float
+// vertices, which supply their bitangent directly).
+void DecodeTangentFrame(vec3 normal, vec4 tangent, vec3 bitangent, out vec3 T, out vec3 B)
+{
+    if (VertexFormat == 0)
+    {
+        T = tangent.xyz;
+        B = bitangent;
+    }
+    else
+    {
+        T = OctahedralDecode(tangent.xy);
+        B = cross(normal, T) * tangent.w;
+    }
+}
+#endif
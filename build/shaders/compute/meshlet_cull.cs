@@ -0,0 +1,66 @@
+#version 430 core
+layout (local_size_x = 64) in;
+
+// see Cell::Meshlet (std430)
+struct Meshlet
+{
+    vec4  Sphere; // xyz: center, w: radius
+    vec4  Cone;   // xyz: axis, w: cutoff
+    uvec4 Range;  // x: index offset, y: index count, z: vertex count
+};
+
+// see glMultiDrawElementsIndirect
+struct DrawCommand
+{
+    uint Count;
+    uint InstanceCount;
+    uint FirstIndex;
+    uint BaseVertex;
+    uint BaseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Meshlets
+{
+    Meshlet meshlets[];
+};
+layout (std430, binding = 1) writeonly buffer Draws
+{
+    DrawCommand draws[];
+};
+
+uniform int MeshletCount;
+uniform int DrawOffset;
+// object space frustum planes and eye (see MeshletBuilder::ObjectSpaceView)
+uniform vec4 FrustumPlanes[6];
+uniform vec3 EyePosition;
+uniform bool ConeCulling;
+
+void main()
+{
+    int id = int(gl_GlobalInvocationID.x);
+    if (id >= MeshletCount)
+        return;
+
+    Meshlet meshlet = meshlets[id];
+    vec3  center = meshlet.Sphere.xyz;
+    float radius = meshlet.Sphere.w;
+
+    bool visible = true;
+    for (int i = 0; i < 6; ++i)
+        visible = visible && dot(FrustumPlanes[i].xyz, center) + FrustumPlanes[i].w >= -radius;
+
+    if (visible && ConeCulling)
+    {
+        vec3 direction = center - EyePosition;
+        visible = dot(direction, meshlet.Cone.xyz) < meshlet.Cone.w * length(direction) + radius;
+    }
+
+    // culled meshlets are kept as empty draws s.t. the draw count stays known on the CPU.
+    DrawCommand command;
+    command.Count         = visible ? meshlet.Range.y : 0u;
+    command.InstanceCount = 1u;
+    command.FirstIndex    = meshlet.Range.x;
+    command.BaseVertex    = 0u;
+    command.BaseInstance  = 0u;
+    draws[DrawOffset + id] = command;
+}
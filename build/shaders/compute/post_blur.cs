@@ -0,0 +1,72 @@
+#version 430 core
+// Separable gaussian blur of a pyramid level in a single dispatch: each work group loads its
+// tile (w/ an apron of RADIUS texels) into shared memory once and blurs it horizontally and
+// then vertically in shared memory, instead of ping-ponging full screen passes through
+// memory. With Accumulate set, the bilinearly upsampled next (coarser) bloom level is added,
+// s.t. bloom accumulates all levels from the coarsest up.
+#define TILE   16
+#define RADIUS 8
+#define APRON  (TILE + 2 * RADIUS)
+layout (local_size_x = TILE, local_size_y = TILE) in;
+
+uniform sampler2D TexSrc;
+uniform sampler2D TexCoarser;
+uniform bool  Accumulate;
+uniform float Weight;
+layout (rgba16f, binding = 0) uniform writeonly image2D Output;
+
+shared vec3 tile[APRON][APRON];
+shared vec3 horizontal[APRON][TILE];
+
+// NOTE(Joey): sigma 2.83 matches 4 iterations of the 9-tap binomial kernel the fragment
+// shader blur used to run per axis.
+const float SIGMA = 2.83;
+
+void main()
+{
+    float weights[RADIUS + 1];
+    float total = 0.0;
+    for(int i = 0; i <= RADIUS; ++i)
+    {
+        weights[i] = exp(-float(i * i) / (2.0 * SIGMA * SIGMA));
+        total += i == 0 ? weights[i] : 2.0 * weights[i];
+    }
+
+    // load the tile and its apron (clamped to the level's edges)
+    ivec2 size   = textureSize(TexSrc, 0);
+    ivec2 origin = ivec2(gl_WorkGroupID.xy) * TILE - RADIUS;
+    int   index  = int(gl_LocalInvocationIndex);
+    for(int i = index; i < APRON * APRON; i += TILE * TILE)
+    {
+        ivec2 p = ivec2(i % APRON, i / APRON);
+        tile[p.y][p.x] = texelFetch(TexSrc, clamp(origin + p, ivec2(0), size - 1), 0).rgb;
+    }
+    memoryBarrierShared();
+    barrier();
+
+    // horizontal pass over all rows of the apron
+    for(int i = index; i < APRON * TILE; i += TILE * TILE)
+    {
+        int x = i % TILE, y = i / TILE;
+        vec3 sum = tile[y][x + RADIUS] * weights[0];
+        for(int k = 1; k <= RADIUS; ++k)
+            sum += (tile[y][x + RADIUS - k] + tile[y][x + RADIUS + k]) * weights[k];
+        horizontal[y][x] = sum / total;
+    }
+    memoryBarrierShared();
+    barrier();
+
+    // vertical pass
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+    vec3 result = horizontal[local.y + RADIUS][local.x] * weights[0];
+    for(int k = 1; k <= RADIUS; ++k)
+        result += (horizontal[local.y + RADIUS - k][local.x] + horizontal[local.y + RADIUS + k][local.x]) * weights[k];
+    result *= Weight / total;
+
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if(any(greaterThanEqual(texel, imageSize(Output))))
+        return;
+    if(Accumulate)
+        result += textureLod(TexCoarser, (vec2(texel) + 0.5) / vec2(imageSize(Output)), 0.0).rgb;
+    imageStore(Output, texel, vec4(result, 1.0));
+}
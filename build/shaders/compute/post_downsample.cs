@@ -0,0 +1,65 @@
+#version 430 core
+// Single pass downsample (after AMD's FidelityFX SPD): each work group reduces a tile of the
+// source to 16x16, 8x8, 4x4 and 2x2 texels of the 4 pyramid levels in shared memory, s.t. the
+// whole pyramid is built in a single dispatch w/o round trips through memory between levels.
+layout (local_size_x = 16, local_size_y = 16) in;
+
+uniform sampler2D TexSrc;
+layout (rgba16f, binding = 0) uniform writeonly image2D Level0;
+layout (rgba16f, binding = 1) uniform writeonly image2D Level1;
+layout (rgba16f, binding = 2) uniform writeonly image2D Level2;
+layout (rgba16f, binding = 3) uniform writeonly image2D Level3;
+
+shared vec4 tile[16][16];
+
+void storeLevel(int level, ivec2 texel, vec4 color)
+{
+    if(level == 1)
+    {
+        if(all(lessThan(texel, imageSize(Level1)))) imageStore(Level1, texel, color);
+    }
+    else if(level == 2)
+    {
+        if(all(lessThan(texel, imageSize(Level2)))) imageStore(Level2, texel, color);
+    }
+    else
+    {
+        if(all(lessThan(texel, imageSize(Level3)))) imageStore(Level3, texel, color);
+    }
+}
+
+void main()
+{
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+
+    // level 0: a bilinear tap between the 2x2 source texels covered by a level 0 texel
+    // averages them
+    ivec2 size0 = imageSize(Level0);
+    vec4 color = textureLod(TexSrc, (vec2(texel) + 0.5) / vec2(size0), 0.0);
+    if(all(lessThan(texel, size0)))
+        imageStore(Level0, texel, color);
+    tile[local.y][local.x] = color;
+
+    // the coarser levels average 2x2 texels of the previous level, halving the active threads
+    // each time
+    for(int level = 1; level < 4; ++level)
+    {
+        int  n      = 16 >> level;
+        bool active = local.x < n && local.y < n;
+        memoryBarrierShared();
+        barrier();
+        if(active)
+        {
+            ivec2 p = local * 2;
+            color = 0.25 * (tile[p.y][p.x] + tile[p.y][p.x + 1] + tile[p.y + 1][p.x] + tile[p.y + 1][p.x + 1]);
+        }
+        memoryBarrierShared();
+        barrier();
+        if(active)
+        {
+            tile[local.y][local.x] = color;
+            storeLevel(level, ivec2(gl_WorkGroupID.xy) * n + local, color);
+        }
+    }
+}
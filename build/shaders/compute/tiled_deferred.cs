@@ -0,0 +1,151 @@
+#version 430 core
+// Tiled deferred lighting (see Renderer::renderDeferredTiled): one work group per 16x16 tile
+// reduces the tile's view depth bounds, bins the point lights whose footprint (screen tiles
+// and depth range, see math::binLights for the CPU reference) overlaps the tile into shared
+// memory and shades each pixel w/ the directional lights and the tile's point lights in a
+// single pass, reading the G-buffer once. The lighting is added to the ambient lighting
+// already in the scene target.
+layout (local_size_x = 16, local_size_y = 16) in;
+
+#define MAX_TILE_LIGHTS 256
+#define MAX_DIR_LIGHTS  4
+
+#include ../common/constants.glsl
+#include ../common/brdf.glsl
+#include ../common/shadows.glsl
+#include ../common/uniforms.glsl
+
+// see Renderer::renderDeferredTiled (std430)
+struct TiledLight
+{
+    vec4  PositionRadius; // world space
+    vec4  Color;
+    ivec4 Tiles;          // inclusive tile range: min x, min y, max x, max y
+    vec4  Depth;          // x: min, y: max view depth
+};
+
+layout (std430, binding = 0) readonly buffer Lights
+{
+    TiledLight lights[];
+};
+layout (rgba16f, binding = 0) uniform image2D Scene;
+
+uniform sampler2D gPositionMetallic;
+uniform sampler2D gNormalRoughness;
+uniform sampler2D gAlbedoAO;
+
+uniform vec2 RenderSize; // the internal resolution
+uniform int  LightCount;
+
+uniform int       DirLightCount;
+uniform vec3      DirLightDirection[MAX_DIR_LIGHTS];
+uniform vec3      DirLightColor[MAX_DIR_LIGHTS];
+uniform bool      DirLightShadow[MAX_DIR_LIGHTS];
+uniform mat4      DirLightShadowViewProjection[MAX_DIR_LIGHTS];
+uniform sampler2D DirLightShadowMap[MAX_DIR_LIGHTS];
+
+shared uint tileDepthMin;
+shared uint tileDepthMax;
+shared uint tileLightCount;
+shared uint tileLights[MAX_TILE_LIGHTS];
+
+// cook-torrance brdf (as the deferred light shaders)
+vec3 Shade(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float roughness, float metallic)
+{
+    vec3 H  = normalize(V + L);
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+
+    float NDF = DistributionGGX(N, H, roughness);
+    float G   = GeometryGGX(max(dot(N, V), 0.0), max(dot(N, L), 0.0), roughness);
+    vec3  F   = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
+
+    vec3 nominator    = NDF * G * F;
+    float denominator = 4 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.001;
+    vec3 specular     = nominator / denominator;
+
+    float NdotL = max(dot(N, L), 0.0);
+    return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+void main()
+{
+    ivec2 pixel  = ivec2(gl_GlobalInvocationID.xy);
+    bool  inside = all(lessThan(vec2(pixel), RenderSize));
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        tileDepthMin   = 0x7F7FFFFFu; // FLT_MAX
+        tileDepthMax   = 0u;
+        tileLightCount = 0u;
+    }
+    barrier();
+
+    // 1. the tile's depth bounds; pixels w/o geometry (cleared normals) don't count. View
+    // depths are positive, s.t. their bit patterns order as unsigned integers.
+    vec4 positionMetallic = texelFetch(gPositionMetallic, pixel, 0);
+    vec4 normalRoughness  = texelFetch(gNormalRoughness, pixel, 0);
+    bool geometry = inside && dot(normalRoughness.rgb, normalRoughness.rgb) > 0.0;
+    float depth = max(-(view * vec4(positionMetallic.xyz, 1.0)).z, 0.0);
+    if (geometry)
+    {
+        atomicMin(tileDepthMin, floatBitsToUint(depth));
+        atomicMax(tileDepthMax, floatBitsToUint(depth));
+    }
+    barrier();
+
+    // 2. bin the lights overlapping the tile, 256 at a time
+    float depthMin = uintBitsToFloat(tileDepthMin);
+    float depthMax = uintBitsToFloat(tileDepthMax);
+    ivec2 tile     = ivec2(gl_WorkGroupID.xy);
+    for (uint i = gl_LocalInvocationIndex; i < uint(LightCount); i += 256u)
+    {
+        TiledLight light = lights[i];
+        if (all(greaterThanEqual(tile, light.Tiles.xy)) && all(lessThanEqual(tile, light.Tiles.zw)) &&
+            light.Depth.x <= depthMax && light.Depth.y >= depthMin)
+        {
+            uint slot = atomicAdd(tileLightCount, 1u);
+            if (slot < MAX_TILE_LIGHTS)
+                tileLights[slot] = i;
+        }
+    }
+    barrier();
+
+    if (!geometry)
+        return;
+
+    // 3. shade
+    vec3 worldPos   = positionMetallic.xyz;
+    float metallic  = positionMetallic.a;
+    vec3 albedo     = texelFetch(gAlbedoAO, pixel, 0).rgb;
+    float roughness = normalRoughness.a;
+    vec3 N = normalize(normalRoughness.rgb);
+    vec3 V = normalize(camPos.xyz - worldPos);
+
+    vec3 Lo = vec3(0.0);
+    for (int i = 0; i < DirLightCount; ++i)
+    {
+        vec3 L = normalize(-DirLightDirection[i]);
+        float shadow = 0.0;
+        if (DirLightShadow[i])
+            shadow = ShadowFactor(DirLightShadowMap[i], DirLightShadowViewProjection[i] * vec4(worldPos, 1.0), N, L);
+        Lo += Shade(N, V, L, DirLightColor[i], albedo, roughness, metallic) * (1.0 - shadow);
+    }
+
+    uint count = min(tileLightCount, uint(MAX_TILE_LIGHTS));
+    for (uint i = 0u; i < count; ++i)
+    {
+        TiledLight light = lights[tileLights[i]];
+        vec3  lightPos = light.PositionRadius.xyz;
+        float radius   = light.PositionRadius.w;
+        // UE4's light attenuation model (as point.fs)
+        float distance    = length(worldPos - lightPos);
+        float attenuation = pow(clamp(1.0 - distance / radius, 0.0, 1.0), 2.0) / (distance * distance + 1.0);
+        if (attenuation > 0.0)
+            Lo += Shade(N, V, normalize(lightPos - worldPos), light.Color.rgb * attenuation, albedo, roughness, metallic);
+    }
+
+    vec4 color = imageLoad(Scene, pixel);
+    imageStore(Scene, pixel, vec4(color.rgb + Lo, color.a));
+}
@@ -0,0 +1,54 @@
+#version 400 core
+// Fans each triangle out to the faces of a layered cubemap target in a single pass (see
+// Renderer::renderToCubemap): one invocation per face, w/ the faces the draw doesn't touch
+// (culled on the CPU) masked out by FaceMask. The vertex shaders pass their world (or sky)
+// positions unprojected under LAYERED.
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+uniform mat4 projection;
+uniform mat4 FaceView[6];
+uniform int  FaceMask;
+
+#if defined(CAPTURE)
+in vec2 vTexCoords[];
+in vec3 vFragPos[];
+in vec3 vNormal[];
+out vec2 TexCoords;
+out vec3 FragPos;
+out vec3 Normal;
+#elif defined(BACKGROUND)
+in vec3 vLocalPos[];
+out vec3 LocalPos;
+#define SKY_IN  vLocalPos
+#define SKY_OUT LocalPos
+#else
+in vec3 vWorldPos[];
+out vec3 WorldPos;
+#define SKY_IN  vWorldPos
+#define SKY_OUT WorldPos
+#endif
+
+void main()
+{
+    int face = gl_InvocationID;
+    if((FaceMask & (1 << face)) == 0)
+        return;
+
+    for(int i = 0; i < 3; ++i)
+    {
+#if defined(CAPTURE)
+        TexCoords   = vTexCoords[i];
+        FragPos     = vFragPos[i];
+        Normal      = vNormal[i];
+        gl_Position = projection * FaceView[face] * vec4(vFragPos[i], 1.0);
+#else
+        // the sky ignores the faces' translation and is projected onto the far plane
+        SKY_OUT     = SKY_IN[i];
+        gl_Position = (projection * mat4(mat3(FaceView[face])) * vec4(SKY_IN[i], 1.0)).xyww;
+#endif
+        gl_Layer = face;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
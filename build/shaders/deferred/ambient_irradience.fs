@@ -1,14 +1,12 @@
 #version 430 core
 out vec4 FragColor;
 
-in vec3 FragPos;
-in vec4 ScreenPos;
-in vec3 CamPos;
-in vec3 ProbePos;
+in vec2 TexCoords;
 
 #include ../common/constants.glsl
 #include ../common/brdf.glsl
 #include ../common/uniforms.glsl
+#include ../common/spherical_harmonics.glsl
 
 uniform sampler2D gPositionMetallic;
 uniform sampler2D gNormalRoughness;
@@ -19,23 +17,47 @@ uniform samplerCube envPrefilter;
 uniform sampler2D   BRDFLUT;
 uniform sampler2D   TexSSAO;
 
-uniform vec3 probePos;
-uniform float probeRadius;
+// the irradiance probe grid (see IrradianceVolume): the 9 coefficient slabs stacked along z,
+// premultiplied by the probes' validity (in alpha).
+uniform sampler3D IrradianceVolume;
+uniform vec3  VolumeMin;
+uniform vec3  VolumeMax;
+uniform vec3  VolumeResolution; // probes per axis
+uniform float VolumeSpacing;
+
+// validity weighted trilinear interpolation of the probes around p; returns the interpolated
+// validity (0 if none of the probes is valid).
+float SampleIrradianceVolume(vec3 p, out vec3 sh[9])
+{
+    vec3 uvw   = (clamp(p, VolumeMin, VolumeMax) - VolumeMin) / (VolumeMax - VolumeMin);
+    // probes are at the texel centers; z stays within a slab s.t. slabs never bleed together
+    vec3 texel = uvw * (VolumeResolution - 1.0) + 0.5;
+    vec2 xy    = texel.xy / VolumeResolution.xy;
+    float validity = 0.0;
+    for (int c = 0; c < 9; ++c)
+    {
+        vec4 s = texture(IrradianceVolume, vec3(xy, (c * VolumeResolution.z + texel.z) / (9.0 * VolumeResolution.z)));
+        sh[c] = s.rgb;
+        if (c == 0)
+            validity = s.a;
+    }
+    for (int c = 0; c < 9; ++c)
+        sh[c] /= max(validity, 0.0001);
+    return validity;
+}
 
 uniform int SSAO;
 uniform int SSR;
 
 void main()
 {
-    vec2 uv = (ScreenPos.xy / ScreenPos.w) * 0.5 + 0.5;
-    
-    vec4 albedoAO         = texture(gAlbedoAO, uv);
-    vec4 normalRoughness  = texture(gNormalRoughness, uv);
-    vec4 positionMetallic = texture(gPositionMetallic, uv);
+    vec4 albedoAO         = texture(gAlbedoAO, TexCoords);
+    vec4 normalRoughness  = texture(gNormalRoughness, TexCoords);
+    vec4 positionMetallic = texture(gPositionMetallic, TexCoords);
     float ao = 1.0;
     if(SSAO)
     {
-        ao = texture(TexSSAO, uv).r;
+        ao = texture(TexSSAO, TexCoords).r;
     }
     
     vec3 worldPos   = positionMetallic.xyz;
@@ -43,17 +65,21 @@ void main()
     vec3 normal     = normalRoughness.rgb;
     float roughness = normalRoughness.a;
     float metallic  = positionMetallic.a;
-    
        
     // lighting input
     vec3 N = normalize(normal);
     vec3 V = normalize(camPos.xyz - worldPos); 
-    vec3 L = normalize(probePos - worldPos);
-    vec3 H = normalize(V + L);     
     vec3 R = reflect(-V, N); 
     
-    // calculate light radiance    
-    float attenuation = pow(max(1.0 - length(worldPos - probePos) / probeRadius, 0.0), 2.0);
+    // look up the probe grid slightly offset along the normal (s.t. a surface doesn't sample
+    // probes right behind it); the sky's irradiance fills in outside the grid (fading out over
+    // a cell) and where there are no valid probes around.
+    vec3 samplePos = worldPos + N * 0.25 * VolumeSpacing;
+    vec3 sh[9];
+    float validity = SampleIrradianceVolume(samplePos, sh);
+    vec3 outside = max(max(VolumeMin - samplePos, samplePos - VolumeMax), vec3(0.0));
+    float coverage = (1.0 - clamp(length(outside) / VolumeSpacing, 0.0, 1.0)) * smoothstep(0.0, 0.05, validity);
+    vec3 irradiance = mix(texture(envIrradiance, N).rgb, max(EvaluateSH9(sh, N), vec3(0.0)), coverage);
         
     // cook-torrance brdf
     vec3 F0 = vec3(0.04); // base reflectance at incident angle for non-metallic (dia-conductor) surfaces 
@@ -61,14 +87,15 @@ void main()
 	vec3 F   = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
 	vec3 kS = F;
 	
-	// calculate specular global illumination contribution w/ Epic's split-sum approximation
+	// calculate specular global illumination contribution w/ Epic's split-sum approximation;
+    // the sky's reflections are dimmed within the (mostly indoor) probe volumes.
     vec3 specular = vec3(0.0);
     if(SSR == 0)
     {
         const float MAX_REFLECTION_LOD = 5.0;
         vec3 prefilteredColor = textureLod(envPrefilter, R,  roughness * MAX_REFLECTION_LOD).rgb;
         vec2 envBRDF          = texture(BRDFLUT, vec2(max(dot(N, V), 0.0), roughness)).rg;
-        specular = prefilteredColor * (F * envBRDF.x + envBRDF.y);
+        specular = prefilteredColor * (F * envBRDF.x + envBRDF.y) * mix(1.0, 0.4, coverage);
     }
     
 	// for energy conservation, the diffuse and specular light can't
@@ -79,15 +106,13 @@ void main()
     // have diffuse lighting, or a linear blend if partly metal (pure metals have
     // no diffuse light).
 	kD *= 1.0 - metallic;	
-	// directly obtain irradiance from irradiance environment map
-	vec3 irradiance = texture(envIrradiance, N).rgb;
 	vec3 diffuse = albedo * irradiance;
 	
 	// combine contributions, note that we don't multiply by kS as kS equals
     // the Fresnel value and the specular value was already multipled by Fresnel
     // during the importance sampling.
-	vec3 color = (kD * diffuse + specular * 0.4) * ao * attenuation; 
+	vec3 color = (kD * diffuse + specular) * ao; 
     
     FragColor.rgb = color;
     FragColor.a = 1.0;
-}
\ No newline at end of file
+}
@@ -18,7 +18,7 @@ uniform float lightRadius;
 
 void main()
 {
-    vec2 uv = (ScreenPos.xy / ScreenPos.w) * 0.5 + 0.5;
+    vec2 uv = ((ScreenPos.xy / ScreenPos.w) * 0.5 + 0.5) * renderScale.xy;
     
     vec4 albedoAO = texture(gAlbedoAO, uv);
     vec4 normalRoughness = texture(gNormalRoughness, uv);
@@ -8,6 +8,6 @@ out vec2 TexCoords;
 
 void main()
 {
-	TexCoords = aUV0;
+	TexCoords = aUV0 * renderScale.xy;
 	gl_Position = vec4(aPos, 1.0);
 }
\ No newline at end of file
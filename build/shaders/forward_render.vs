@@ -8,14 +8,15 @@ out vec3 FragPos;
 out vec3 Normal;
 
 #include common/uniforms.glsl
+#include common/vertex.glsl
 
 uniform mat4 model;
 
 void main()
 {
 	TexCoords = texCoords;
-	FragPos   = vec3(model * vec4(pos, 1.0));
-	Normal    = mat3(model) * normal;
+	FragPos   = vec3(model * vec4(DecodePosition(pos), 1.0));
+	Normal    = mat3(model) * DecodeNormal(normal);
     
 	gl_Position =  projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
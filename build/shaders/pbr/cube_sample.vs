@@ -7,6 +7,10 @@ uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
 
+#ifdef LAYERED
+// projected per cube face by cube_layered.gs
+#define WorldPos vWorldPos
+#endif
 out vec3 WorldPos;
 
 void main()
@@ -14,6 +18,10 @@ void main()
 	vec4 worldPos = model * vec4(pos, 1.0);
 	WorldPos.xyz = worldPos.xyz;
 
+#ifdef LAYERED
+	gl_Position = worldPos;
+	return;
+#endif
 	mat4 rotView = mat4(mat3(view));
 	vec4 clipPos = projection * rotView * model * worldPos;
 
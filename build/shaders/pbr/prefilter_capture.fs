@@ -4,9 +4,12 @@ in vec3 WorldPos;
 
 #include ../common/constants.glsl
 #include ../common/sampling.glsl
+#include ../common/brdf.glsl
 
 uniform samplerCube environment;
 uniform float roughness;
+uniform int   SampleCount; // adapted per mip by the CPU: wider lobes need more samples
+uniform float resolution;  // the (mip 0) face resolution of environment
 
 void main(void) {
     // the world vector acts as the normal of a tangent surface from the origin, 
@@ -17,25 +20,39 @@ void main(void) {
     vec3 R = N;
     vec3 V = N;
 
-    const uint SAMPLE_COUNT = 4096u * 4u;
+    // a perfect mirror reflects the environment as is
+    if(roughness == 0.0)
+    {
+        FragColor = vec4(textureLod(environment, N, 0.0).rgb, 1.0);
+        return;
+    }
+
+    // filtered importance sampling (GPU Gems 3, ch. 20): each sample reads the environment's
+    // mip whose texels cover the solid angle the sample stands for, s.t. a few hundred
+    // samples converge w/o the noise of point sampling a high resolution map.
+    const float saTexel = 4.0 * PI / (6.0 * resolution * resolution);
+    uint sampleCount = uint(SampleCount);
     vec3 prefilteredColor = vec3(0.0);
     float totalWeight = 0.0;
 
-    // for debugging, make scope visible to end part
-    for(uint i = 0u; i < SAMPLE_COUNT; ++i)
+    for(uint i = 0u; i < sampleCount; ++i)
     {
         // generates a sample vector that's biased towards the
         // preferred alignment direction (importance sampling).
-        vec2 Xi = Hammersley(i, SAMPLE_COUNT);
+        vec2 Xi = Hammersley(i, sampleCount);
         vec3 H = ImportanceSampleGGX(Xi, N, roughness);
         vec3 L = normalize(2.0 * dot(V, H) * H - V);
 
         float NdotL = max(dot(N, L), 0.0);
-        // also try without NdotL!
         if(NdotL > 0.0)
         {
+            // w/ N = V the pdf D * NdotH / (4 * HdotV) reduces to D / 4
+            float pdf      = DistributionGGX(N, H, roughness) * 0.25;
+            float saSample = 1.0 / (float(sampleCount) * pdf + 0.0001);
+            float mipLevel = 0.5 * log2(saSample / saTexel) + 1.0;
+
             // note that HDR environment map is loaded linearly, so no need for linearizing first.
-            prefilteredColor += texture(environment, L).rgb * NdotL;
+            prefilteredColor += textureLod(environment, L, mipLevel).rgb * NdotL;
             totalWeight      += NdotL;
         }
     }
@@ -4,14 +4,24 @@ out vec4 FragColor;
 in vec3 LocalPos;
 in vec3 WorldPos;
 
+#ifdef SH_PROBE
+#include ../common/spherical_harmonics.glsl
+uniform vec3 ProbeSH[9];
+#else
 uniform samplerCube PrefilterMap;
+#endif
 uniform vec3 CamPos;
 
 void main()
 {
     vec3 N = normalize(LocalPos);
+#ifdef SH_PROBE
+    // irradiance probes show the diffuse lighting they provide in each direction
+    vec3 color = EvaluateSH9(ProbeSH, N);
+#else
     vec3 V = normalize(CamPos - WorldPos);
     vec3 R = reflect(-V, N);
     vec3 color = textureLod(PrefilterMap, R, 0.0).rgb;
+#endif
     FragColor = vec4(color, 1.0);
-}
\ No newline at end of file
+}
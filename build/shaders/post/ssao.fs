@@ -8,8 +8,16 @@ uniform sampler2D gNormalRoughness;
 uniform sampler2D texNoise;
 
 uniform vec2 renderSize;
+// the internal render size relative to the G-buffer's size (dynamic resolution)
+uniform vec2 renderScale;
 uniform vec3 kernel[64];
 uniform int sampleCount;
+// the kernel's samples used this frame: every kernelStride-th, starting at kernelOffset, s.t.
+// the frames of temporal accumulation together cover the full kernel
+uniform int kernelStride;
+uniform int kernelOffset;
+// per-frame rotation (cos, sin) of the noise
+uniform vec2 noiseRotation;
 
 uniform mat4 projection;
 uniform mat4 view;
@@ -20,9 +28,14 @@ void main()
     float bias = 0.025;
     vec2 noiseScale = renderSize.xy * vec2(1.0 / 4.0);
     
-    vec4 normalRoughness  = texture(gNormalRoughness, TexCoords);
-    vec4 positionMetallic = texture(gPositionMetallic, TexCoords);
+    // fetch a single G-buffer texel (rather than filtering the texels it covers at lower
+    // resolutions) s.t. its depth matches one surface for the bilateral upsample
+    ivec2 gTexel = ivec2(TexCoords * renderScale * vec2(textureSize(gPositionMetallic, 0)));
+    vec4 normalRoughness  = texelFetch(gNormalRoughness, gTexel, 0);
+    vec4 positionMetallic = texelFetch(gPositionMetallic, gTexel, 0);
     vec3 randomVec        = texture(texNoise, TexCoords * noiseScale).xyz;
+    randomVec.xy          = vec2(randomVec.x * noiseRotation.x - randomVec.y * noiseRotation.y,
+                                 randomVec.x * noiseRotation.y + randomVec.y * noiseRotation.x);
     
     vec3 fragPos = (view * vec4(positionMetallic.xyz, 1.0)).xyz;
     vec3 normal  = mat3(view) * normalRoughness.xyz;
@@ -35,7 +48,7 @@ void main()
     for(int i = 0; i < sampleCount; ++i)
     {
         // get sample position
-        vec3 sample = TBN * kernel[i]; // from tangent to view-space
+        vec3 sample = TBN * kernel[i * kernelStride + kernelOffset]; // from tangent to view-space
         sample = fragPos + sample * radius; 
         
         // project sample position (to sample texture) (to get position on screen/texture)
@@ -43,6 +56,7 @@ void main()
         offset = projection * offset; // from view to clip-space
         offset.xyz /= offset.w; // perspective divide
         offset.xyz = offset.xyz * 0.5 + 0.5; // transform to range 0.0 - 1.0
+        offset.xy *= renderScale;
         
         // get sample depth
         float sampleDepth = (view * vec4(texture(gPositionMetallic, offset.xy).xyz, 1.0)).z;
@@ -54,5 +68,6 @@ void main()
     occlusion = 1.0 - (occlusion / float(sampleCount));
     occlusion = pow(occlusion, 3.0);
 
-    FragColor = vec4(vec3(occlusion), 1.0);
+    // the view space depth is kept for temporal rejection and the bilateral upsample
+    FragColor = vec4(occlusion, fragPos.z, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// this frame's SSAO (occlusion, view depth) and last frame's accumulation (occlusion, view
+// depth, accumulated frames)
+uniform sampler2D TexSSAO;
+uniform sampler2D TexHistory;
+uniform sampler2D gMotion;
+
+// the internal render size relative to the targets' size, this and the previous frame
+// (dynamic resolution): the targets are only rendered to in part.
+uniform vec2 renderScale;
+uniform vec2 HistoryScale;
+
+uniform bool  HistoryValid;
+uniform float HistoryFrames; // maximum number of frames accumulated
+uniform float DepthTolerance; // relative view depth difference rejecting the history
+
+void main()
+{
+    vec2 current = texture(TexSSAO, TexCoords * renderScale).rg;
+
+    // reproject: the motion vectors are the NDC offset since the previous frame
+    vec2 motion = texture(gMotion, TexCoords * renderScale).xy;
+    vec2 prevTexCoords = TexCoords - motion * 0.5;
+
+    float frames = 0.0;
+    float occlusion = current.r;
+    if(HistoryValid && all(greaterThanEqual(prevTexCoords, vec2(0.0))) && all(lessThanEqual(prevTexCoords, vec2(1.0))))
+    {
+        vec3 history = texture(TexHistory, prevTexCoords * HistoryScale).rgb;
+        // reject the history of other surfaces (disocclusion)
+        if(abs(history.g - current.g) < DepthTolerance * abs(current.g))
+        {
+            frames = min(history.b + 1.0, HistoryFrames);
+            occlusion = mix(history.r, current.r, 1.0 / (frames + 1.0));
+        }
+    }
+    FragColor = vec4(occlusion, current.g, frames, 1.0);
+}
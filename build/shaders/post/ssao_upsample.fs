@@ -0,0 +1,39 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// the (lower resolution) SSAO: occlusion and view depth
+uniform sampler2D TexSSAO;
+uniform sampler2D gPositionMetallic;
+
+uniform mat4 view;
+// the internal render size relative to the targets' size (dynamic resolution)
+uniform vec2 renderScale;
+
+// bilateral upsample: the bilinear weights of the 4 nearest low resolution texels, scaled by
+// how close their depth is to this pixel's s.t. occlusion doesn't bleed across edges.
+void main()
+{
+    vec2  uv    = TexCoords * renderScale;
+    float depth = (view * vec4(texture(gPositionMetallic, uv).xyz, 1.0)).z;
+
+    // only the part of the SSAO target rendered to this frame is valid
+    ivec2 size = ivec2(ceil(vec2(textureSize(TexSSAO, 0)) * renderScale));
+    vec2  p    = uv * vec2(textureSize(TexSSAO, 0)) - 0.5;
+    ivec2 base = ivec2(floor(p));
+    vec2  f    = fract(p);
+
+    float occlusion = 0.0;
+    float total     = 0.0;
+    for(int i = 0; i < 4; ++i)
+    {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        vec2 texel = texelFetch(TexSSAO, clamp(base + offset, ivec2(0), size - 1), 0).rg;
+        float bilinear = (offset.x == 1 ? f.x : 1.0 - f.x) * (offset.y == 1 ? f.y : 1.0 - f.y);
+        float weight = bilinear / (abs(texel.g - depth) + 0.01);
+        occlusion += texel.r * weight;
+        total     += weight;
+    }
+    FragColor = vec4(total > 0.0 ? occlusion / total : 1.0);
+}
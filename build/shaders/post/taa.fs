@@ -0,0 +1,83 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+#include ../common/uniforms.glsl
+
+// this frame's (jittered) lit scene and the G-buffer's motion vectors, both only rendered to
+// in part (renderScale.xy) at the internal resolution, and last frame's (output resolution)
+// result.
+uniform sampler2D TexSrc;
+uniform sampler2D TexHistory;
+uniform sampler2D gMotion;
+
+uniform bool  HistoryValid;
+uniform float Feedback;    // the weight of this frame's sample
+uniform float ClampGamma;  // the neighbourhood's extent in standard deviations
+
+float luminance(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+// weighs HDR samples by their inverse luminance (before blending/averaging) s.t. a few very
+// bright samples don't dominate the result (and flicker).
+vec3 tonemap(vec3 color)
+{
+    return color / (1.0 + luminance(color));
+}
+
+vec3 untonemap(vec3 color)
+{
+    return color / max(1.0 - luminance(color), 0.0001);
+}
+
+void main()
+{
+    // the scene's texels at the internal resolution; the projection was offset by
+    // renderScale.zw (NDC) s.t. the unjittered position of this pixel lies half of that further.
+    vec2 texelSize = 1.0 / vec2(textureSize(TexSrc, 0));
+    vec2 uv        = (TexCoords + renderScale.zw * 0.5) * renderScale.xy;
+    vec2 uvMax     = renderScale.xy - texelSize * 0.5; // don't sample outside the rendered part
+
+    // the neighbourhood of the current sample: its color's mean and standard deviation (in
+    // tonemapped space) bound the history, s.t. stale history (disocclusions, lighting and
+    // shading changes) is clamped instead of ghosting.
+    vec3 current = vec3(0.0);
+    vec3 m1      = vec3(0.0);
+    vec3 m2      = vec3(0.0);
+    vec3 minimum = vec3( 1e10);
+    vec3 maximum = vec3(-1e10);
+    for(int y = -1; y <= 1; ++y)
+    {
+        for(int x = -1; x <= 1; ++x)
+        {
+            vec2 sampleUV = clamp(uv + vec2(x, y) * texelSize, texelSize * 0.5, uvMax);
+            vec3 s = tonemap(max(texture(TexSrc, sampleUV).rgb, vec3(0.0)));
+            if(x == 0 && y == 0)
+                current = s;
+            m1 += s;
+            m2 += s * s;
+            minimum = min(minimum, s);
+            maximum = max(maximum, s);
+        }
+    }
+    m1 /= 9.0;
+    vec3 sigma = sqrt(max(m2 / 9.0 - m1 * m1, vec3(0.0)));
+    minimum = max(minimum, m1 - ClampGamma * sigma);
+    maximum = min(maximum, m1 + ClampGamma * sigma);
+
+    // reproject: the motion vectors are the (unjittered) NDC offset since the previous frame
+    vec2 motion = texture(gMotion, clamp(TexCoords * renderScale.xy, texelSize * 0.5, uvMax)).xy;
+    vec2 prevTexCoords = TexCoords - motion * 0.5;
+
+    vec3 color = current;
+    if(HistoryValid && all(greaterThanEqual(prevTexCoords, vec2(0.0))) && all(lessThanEqual(prevTexCoords, vec2(1.0))))
+    {
+        vec3 history = tonemap(max(texture(TexHistory, prevTexCoords).rgb, vec3(0.0)));
+        history = clamp(history, minimum, maximum);
+        color = mix(history, current, Feedback);
+    }
+    FragColor = vec4(untonemap(color), 1.0);
+}
@@ -3,6 +3,8 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
+#include common/uniforms.glsl
+
 uniform sampler2D TexSrc;
 
 // post-process effect toggles
@@ -17,13 +19,10 @@ const vec3 sepiaColor = vec3(1.2, 1.0, 0.8);
 
 // vignette
 
-// bloom
-uniform sampler2D TexBloom1;
-uniform sampler2D TexBloom2;
-uniform sampler2D TexBloom3;
-uniform sampler2D TexBloom4;
+// bloom (all levels, already weighted; see PostProcessor)
+uniform sampler2D TexBloom;
 
-// motion blur
+// motion blur; the G-buffer is at the internal resolution (see renderScale)
 uniform sampler2D gMotion;
 uniform float MotionScale;
 uniform int MotionSamples;
@@ -47,7 +46,7 @@ void main()
         
     if(MotionBlur == 1)
     {
-        vec2 motion = texture(gMotion, TexCoords).xy;
+        vec2 motion = texture(gMotion, TexCoords * renderScale.xy).xy;
         motion     *= MotionScale;
         
         vec3 avgColor = color;
@@ -62,15 +61,7 @@ void main()
        
     if(Bloom == 1)
     {
-        const float strength = 0.5;
-        vec3 bloom1 = texture(TexBloom1, TexCoords).rgb * strength * 1.00;
-        vec3 bloom2 = texture(TexBloom2, TexCoords).rgb * strength * 0.75;
-        vec3 bloom3 = texture(TexBloom3, TexCoords).rgb * strength * 0.50;
-        vec3 bloom4 = texture(TexBloom4, TexCoords).rgb * strength * 0.25;
-        color += bloom1;
-        color += bloom2;
-        color += bloom3;
-        color += bloom4;
+        color += texture(TexBloom, TexCoords).rgb;
     }
     
     // HDR tonemapping
@@ -6,6 +6,10 @@
 #include "imgui/imgui.h"
 
 #include "renderer/PostProcessor.h"
+#include "renderer/render_graph.h"
+#include "resources/texture_streamer.h"
+
+#include <fstream>
 
 namespace Cell
 {
@@ -115,6 +119,9 @@ namespace Cell
 
     void NewFrame()
     {
+        // upload (a bounded amount of) textures that finished loading in the background
+        TextureStreamer::Update();
+
         ImGui_ImplGlfwGL3_NewFrame();
     }
 
@@ -129,25 +136,63 @@ namespace Cell
         if (ImGui::CollapsingHeader("General Options"))
         {
             ImGui::Checkbox("IrradianceGI", &renderer->IrradianceGI);
+            ImGui::Checkbox("Irradiance Probe Updates", &renderer->IrradianceProbeUpdates);
+            ImGui::Text("Probes pending: %u", renderer->GetPendingProbeCount());
             ImGui::Checkbox("Shadows", &renderer->Shadows);
             ImGui::Checkbox("Lights", &renderer->Lights);
+            ImGui::Checkbox("Tiled Lighting", &renderer->TiledLighting);
             ImGui::Checkbox("Render Light Shapes", &renderer->RenderLights);
+            ImGui::Checkbox("Meshlet Culling", &renderer->MeshletCulling);
+            ImGui::Checkbox("GPU Meshlet Culling", &renderer->GPUMeshletCulling);
         }
         if (ImGui::CollapsingHeader("Post-processing"))
         {
             ImGui::Checkbox("SSAO", &renderer->GetPostProcessor()->SSAO);
+            ImGui::Combo("SSAO Quality", (int*)&renderer->GetPostProcessor()->SSAOQuality, "Low (temporal)\0Medium (temporal)\0High\0\0");
             ImGui::Checkbox("Bloom", &renderer->GetPostProcessor()->Bloom);
             ImGui::Checkbox("Motion Blur", &renderer->GetPostProcessor()->MotionBlur);
             //ImGui::Checkbox("SSR", &renderer->GetPostProcessor()->SSR);
-            //ImGui::Checkbox("TXAA", &renderer->GetPostProcessor()->TXAA);
+            ImGui::Checkbox("TXAA", &renderer->GetPostProcessor()->TXAA);
+            ImGui::Checkbox("Dynamic Resolution (TXAA)", &renderer->DynamicResolution);
+            ImGui::SliderFloat("GPU Frame Target (ms)", &renderer->DynamicResolutionTarget, 4.0f, 33.0f);
+            ImGui::SliderFloat("Minimum Resolution", &renderer->DynamicResolutionMin, 0.25f, 1.0f);
+            ImGui::Text("Internal resolution: %.0fx%.0f (%.0f%%), GPU frame %.3f ms", renderer->GetInternalSize().x, renderer->GetInternalSize().y,
+                        renderer->GetRenderScale() * 100.0f, renderer->GetGPUFrameTime());
             ImGui::Checkbox("Vignette", &renderer->GetPostProcessor()->Vignette);
             ImGui::Checkbox("Sepia", &renderer->GetPostProcessor()->Sepia);
+
+            Cell::PostProcessor* postProcessor = renderer->GetPostProcessor();
+            ImGui::Text("GPU: SSAO %.3f ms, downsample %.3f ms, blur %.3f ms", postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_SSAO), postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_DOWNSAMPLE), postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_BLUR));
+            ImGui::Text("GPU: TXAA %.3f ms, bloom %.3f ms, composite %.3f ms", postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_TXAA), postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_BLOOM),
+                        postProcessor->GetGPUTime(Cell::PostProcessor::POST_STAGE_COMPOSITE));
+        }
+        if (ImGui::CollapsingHeader("Render graph"))
+        {
+            const Cell::RenderGraph* graph = renderer->GetRenderGraph();
+            const Cell::RenderGraphStats& stats = graph->GetStats();
+            ImGui::Text("Passes: %u (culled: %u)", stats.Passes - stats.PassesCulled, stats.PassesCulled);
+            ImGui::Text("Transients: %u in %u textures", stats.Transients, stats.Textures);
+            ImGui::Text("Memory: %.2f MB (declared %.2f MB, saved %.2f MB)", stats.AllocatedBytes / (1024.0f * 1024.0f), stats.DeclaredBytes / (1024.0f * 1024.0f),
+                        (stats.DeclaredBytes - stats.AllocatedBytes) / (1024.0f * 1024.0f));
+            if (ImGui::Button("Save render graph"))
+            {
+                std::ofstream file("render_graph.dot", std::ios::trunc);
+                file << graph->Serialize();
+                Log::Message("Render graph saved to render_graph.dot", LOG_DEBUG);
+            }
         }
         if (ImGui::CollapsingHeader("Debug visualization"))
         {
             ImGui::Checkbox("Wireframe", &renderer->Wireframe);
             ImGui::Checkbox("Light Volumes", &renderer->LightVolumes);
             ImGui::Checkbox("Ambient Probes", &renderer->RenderProbes);
+            ImGui::Checkbox("Meshlet Statistics", &renderer->MeshletStatistics);
+            if (renderer->MeshletStatistics)
+            {
+                const Cell::MeshletStats& stats = renderer->GetMeshletStats();
+                ImGui::Text("Meshlets: %u (frustum culled: %u, cone culled: %u)", stats.Meshlets, stats.CulledFrustum, stats.CulledCone);
+                ImGui::Text("Triangles: %u (culled: %u)", stats.Triangles, stats.TrianglesCulled);
+            }
         }
         ImGui::End();
 
@@ -7,6 +7,7 @@
 #include "camera/fly_camera.h"
 #include "resources/resources.h"
 #include "mesh/mesh.h"
+#include "mesh/mesh_simplifier.h"
 #include "mesh/quad.h"
 #include "mesh/circle.h"
 #include "mesh/line_strip.h"
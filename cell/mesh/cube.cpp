@@ -136,6 +136,7 @@ namespace Cell
         };
 
         Topology = TRIANGLES;
+        CalculateTangents();
         Finalize();
     }
 }
\ No newline at end of file
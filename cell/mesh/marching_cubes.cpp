@@ -0,0 +1,811 @@
+#include "marching_cubes.h"
+
+#include <math.h>
+#include <math/linear_algebra/operation.h>
+#include <utility/threading/thread_pool.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Cell
+{
+    // tables from: http://paulbourke.net/geometry/polygonise/
+    static const int edgeTable[256] =
+    {
+        0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+        0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+        0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+        0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+        0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+        0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+        0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
+        0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+        0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
+        0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+        0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
+        0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+        0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
+        0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+        0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
+        0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+        0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+        0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+        0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+        0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+        0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+        0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+        0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+        0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
+        0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+        0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
+        0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+        0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
+        0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+        0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
+        0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+        0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0   
+    };
+    static const int triTable[256][16] =
+    {
+        {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+        {3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+        {3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1},
+        {3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+        {9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1},
+        {9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
+        {2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1},
+        {8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1},
+        {9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+        {4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1},
+        {3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1},
+        {1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1},
+        {4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1},
+        {4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1},
+        {9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+        {5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1},
+        {2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1},
+        {9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+        {0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+        {2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1},
+        {10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1},
+        {4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1},
+        {5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1},
+        {5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+        {9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1},
+        {0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1},
+        {1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1},
+        {10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1},
+        {8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1},
+        {2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1},
+        {7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1},
+        {9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1},
+        {2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1},
+        {11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1},
+        {9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1},
+        {5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1},
+        {11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1},
+        {11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
+        {1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1},
+        {9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+        {5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1},
+        {2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
+        {0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
+        {5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1},
+        {6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1},
+        {3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1},
+        {6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+        {5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1},
+        {1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
+        {10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1},
+        {6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1},
+        {8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1},
+        {7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1},
+        {3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
+        {5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1},
+        {0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1},
+        {9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1},
+        {8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1},
+        {5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1},
+        {0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1},
+        {6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1},
+        {10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1},
+        {10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1},
+        {8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1},
+        {1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1},
+        {3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1},
+        {0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+        {10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1},
+        {3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1},
+        {6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1},
+        {9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1},
+        {8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1},
+        {3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1},
+        {6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+        {0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1},
+        {10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1},
+        {10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1},
+        {2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1},
+        {7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1},
+        {7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1},
+        {2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1},
+        {1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1},
+        {11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1},
+        {8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1},
+        {0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1},
+        {7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
+        {10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
+        {2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
+        {6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1},
+        {7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1},
+        {2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1},
+        {1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1},
+        {10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+        {10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1},
+        {0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1},
+        {7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+        {6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+        {8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1},
+        {6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1},
+        {4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1},
+        {10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1},
+        {8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1},
+        {0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1},
+        {1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+        {8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1},
+        {10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1},
+        {4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1},
+        {10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
+        {5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
+        {11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1},
+        {9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
+        {6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1},
+        {7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1},
+        {3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1},
+        {7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1},
+        {9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1},
+        {3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1},
+        {6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1},
+        {9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1},
+        {1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1},
+        {4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1},
+        {7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1},
+        {6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1},
+        {3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1},
+        {0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1},
+        {6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1},
+        {0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1},
+        {11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1},
+        {6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1},
+        {5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1},
+        {9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1},
+        {1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1},
+        {1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1},
+        {10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1},
+        {0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1},
+        {5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1},
+        {10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1},
+        {11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1},
+        {9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1},
+        {7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1},
+        {2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1},
+        {8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1},
+        {9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1},
+        {9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1},
+        {1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1},
+        {9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+        {9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1},
+        {5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1},
+        {0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1},
+        {10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1},
+        {2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1},
+        {0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1},
+        {0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1},
+        {9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1},
+        {5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1},
+        {3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1},
+        {5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1},
+        {8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1},
+        {9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1},
+        {0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1},
+        {1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1},
+        {3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1},
+        {4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1},
+        {9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1},
+        {11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1},
+        {11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1},
+        {2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1},
+        {9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1},
+        {3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1},
+        {1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1},
+        {4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1},
+        {4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+        {0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1},
+        {3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1},
+        {3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1},
+        {0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1},
+        {9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1},
+        {1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+        {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
+    };
+
+    // grid offsets (x, y, z) of the cube's corners in table order; notation of the corners:
+    // L/R = x, B/T (bottom/top) = y, B/F (back/front) = z: LBB, RBB, RBF, LBF, LTB, RTB, RTF, LTF.
+    static const unsigned int cornerOffsets[8][3] =
+    {
+        { 0, 0, 0 }, { 1, 0, 0 }, { 1, 0, 1 }, { 0, 0, 1 },
+        { 0, 1, 0 }, { 1, 1, 0 }, { 1, 1, 1 }, { 0, 1, 1 },
+    };
+    // the corners of each of the cube's edges, ordered from the lower to the higher grid corner
+    // s.t. each cell sharing an edge interpolates the exact same vertex.
+    static const unsigned int edgeCorners[12][2] =
+    {
+        { 0, 1 }, { 1, 2 }, { 3, 2 }, { 0, 3 },
+        { 4, 5 }, { 5, 6 }, { 7, 6 }, { 4, 7 },
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+    };
+
+    static const unsigned int INVALID_VERTEX = 0xFFFFFFFF;
+    static const uint64_t     INTERIOR_EDGE  = 0xFFFFFFFFFFFFFFFFull;
+
+    // world position of grid corner (x, y, z); shared by the dense and the sparse polygonizer
+    // s.t. both produce the exact same vertices.
+    static math::vec3 gridCorner(float maxDistance, float cubeScale, unsigned int x, unsigned int y, unsigned int z)
+    {
+        return math::vec3(-maxDistance + x * cubeScale, -maxDistance + y * cubeScale, -maxDistance + z * cubeScale);
+    }
+
+    // cube-march aware lerp: the zero crossing between two grid corners w/ distance d1 and d2.
+    static math::vec3 zeroCrossing(const math::vec3& p1, float d1, const math::vec3& p2, float d2)
+    {
+        const float epsilon = 0.0001f;
+        if (std::abs(d1) < epsilon)
+            return p1;
+        if (std::abs(d2) < epsilon)
+            return p2;
+        if (std::abs(d1 - d2) < epsilon)
+            return p1;
+        float t = -d1 / (d2 - d1);
+        return p1 + (p2 - p1) * t;
+    }
+
+    // the polygonized surface of a range of slabs; vertex indices are local to the range.
+    struct SlabRange
+    {
+        std::vector<math::vec3>   Positions;
+        std::vector<unsigned int> Indices;
+        // vertices on the x and y edges of the range's first and last corner plane
+        std::vector<unsigned int> FirstX, FirstY;
+        std::vector<unsigned int> LastX, LastY;
+    };
+
+    static void polygonizeSlabs(const SDFBatch& sdf, float maxDistance, unsigned int n, unsigned int zBegin, unsigned int zEnd, SlabRange& range)
+    {
+        const unsigned int s = n + 1; // grid corners per row
+        const float cubeScale = 2.0f * maxDistance / n; // range => [-scale, scale] => 2*scale
+        auto corner = [&](unsigned int x, unsigned int y, unsigned int z)
+        {
+            return gridCorner(maxDistance, cubeScale, x, y, z);
+        };
+
+        std::vector<math::vec3> points(s * s);
+        auto sample = [&](unsigned int z, std::vector<float>& plane)
+        {
+            for (unsigned int y = 0; y < s; ++y)
+                for (unsigned int x = 0; x < s; ++x)
+                    points[y * s + x] = corner(x, y, z);
+            sdf(&points[0], &plane[0], s * s);
+        };
+
+        // per corner plane: the SDF samples and the vertices on its x edges (s rows of n edges)
+        // and y edges (n rows of s edges); between the two planes: the vertices on the z edges.
+        std::vector<float>        planes[2] = { std::vector<float>(s * s), std::vector<float>(s * s) };
+        std::vector<unsigned int> edgesX[2] = { std::vector<unsigned int>(n * s, INVALID_VERTEX), std::vector<unsigned int>(n * s, INVALID_VERTEX) };
+        std::vector<unsigned int> edgesY[2] = { std::vector<unsigned int>(n * s, INVALID_VERTEX), std::vector<unsigned int>(n * s, INVALID_VERTEX) };
+        std::vector<unsigned int> edgesZ(s * s);
+
+        sample(zBegin, planes[0]);
+        for (unsigned int z = zBegin; z < zEnd; ++z)
+        {
+            sample(z + 1, planes[1]);
+            std::fill(edgesX[1].begin(), edgesX[1].end(), INVALID_VERTEX);
+            std::fill(edgesY[1].begin(), edgesY[1].end(), INVALID_VERTEX);
+            std::fill(edgesZ.begin(), edgesZ.end(), INVALID_VERTEX);
+
+            for (unsigned int y = 0; y < n; ++y)
+            {
+                for (unsigned int x = 0; x < n; ++x)
+                {
+                    float distances[8];
+                    int cubeIndex = 0;
+                    for (unsigned int c = 0; c < 8; ++c)
+                    {
+                        const unsigned int* offset = cornerOffsets[c];
+                        distances[c] = planes[offset[2]][(y + offset[1]) * s + x + offset[0]];
+                        if (distances[c] < 0.0f)
+                            cubeIndex |= 1 << c;
+                    }
+                    const int edges = edgeTable[cubeIndex];
+                    if (edges == 0) // cube is in/out of surface, do nothing
+                        continue;
+
+                    unsigned int vertices[12];
+                    for (unsigned int e = 0; e < 12; ++e)
+                    {
+                        if (!(edges & (1 << e)))
+                            continue;
+                        const unsigned int* a = cornerOffsets[edgeCorners[e][0]];
+                        const unsigned int* b = cornerOffsets[edgeCorners[e][1]];
+                        unsigned int ex = x + a[0], ey = y + a[1];
+                        unsigned int* vertex;
+                        if (a[0] != b[0])
+                            vertex = &edgesX[a[2]][ey * n + ex];
+                        else if (a[1] != b[1])
+                            vertex = &edgesY[a[2]][ey * s + ex];
+                        else
+                            vertex = &edgesZ[ey * s + ex];
+                        if (*vertex == INVALID_VERTEX)
+                        {
+                            *vertex = (unsigned int)range.Positions.size();
+                            range.Positions.push_back(zeroCrossing(corner(ex, ey, z + a[2]), distances[edgeCorners[e][0]],
+                                                                   corner(x + b[0], y + b[1], z + b[2]), distances[edgeCorners[e][1]]));
+                        }
+                        vertices[e] = *vertex;
+                    }
+                    for (unsigned int i = 0; triTable[cubeIndex][i] != -1; i += 3)
+                    {
+                        range.Indices.push_back(vertices[triTable[cubeIndex][i + 0]]);
+                        range.Indices.push_back(vertices[triTable[cubeIndex][i + 1]]);
+                        range.Indices.push_back(vertices[triTable[cubeIndex][i + 2]]);
+                    }
+                }
+            }
+
+            if (z == zBegin)
+            {
+                range.FirstX = edgesX[0];
+                range.FirstY = edgesY[0];
+            }
+            std::swap(planes[0], planes[1]);
+            std::swap(edgesX[0], edgesX[1]);
+            std::swap(edgesY[0], edgesY[1]);
+        }
+        range.LastX = edgesX[0];
+        range.LastY = edgesY[0];
+    }
+
+    // --------------------------------------------------------------------------------------------
+    void MarchingCubes::Polygonize(const SDFBatch& sdf, float maxDistance, unsigned int gridResolution, std::vector<math::vec3>& positions,
+                                   std::vector<unsigned int>& indices, ThreadPool* threadPool)
+    {
+        positions.clear();
+        indices.clear();
+        const unsigned int n = gridResolution;
+        if (n == 0)
+            return;
+
+        // a few slab ranges per thread balances the load (the surface is rarely spread evenly
+        // over the grid), while at least 4 slabs per range keeps the cost of sampling the
+        // boundary planes twice low.
+        const unsigned int threads    = threadPool ? threadPool->GetThreadCount() + 1 : 1;
+        const unsigned int rangeCount = std::max(1u, std::min(n / 4, threads * 4));
+        std::vector<SlabRange> ranges(rangeCount);
+        auto polygonize = [&](unsigned int i)
+        {
+            polygonizeSlabs(sdf, maxDistance, n, n * i / rangeCount, n * (i + 1) / rangeCount, ranges[i]);
+        };
+        if (threadPool && rangeCount > 1)
+        {
+            threadPool->ParallelFor(rangeCount, polygonize);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < rangeCount; ++i)
+                polygonize(i);
+        }
+
+        // stitch the ranges together: the first plane of each range is the last plane of the
+        // previous range, s.t. its vertices map onto the previous range's identical vertices.
+        size_t vertexCount = 0, indexCount = 0;
+        for (unsigned int i = 0; i < rangeCount; ++i)
+        {
+            vertexCount += ranges[i].Positions.size();
+            indexCount  += ranges[i].Indices.size();
+        }
+        positions.reserve(vertexCount);
+        indices.reserve(indexCount);
+
+        std::vector<unsigned int> previousX, previousY, remap;
+        for (unsigned int i = 0; i < rangeCount; ++i)
+        {
+            SlabRange& range = ranges[i];
+            remap.assign(range.Positions.size(), INVALID_VERTEX);
+            for (unsigned int e = 0; i > 0 && e < range.FirstX.size(); ++e)
+            {
+                if (range.FirstX[e] != INVALID_VERTEX && previousX[e] != INVALID_VERTEX)
+                    remap[range.FirstX[e]] = previousX[e];
+                if (range.FirstY[e] != INVALID_VERTEX && previousY[e] != INVALID_VERTEX)
+                    remap[range.FirstY[e]] = previousY[e];
+            }
+            for (unsigned int v = 0; v < range.Positions.size(); ++v)
+            {
+                if (remap[v] == INVALID_VERTEX)
+                {
+                    remap[v] = (unsigned int)positions.size();
+                    positions.push_back(range.Positions[v]);
+                }
+            }
+            for (unsigned int j = 0; j < range.Indices.size(); ++j)
+                indices.push_back(remap[range.Indices[j]]);
+
+            previousX.resize(range.LastX.size());
+            previousY.resize(range.LastY.size());
+            for (unsigned int e = 0; e < range.LastX.size(); ++e)
+            {
+                previousX[e] = range.LastX[e] != INVALID_VERTEX ? remap[range.LastX[e]] : INVALID_VERTEX;
+                previousY[e] = range.LastY[e] != INVALID_VERTEX ? remap[range.LastY[e]] : INVALID_VERTEX;
+            }
+            range = SlabRange();
+        }
+    }
+    // the polygonized surface of a set of bricks; vertices are local to the set. Vertices on a
+    // brick's faces may be shared w/ a neighboring brick and carry the (grid wide) key of their
+    // edge, all other vertices are INTERIOR_EDGE.
+    struct BrickRange
+    {
+        std::vector<math::vec3>   Positions;
+        std::vector<unsigned int> Indices;
+        std::vector<uint64_t>     EdgeKeys;
+    };
+
+    static void polygonizeBricks(const SDFBatch& sdf, float maxDistance, unsigned int n, const unsigned int* bricks, unsigned int brickCount, BrickRange& range)
+    {
+        const unsigned int B        = MarchingCubes::BRICK_SIZE;
+        const unsigned int brickRow = (n + B - 1) / B;
+        const uint64_t     s        = n + 1; // grid corners per row
+        const float        cubeScale = 2.0f * maxDistance / n;
+
+        std::vector<math::vec3>   points((B + 1) * (B + 1) * (B + 1));
+        std::vector<float>        distances(points.size());
+        std::vector<unsigned int> edges(points.size() * 3); // x, y and z edge starting at each corner
+        for (unsigned int i = 0; i < brickCount; ++i)
+        {
+            // the brick's first cell and its number of cells along each axis (less than B for
+            // the bricks at the end of a grid that isn't a multiple of the brick size).
+            const unsigned int bx = bricks[i] % brickRow * B;
+            const unsigned int by = bricks[i] / brickRow % brickRow * B;
+            const unsigned int bz = bricks[i] / (brickRow * brickRow) * B;
+            const unsigned int size[3] = { std::min(B, n - bx), std::min(B, n - by), std::min(B, n - bz) };
+            const unsigned int sx = size[0] + 1, sy = size[1] + 1, sz = size[2] + 1;
+            const unsigned int count = sx * sy * sz;
+
+            for (unsigned int z = 0; z < sz; ++z)
+                for (unsigned int y = 0; y < sy; ++y)
+                    for (unsigned int x = 0; x < sx; ++x)
+                        points[(z * sy + y) * sx + x] = gridCorner(maxDistance, cubeScale, bx + x, by + y, bz + z);
+            sdf(&points[0], &distances[0], count);
+            std::fill(edges.begin(), edges.begin() + count * 3, INVALID_VERTEX);
+
+            for (unsigned int z = 0; z < size[2]; ++z)
+            {
+                for (unsigned int y = 0; y < size[1]; ++y)
+                {
+                    for (unsigned int x = 0; x < size[0]; ++x)
+                    {
+                        float cornerDistances[8];
+                        int cubeIndex = 0;
+                        for (unsigned int c = 0; c < 8; ++c)
+                        {
+                            const unsigned int* offset = cornerOffsets[c];
+                            cornerDistances[c] = distances[((z + offset[2]) * sy + y + offset[1]) * sx + x + offset[0]];
+                            if (cornerDistances[c] < 0.0f)
+                                cubeIndex |= 1 << c;
+                        }
+                        const int cubeEdges = edgeTable[cubeIndex];
+                        if (cubeEdges == 0)
+                            continue;
+
+                        unsigned int vertices[12];
+                        for (unsigned int e = 0; e < 12; ++e)
+                        {
+                            if (!(cubeEdges & (1 << e)))
+                                continue;
+                            const unsigned int* a = cornerOffsets[edgeCorners[e][0]];
+                            const unsigned int* b = cornerOffsets[edgeCorners[e][1]];
+                            const unsigned int axis = a[0] != b[0] ? 0 : a[1] != b[1] ? 1 : 2;
+                            const unsigned int local[3] = { x + a[0], y + a[1], z + a[2] };
+                            unsigned int& vertex = edges[((local[2] * sy + local[1]) * sx + local[0]) * 3 + axis];
+                            if (vertex == INVALID_VERTEX)
+                            {
+                                vertex = (unsigned int)range.Positions.size();
+                                range.Positions.push_back(zeroCrossing(gridCorner(maxDistance, cubeScale, bx + local[0], by + local[1], bz + local[2]),
+                                                                       cornerDistances[edgeCorners[e][0]],
+                                                                       gridCorner(maxDistance, cubeScale, bx + x + b[0], by + y + b[1], bz + z + b[2]),
+                                                                       cornerDistances[edgeCorners[e][1]]));
+                                // an edge is on one of the brick's faces if either of its fixed
+                                // coordinates is on the brick's boundary.
+                                bool face = false;
+                                for (unsigned int j = 0; j < 3; ++j)
+                                    face |= j != axis && (local[j] == 0 || local[j] == size[j]);
+                                range.EdgeKeys.push_back(face ? (((bz + local[2]) * s + by + local[1]) * s + bx + local[0]) * 3 + axis : INTERIOR_EDGE);
+                            }
+                            vertices[e] = vertex;
+                        }
+                        for (unsigned int j = 0; triTable[cubeIndex][j] != -1; j += 3)
+                        {
+                            range.Indices.push_back(vertices[triTable[cubeIndex][j + 0]]);
+                            range.Indices.push_back(vertices[triTable[cubeIndex][j + 1]]);
+                            range.Indices.push_back(vertices[triTable[cubeIndex][j + 2]]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+    uint32_t MarchingCubes::PolygonizeSparse(const SDFBatch& sdf, float maxDistance, unsigned int gridResolution, std::vector<math::vec3>& positions,
+                                             std::vector<unsigned int>& indices, ThreadPool* threadPool, float lipschitz)
+    {
+        positions.clear();
+        indices.clear();
+        const unsigned int n = gridResolution;
+        if (n == 0)
+            return 0;
+
+        const unsigned int B         = BRICK_SIZE;
+        const unsigned int brickRow  = (n + B - 1) / B;
+        const float        cubeScale = 2.0f * maxDistance / n;
+        const unsigned int threads   = threadPool ? threadPool->GetThreadCount() + 1 : 1;
+
+        // calls func(begin, end) over [0, count) in chunks of at most chunkSize, in parallel if
+        // there's more than one chunk.
+        auto forChunks = [&](unsigned int count, unsigned int chunkSize, const std::function<void(unsigned int, unsigned int)>& func)
+        {
+            const unsigned int chunkCount = (count + chunkSize - 1) / chunkSize;
+            auto chunk = [&](unsigned int i)
+            {
+                func(i * chunkSize, std::min(count, (i + 1) * chunkSize));
+            };
+            if (threadPool && chunkCount > 1)
+            {
+                threadPool->ParallelFor(chunkCount, chunk);
+            }
+            else
+            {
+                for (unsigned int i = 0; i < chunkCount; ++i)
+                    chunk(i);
+            }
+        };
+
+        // refine the brick octree level by level, from a single root node covering the
+        // (power of two rounded) grid of bricks down to individual bricks. A node is refined
+        // only if the surface can pass through its cells: the SDF at the node's center is
+        // within lipschitz times the distance from its center to its farthest corner (w/ a
+        // small margin for the SDF's own rounding errors).
+        struct Node
+        {
+            unsigned int X, Y, Z; // in bricks
+        };
+        unsigned int nodeSize = 1; // in bricks
+        while (nodeSize < brickRow)
+            nodeSize *= 2;
+        std::vector<Node> nodes(1, Node{ 0, 0, 0 }), children;
+        std::vector<unsigned int> bricks;
+        std::vector<math::vec3> centers;
+        std::vector<float> radii, distances;
+        while (!nodes.empty())
+        {
+            centers.resize(nodes.size());
+            radii.resize(nodes.size());
+            distances.resize(nodes.size());
+            for (unsigned int i = 0; i < nodes.size(); ++i)
+            {
+                const unsigned int begin[3] = { nodes[i].X * nodeSize * B, nodes[i].Y * nodeSize * B, nodes[i].Z * nodeSize * B };
+                const unsigned int end[3]   = { std::min(n, begin[0] + nodeSize * B), std::min(n, begin[1] + nodeSize * B), std::min(n, begin[2] + nodeSize * B) };
+                centers[i] = math::vec3(-maxDistance + (begin[0] + end[0]) * 0.5f * cubeScale,
+                                        -maxDistance + (begin[1] + end[1]) * 0.5f * cubeScale,
+                                        -maxDistance + (begin[2] + end[2]) * 0.5f * cubeScale);
+                math::vec3 extent((float)(end[0] - begin[0]), (float)(end[1] - begin[1]), (float)(end[2] - begin[2]));
+                radii[i] = 0.5f * cubeScale * math::length(extent);
+            }
+            forChunks((unsigned int)nodes.size(), 1024, [&](unsigned int begin, unsigned int end)
+            {
+                sdf(&centers[begin], &distances[begin], end - begin);
+            });
+
+            children.clear();
+            for (unsigned int i = 0; i < nodes.size(); ++i)
+            {
+                if (std::abs(distances[i]) > lipschitz * radii[i] * 1.01f)
+                    continue;
+                const Node& node = nodes[i];
+                if (nodeSize == 1)
+                {
+                    bricks.push_back((node.Z * brickRow + node.Y) * brickRow + node.X);
+                    continue;
+                }
+                const unsigned int half = nodeSize / 2;
+                for (unsigned int c = 0; c < 8; ++c)
+                {
+                    Node child = { node.X * 2 + (c & 1), node.Y * 2 + ((c >> 1) & 1), node.Z * 2 + (c >> 2) };
+                    if (child.X * half < brickRow && child.Y * half < brickRow && child.Z * half < brickRow)
+                        children.push_back(child);
+                }
+            }
+            std::swap(nodes, children);
+            nodeSize /= 2;
+        }
+        if (bricks.empty())
+            return 0;
+
+        // polygonize the bricks in a few ranges per thread (for load balancing, as the
+        // complexity of the surface varies per brick).
+        const unsigned int rangeSize = std::max(1u, (unsigned int)bricks.size() / (threads * 8));
+        std::vector<BrickRange> ranges((bricks.size() + rangeSize - 1) / rangeSize);
+        forChunks((unsigned int)bricks.size(), rangeSize, [&](unsigned int begin, unsigned int end)
+        {
+            polygonizeBricks(sdf, maxDistance, n, &bricks[begin], end - begin, ranges[begin / rangeSize]);
+        });
+
+        // merge the ranges, welding the vertices on shared brick faces by their edge key.
+        size_t vertexCount = 0, indexCount = 0, faceCount = 0;
+        for (const BrickRange& range : ranges)
+        {
+            vertexCount += range.Positions.size();
+            indexCount  += range.Indices.size();
+            for (uint64_t key : range.EdgeKeys)
+                faceCount += key != INTERIOR_EDGE;
+        }
+        positions.reserve(vertexCount);
+        indices.reserve(indexCount);
+        std::unordered_map<uint64_t, unsigned int> faceVertices;
+        faceVertices.reserve(faceCount);
+
+        std::vector<unsigned int> remap;
+        for (BrickRange& range : ranges)
+        {
+            remap.resize(range.Positions.size());
+            for (unsigned int v = 0; v < range.Positions.size(); ++v)
+            {
+                if (range.EdgeKeys[v] != INTERIOR_EDGE)
+                {
+                    auto inserted = faceVertices.insert(std::make_pair(range.EdgeKeys[v], (unsigned int)positions.size()));
+                    remap[v] = inserted.first->second;
+                    if (!inserted.second)
+                        continue;
+                }
+                else
+                {
+                    remap[v] = (unsigned int)positions.size();
+                }
+                positions.push_back(range.Positions[v]);
+            }
+            for (unsigned int j = 0; j < range.Indices.size(); ++j)
+                indices.push_back(remap[range.Indices[j]]);
+            range = BrickRange();
+        }
+        return (uint32_t)bricks.size();
+    }
+    // --------------------------------------------------------------------------------------------
+    void MarchingCubes::GradientNormals(const SDFBatch& sdf, const std::vector<math::vec3>& positions, float epsilon, std::vector<math::vec3>& normals,
+                                        ThreadPool* threadPool)
+    {
+        const unsigned int BATCH_SIZE  = 1024; // vertices per batch of SDF evaluations
+        const unsigned int count       = (unsigned int)positions.size();
+        const unsigned int batchCount  = (count + BATCH_SIZE - 1) / BATCH_SIZE;
+        normals.resize(count);
+
+        auto gradient = [&](unsigned int batch)
+        {
+            const unsigned int begin = batch * BATCH_SIZE;
+            const unsigned int end   = std::min(count, begin + BATCH_SIZE);
+            std::vector<math::vec3> points((end - begin) * 6);
+            std::vector<float>      distances(points.size());
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const math::vec3& p = positions[i];
+                math::vec3* samples = &points[(i - begin) * 6];
+                samples[0] = math::vec3(p.x + epsilon, p.y, p.z);
+                samples[1] = math::vec3(p.x - epsilon, p.y, p.z);
+                samples[2] = math::vec3(p.x, p.y + epsilon, p.z);
+                samples[3] = math::vec3(p.x, p.y - epsilon, p.z);
+                samples[4] = math::vec3(p.x, p.y, p.z + epsilon);
+                samples[5] = math::vec3(p.x, p.y, p.z - epsilon);
+            }
+            sdf(&points[0], &distances[0], (unsigned int)points.size());
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const float* d = &distances[(i - begin) * 6];
+                math::vec3 g(d[0] - d[1], d[2] - d[3], d[4] - d[5]);
+                float length = math::length(g);
+                normals[i] = length > 0.0f ? g / length : math::vec3(0.0f, 1.0f, 0.0f);
+            }
+        };
+        if (threadPool && batchCount > 1)
+        {
+            threadPool->ParallelFor(batchCount, gradient);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < batchCount; ++i)
+                gradient(i);
+        }
+    }
+}
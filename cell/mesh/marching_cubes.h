@@ -0,0 +1,64 @@
+#ifndef CELL_MESH_MARCHING_CUBES_H
+#define CELL_MESH_MARCHING_CUBES_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+
+class ThreadPool;
+
+namespace Cell
+{
+    // evaluates a signed distance field at count points at once, s.t. an SDF can process the
+    // whole span w/ SIMD instructions; negative distances are inside the surface.
+    typedef std::function<void(const math::vec3* points, float* distances, unsigned int count)> SDFBatch;
+
+    /*
+
+      Polygonizes the zero isosurface of a signed distance field sampled on a regular grid
+      (Lorensen and Cline 1987; tables by Paul Bourke) into an indexed triangle mesh.
+
+      The grid is processed in slabs along z: each slab only keeps the SDF samples of its two
+      corner planes and the vertex indices of the edges on and between those planes, s.t. each
+      grid corner is evaluated once and each surface vertex is shared by all cells around its
+      edge. Ranges of slabs are polygonized in parallel and stitched together afterwards.
+
+      The sparse variant skips the (usually vast) empty parts of the grid: the grid is split in
+      bricks of BRICK_SIZE^3 cells, organized in an octree that is refined top-down only where
+      the SDF at a node's center is within reach of the surface (|d| <= lipschitz * radius of
+      the node). As a distance field changes by at most its Lipschitz bound per unit distance,
+      all other nodes are conservatively known to be fully inside or outside and are skipped;
+      the cost of the sparse variant thus scales w/ the surface area instead of the volume.
+
+    */
+    class MarchingCubes
+    {
+    private:
+        // disallow creation of any MarchingCubes object; it's defined as a static object
+        MarchingCubes();
+    public:
+        // the number of cells along each axis of a brick of the sparse polygonizer
+        static const unsigned int BRICK_SIZE = 8;
+    public:
+        // polygonizes the SDF within [-maxDistance, maxDistance]^3 on a grid of gridResolution^3
+        // cells; runs on the thread pool (and the calling thread) if given. The SDF is called
+        // concurrently from multiple threads in that case.
+        static void Polygonize(const SDFBatch& sdf, float maxDistance, unsigned int gridResolution, std::vector<math::vec3>& positions,
+                               std::vector<unsigned int>& indices, ThreadPool* threadPool = nullptr);
+
+        // polygonizes the same surface as Polygonize (bit-identical vertices, though in a
+        // different order), but only visits bricks that can contain the surface. This requires
+        // the SDF to change by at most lipschitz per unit of distance (1 for exact distance
+        // fields; larger for e.g. non-uniformly scaled fields). Returns the number of bricks
+        // that were polygonized.
+        static uint32_t PolygonizeSparse(const SDFBatch& sdf, float maxDistance, unsigned int gridResolution, std::vector<math::vec3>& positions,
+                                         std::vector<unsigned int>& indices, ThreadPool* threadPool = nullptr, float lipschitz = 1.0f);
+
+        // unit length normals from the SDF's gradient (central differences w/ step epsilon).
+        static void GradientNormals(const SDFBatch& sdf, const std::vector<math::vec3>& positions, float epsilon, std::vector<math::vec3>& normals,
+                                    ThreadPool* threadPool = nullptr);
+    };
+}
+#endif
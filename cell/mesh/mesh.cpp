@@ -1,12 +1,77 @@
 #include "mesh.h"
+#include "mesh_optimizer.h"
+#include "marching_cubes.h"
+#include "tangent_space.h"
 
 #include "../glad/glad.h"
 
 #include <math/linear_algebra/operation.h>
+#include <math/linear_algebra/soa.h>
+#include <math/linear_algebra/packing.h>
 #include <utility/logging/log.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
 namespace Cell
 {
+    // GPU format of a single vertex attribute
+    struct AttributeFormat
+    {
+        unsigned int Flag;       // VERTEX_ATTRIBUTE
+        unsigned int Location;   // shader attribute location
+        GLint        Components;
+        GLenum       Type;
+        GLboolean    Normalized;
+        unsigned int Size;       // bytes
+    };
+
+    // fills the formats of the layout's attributes in buffer order; returns the attribute count.
+    static unsigned int attributeFormats(const VertexLayout& layout, AttributeFormat* out)
+    {
+        const AttributeFormat floatFormats[5] =
+        {
+            { VERTEX_POSITION,  0, 3, GL_FLOAT, GL_FALSE, 12 },
+            { VERTEX_UV,        1, 2, GL_FLOAT, GL_FALSE,  8 },
+            { VERTEX_NORMAL,    2, 3, GL_FLOAT, GL_FALSE, 12 },
+            { VERTEX_TANGENT,   3, 3, GL_FLOAT, GL_FALSE, 12 },
+            { VERTEX_BITANGENT, 4, 3, GL_FLOAT, GL_FALSE, 12 },
+        };
+        const AttributeFormat compactFormats[5] =
+        {
+            { VERTEX_POSITION,  0, 3, GL_FLOAT,               GL_FALSE, 12 },
+            { VERTEX_UV,        1, 2, GL_HALF_FLOAT,          GL_FALSE,  4 },
+            { VERTEX_NORMAL,    2, 2, GL_SHORT,               GL_TRUE,   4 },
+            { VERTEX_TANGENT,   3, 4, GL_INT_2_10_10_10_REV,  GL_TRUE,   4 },
+            { VERTEX_BITANGENT, 4, 3, GL_FLOAT,               GL_FALSE, 12 },
+        };
+        const AttributeFormat quantizedPosition = { VERTEX_POSITION, 0, 4, GL_UNSIGNED_SHORT, GL_TRUE, 8 };
+
+        const AttributeFormat* formats = layout.Format == VERTEX_FORMAT_FLOAT ? floatFormats : compactFormats;
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < 5; ++i)
+        {
+            if (!(layout.Attributes & formats[i].Flag))
+                continue;
+            out[count] = formats[i];
+            if (formats[i].Flag == VERTEX_POSITION && layout.Format == VERTEX_FORMAT_QUANTIZED)
+                out[count] = quantizedPosition;
+            ++count;
+        }
+        return count;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int VertexLayout::VertexSize() const
+    {
+        AttributeFormat attributes[5];
+        unsigned int count = attributeFormats(*this, attributes);
+        unsigned int size = 0;
+        for (unsigned int i = 0; i < count; ++i)
+            size += attributes[i].Size;
+        return size;
+    }
     // --------------------------------------------------------------------------------------------
     Mesh::Mesh()
     {
@@ -67,682 +132,335 @@ namespace Cell
     // --------------------------------------------------------------------------------------------
     void Mesh::Finalize(bool interleaved)
     {
-        // initialize object IDs if not configured before
-        if (!m_VAO)
+        VertexLayout layout;
+        std::vector<u8> data = PackVertexData(layout, interleaved);
+        Upload(data, layout);
+    }
+    // --------------------------------------------------------------------------------------------
+    std::vector<u8> Mesh::PackVertexData(VertexLayout& layout, bool interleaved) const
+    {
+        const size_t vertexCount = Positions.size();
+        layout.Format      = Format;
+        layout.Interleaved = interleaved;
+        layout.Attributes  = VERTEX_POSITION;
+        if (UV.size() > 0)         layout.Attributes |= VERTEX_UV;
+        if (Normals.size() > 0)    layout.Attributes |= VERTEX_NORMAL;
+        if (Tangents.size() > 0)   layout.Attributes |= VERTEX_TANGENT;
+        // compact formats only store the bitangent's sign (w/ the tangent)
+        if (Bitangents.size() > 0 && (Format == VERTEX_FORMAT_FLOAT || Tangents.size() == 0))
+            layout.Attributes |= VERTEX_BITANGENT;
+        layout.PositionOffset = math::vec3(0.0f);
+        layout.PositionScale  = math::vec3(1.0f);
+
+        AttributeFormat attributes[5];
+        const unsigned int attributeCount = attributeFormats(layout, attributes);
+        const size_t vertexSize = layout.VertexSize();
+
+        std::vector<u8> data(vertexCount * vertexSize);
+        if (vertexCount == 0)
+            return data;
+
+        // interleaved: each attribute is offset within the vertex and strided by the full
+        // vertex size; seperate: each attribute array is tightly packed after the previous.
+        size_t offsets[5], strides[5];
+        size_t offset = 0;
+        for (unsigned int i = 0; i < attributeCount; ++i)
         {
-            glGenVertexArrays(1, &m_VAO);
-            glGenBuffers(1, &m_VBO);
-            glGenBuffers(1, &m_EBO);
+            offsets[i] = offset;
+            strides[i] = interleaved ? vertexSize : attributes[i].Size;
+            offset += interleaved ? attributes[i].Size : attributes[i].Size * vertexCount;
         }
 
-        // preprocess buffer data as interleaved or seperate when specified
-        std::vector<float> data; 
-        if (interleaved)
+        if (Format == VERTEX_FORMAT_FLOAT)
         {
-            for (int i = 0; i < Positions.size(); ++i)
+            // the float arrays are copied in bulk by the math library's (de)interleave kernels.
+            for (unsigned int i = 0; i < attributeCount; ++i)
             {
-                data.push_back(Positions[i].x);
-                data.push_back(Positions[i].y);
-                data.push_back(Positions[i].z);
-                if (UV.size() > 0)
+                const float* src = nullptr;
+                switch (attributes[i].Flag)
                 {
-                    data.push_back(UV[i].x);
-                    data.push_back(UV[i].y);
+                case VERTEX_POSITION:  src = &Positions[0].x;  break;
+                case VERTEX_UV:        src = &UV[0].x;         break;
+                case VERTEX_NORMAL:    src = &Normals[0].x;    break;
+                case VERTEX_TANGENT:   src = &Tangents[0].x;   break;
+                case VERTEX_BITANGENT: src = &Bitangents[0].x; break;
                 }
-                if (Normals.size() > 0)
+                const size_t components = attributes[i].Components;
+                math::interleave((float*)&data[offsets[i]], strides[i] / sizeof(float), src, components, components, vertexCount);
+            }
+            return data;
+        }
+
+        // quantized positions are stored relative to the mesh's bounding box
+        if (Format == VERTEX_FORMAT_QUANTIZED)
+        {
+            math::vec3 boxMin, boxMax;
+            math::aabb(&Positions[0].x, 3, vertexCount, boxMin, boxMax);
+            layout.PositionOffset = boxMin;
+            layout.PositionScale  = boxMax - boxMin;
+        }
+
+        for (unsigned int a = 0; a < attributeCount; ++a)
+        {
+            u8* dst = &data[offsets[a]];
+            const size_t stride = strides[a];
+            switch (attributes[a].Flag)
+            {
+            case VERTEX_POSITION:
+                if (Format == VERTEX_FORMAT_QUANTIZED)
                 {
-                    data.push_back(Normals[i].x);
-                    data.push_back(Normals[i].y);
-                    data.push_back(Normals[i].z);
+                    const math::vec3& boxMin = layout.PositionOffset;
+                    const math::vec3& extent = layout.PositionScale;
+                    math::vec3 scale(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                                     extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                                     extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+                    for (size_t i = 0; i < vertexCount; ++i, dst += stride)
+                    {
+                        u16* p = (u16*)dst;
+                        p[0] = math::packUnorm16((Positions[i].x - boxMin.x) * scale.x);
+                        p[1] = math::packUnorm16((Positions[i].y - boxMin.y) * scale.y);
+                        p[2] = math::packUnorm16((Positions[i].z - boxMin.z) * scale.z);
+                        p[3] = 0;
+                    }
                 }
-                if (Tangents.size() > 0)
+                else
                 {
-                    data.push_back(Tangents[i].x);
-                    data.push_back(Tangents[i].y);
-                    data.push_back(Tangents[i].z);
+                    for (size_t i = 0; i < vertexCount; ++i, dst += stride)
+                        memcpy(dst, &Positions[i].x, 3 * sizeof(float));
                 }
-                if (Bitangents.size() > 0)
+                break;
+            case VERTEX_UV:
+                for (size_t i = 0; i < vertexCount; ++i, dst += stride)
                 {
-                    data.push_back(Bitangents[i].x);
-                    data.push_back(Bitangents[i].y);
-                    data.push_back(Bitangents[i].z);
+                    u16* uv = (u16*)dst;
+                    uv[0] = math::packHalf(UV[i].x);
+                    uv[1] = math::packHalf(UV[i].y);
                 }
+                break;
+            case VERTEX_NORMAL:
+                // the octahedral encodings are computed 4 vertices at a time by the math
+                // library's strided kernels, straight from the mesh's vec3 arrays.
+                math::packOctSnorm16(dst, stride, &Normals[0].x, 3, vertexCount);
+                break;
+            case VERTEX_TANGENT:
+                // w/ the bitangent's handedness w.r.t. normal and tangent
+                math::packOctTangents(dst, stride, &Tangents[0].x, Normals.size() > 0 ? &Normals[0].x : nullptr,
+                                      Bitangents.size() > 0 ? &Bitangents[0].x : nullptr, 3, vertexCount);
+                break;
+            case VERTEX_BITANGENT: // tangent-less mesh: stored as a plain float attribute
+                for (size_t i = 0; i < vertexCount; ++i, dst += stride)
+                    memcpy(dst, &Bitangents[i].x, 3 * sizeof(float));
+                break;
             }
         }
-        else
+        return data;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Mesh::Upload(const std::vector<u8>& data, const VertexLayout& layout)
+    {
+        const Meshlet* meshlets = Meshlets.size() > 0 ? &Meshlets[0] : nullptr;
+        if (Lods.empty())
         {
-            // if any of the float arrays are empty, data won't be filled by them.
-            for (int i = 0; i < Positions.size(); ++i)
-            {
-                data.push_back(Positions[i].x);
-                data.push_back(Positions[i].y);
-                data.push_back(Positions[i].z);
-            }
-            for (int i = 0; i < UV.size(); ++i)
-            {
-                data.push_back(UV[i].x);
-                data.push_back(UV[i].y);
-            }
-            for (int i = 0; i < Normals.size(); ++i)
-            {
-                data.push_back(Normals[i].x);
-                data.push_back(Normals[i].y);
-                data.push_back(Normals[i].z);
-            }
-            for (int i = 0; i < Tangents.size(); ++i)
-            {
-                data.push_back(Tangents[i].x);
-                data.push_back(Tangents[i].y);
-                data.push_back(Tangents[i].z);
-            }
-            for (int i = 0; i < Bitangents.size(); ++i)
-            {
-                data.push_back(Bitangents[i].x);
-                data.push_back(Bitangents[i].y);
-                data.push_back(Bitangents[i].z);
-            }
+            Upload(data.size() > 0 ? &data[0] : nullptr, (unsigned int)Positions.size(), layout,
+                   Indices.size() > 0 ? &Indices[0] : nullptr, (unsigned int)Indices.size(), nullptr, 0, meshlets, (unsigned int)Meshlets.size());
+            return;
+        }
+
+        // all levels of detail share the vertex buffer; their indices are stored back to back.
+        std::vector<unsigned int> indices(Indices);
+        std::vector<LodRange> lods(Lods.size() + 1);
+        lods[0].IndexCount = (unsigned int)Indices.size();
+        for (unsigned int i = 0; i < Lods.size(); ++i)
+        {
+            lods[i + 1].IndexOffset = (unsigned int)indices.size();
+            lods[i + 1].IndexCount  = (unsigned int)Lods[i].Indices.size();
+            lods[i + 1].Error       = Lods[i].Error;
+            indices.insert(indices.end(), Lods[i].Indices.begin(), Lods[i].Indices.end());
+        }
+        Upload(data.size() > 0 ? &data[0] : nullptr, (unsigned int)Positions.size(), layout,
+               indices.size() > 0 ? &indices[0] : nullptr, (unsigned int)indices.size(), &lods[0], (unsigned int)lods.size(),
+               meshlets, (unsigned int)Meshlets.size());
+    }
+    // --------------------------------------------------------------------------------------------
+    void Mesh::Upload(const void* data, unsigned int vertexCount, const VertexLayout& layout, const unsigned int* indices, unsigned int indexCount,
+                      const LodRange* lods, unsigned int lodCount, const Meshlet* meshlets, unsigned int meshletCount)
+    {
+        // initialize object IDs if not configured before
+        if (!m_VAO)
+        {
+            glGenVertexArrays(1, &m_VAO);
+            glGenBuffers(1, &m_VBO);
+            glGenBuffers(1, &m_EBO);
+        }
+
+        AttributeFormat attributes[5];
+        const unsigned int attributeCount = attributeFormats(layout, attributes);
+        const size_t vertexSize = layout.VertexSize();
+
+        m_Layout      = layout;
+        m_VertexCount = vertexCount;
+        m_IndexCount  = indexCount;
+        m_BufferSize  = vertexCount * vertexSize + indexCount * sizeof(unsigned int) + meshletCount * sizeof(Meshlet);
+        m_Lods.assign(lods, lods + lodCount);
+        m_Meshlets.assign(meshlets, meshlets + meshletCount);
+        if (meshletCount > 0)
+        {
+            if (!m_MeshletBuffer)
+                glGenBuffers(1, &m_MeshletBuffer);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_MeshletBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, meshletCount * sizeof(Meshlet), meshlets, GL_STATIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
         }
 
         // configure vertex attributes (only on vertex data size() > 0)
         glBindVertexArray(m_VAO);
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * vertexSize, data, GL_STATIC_DRAW);
         // only fill the index buffer if the index array is non-empty.
-        if (Indices.size() > 0)
+        if (indexCount > 0)
         {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int), &Indices[0], GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
         }
-        if (interleaved)
+        // interleaved: stride follows from number of non-empty vertex attribute arrays and each
+        // attribute is offset within the vertex; seperate: each attribute array is tightly packed
+        // after the previous.
+        size_t stride = layout.Interleaved ? vertexSize : 0;
+        size_t offset = 0;
+        for (unsigned int i = 0; i < attributeCount; ++i)
         {
-            // calculate stride from number of non-empty vertex attribute arrays
-            size_t stride                      = 3 * sizeof(float);
-            if (UV.size() > 0)         stride += 2 * sizeof(float);
-            if (Normals.size() > 0)    stride += 3 * sizeof(float);
-            if (Tangents.size() > 0)   stride += 3 * sizeof(float);
-            if (Bitangents.size() > 0) stride += 3 * sizeof(float);
-
-            size_t offset = 0;
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-            offset += 3 * sizeof(float);
-            if (UV.size() > 0)
-            {
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-                offset += 2 * sizeof(float);
-            }
-            if (Normals.size() > 0)
-            {
-                glEnableVertexAttribArray(2);
-                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-                offset += 3 * sizeof(float);
-            }
-            if (Tangents.size() > 0)
-            {
-                glEnableVertexAttribArray(3);
-                glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-                offset += 3 * sizeof(float);
-            }
-            if (Bitangents.size() > 0)
-            {
-                glEnableVertexAttribArray(4);
-                glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
-                offset += 3 * sizeof(float);
-            }
+            const AttributeFormat& attribute = attributes[i];
+            glEnableVertexAttribArray(attribute.Location);
+            glVertexAttribPointer(attribute.Location, attribute.Components, attribute.Type, attribute.Normalized, (GLsizei)stride, (GLvoid*)offset);
+            offset += (layout.Interleaved ? 1 : vertexCount) * attribute.Size;
         }
-        else
+        // NOTE(Joey): (re-)uploading w/ less attributes than before; disable the stale arrays.
+        for (unsigned int location = 0; location < 5; ++location)
         {
-            size_t offset = 0;
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)offset);
-            offset += Positions.size() * sizeof(float);
-            if (UV.size() > 0)
-            {
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)offset);
-                offset += UV.size() * sizeof(float);
-            }
-            if (Normals.size() > 0)
-            {
-                glEnableVertexAttribArray(2);
-                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)offset);
-                offset += Normals.size() * sizeof(float);
-            }
-            if (Tangents.size() > 0)
-            {
-                glEnableVertexAttribArray(3);
-                glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)offset);
-                offset += Tangents.size() * sizeof(float);
-            }
-            if (Bitangents.size() > 0)
-            {
-                glEnableVertexAttribArray(4);
-                glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)offset);
-                offset += Bitangents.size() * sizeof(float);
-            }
+            bool enabled = false;
+            for (unsigned int i = 0; i < attributeCount; ++i)
+                enabled = enabled || attributes[i].Location == location;
+            if (!enabled)
+                glDisableVertexAttribArray(location);
         }
         glBindVertexArray(0);
     }
     // --------------------------------------------------------------------------------------------
-    void Mesh::FromSDF(std::function<float(math::vec3)>& sdf, float maxDistance, uint16_t gridResolution) 
+    void Mesh::FromSDF(std::function<float(math::vec3)>& sdf, float maxDistance, uint16_t gridResolution, float lipschitz, ThreadPool* threadPool)
     {
-        Log::Message("Generating 3D mesh from SDF", LOG_DEBUG);
-
-        // tables from: http://paulbourke.net/geometry/polygonise/
-        static int edgeTable[256]=
-        {
-            0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
-            0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
-            0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
-            0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
-            0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
-            0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
-            0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
-            0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
-            0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
-            0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
-            0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
-            0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
-            0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
-            0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
-            0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
-            0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
-            0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
-            0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
-            0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
-            0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
-            0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
-            0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
-            0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
-            0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
-            0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
-            0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
-            0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
-            0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
-            0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
-            0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
-            0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
-            0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0   
-        };
-        static int triTable[256][16] = 
+        // NOTE(Joey): a scalar SDF simply evaluates each point of a batch in turn.
+        SDFBatch batch = [&sdf](const math::vec3* points, float* distances, unsigned int count)
         {
-            {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1},
-            {3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1},
-            {3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1},
-            {3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1},
-            {9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1},
-            {9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
-            {2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1},
-            {8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1},
-            {9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
-            {4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1},
-            {3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1},
-            {1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1},
-            {4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1},
-            {4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1},
-            {9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
-            {5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1},
-            {2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1},
-            {9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
-            {0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
-            {2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1},
-            {10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1},
-            {4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1},
-            {5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1},
-            {5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1},
-            {9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1},
-            {0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1},
-            {1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1},
-            {10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1},
-            {8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1},
-            {2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1},
-            {7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1},
-            {9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1},
-            {2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1},
-            {11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1},
-            {9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1},
-            {5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1},
-            {11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1},
-            {11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
-            {1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1},
-            {9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
-            {5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1},
-            {2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
-            {0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
-            {5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1},
-            {6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1},
-            {3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1},
-            {6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1},
-            {5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1},
-            {1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
-            {10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1},
-            {6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1},
-            {8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1},
-            {7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1},
-            {3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
-            {5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1},
-            {0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1},
-            {9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1},
-            {8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1},
-            {5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1},
-            {0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1},
-            {6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1},
-            {10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1},
-            {10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1},
-            {8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1},
-            {1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1},
-            {3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1},
-            {0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1},
-            {10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1},
-            {3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1},
-            {6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1},
-            {9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1},
-            {8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1},
-            {3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1},
-            {6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1},
-            {0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1},
-            {10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1},
-            {10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1},
-            {2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1},
-            {7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1},
-            {7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1},
-            {2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1},
-            {1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1},
-            {11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1},
-            {8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1},
-            {0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1},
-            {7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
-            {10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
-            {2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
-            {6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1},
-            {7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1},
-            {2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1},
-            {1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1},
-            {10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
-            {10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1},
-            {0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1},
-            {7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1},
-            {6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
-            {8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1},
-            {6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1},
-            {4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1},
-            {10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1},
-            {8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1},
-            {0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1},
-            {1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1},
-            {8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1},
-            {10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1},
-            {4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1},
-            {10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
-            {5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
-            {11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1},
-            {9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
-            {6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1},
-            {7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1},
-            {3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1},
-            {7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1},
-            {9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1},
-            {3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1},
-            {6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1},
-            {9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1},
-            {1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1},
-            {4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1},
-            {7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1},
-            {6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1},
-            {3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1},
-            {0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1},
-            {6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1},
-            {0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1},
-            {11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1},
-            {6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1},
-            {5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1},
-            {9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1},
-            {1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1},
-            {1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1},
-            {10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1},
-            {0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1},
-            {5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1},
-            {10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1},
-            {11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1},
-            {9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1},
-            {7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1},
-            {2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1},
-            {8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1},
-            {9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1},
-            {9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1},
-            {1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1},
-            {9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1},
-            {9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1},
-            {5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1},
-            {0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1},
-            {10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1},
-            {2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1},
-            {0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1},
-            {0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1},
-            {9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1},
-            {5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1},
-            {3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1},
-            {5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1},
-            {8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1},
-            {9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1},
-            {0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1},
-            {1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1},
-            {3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1},
-            {4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1},
-            {9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1},
-            {11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1},
-            {11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1},
-            {2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1},
-            {9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1},
-            {3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1},
-            {1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1},
-            {4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1},
-            {4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1},
-            {0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1},
-            {3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1},
-            {3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1},
-            {0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1},
-            {9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1},
-            {1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-            {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
+            for (unsigned int i = 0; i < count; ++i)
+                distances[i] = sdf(points[i]);
         };
+        FromSDF(batch, maxDistance, gridResolution, lipschitz, threadPool);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Mesh::FromSDF(const SDFBatch& sdf, float maxDistance, uint16_t gridResolution, float lipschitz, ThreadPool* threadPool)
+    {
+        Log::Message("Generating 3D mesh from SDF", LOG_DEBUG);
+        auto timeStart = std::chrono::steady_clock::now();
 
-        // container object for all voxel data required for an individual algorithm march
-        struct MCube 
+        // marching cubes produces an indexed mesh w/ each surface vertex shared by all
+        // triangles around it; normals follow from the SDF's gradient (half a cell step).
+        std::string sampled = "full grid";
+        if (lipschitz > 0.0f)
         {
-            union 
-            {
-                math::vec4 Corners[8]; // <xyz: position, w: isosurface distance>
-                struct 
-                {
-                    // notation: L = Left, R = Right, B = Bottom, T = Top, F = Front, B = Back (XYZ in right-handed system)
-                    math::vec4 LBB;
-                    math::vec4 RBB;
-                    math::vec4 RBF;
-                    math::vec4 LBF;
-                    math::vec4 LTB;
-                    math::vec4 RTB;
-                    math::vec4 RTF;
-                    math::vec4 LTF;
-                };            
-            };
-            MCube() { }
-            int GetEdgeIndex()
-            {
-                int index = 0;
-                if (Corners[0].w < 0.0f) index |= 1;
-                if (Corners[1].w < 0.0f) index |= 2;
-                if (Corners[2].w < 0.0f) index |= 4;
-                if (Corners[3].w < 0.0f) index |= 8;
-                if (Corners[4].w < 0.0f) index |= 16;
-                if (Corners[5].w < 0.0f) index |= 32;
-                if (Corners[6].w < 0.0f) index |= 64;
-                if (Corners[7].w < 0.0f) index |= 128;
-                return index;
-            }
-        };
-
-        // cube-march aware lerp
-        static auto mLerp = [](const math::vec4& p1, const math::vec4& p2) -> math::vec3
+            uint64_t brickCount = (gridResolution + MarchingCubes::BRICK_SIZE - 1) / MarchingCubes::BRICK_SIZE;
+            uint32_t bricks = MarchingCubes::PolygonizeSparse(sdf, maxDistance, gridResolution, Positions, Indices, threadPool, lipschitz);
+            sampled = std::to_string(bricks) + "/" + std::to_string(brickCount * brickCount * brickCount) + " bricks";
+        }
+        else
         {
-            const float epsilon = 0.0001f;
-            if(std::abs(0.0f - p1.w) < epsilon) 
-                return p1.xyz;
-            if(std::abs(0.0f - p2.w) < epsilon)
-                return p2.xyz;
-            if(std::abs(p1.w - p2.w) < epsilon)
-                return p1.xyz;
-            float t = (0.0f - p1.w) / (p2.w - p1.w);
-            math::vec3 result({
-                p1.x + t * (p2.x - p1.x),
-                p1.y + t * (p2.y - p1.y),
-                p1.z + t * (p2.z - p1.z)
-            });
-            return result;
-        };
-
-        // create a grid of cubes, evaluatie SDF at each cube vertex
-        const uint16_t gridSize  = gridResolution;
-        const float    scale     = maxDistance;
-        const float    cubeScale = (1.0f / static_cast<float>(gridSize)) * 2.0f * scale; // range => [-scale, scale] => 2*scale
-
-                                                                                         // traverse the voxel grid
-        for (uint16_t z = 0; z < gridSize; ++z) {
-            for (uint16_t y = 0; y < gridSize; ++y) {
-                for (uint16_t x = 0; x < gridSize; ++x) {
-                    // calculate voxel's 3D positions and evaluate SDF at each of its corners
-                    float halfCube = cubeScale * 0.5f;
-                    math::vec3 center({
-                        -scale + x * cubeScale + halfCube,
-                        -scale + y * cubeScale + halfCube,
-                        -scale + z * cubeScale + halfCube
-                    });
-
-                    MCube voxel;
-                    math::vec3 offset;
-                    // left-bottom-back
-                    offset = math::vec3(-halfCube, -halfCube, -halfCube);
-                    voxel.LBB = math::vec4(center + offset, 0.0f); 
-                    voxel.LBB.w = sdf(voxel.LBB.xyz);
-                    // right-bottom-back
-                    offset = math::vec3( halfCube, -halfCube, -halfCube);
-                    voxel.RBB = math::vec4(center + offset, 0.0f); 
-                    voxel.RBB.w = sdf(voxel.RBB.xyz);
-                    // right-bottom-front
-                    offset = math::vec3( halfCube, -halfCube,  halfCube);
-                    voxel.RBF = math::vec4(center + offset, 0.0f); 
-                    voxel.RBF.w = sdf(voxel.RBF.xyz);
-                    // left-bottom-front
-                    offset = math::vec3(-halfCube, -halfCube,  halfCube);
-                    voxel.LBF   = math::vec4(center + offset, 0.0f); 
-                    voxel.LBF.w = sdf(voxel.LBF.xyz);
-                    // left-top-back
-                    offset = math::vec3(-halfCube,  halfCube, -halfCube);
-                    voxel.LTB = math::vec4(center + offset, 0.0f); 
-                    voxel.LTB.w = sdf(voxel.LTB.xyz);
-                    // right-top-back
-                    offset = math::vec3( halfCube,  halfCube, -halfCube);
-                    voxel.RTB = math::vec4(center + offset, 0.0f); 
-                    voxel.RTB.w = sdf(voxel.RTB.xyz);
-                    // right-top-front
-                    offset = math::vec3( halfCube,  halfCube,  halfCube);
-                    voxel.RTF = math::vec4(center + offset, 0.0f); 
-                    voxel.RTF.w = sdf(voxel.RTF.xyz);
-                    // left-top-front
-                    offset = math::vec3(-halfCube,  halfCube,  halfCube);
-                    voxel.LTF = math::vec4(center + offset, 0.0f); 
-                    voxel.LTF.w = sdf(voxel.LTF.xyz);
-
-                    // given all calculated data, generate this voxel's vertices
-                    std::vector<math::vec3> vertList(12);
-
-                    int index = voxel.GetEdgeIndex();
-                    // edge table indexing from: http://paulbourke.net/geometry/polygonise/
-                    if (edgeTable[index] == 0)   { } // cube is in/out of surface, do nothing
-                    if (edgeTable[index] & 1)    { vertList[0]  = mLerp(voxel.Corners[0], voxel.Corners[1]); }
-                    if (edgeTable[index] & 2)    { vertList[1]  = mLerp(voxel.Corners[1], voxel.Corners[2]); }
-                    if (edgeTable[index] & 4)    { vertList[2]  = mLerp(voxel.Corners[2], voxel.Corners[3]); }
-                    if (edgeTable[index] & 8)    { vertList[3]  = mLerp(voxel.Corners[3], voxel.Corners[0]); }
-                    if (edgeTable[index] & 16)   { vertList[4]  = mLerp(voxel.Corners[4], voxel.Corners[5]); }
-                    if (edgeTable[index] & 32)   { vertList[5]  = mLerp(voxel.Corners[5], voxel.Corners[6]); }
-                    if (edgeTable[index] & 64)   { vertList[6]  = mLerp(voxel.Corners[6], voxel.Corners[7]); }
-                    if (edgeTable[index] & 128)  { vertList[7]  = mLerp(voxel.Corners[7], voxel.Corners[4]); }
-                    if (edgeTable[index] & 256)  { vertList[8]  = mLerp(voxel.Corners[0], voxel.Corners[4]); }
-                    if (edgeTable[index] & 512)  { vertList[9]  = mLerp(voxel.Corners[1], voxel.Corners[5]); }
-                    if (edgeTable[index] & 1024) { vertList[10] = mLerp(voxel.Corners[2], voxel.Corners[6]); }
-                    if (edgeTable[index] & 2048) { vertList[11] = mLerp(voxel.Corners[3], voxel.Corners[7]); }
-
-                    // generate triangle vertices
-                    for (uint16_t i = 0; triTable[index][i] != -1; i += 3)
-                    {
-                        math::vec3 pos1 = vertList[triTable[index][i + 0]];
-                        math::vec3 pos2 = vertList[triTable[index][i + 1]];
-                        math::vec3 pos3 = vertList[triTable[index][i + 2]];
-                        Positions.push_back(pos1);
-                        Positions.push_back(pos2);
-                        Positions.push_back(pos3);
-
-                        // calculate per-face normals from position data
-                        math::vec3 normal = math::cross(math::normalize(pos2 - pos1), math::normalize(pos3 - pos1));
-                        Normals.push_back(normal);
-                        Normals.push_back(normal);
-                        Normals.push_back(normal);
-
-                        // dirty local-space UV mapping approximation (to give some detail to objects)
-                        UV.push_back(vertList[triTable[index][i + 0]].xy);
-                        UV.push_back(vertList[triTable[index][i + 1]].yz);
-                        UV.push_back(vertList[triTable[index][i + 2]].xy * 0.5f + vertList[triTable[index][i + 2]].yz * 0.5f);
-                    }
-                }
-            }
+            MarchingCubes::Polygonize(sdf, maxDistance, gridResolution, Positions, Indices, threadPool);
         }
+        MarchingCubes::GradientNormals(sdf, Positions, maxDistance / gridResolution, Normals, threadPool);
 
+        // dirty local-space UV mapping approximation (to give some detail to objects): a planar
+        // projection along each vertex normal's dominant axis.
+        UV.resize(Positions.size());
+        for (unsigned int i = 0; i < Positions.size(); ++i)
+        {
+            const math::vec3& p = Positions[i];
+            const math::vec3& n = Normals[i];
+            float x = std::abs(n.x), y = std::abs(n.y), z = std::abs(n.z);
+            if (x >= y && x >= z)
+                UV[i] = math::vec2(p.y, p.z);
+            else if (y >= z)
+                UV[i] = math::vec2(p.x, p.z);
+            else
+                UV[i] = math::vec2(p.x, p.y);
+        }
         Topology = TRIANGLES;
+        CalculateTangents(threadPool);
+        auto timePolygonize = std::chrono::steady_clock::now();
+
+        // optimize the resulting index buffer for the post-transform cache.
+        MeshOptimizer::CacheStatistics before, after;
+        MeshOptimizer::Optimize(this, &before, &after);
+        Log::Message("SDF mesh vertices: " + std::to_string(before.Vertices) + " -> " + std::to_string(after.Vertices) +
+                     " | ACMR " + std::to_string(before.ACMR) + " -> " + std::to_string(after.ACMR), LOG_DEBUG);
+
         Finalize();
 
-        Log::Message("SDF mesh generation complete!", LOG_DEBUG);
+        Log::Message("SDF mesh generation complete (" + std::to_string(gridResolution) + "^3 grid, " + sampled + ", " + std::to_string(Indices.size() / 3) +
+                     " triangles): polygonize " + std::to_string(std::chrono::duration<float, std::milli>(timePolygonize - timeStart).count()) +
+                     " ms | optimize + upload " + std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - timePolygonize).count()) +
+                     " ms.", LOG_DEBUG);
     }
     // --------------------------------------------------------------------------------------------
-    void Mesh::calculateNormals(bool smooth)
+    void Mesh::CalculateNormals(bool smooth, ThreadPool* threadPool)
     {
-        // TODO(Joey): manually calculate the normals of each vertex
+        std::vector<unsigned int> triangles;
+        if (!TangentSpace::Triangulate(Topology, Indices, (unsigned int)Positions.size(), triangles))
+        {
+            Log::Message("Normals can only be calculated for triangle meshes.", LOG_WARNING);
+            return;
+        }
+
+        // NOTE(Joey): flat shading requires each face to have its own vertices; unshare all
+        // vertices s.t. each vertex only receives the normal of its single face.
+        if (!smooth)
+        {
+            auto unshare = [&triangles](auto& attribute)
+            {
+                auto source = attribute;
+                attribute.resize(triangles.size());
+                for (unsigned int i = 0; i < triangles.size(); ++i)
+                    attribute[i] = source[triangles[i]];
+            };
+            const size_t vertexCount = Positions.size();
+            if (UV.size()         == vertexCount) unshare(UV);
+            if (Tangents.size()   == vertexCount) unshare(Tangents);
+            if (Bitangents.size() == vertexCount) unshare(Bitangents);
+            unshare(Positions);
+            for (unsigned int i = 0; i < triangles.size(); ++i)
+                triangles[i] = i;
+            Indices  = triangles;
+            Topology = TRIANGLES;
+            Lods.clear();
+            Meshlets.clear();
+        }
+        TangentSpace::GenerateNormals(Positions, triangles, smooth, Normals, threadPool);
     }
     // --------------------------------------------------------------------------------------------
-    void Mesh::calculateTangents()
+    void Mesh::CalculateTangents(ThreadPool* threadPool)
     {
-        // TODO(Joey): walk overall the vertices and calculate the tangent space vectors manually
-        // TODO: based on topology, handle some of the winding orders differently.
-        //tangents.resize(positions.size());
-        //bitangents.resize(positions.size());
-        //for (unsigned int i = 0; i < indices.size() - 2; ++i)
-        //{
-        //    unsigned int index1 = indices[i + 0];
-        //    unsigned int index2 = indices[i + 1];
-        //    unsigned int index3 = indices[i + 2];
-        //    // TODO: do we take different winding order into account for triangle strip?
-        //    glm::vec3 pos1 = positions[index1];
-        //    glm::vec3 pos2 = positions[index2];
-        //    glm::vec3 pos3 = positions[index3];
-
-        //    glm::vec2 uv1 = uv[index1];
-        //    glm::vec2 uv2 = uv[index2];
-        //    glm::vec2 uv3 = uv[index3];
-
-        //    // due to winding order getting changed each next triangle (as we render as triangle strip) we 
-        //    // change the order of the cross product to account for winding order switch
-        //    glm::vec3 edge1 = pos2 - pos1;
-        //    glm::vec3 edge2 = pos3 - pos1;
-        //    glm::vec2 deltaUV1 = uv2 - uv1;
-        //    glm::vec2 deltaUV2 = uv3 - uv1;
-
-        //    GLfloat f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+        if (UV.size() != Positions.size())
+        {
+            Log::Message("Tangents can only be calculated for meshes w/ texture coordinates.", LOG_WARNING);
+            return;
+        }
+        if (Normals.size() != Positions.size())
+            CalculateNormals(true, threadPool);
 
-        //    glm::vec3 tangent, bitangent;
-        //    tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        //    tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        //    tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-        //    /*    if (i % 2 == 0)
-        //    {*/
-        //    bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        //    bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        //    bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-        //    //} 
-        //    /*    else
-        //    {
-        //    bitangent.x = f * (-deltaUV2.x * edge2.x + deltaUV1.x * edge1.x);
-        //    bitangent.y = f * (-deltaUV2.x * edge2.y + deltaUV1.x * edge1.y);
-        //    bitangent.z = f * (-deltaUV2.x * edge2.z + deltaUV1.x * edge1.z);
-        //    }*/
-        //    tangents[index1] += tangent;
-        //    tangents[index2] += tangent;
-        //    tangents[index3] += tangent;
-        //    bitangents[index1] += bitangent;
-        //    bitangents[index2] += bitangent;
-        //    bitangents[index3] += bitangent;
-        //}
-        //// normalize all tangents/bi-tangents
-        //for (int i = 0; i < tangents.size(); ++i)
-        //{
-        //    tangents[i] = glm::normalize(tangents[i]);
-        //    bitangents[i] = glm::normalize(bitangents[i]);
-        //}
+        std::vector<unsigned int> triangles;
+        if (!TangentSpace::Triangulate(Topology, Indices, (unsigned int)Positions.size(), triangles))
+        {
+            Log::Message("Tangents can only be calculated for triangle meshes.", LOG_WARNING);
+            return;
+        }
+        TangentSpace::GenerateTangents(Positions, UV, Normals, triangles, Tangents, Bitangents, threadPool);
     }
 }
\ No newline at end of file
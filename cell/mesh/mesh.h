@@ -3,8 +3,12 @@
 
 #include <vector>
 #include <functional>
+#include <cstddef>
 
 #include <math/linear_algebra/vector.h>
+#include <utility/std_types.h>
+
+#include "marching_cubes.h"
 
 
 namespace Cell
@@ -28,6 +32,89 @@ namespace Cell
         TRIANGLE_FAN,
     };
 
+    /*
+
+      The vertex attributes a mesh's vertex buffer can consist of; always stored in this order.
+
+    */
+    enum VERTEX_ATTRIBUTE
+    {
+        VERTEX_POSITION  = 0x01,
+        VERTEX_UV        = 0x02,
+        VERTEX_NORMAL    = 0x04,
+        VERTEX_TANGENT   = 0x08,
+        VERTEX_BITANGENT = 0x10,
+    };
+
+    /*
+
+      The encoding of a mesh's vertex data on the GPU:
+
+        - VERTEX_FORMAT_FLOAT:     all attributes as 32-bit floats (56 bytes per vertex w/ all
+                                   attributes present).
+        - VERTEX_FORMAT_COMPACT:   float positions, half float UVs, octahedral snorm16 normals
+                                   and octahedral 10_10_10_2 tangents w/ the bitangent's sign in
+                                   the 2-bit w component; the bitangent itself is reconstructed
+                                   in the vertex shader (24 bytes per vertex).
+        - VERTEX_FORMAT_QUANTIZED: as compact, w/ unorm16 positions relative to the mesh's
+                                   bounding box (20 bytes per vertex).
+
+      The compact formats are decoded in the vertex shader (see shaders/common/vertex.glsl), s.t.
+      the renderer configures the decoding per draw call.
+
+    */
+    enum VERTEX_FORMAT
+    {
+        VERTEX_FORMAT_FLOAT     = 0,
+        VERTEX_FORMAT_COMPACT   = 1,
+        VERTEX_FORMAT_QUANTIZED = 2,
+    };
+
+    // describes the contents of a vertex buffer as packed by Mesh::PackVertexData.
+    struct VertexLayout
+    {
+        unsigned int  Attributes  = 0; // VERTEX_ATTRIBUTE flags
+        VERTEX_FORMAT Format      = VERTEX_FORMAT_FLOAT;
+        bool          Interleaved = true;
+        // quantized positions decode as: PositionOffset + PositionScale * position
+        math::vec3    PositionOffset = math::vec3(0.0f);
+        math::vec3    PositionScale  = math::vec3(1.0f);
+
+        // size (in bytes) of a single vertex
+        unsigned int VertexSize() const;
+    };
+
+    // a (simplified) level of detail of a mesh: an index buffer into the mesh's full vertex
+    // buffer and its geometric error (in object space) w.r.t. the full detail mesh.
+    struct MeshLod
+    {
+        std::vector<unsigned int> Indices;
+        float                     Error = 0.0f;
+    };
+    // a level of detail as uploaded to the GPU: a range of the mesh's index buffer, which holds
+    // all of the mesh's levels back to back.
+    struct LodRange
+    {
+        unsigned int IndexOffset = 0;
+        unsigned int IndexCount  = 0;
+        float        Error       = 0.0f;
+    };
+    // a small cluster of a mesh's triangles (see MeshletBuilder): a range of the mesh's (full
+    // detail) index buffer w/ a bounding sphere and a cone bounding its triangles' normals, for
+    // culling parts of a mesh. The layout matches the std430 Meshlet struct of the culling
+    // compute shader (shaders/compute/meshlet_cull.cs).
+    struct Meshlet
+    {
+        math::vec3   Center;
+        float        Radius;
+        math::vec3   ConeAxis;
+        float        ConeCutoff; // sine of the cone's half angle; 1.0 if the cone is too wide to cull
+        unsigned int IndexOffset;
+        unsigned int IndexCount;
+        unsigned int VertexCount;
+        unsigned int Padding;
+    };
+
     /* 
 
       Base Mesh class. A mesh in its simplest form is purely a list of vertices, with some added 
@@ -41,6 +128,16 @@ namespace Cell
         unsigned int m_VAO = 0;
         unsigned int m_VBO;
         unsigned int m_EBO;
+        // vertex/index count and size (in bytes) of the data last uploaded to the GPU
+        unsigned int m_VertexCount = 0;
+        unsigned int m_IndexCount  = 0;
+        size_t       m_BufferSize  = 0;
+        VertexLayout m_Layout;
+        // the uploaded levels of detail (level 0 first); empty if the mesh has none
+        std::vector<LodRange> m_Lods;
+        // the uploaded meshlets of level 0 and their GPU copy (a shader storage buffer)
+        std::vector<Meshlet>  m_Meshlets;
+        unsigned int          m_MeshletBuffer = 0;
     public:
         std::vector<math::vec3> Positions;
         std::vector<math::vec2> UV;
@@ -48,8 +145,14 @@ namespace Cell
         std::vector<math::vec3> Tangents;
         std::vector<math::vec3> Bitangents;
 
-        TOPOLOGY Topology = TRIANGLES;
+        TOPOLOGY      Topology = TRIANGLES;
+        VERTEX_FORMAT Format   = VERTEX_FORMAT_FLOAT; // GPU vertex encoding; set before finalizing
         std::vector<unsigned int> Indices;
+        // levels of detail 1 and up (level 0 is the mesh itself); see MeshSimplifier
+        std::vector<MeshLod>      Lods;
+        // clusters of the full detail mesh's triangles, for finer grained culling; see
+        // MeshletBuilder
+        std::vector<Meshlet>      Meshlets;
 
         // support multiple ways of initializing a mesh
         Mesh();
@@ -67,13 +170,33 @@ namespace Cell
 
         // commits all buffers and attributes to the GPU driver
         void Finalize(bool interleaved = true);
-
-        // generate triangulated mesh from signed distance field
-        void FromSDF(std::function<float(math::vec3)>& sdf, float maxDistance, uint16_t gridResolution);
-
-    private:
-        void calculateNormals(bool smooth = true);
-        void calculateTangents();
+        // Finalize split in its CPU and GPU stage: PackVertexData encodes the vertex buffer's
+        // contents in the mesh's Format and touches no GL state (safe to run on any thread);
+        // Upload then commits the packed data w/ its layout on the render thread.
+        std::vector<u8> PackVertexData(VertexLayout& layout, bool interleaved = true) const;
+        void            Upload(const std::vector<u8>& data, const VertexLayout& layout);
+        // uploads raw vertex/index data w/ the given layout; the mesh's own vertex arrays are
+        // left untouched (e.g. when streaming data directly from a memory mapped file). The
+        // index data holds all levels of detail as given by lods (if any).
+        void            Upload(const void* data, unsigned int vertexCount, const VertexLayout& layout, const unsigned int* indices, unsigned int indexCount,
+                               const LodRange* lods = nullptr, unsigned int lodCount = 0, const Meshlet* meshlets = nullptr, unsigned int meshletCount = 0);
+
+        // generate triangulated (indexed) mesh from signed distance field, sampled on a grid of
+        // gridResolution^3 cells within [-maxDistance, maxDistance]^3. The SDF may be evaluated
+        // from multiple threads at once. If lipschitz is non-zero, the SDF's values are taken as
+        // (a bound on) distances, changing by at most lipschitz per unit of distance, s.t. only
+        // the parts of the grid near the surface are visited (see MarchingCubes::PolygonizeSparse);
+        // otherwise the full grid is sampled. Runs on threadPool (and the calling thread) if given.
+        void FromSDF(std::function<float(math::vec3)>& sdf, float maxDistance, uint16_t gridResolution, float lipschitz = 1.0f, ThreadPool* threadPool = nullptr);
+        void FromSDF(const SDFBatch& sdf, float maxDistance, uint16_t gridResolution, float lipschitz = 1.0f, ThreadPool* threadPool = nullptr);
+
+        // generates angle weighted normals for the mesh's triangles: smooth normals are shared
+        // by all vertices at the same position, while flat normals unshare the mesh's vertices
+        // s.t. each face has its own (see TangentSpace).
+        void CalculateNormals(bool smooth = true, ThreadPool* threadPool = nullptr);
+        // generates MikkTSpace style tangents/bitangents from the mesh's normals and UVs; call
+        // before Finalize.
+        void CalculateTangents(ThreadPool* threadPool = nullptr);
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "mesh_optimizer.h"
+
+#include "mesh.h"
+
+#include <math.h>
+#include <math/linear_algebra/operation.h>
+
+#include <algorithm>
+#include <string.h>
+
+namespace Cell
+{
+    /* NOTE(Joey):
+
+      Both the cache simulator and Tipsify model the post-transform cache as a FIFO of cacheSize
+      entries using per-vertex timestamps: the timestamp counts cache insertions (misses), so a
+      vertex is still in the cache as long as fewer than cacheSize vertices were inserted after
+      it. This is exact for a FIFO cache and costs O(1) per lookup.
+
+    */
+    static bool cacheLookup(unsigned int vertex, unsigned int cacheSize, std::vector<unsigned int>& timestamps, unsigned int& timestamp)
+    {
+        if (timestamp - timestamps[vertex] > cacheSize)
+        {
+            timestamps[vertex] = timestamp++;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    static void remapAttribute(std::vector<T>& attribute, const std::vector<unsigned int>& remap, unsigned int count)
+    {
+        if (attribute.empty())
+            return;
+        std::vector<T> result(count);
+        for (unsigned int i = 0; i < remap.size(); ++i)
+        {
+            if (remap[i] != 0xFFFFFFFF)
+                result[remap[i]] = attribute[i];
+        }
+        attribute.swap(result);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    void MeshOptimizer::CacheStatistics::Add(const CacheStatistics& other)
+    {
+        Triangles += other.Triangles;
+        Vertices  += other.Vertices;
+        Misses    += other.Misses;
+        ACMR = Triangles > 0 ? (float)Misses / Triangles : 0.0f;
+        ATVR = Vertices  > 0 ? (float)Misses / Vertices  : 0.0f;
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshOptimizer::Optimize(Mesh* mesh, CacheStatistics* before, CacheStatistics* after)
+    {
+        if (mesh->Topology != TRIANGLES || mesh->Positions.empty())
+            return;
+
+        if (before)
+        {
+            if (mesh->Indices.empty())
+            {
+                // triangle soup: every vertex is transformed exactly once
+                before->Triangles = (unsigned int)mesh->Positions.size() / 3;
+                before->Vertices  = (unsigned int)mesh->Positions.size();
+                before->Misses    = (unsigned int)mesh->Positions.size();
+                before->ACMR      = before->Triangles > 0 ? 3.0f : 0.0f;
+                before->ATVR      = 1.0f;
+            }
+            else
+            {
+                *before = AnalyzeVertexCache(mesh->Indices, (unsigned int)mesh->Positions.size());
+            }
+        }
+
+        unsigned int vertexCount = DeduplicateVertices(mesh);
+        OptimizeVertexCache(mesh->Indices, vertexCount);
+        OptimizeOverdraw(mesh->Indices, mesh->Positions);
+        vertexCount = OptimizeVertexFetch(mesh);
+
+        if (after)
+        {
+            *after = AnalyzeVertexCache(mesh->Indices, vertexCount);
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int MeshOptimizer::DeduplicateVertices(Mesh* mesh)
+    {
+        const unsigned int vertexCount = (unsigned int)mesh->Positions.size();
+        const bool hasUV         = mesh->UV.size()         == vertexCount;
+        const bool hasNormals    = mesh->Normals.size()    == vertexCount;
+        const bool hasTangents   = mesh->Tangents.size()   == vertexCount;
+        const bool hasBitangents = mesh->Bitangents.size() == vertexCount;
+
+        // NOTE(Joey): vertices are compared bitwise over all their attributes; we gather each
+        // vertex's attributes in a flat array first s.t. hashing/comparing is a plain memory op.
+        unsigned int stride = 3 + (hasUV ? 2 : 0) + (hasNormals ? 3 : 0) + (hasTangents ? 3 : 0) + (hasBitangents ? 3 : 0);
+        std::vector<float> vertices(vertexCount * stride);
+        for (unsigned int i = 0; i < vertexCount; ++i)
+        {
+            float* v = &vertices[i * stride];
+            *v++ = mesh->Positions[i].x; *v++ = mesh->Positions[i].y; *v++ = mesh->Positions[i].z;
+            if (hasUV)
+            {
+                *v++ = mesh->UV[i].x; *v++ = mesh->UV[i].y;
+            }
+            if (hasNormals)
+            {
+                *v++ = mesh->Normals[i].x; *v++ = mesh->Normals[i].y; *v++ = mesh->Normals[i].z;
+            }
+            if (hasTangents)
+            {
+                *v++ = mesh->Tangents[i].x; *v++ = mesh->Tangents[i].y; *v++ = mesh->Tangents[i].z;
+            }
+            if (hasBitangents)
+            {
+                *v++ = mesh->Bitangents[i].x; *v++ = mesh->Bitangents[i].y; *v++ = mesh->Bitangents[i].z;
+            }
+        }
+
+        // open addressing table of (first) vertex indices, hashed by their attribute bits
+        unsigned int tableSize = 16;
+        while (tableSize < vertexCount * 2)
+            tableSize *= 2;
+        std::vector<unsigned int> table(tableSize, 0xFFFFFFFF);
+        std::vector<unsigned int> remap(vertexCount);
+        unsigned int uniqueCount = 0;
+        for (unsigned int i = 0; i < vertexCount; ++i)
+        {
+            const float* v = &vertices[i * stride];
+            unsigned int hash = 2166136261u;
+            const unsigned char* bytes = (const unsigned char*)v;
+            for (unsigned int b = 0; b < stride * sizeof(float); ++b)
+                hash = (hash ^ bytes[b]) * 16777619u;
+
+            unsigned int slot = hash & (tableSize - 1);
+            while (table[slot] != 0xFFFFFFFF && memcmp(&vertices[table[slot] * stride], v, stride * sizeof(float)) != 0)
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == 0xFFFFFFFF)
+            {
+                table[slot] = i;
+                remap[i] = uniqueCount++;
+            }
+            else
+            {
+                remap[i] = remap[table[slot]];
+            }
+        }
+
+        // the first occurence of each vertex keeps its place (relative to the other unique ones)
+        std::vector<unsigned int> first(vertexCount, 0xFFFFFFFF);
+        for (unsigned int i = 0; i < vertexCount; ++i)
+        {
+            if (first[remap[i]] == 0xFFFFFFFF)
+                first[remap[i]] = i;
+        }
+        std::vector<unsigned int> keep(vertexCount, 0xFFFFFFFF);
+        for (unsigned int i = 0; i < uniqueCount; ++i)
+            keep[first[i]] = i;
+        remapAttribute(mesh->Positions, keep, uniqueCount);
+        if (hasUV)         remapAttribute(mesh->UV, keep, uniqueCount);
+        if (hasNormals)    remapAttribute(mesh->Normals, keep, uniqueCount);
+        if (hasTangents)   remapAttribute(mesh->Tangents, keep, uniqueCount);
+        if (hasBitangents) remapAttribute(mesh->Bitangents, keep, uniqueCount);
+
+        if (mesh->Indices.empty())
+        {
+            mesh->Indices = remap;
+        }
+        else
+        {
+            for (unsigned int i = 0; i < mesh->Indices.size(); ++i)
+                mesh->Indices[i] = remap[mesh->Indices[i]];
+        }
+        return uniqueCount;
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize)
+    {
+        const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        /* NOTE(Joey):
+
+          Tipsify: starting from a 'fanning' vertex, emit all of its remaining triangles, then pick
+          the next fanning vertex among the vertices just emitted: the one that entered the cache
+          the longest ago while still being expected to be in the cache after emitting its own
+          remaining triangles. If none of them qualify (or have triangles left) we back-track
+          through recently emitted vertices (the dead-end stack) and finally fall back to the
+          next unprocessed vertex in input order.
+
+        */
+        // vertex -> triangle adjacency
+        std::vector<unsigned int> live(vertexCount, 0);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+            ++live[indices[i]];
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            offsets[i + 1] = offsets[i] + live[i];
+        std::vector<unsigned int> adjacency(indices.size());
+        {
+            std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+            for (unsigned int i = 0; i < indices.size(); ++i)
+                adjacency[cursor[indices[i]]++] = i / 3;
+        }
+
+        std::vector<unsigned int>  timestamps(vertexCount, 0);
+        std::vector<unsigned char> emitted(triangleCount, 0);
+        std::vector<unsigned int>  deadEnd;
+        std::vector<unsigned int>  result;
+        deadEnd.reserve(indices.size());
+        result.reserve(indices.size());
+        unsigned int timestamp   = cacheSize + 1;
+        unsigned int inputCursor = 0;
+
+        int fanning = indices[0];
+        while (fanning >= 0)
+        {
+            const size_t candidates = deadEnd.size();
+            for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+            {
+                unsigned int triangle = adjacency[a];
+                if (emitted[triangle])
+                    continue;
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    unsigned int vertex = indices[triangle * 3 + k];
+                    result.push_back(vertex);
+                    deadEnd.push_back(vertex);
+                    --live[vertex];
+                    cacheLookup(vertex, cacheSize, timestamps, timestamp);
+                }
+                emitted[triangle] = 1;
+            }
+
+            // select the next fanning vertex from the emitted triangles' vertices
+            int best = -1, bestPriority = -1;
+            for (size_t c = candidates; c < deadEnd.size(); ++c)
+            {
+                unsigned int vertex = deadEnd[c];
+                if (live[vertex] == 0)
+                    continue;
+                int priority = 0;
+                if (timestamp - timestamps[vertex] + 2 * live[vertex] <= cacheSize)
+                    priority = timestamp - timestamps[vertex];
+                if (priority > bestPriority)
+                {
+                    best = vertex;
+                    bestPriority = priority;
+                }
+            }
+            // dead-end: back-track through the recently emitted vertices, or continue in input order
+            while (best < 0 && !deadEnd.empty())
+            {
+                unsigned int vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[vertex] > 0)
+                    best = vertex;
+            }
+            while (best < 0 && inputCursor < indices.size())
+            {
+                unsigned int vertex = indices[inputCursor++];
+                if (live[vertex] > 0)
+                    best = vertex;
+            }
+            fanning = best;
+        }
+        indices.swap(result);
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, float threshold, unsigned int cacheSize)
+    {
+        const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+        const unsigned int vertexCount   = (unsigned int)positions.size();
+        if (triangleCount == 0)
+            return;
+
+        /* NOTE(Joey):
+
+          Cluster boundaries come in two kinds (Sander et al. 2007):
+
+            - hard: triangles that miss the cache on all 3 vertices; the cache optimizer jumped to
+              a disjoint patch here, so re-ordering at this point costs (next to) nothing.
+            - soft: each hard cluster is further split as soon as the ACMR of the triangles since
+              the last split drops below threshold times the ACMR of the entire hard cluster
+              (when rendered w/ a cold cache), bounding the cache efficiency we give up.
+
+        */
+        std::vector<unsigned int> timestamps(vertexCount, 0);
+        unsigned int timestamp = cacheSize + 1;
+        auto resetCache = [&]() { timestamp += cacheSize + 1; };
+        auto triangleMisses = [&](unsigned int triangle) -> unsigned int
+        {
+            unsigned int misses = 0;
+            for (unsigned int k = 0; k < 3; ++k)
+                misses += cacheLookup(indices[triangle * 3 + k], cacheSize, timestamps, timestamp) ? 0 : 1;
+            return misses;
+        };
+
+        std::vector<unsigned int> hard;
+        for (unsigned int t = 0; t < triangleCount; ++t)
+        {
+            if (triangleMisses(t) == 3 || t == 0)
+                hard.push_back(t);
+        }
+        hard.push_back(triangleCount);
+
+        std::vector<unsigned int> clusters;
+        for (unsigned int h = 0; h + 1 < hard.size(); ++h)
+        {
+            const unsigned int start = hard[h], end = hard[h + 1];
+
+            resetCache();
+            unsigned int clusterMisses = 0;
+            for (unsigned int t = start; t < end; ++t)
+                clusterMisses += triangleMisses(t);
+            const float clusterThreshold = threshold * (float)clusterMisses / (end - start);
+
+            clusters.push_back(start);
+            resetCache();
+            unsigned int runningMisses = 0, runningTriangles = 0;
+            for (unsigned int t = start; t < end; ++t)
+            {
+                runningMisses += triangleMisses(t);
+                ++runningTriangles;
+                if ((float)runningMisses / runningTriangles <= clusterThreshold)
+                {
+                    clusters.push_back(t + 1);
+                    resetCache();
+                    runningMisses = runningTriangles = 0;
+                }
+            }
+            // the trailing (incomplete) cluster tends to have a poor ACMR; merge it w/ the last
+            // complete cluster (this also removes a boundary that ended up at 'end').
+            if (clusters.back() != start)
+                clusters.pop_back();
+        }
+        clusters.push_back(triangleCount);
+
+        // NOTE(Joey): sort clusters on how much they face 'outward' from the mesh centroid;
+        // outward facing clusters are likely to occlude the rest from most view directions.
+        math::vec3 meshCentroid(0.0f);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+            meshCentroid = meshCentroid + positions[indices[i]];
+        meshCentroid = meshCentroid / (float)indices.size();
+
+        const unsigned int clusterCount = (unsigned int)clusters.size() - 1;
+        std::vector<float> sortKeys(clusterCount);
+        for (unsigned int c = 0; c < clusterCount; ++c)
+        {
+            math::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (unsigned int t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const math::vec3& p0 = positions[indices[t * 3 + 0]];
+                const math::vec3& p1 = positions[indices[t * 3 + 1]];
+                const math::vec3& p2 = positions[indices[t * 3 + 2]];
+                math::vec3 n = math::cross(p1 - p0, p2 - p0);
+                float triangleArea = math::length(n);
+                centroid = centroid + (p0 + p1 + p2) * (triangleArea / 3.0f);
+                normal = normal + n;
+                area += triangleArea;
+            }
+            float normalLength = math::length(normal);
+            centroid = area > 0.0f ? centroid / area : positions[indices[clusters[c] * 3]];
+            normal   = normalLength > 0.0f ? normal / normalLength : math::vec3(0.0f);
+            sortKeys[c] = math::dot(centroid - meshCentroid, normal);
+        }
+
+        std::vector<unsigned int> order(clusterCount);
+        for (unsigned int c = 0; c < clusterCount; ++c)
+            order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](unsigned int a, unsigned int b) { return sortKeys[a] > sortKeys[b]; });
+
+        std::vector<unsigned int> result;
+        result.reserve(indices.size());
+        for (unsigned int c = 0; c < clusterCount; ++c)
+        {
+            result.insert(result.end(), indices.begin() + clusters[order[c]] * 3, indices.begin() + clusters[order[c] + 1] * 3);
+        }
+        indices.swap(result);
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int MeshOptimizer::OptimizeVertexFetch(Mesh* mesh)
+    {
+        const unsigned int vertexCount = (unsigned int)mesh->Positions.size();
+        std::vector<unsigned int> remap(vertexCount, 0xFFFFFFFF);
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < mesh->Indices.size(); ++i)
+        {
+            unsigned int& index = mesh->Indices[i];
+            if (remap[index] == 0xFFFFFFFF)
+                remap[index] = count++;
+            index = remap[index];
+        }
+
+        if (mesh->UV.size()         == vertexCount) remapAttribute(mesh->UV, remap, count);
+        if (mesh->Normals.size()    == vertexCount) remapAttribute(mesh->Normals, remap, count);
+        if (mesh->Tangents.size()   == vertexCount) remapAttribute(mesh->Tangents, remap, count);
+        if (mesh->Bitangents.size() == vertexCount) remapAttribute(mesh->Bitangents, remap, count);
+        remapAttribute(mesh->Positions, remap, count);
+        return count;
+    }
+    // --------------------------------------------------------------------------------------------
+    MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize)
+    {
+        CacheStatistics statistics;
+        std::vector<unsigned int>  timestamps(vertexCount, 0);
+        std::vector<unsigned char> referenced(vertexCount, 0);
+        unsigned int timestamp = cacheSize + 1;
+        for (unsigned int i = 0; i < indices.size(); ++i)
+        {
+            unsigned int vertex = indices[i];
+            if (!cacheLookup(vertex, cacheSize, timestamps, timestamp))
+                ++statistics.Misses;
+            if (!referenced[vertex])
+            {
+                referenced[vertex] = 1;
+                ++statistics.Vertices;
+            }
+        }
+        statistics.Triangles = (unsigned int)indices.size() / 3;
+        statistics.ACMR = statistics.Triangles > 0 ? (float)statistics.Misses / statistics.Triangles : 0.0f;
+        statistics.ATVR = statistics.Vertices  > 0 ? (float)statistics.Misses / statistics.Vertices  : 0.0f;
+        return statistics;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef CELL_MESH_OPTIMIZER_H
+#define CELL_MESH_OPTIMIZER_H
+
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+
+namespace Cell
+{
+    class Mesh;
+
+    /*
+
+      Optimizes the triangle and vertex order of (indexed) triangle meshes for the GPU, without
+      changing what is rendered. The stages, in the order Optimize runs them:
+
+        1. vertex deduplication: merges vertices w/ bitwise identical attributes; turns
+           unindexed triangle soup into an indexed mesh.
+        2. vertex cache:         reorders triangles s.t. recently transformed vertices are
+           re-used from the post-transform cache (Tipsify, Sander et al. 2007).
+        3. overdraw:             splits the cache optimized triangle order in clusters and
+           sorts those clusters roughly front-to-back from any view direction (outward facing
+           clusters first), trading a bit of cache efficiency (bound by threshold) for less
+           overdraw.
+        4. vertex fetch:         reorders the vertex buffer in the order the index buffer first
+           references each vertex, s.t. vertex fetches walk memory linearly.
+
+      The effect on the vertex cache is measured w/ a FIFO post-transform cache simulator, s.t.
+      results can be verified on the CPU; see AnalyzeVertexCache.
+
+    */
+    class MeshOptimizer
+    {
+    public:
+        // results of simulating an index buffer through a FIFO post-transform vertex cache.
+        struct CacheStatistics
+        {
+            unsigned int Triangles = 0;
+            unsigned int Vertices  = 0; // unique vertices referenced by the index buffer
+            unsigned int Misses    = 0; // vertex shader invocations
+            float        ACMR      = 0.0f; // average cache miss ratio: misses per triangle [0.5, 3]
+            float        ATVR      = 0.0f; // average transform to vertex ratio: misses per vertex [1, 3]
+
+            // accumulates the statistics of another index buffer
+            void Add(const CacheStatistics& other);
+        };
+
+        static const unsigned int CACHE_SIZE = 16;
+    private:
+        // disallow creation of any MeshOptimizer object; it's defined as a static object
+        MeshOptimizer();
+    public:
+        // runs all optimization stages on a triangle mesh, before its vertex data is finalized;
+        // optionally returns the vertex cache statistics before and after optimization.
+        static void Optimize(Mesh* mesh, CacheStatistics* before = nullptr, CacheStatistics* after = nullptr);
+
+        // returns the number of unique vertices; the mesh is always indexed afterwards.
+        static unsigned int DeduplicateVertices(Mesh* mesh);
+        static void         OptimizeVertexCache(std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize = CACHE_SIZE);
+        // expects a vertex cache optimized index buffer; threshold is the maximum allowed ACMR
+        // increase (relative) of each of the clusters.
+        static void         OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, float threshold = 1.05f, unsigned int cacheSize = CACHE_SIZE);
+        // also drops unreferenced vertices; returns the new vertex count.
+        static unsigned int OptimizeVertexFetch(Mesh* mesh);
+
+        static CacheStatistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int vertexCount, unsigned int cacheSize = CACHE_SIZE);
+    };
+}
+#endif
@@ -0,0 +1,459 @@
+#include "mesh_simplifier.h"
+
+#include "mesh.h"
+#include "mesh_optimizer.h"
+
+#include <math.h>
+#include <math/linear_algebra/operation.h>
+
+#include <algorithm>
+#include <string.h>
+#include <unordered_map>
+
+namespace Cell
+{
+    // the topological role of a (welded) vertex; determines where it may collapse to.
+    enum VERTEX_KIND
+    {
+        KIND_MANIFOLD, // interior vertex: collapses onto any neighbor
+        KIND_BORDER,   // on a single open border: only collapses along the border
+        KIND_SEAM,     // on a single attribute seam: collapses along the seam w/ its twin
+        KIND_LOCKED,   // never collapses (corners, seam/border intersections, poles)
+    };
+
+    // NOTE(Joey): weight of the planes perpendicular to border edges (w.r.t. the area weighted
+    // triangle planes) that keep borders from shrinking inwards.
+    static const double BORDER_WEIGHT = 10.0;
+
+    /* NOTE(Joey):
+
+      Symmetric 4x4 quadric Q(p) = p^T A p + 2 b.p + c, the sum of squared distances to a set of
+      (weighted) planes. W is the total weight, s.t. Q(p) / W is the weighted mean squared
+      distance of p to the planes. Stored in double precision as the evaluation cancels large
+      terms for meshes far from their origin.
+
+    */
+    struct Quadric
+    {
+        double A00 = 0.0, A11 = 0.0, A22 = 0.0, A10 = 0.0, A20 = 0.0, A21 = 0.0;
+        double B0  = 0.0, B1  = 0.0, B2  = 0.0;
+        double C   = 0.0;
+        double W   = 0.0;
+    };
+    static void quadricAddPlane(Quadric& q, const math::vec3& n, float d, double weight)
+    {
+        q.A00 += weight * n.x * n.x;
+        q.A11 += weight * n.y * n.y;
+        q.A22 += weight * n.z * n.z;
+        q.A10 += weight * n.y * n.x;
+        q.A20 += weight * n.z * n.x;
+        q.A21 += weight * n.z * n.y;
+        q.B0  += weight * n.x * d;
+        q.B1  += weight * n.y * d;
+        q.B2  += weight * n.z * d;
+        q.C   += weight * d * d;
+        q.W   += weight;
+    }
+    static void quadricAdd(Quadric& q, const Quadric& other)
+    {
+        q.A00 += other.A00; q.A11 += other.A11; q.A22 += other.A22;
+        q.A10 += other.A10; q.A20 += other.A20; q.A21 += other.A21;
+        q.B0  += other.B0;  q.B1  += other.B1;  q.B2  += other.B2;
+        q.C   += other.C;
+        q.W   += other.W;
+    }
+    // returns the mean squared distance of p to the planes of both quadrics
+    static float quadricError(const Quadric& a, const Quadric& b, const math::vec3& p)
+    {
+        Quadric q = a;
+        quadricAdd(q, b);
+        if (q.W <= 0.0)
+            return 0.0f;
+        const double x = p.x, y = p.y, z = p.z;
+        double ax = q.A00 * x + q.A10 * y + q.A20 * z;
+        double ay = q.A10 * x + q.A11 * y + q.A21 * z;
+        double az = q.A20 * x + q.A21 * y + q.A22 * z;
+        double error = x * ax + y * ay + z * az + 2.0 * (q.B0 * x + q.B1 * y + q.B2 * z) + q.C;
+        return (float)(fabs(error) / q.W);
+    }
+
+    // vertex positions quantized to a grid relative to the mesh's bounds, used for welding.
+    struct WeldKey
+    {
+        int X, Y, Z;
+        bool operator==(const WeldKey& other) const { return X == other.X && Y == other.Y && Z == other.Z; }
+    };
+    struct WeldKeyHash
+    {
+        size_t operator()(const WeldKey& key) const
+        {
+            return ((unsigned int)key.X * 73856093u) ^ ((unsigned int)key.Y * 19349663u) ^ ((unsigned int)key.Z * 83492791u);
+        }
+    };
+
+    /* NOTE(Joey):
+
+      Triangle adjacency per welded vertex in compressed form: the triangles around vertex v are
+      stored at [offsets[v], offsets[v + 1]) of triangles.
+
+    */
+    struct TriangleAdjacency
+    {
+        std::vector<unsigned int> Offsets;
+        std::vector<unsigned int> Triangles;
+    };
+    static void buildAdjacency(TriangleAdjacency& adjacency, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap)
+    {
+        adjacency.Offsets.assign(remap.size() + 1, 0);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+            adjacency.Offsets[remap[indices[i]] + 1]++;
+        for (unsigned int i = 0; i < remap.size(); ++i)
+            adjacency.Offsets[i + 1] += adjacency.Offsets[i];
+
+        std::vector<unsigned int> fill(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+        adjacency.Triangles.resize(indices.size());
+        for (unsigned int i = 0; i < indices.size(); ++i)
+            adjacency.Triangles[fill[remap[indices[i]]]++] = i / 3;
+    }
+    // whether the (welded) half-edge a -> b is part of any triangle
+    static bool hasEdge(const TriangleAdjacency& adjacency, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap, unsigned int a, unsigned int b)
+    {
+        for (unsigned int i = adjacency.Offsets[a]; i < adjacency.Offsets[a + 1]; ++i)
+        {
+            const unsigned int* triangle = &indices[adjacency.Triangles[i] * 3];
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                if (remap[triangle[k]] == a && remap[triangle[(k + 1) % 3]] == b)
+                    return true;
+            }
+        }
+        return false;
+    }
+    // whether collapsing (welded) vertex source onto target flips any of the remaining triangles
+    // around source; collapses performed earlier in the same pass are resolved through collapse.
+    static bool hasTriangleFlip(const TriangleAdjacency& adjacency, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap, const std::vector<unsigned int>& collapse,
+                                const std::vector<math::vec3>& positions, unsigned int source, unsigned int target)
+    {
+        for (unsigned int i = adjacency.Offsets[source]; i < adjacency.Offsets[source + 1]; ++i)
+        {
+            const unsigned int* triangle = &indices[adjacency.Triangles[i] * 3];
+            unsigned int v[3];
+            for (unsigned int k = 0; k < 3; ++k)
+                v[k] = remap[collapse[triangle[k]]];
+            // triangles on the collapsed edge (and those already collapsed) disappear
+            if (v[0] == v[1] || v[1] == v[2] || v[0] == v[2] || v[0] == target || v[1] == target || v[2] == target)
+                continue;
+
+            math::vec3 before[3], after[3];
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                before[k] = positions[v[k]];
+                after[k]  = v[k] == source ? positions[target] : before[k];
+            }
+            math::vec3 normalBefore = math::cross(before[1] - before[0], before[2] - before[0]);
+            math::vec3 normalAfter  = math::cross(after[1]  - after[0],  after[2]  - after[0]);
+            if (math::dot(normalBefore, normalAfter) <= 0.0f)
+                return true;
+        }
+        return false;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    void MeshSimplifier::GenerateLods(Mesh* mesh, unsigned int maxLods, float reduction, float maxError)
+    {
+        mesh->Lods.clear();
+        if (mesh->Topology != TRIANGLES || mesh->Indices.empty() || mesh->Positions.empty())
+            return;
+
+        // errors are relative to the mesh's size
+        math::vec3 boxMin = mesh->Positions[0], boxMax = mesh->Positions[0];
+        for (unsigned int i = 1; i < mesh->Positions.size(); ++i)
+        {
+            const math::vec3& p = mesh->Positions[i];
+            boxMin.x = std::min(boxMin.x, p.x); boxMax.x = std::max(boxMax.x, p.x);
+            boxMin.y = std::min(boxMin.y, p.y); boxMax.y = std::max(boxMax.y, p.y);
+            boxMin.z = std::min(boxMin.z, p.z); boxMax.z = std::max(boxMax.z, p.z);
+        }
+        const float radius = 0.5f * math::length(boxMax - boxMin);
+        if (radius <= 0.0f)
+            return;
+
+        /* NOTE(Joey):
+
+          Each level is simplified from the previous one (not from the full detail mesh), which
+          keeps the levels nested and is considerably faster for long chains. The quadrics only
+          measure the error w.r.t. the previous level though, s.t. the errors of the levels are
+          summed: a conservative bound on the distance to the full detail mesh.
+
+        */
+        maxLods = std::min(maxLods, MAX_LODS);
+        mesh->Lods.reserve(maxLods);
+        float error = 0.0f;
+        for (unsigned int level = 1; level < maxLods; ++level)
+        {
+            const std::vector<unsigned int>& previous = level == 1 ? mesh->Indices : mesh->Lods.back().Indices;
+            const unsigned int previousCount = (unsigned int)previous.size();
+            if (previousCount < 3 * 32) // not worth it for a handful of triangles
+                break;
+
+            MeshLod lod;
+            lod.Indices = previous;
+            const unsigned int target = (unsigned int)(previousCount / 3 * reduction) * 3;
+            float levelError = Simplify(lod.Indices, mesh->Positions, target, maxError * radius - error);
+            // the remaining error budget no longer allows a meaningful reduction
+            if (lod.Indices.size() > previousCount * 0.85f)
+                break;
+
+            error += levelError;
+            lod.Error = error;
+            MeshOptimizer::OptimizeVertexCache(lod.Indices, (unsigned int)mesh->Positions.size());
+            mesh->Lods.push_back(std::move(lod));
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    float MeshSimplifier::Simplify(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, unsigned int targetIndexCount, float targetError)
+    {
+        const unsigned int vertexCount = (unsigned int)positions.size();
+        if (indices.size() < 3 || vertexCount == 0 || targetError < 0.0f)
+            return 0.0f;
+
+        // weld vertices at the same position: remap points each vertex to the first vertex at
+        // its position, and wedge links all vertices at the same position in a circular list.
+        // NOTE(Joey): positions are compared on a grid of 2^-20 times the mesh's extent, as
+        // procedural meshes rarely produce bitwise identical positions on both sides of a seam
+        // (e.g. sin(2 * PI) != sin(0)).
+        std::vector<unsigned int> remap(vertexCount), wedge(vertexCount);
+        {
+            math::vec3 boxMin = positions[0], boxMax = positions[0];
+            for (unsigned int i = 1; i < vertexCount; ++i)
+            {
+                boxMin.x = std::min(boxMin.x, positions[i].x); boxMax.x = std::max(boxMax.x, positions[i].x);
+                boxMin.y = std::min(boxMin.y, positions[i].y); boxMax.y = std::max(boxMax.y, positions[i].y);
+                boxMin.z = std::min(boxMin.z, positions[i].z); boxMax.z = std::max(boxMax.z, positions[i].z);
+            }
+            float extent = std::max(std::max(boxMax.x - boxMin.x, boxMax.y - boxMin.y), boxMax.z - boxMin.z);
+            float scale  = extent > 0.0f ? 1048576.0f / extent : 0.0f;
+
+            std::unordered_map<WeldKey, unsigned int, WeldKeyHash> welded;
+            welded.reserve(vertexCount);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+            {
+                WeldKey key = { (int)floorf((positions[i].x - boxMin.x) * scale + 0.5f),
+                                (int)floorf((positions[i].y - boxMin.y) * scale + 0.5f),
+                                (int)floorf((positions[i].z - boxMin.z) * scale + 0.5f) };
+                auto it = welded.insert(std::make_pair(key, i)).first;
+                remap[i] = it->second;
+                wedge[i] = i;
+                if (remap[i] != i)
+                {
+                    wedge[i] = wedge[remap[i]];
+                    wedge[remap[i]] = i;
+                }
+            }
+        }
+        auto degenerate = [&remap](unsigned int a, unsigned int b, unsigned int c)
+        {
+            return remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c];
+        };
+
+        // drop triangles that are already degenerate w/ the welded positions (e.g. at the poles
+        // of a uv sphere); they don't contribute to the surface.
+        unsigned int write = 0;
+        for (unsigned int i = 0; i + 2 < indices.size(); i += 3)
+        {
+            if (degenerate(indices[i], indices[i + 1], indices[i + 2]))
+                continue;
+            indices[write++] = indices[i];
+            indices[write++] = indices[i + 1];
+            indices[write++] = indices[i + 2];
+        }
+        indices.resize(write);
+
+        TriangleAdjacency adjacency;
+        buildAdjacency(adjacency, indices, remap);
+
+        // classify each welded vertex by its open (welded) edges and number of wedges
+        std::vector<unsigned char> kinds(vertexCount, KIND_LOCKED);
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            if (remap[v] != v || adjacency.Offsets[v] == adjacency.Offsets[v + 1])
+                continue;
+            unsigned int wedges = 1;
+            for (unsigned int w = wedge[v]; w != v; w = wedge[w])
+                ++wedges;
+
+            unsigned int openOut = 0, openIn = 0;
+            for (unsigned int i = adjacency.Offsets[v]; i < adjacency.Offsets[v + 1]; ++i)
+            {
+                const unsigned int* triangle = &indices[adjacency.Triangles[i] * 3];
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    if (remap[triangle[k]] != v)
+                        continue;
+                    unsigned int next = remap[triangle[(k + 1) % 3]];
+                    unsigned int prev = remap[triangle[(k + 2) % 3]];
+                    if (!hasEdge(adjacency, indices, remap, next, v)) ++openOut;
+                    if (!hasEdge(adjacency, indices, remap, v, prev)) ++openIn;
+                }
+            }
+
+            if (wedges == 1 && openOut == 0 && openIn == 0)
+                kinds[v] = KIND_MANIFOLD;
+            else if (wedges == 1 && openOut == 1 && openIn == 1)
+                kinds[v] = KIND_BORDER;
+            else if (wedges == 2 && openOut == 0 && openIn == 0)
+                kinds[v] = KIND_SEAM;
+        }
+
+        // quadrics of the (area weighted) triangle planes and the border edge planes
+        std::vector<Quadric> quadrics(vertexCount);
+        for (unsigned int i = 0; i < indices.size(); i += 3)
+        {
+            unsigned int v[3] = { remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]] };
+            const math::vec3& p0 = positions[v[0]];
+            math::vec3 normal = math::cross(positions[v[1]] - p0, positions[v[2]] - p0);
+            float area = math::length(normal);
+            if (area <= 0.0f)
+                continue;
+            normal = normal / area;
+            float d = -math::dot(normal, p0);
+            for (unsigned int k = 0; k < 3; ++k)
+                quadricAddPlane(quadrics[v[k]], normal, d, 0.5 * area);
+
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                unsigned int a = v[k], b = v[(k + 1) % 3];
+                if (hasEdge(adjacency, indices, remap, b, a))
+                    continue;
+                math::vec3 edge = positions[b] - positions[a];
+                float length = math::length(edge);
+                if (length <= 0.0f)
+                    continue;
+                math::vec3 borderNormal = math::normalize(math::cross(edge, normal));
+                float borderD = -math::dot(borderNormal, positions[a]);
+                quadricAddPlane(quadrics[a], borderNormal, borderD, BORDER_WEIGHT * length * length);
+                quadricAddPlane(quadrics[b], borderNormal, borderD, BORDER_WEIGHT * length * length);
+            }
+        }
+
+        /* NOTE(Joey):
+
+          Each pass collects all allowed collapses (over every edge, in both directions) w/ their
+          cost, sorts them and greedily performs the cheapest ones; a welded vertex takes part in
+          at most one collapse per pass, s.t. the costs and adjacency stay valid within the pass.
+          The index buffer is rewritten at the end of each pass.
+
+        */
+        struct Collapse
+        {
+            unsigned int Source;
+            unsigned int Target;
+            float        Cost;
+        };
+        std::vector<Collapse>      collapses;
+        std::vector<unsigned int>  collapseRemap(vertexCount);
+        std::vector<unsigned char> touched(vertexCount);
+        const float maxCost = targetError * targetError;
+        float result = 0.0f;
+        while (indices.size() > targetIndexCount)
+        {
+            collapses.clear();
+            auto addCollapse = [&](unsigned int source, unsigned int target)
+            {
+                unsigned int s = remap[source], t = remap[target];
+                unsigned char kind = kinds[s];
+                if (kind == KIND_LOCKED)
+                    return;
+                if (kind == KIND_BORDER)
+                {
+                    // only along the (open) border edge, onto another border vertex
+                    if ((kinds[t] != KIND_BORDER && kinds[t] != KIND_LOCKED) ||
+                        (hasEdge(adjacency, indices, remap, s, t) && hasEdge(adjacency, indices, remap, t, s)))
+                        return;
+                }
+                if (kind == KIND_SEAM && kinds[t] != KIND_SEAM && kinds[t] != KIND_LOCKED)
+                    return;
+                float cost = quadricError(quadrics[s], quadrics[t], positions[t]);
+                if (cost <= maxCost)
+                    collapses.push_back({ source, target, cost });
+            };
+            for (unsigned int i = 0; i < indices.size(); i += 3)
+            {
+                for (unsigned int k = 0; k < 3; ++k)
+                {
+                    addCollapse(indices[i + k], indices[i + (k + 1) % 3]);
+                    addCollapse(indices[i + (k + 1) % 3], indices[i + k]);
+                }
+            }
+            if (collapses.empty())
+                break;
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+            {
+                return a.Cost < b.Cost || (a.Cost == b.Cost && a.Source < b.Source);
+            });
+
+            for (unsigned int i = 0; i < vertexCount; ++i)
+                collapseRemap[i] = i;
+            memset(&touched[0], 0, vertexCount);
+
+            // a collapse removes two triangles (one on a border, four on a seam); stop once the
+            // target is reached.
+            const unsigned int goal = ((unsigned int)indices.size() - targetIndexCount + 2) / 3;
+            unsigned int removed = 0;
+            for (unsigned int c = 0; c < collapses.size() && removed < goal; ++c)
+            {
+                const Collapse& collapse = collapses[c];
+                unsigned int s = remap[collapse.Source], t = remap[collapse.Target];
+                if (touched[s] || touched[t])
+                    continue;
+
+                // a seam vertex moves together w/ its twin, onto the target's wedge on the
+                // twin's side of the seam; if there is none the edge isn't along the seam.
+                unsigned int twin = 0xFFFFFFFF, twinTarget = 0xFFFFFFFF;
+                if (kinds[s] == KIND_SEAM)
+                {
+                    twin = wedge[collapse.Source];
+                    for (unsigned int i = adjacency.Offsets[s]; i < adjacency.Offsets[s + 1] && twinTarget == 0xFFFFFFFF; ++i)
+                    {
+                        const unsigned int* triangle = &indices[adjacency.Triangles[i] * 3];
+                        if (triangle[0] != twin && triangle[1] != twin && triangle[2] != twin)
+                            continue;
+                        for (unsigned int k = 0; k < 3; ++k)
+                        {
+                            if (remap[triangle[k]] == t)
+                                twinTarget = triangle[k];
+                        }
+                    }
+                    if (twinTarget == 0xFFFFFFFF)
+                        continue;
+                }
+                if (hasTriangleFlip(adjacency, indices, remap, collapseRemap, positions, s, t))
+                    continue;
+
+                collapseRemap[collapse.Source] = collapse.Target;
+                if (twin != 0xFFFFFFFF)
+                    collapseRemap[twin] = twinTarget;
+                quadricAdd(quadrics[t], quadrics[s]);
+                touched[s] = touched[t] = 1;
+                removed += kinds[s] == KIND_SEAM ? 4 : kinds[s] == KIND_BORDER ? 1 : 2;
+                result = std::max(result, sqrtf(collapse.Cost));
+            }
+            if (removed == 0)
+                break;
+
+            write = 0;
+            for (unsigned int i = 0; i < indices.size(); i += 3)
+            {
+                unsigned int a = collapseRemap[indices[i]], b = collapseRemap[indices[i + 1]], c = collapseRemap[indices[i + 2]];
+                if (degenerate(a, b, c))
+                    continue;
+                indices[write++] = a;
+                indices[write++] = b;
+                indices[write++] = c;
+            }
+            indices.resize(write);
+            buildAdjacency(adjacency, indices, remap);
+        }
+        return result;
+    }
+}
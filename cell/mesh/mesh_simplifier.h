@@ -0,0 +1,45 @@
+#ifndef CELL_MESH_SIMPLIFIER_H
+#define CELL_MESH_SIMPLIFIER_H
+
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+
+namespace Cell
+{
+    class Mesh;
+
+    /*
+
+      Generates levels of detail for (indexed) triangle meshes by iterative edge collapse, w/
+      the collapse order driven by quadric error metrics (Garland and Heckbert 1997). Vertices
+      are only ever collapsed onto one of their neighbors (no new vertices are created), s.t.
+      each level of detail is a single index buffer into the mesh's original vertex buffer.
+
+      Attribute seams (vertices that share a position but differ in UV/normal) are preserved:
+      a seam vertex only collapses along the seam, together w/ its twin on the other side, and
+      mesh borders only collapse along the border. Vertices where more than two seams/borders
+      meet are locked.
+
+    */
+    class MeshSimplifier
+    {
+    public:
+        // the maximum number of levels of detail of a mesh, including the full detail mesh
+        static const unsigned int MAX_LODS = 8;
+    private:
+        // disallow creation of any MeshSimplifier object; it's defined as a static object
+        MeshSimplifier();
+    public:
+        // generates the LOD chain of a triangle mesh (see Mesh::Lods), before its vertex data is
+        // finalized. Each level targets reduction times the triangle count of the previous one;
+        // the chain ends early once a level's error would exceed maxError (relative to the mesh's
+        // bounding radius) or it no longer meaningfully reduces the triangle count.
+        static void GenerateLods(Mesh* mesh, unsigned int maxLods = 5, float reduction = 0.5f, float maxError = 0.05f);
+
+        // simplifies an index buffer down to (at most) targetIndexCount indices, or until the
+        // next collapse would exceed targetError (in object space); returns the resulting error.
+        static float Simplify(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, unsigned int targetIndexCount, float targetError);
+    };
+}
+#endif
@@ -0,0 +1,224 @@
+#include "meshlet_builder.h"
+
+#include "../camera/camera_frustum.h"
+
+#include <math.h>
+#include <math/linear_algebra/operation.h>
+
+#include <algorithm>
+
+namespace Cell
+{
+    // NOTE(Joey): uploaded as is to the GPU (see Mesh::Upload); must match std430 layout.
+    static_assert(sizeof(Meshlet) == 48, "Meshlet must match the std430 layout of the culling shader.");
+
+    // bounding sphere and normal cone of a meshlet's triangles
+    static void meshletBounds(Meshlet& meshlet, const unsigned int* triangles, const std::vector<math::vec3>& positions)
+    {
+        const unsigned int triangleCount = meshlet.IndexCount / 3;
+
+        // sphere around the center of the bounding box: not minimal, but cheap and tight enough
+        // for clusters of adjacent triangles.
+        math::vec3 boxMin = positions[triangles[0]], boxMax = boxMin;
+        for (unsigned int i = 0; i < meshlet.IndexCount; ++i)
+        {
+            const math::vec3& p = positions[triangles[i]];
+            boxMin = math::vec3(std::min(boxMin.x, p.x), std::min(boxMin.y, p.y), std::min(boxMin.z, p.z));
+            boxMax = math::vec3(std::max(boxMax.x, p.x), std::max(boxMax.y, p.y), std::max(boxMax.z, p.z));
+        }
+        meshlet.Center = (boxMin + boxMax) * 0.5f;
+        float radius = 0.0f;
+        for (unsigned int i = 0; i < meshlet.IndexCount; ++i)
+            radius = std::max(radius, math::length(positions[triangles[i]] - meshlet.Center));
+        meshlet.Radius = radius;
+
+        // the cone's axis is the average face normal and its opening the widest angle between
+        // the axis and any face normal (degenerate faces don't count).
+        std::vector<math::vec3> normals;
+        normals.reserve(triangleCount);
+        math::vec3 axis(0.0f);
+        for (unsigned int t = 0; t < triangleCount; ++t)
+        {
+            const math::vec3& p0 = positions[triangles[t * 3 + 0]];
+            math::vec3 normal = math::cross(positions[triangles[t * 3 + 1]] - p0, positions[triangles[t * 3 + 2]] - p0);
+            float length = math::length(normal);
+            if (length <= 0.0f)
+                continue;
+            normals.push_back(normal / length);
+            axis = axis + normals.back();
+        }
+        float axisLength = math::length(axis);
+        meshlet.ConeAxis   = axisLength > 0.0f ? axis / axisLength : math::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.ConeCutoff = 1.0f;
+        if (axisLength <= 0.0f || normals.empty())
+            return;
+        float minDot = 1.0f;
+        for (const math::vec3& normal : normals)
+            minDot = std::min(minDot, math::dot(normal, meshlet.ConeAxis));
+        // NOTE(Joey): the culling test is only ever satisfied for cones narrower than a
+        // hemisphere; wider cones (or nearly so, which cull too rarely to bother) never cull.
+        if (minDot > 0.1f)
+            meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    void MeshletBuilder::Build(Mesh* mesh, unsigned int maxVertices, unsigned int maxTriangles)
+    {
+        mesh->Meshlets.clear();
+        // NOTE(Joey): a mesh of only a few meshlets is as cheap to draw in full as it is to cull.
+        if (mesh->Topology != TRIANGLES || mesh->Indices.size() < maxTriangles * 3 * 4)
+            return;
+        Build(mesh->Indices, mesh->Positions, mesh->Meshlets, maxVertices, maxTriangles);
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshletBuilder::Build(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, std::vector<Meshlet>& meshlets,
+                               unsigned int maxVertices, unsigned int maxTriangles)
+    {
+        meshlets.clear();
+        const unsigned int vertexCount   = (unsigned int)positions.size();
+        const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+        maxVertices  = std::max(3u, maxVertices);
+        maxTriangles = std::max(1u, maxTriangles);
+
+        // the triangles around each vertex (compressed sparse row)
+        std::vector<unsigned int> offsets(vertexCount + 1, 0), adjacency(triangleCount * 3);
+        for (unsigned int i = 0; i < triangleCount * 3; ++i)
+            ++offsets[indices[i] + 1];
+        for (unsigned int v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+        {
+            std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+            for (unsigned int i = 0; i < triangleCount * 3; ++i)
+                adjacency[cursor[indices[i]]++] = i / 3;
+        }
+
+        const unsigned int NONE = 0xFFFFFFFF;
+        std::vector<bool>         emitted(triangleCount, false);
+        std::vector<unsigned int> vertexMeshlet(vertexCount, NONE); // the meshlet a vertex was last added to
+        std::vector<unsigned int> reordered;
+        reordered.reserve(triangleCount * 3);
+        std::vector<unsigned int> vertices;
+        vertices.reserve(maxVertices);
+
+        unsigned int next = 0; // first triangle that may not yet be emitted
+        while (true)
+        {
+            while (next < triangleCount && emitted[next])
+                ++next;
+            if (next == triangleCount)
+                break;
+
+            const unsigned int id = (unsigned int)meshlets.size();
+            Meshlet meshlet = {};
+            meshlet.IndexOffset = (unsigned int)reordered.size();
+            vertices.clear();
+            math::vec3 centerSum(0.0f);
+
+            unsigned int triangle = next;
+            while (triangle != NONE)
+            {
+                // add the triangle and its new vertices
+                emitted[triangle] = true;
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    unsigned int v = indices[triangle * 3 + c];
+                    reordered.push_back(v);
+                    if (vertexMeshlet[v] != id)
+                    {
+                        vertexMeshlet[v] = id;
+                        vertices.push_back(v);
+                        centerSum = centerSum + positions[v];
+                    }
+                }
+                meshlet.IndexCount += 3;
+                if (meshlet.IndexCount / 3 >= maxTriangles)
+                    break;
+
+                // pick the adjacent triangle adding the fewest vertices, then the closest one
+                const math::vec3 center = centerSum / (float)vertices.size();
+                unsigned int bestTriangle = NONE, bestNew = 4;
+                float bestDistance = 0.0f;
+                for (unsigned int v : vertices)
+                {
+                    for (unsigned int i = offsets[v]; i < offsets[v + 1]; ++i)
+                    {
+                        const unsigned int t = adjacency[i];
+                        if (emitted[t])
+                            continue;
+                        const unsigned int a = indices[t * 3 + 0], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+                        unsigned int newVertices = (vertexMeshlet[a] != id) + (vertexMeshlet[b] != id) + (vertexMeshlet[c] != id);
+                        if (newVertices > bestNew || vertices.size() + newVertices > maxVertices)
+                            continue;
+                        math::vec3 centroid = (positions[a] + positions[b] + positions[c]) / 3.0f;
+                        float distance = math::dot(centroid - center, centroid - center);
+                        if (newVertices < bestNew || distance < bestDistance)
+                        {
+                            bestTriangle = t;
+                            bestNew      = newVertices;
+                            bestDistance = distance;
+                        }
+                    }
+                }
+                triangle = bestTriangle;
+            }
+            meshlet.VertexCount = (unsigned int)vertices.size();
+            meshletBounds(meshlet, &reordered[meshlet.IndexOffset], positions);
+            meshlets.push_back(meshlet);
+        }
+        indices.swap(reordered);
+    }
+    // --------------------------------------------------------------------------------------------
+    MeshletView MeshletBuilder::ObjectSpaceView(const math::mat4& transform, const CameraFrustum& frustum, const math::vec3& eye, bool backfaceCulling)
+    {
+        // NOTE(Joey): w/ p' = R * p + t, a world space plane n . p' + d = 0 becomes the object
+        // space plane (R^T n) . p + (n . t + d) = 0; normalizing it keeps the distances (and thus
+        // the meshlets' bounding spheres) in object space units.
+        math::mat4 m = transform;
+        const math::vec3 c0(m[0].x, m[0].y, m[0].z);
+        const math::vec3 c1(m[1].x, m[1].y, m[1].z);
+        const math::vec3 c2(m[2].x, m[2].y, m[2].z);
+        const math::vec3 t(m[3].x, m[3].y, m[3].z);
+
+        MeshletView view;
+        for (unsigned int i = 0; i < 6; ++i)
+        {
+            const math::vec3& n = frustum.Planes[i].Normal;
+            math::vec3 normal(math::dot(c0, n), math::dot(c1, n), math::dot(c2, n));
+            float length = math::length(normal);
+            float d = math::dot(n, t) + frustum.Planes[i].D;
+            view.Planes[i] = length > 0.0f ? math::vec4(normal / length, d / length) : math::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+
+        // the eye in object space: R^-1 (eye - t), w/ the rows of R^-1 being the cross products
+        // of R's columns divided by its determinant.
+        const math::vec3 c12 = math::cross(c1, c2), c20 = math::cross(c2, c0), c01 = math::cross(c0, c1);
+        const float determinant = math::dot(c0, c12);
+        const math::vec3 e = eye - t;
+        view.Eye         = determinant != 0.0f ? math::vec3(math::dot(c12, e), math::dot(c20, e), math::dot(c01, e)) / determinant : math::vec3(0.0f);
+        // whether a face is seen from behind is invariant to (non-mirroring) affine transforms,
+        // s.t. the object space normal cones can be tested against the object space eye.
+        view.ConeCulling = backfaceCulling && determinant > 0.0f;
+        return view;
+    }
+    // --------------------------------------------------------------------------------------------
+    MESHLET_CULL MeshletBuilder::Cull(const Meshlet& meshlet, const MeshletView& view)
+    {
+        for (unsigned int i = 0; i < 6; ++i)
+        {
+            const math::vec4& plane = view.Planes[i];
+            if (plane.x * meshlet.Center.x + plane.y * meshlet.Center.y + plane.z * meshlet.Center.z + plane.w < -meshlet.Radius)
+                return MESHLET_CULLED_FRUSTUM;
+        }
+        // all faces are backfacing if the direction from the eye to any point of the sphere is
+        // within 90 degrees - the cone's half angle of the cone's axis.
+        if (view.ConeCulling)
+        {
+            math::vec3 direction = meshlet.Center - view.Eye;
+            if (math::dot(direction, meshlet.ConeAxis) >= meshlet.ConeCutoff * math::length(direction) + meshlet.Radius)
+                return MESHLET_CULLED_CONE;
+        }
+        return MESHLET_VISIBLE;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef CELL_MESH_MESHLET_BUILDER_H
+#define CELL_MESH_MESHLET_BUILDER_H
+
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+#include <math/linear_algebra/matrix.h>
+
+#include "mesh.h"
+
+namespace Cell
+{
+    class CameraFrustum;
+
+    // the result of culling a single meshlet
+    enum MESHLET_CULL
+    {
+        MESHLET_VISIBLE,
+        MESHLET_CULLED_FRUSTUM,
+        MESHLET_CULLED_CONE,
+    };
+
+    // a camera transformed to a mesh's object space, s.t. its meshlets can be culled w/o
+    // transforming each of them (see MeshletBuilder::ObjectSpaceView).
+    struct MeshletView
+    {
+        math::vec4 Planes[6]; // frustum planes (xyz: unit normal, w: distance), pointing inwards
+        math::vec3 Eye;
+        bool       ConeCulling;
+    };
+
+    /*
+
+      Partitions a mesh's triangles into meshlets: clusters of at most MAX_VERTICES unique
+      vertices and MAX_TRIANGLES triangles that are culled as a whole, s.t. a large mesh that's
+      only partially visible (or largely facing away from the camera) only draws the clusters
+      that can contribute to the image.
+
+      Meshlets are grown greedily: starting from the first unassigned triangle (in index buffer
+      order, which after MeshOptimizer is spatially coherent), the meshlet repeatedly adds the
+      adjacent triangle that adds the fewest new vertices (the closest to the meshlet's center
+      on a tie) until either limit is reached. Triangles are then reordered s.t. each meshlet is
+      a contiguous range of the index buffer.
+
+      Each meshlet stores a bounding sphere and a cone bounding its (unit) face normals: if the
+      whole sphere lies in the region from which each face in the cone is seen from behind,
+      all of its triangles are backfacing.
+
+    */
+    class MeshletBuilder
+    {
+    public:
+        static const unsigned int MAX_VERTICES  = 64;
+        static const unsigned int MAX_TRIANGLES = 124;
+    private:
+        // disallow creation of any MeshletBuilder object; it's defined as a static object
+        MeshletBuilder();
+    public:
+        // builds the meshlets of a triangle mesh's full detail index buffer (see Mesh::Meshlets),
+        // before it's finalized; meshes too small to benefit are left without meshlets.
+        static void Build(Mesh* mesh, unsigned int maxVertices = MAX_VERTICES, unsigned int maxTriangles = MAX_TRIANGLES);
+
+        // builds meshlets for a triangle list, reordering the triangles of indices.
+        static void Build(std::vector<unsigned int>& indices, const std::vector<math::vec3>& positions, std::vector<Meshlet>& meshlets,
+                          unsigned int maxVertices = MAX_VERTICES, unsigned int maxTriangles = MAX_TRIANGLES);
+
+        // transforms the camera (w/ its world space frustum and position) to the object space of
+        // a mesh rendered w/ transform. Cone culling is disabled for mirroring transforms and if
+        // backfaces aren't culled by the mesh's material.
+        static MeshletView ObjectSpaceView(const math::mat4& transform, const CameraFrustum& frustum, const math::vec3& eye, bool backfaceCulling);
+
+        static MESHLET_CULL Cull(const Meshlet& meshlet, const MeshletView& view);
+    };
+}
+#endif
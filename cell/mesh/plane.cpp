@@ -42,6 +42,7 @@ namespace Cell
         }
 
         Topology = TRIANGLE_STRIP;
+        CalculateTangents();
         Finalize();
     }
 }
\ No newline at end of file
@@ -43,6 +43,7 @@ namespace Cell
         }
 
         Topology = TRIANGLES;
+        CalculateTangents();
         Finalize();
     }
 }
@@ -0,0 +1,312 @@
+#include "tangent_space.h"
+
+#include <math.h>
+#include <math/linear_algebra/operation.h>
+#include <utility/threading/thread_pool.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace Cell
+{
+    static const unsigned int CHUNK_SIZE = 4096; // faces/vertices per job
+
+    // calls func(begin, end) over [0, count) in chunks of CHUNK_SIZE, in parallel if a thread
+    // pool is given and there's more than one chunk.
+    static void forChunks(ThreadPool* threadPool, unsigned int count, const std::function<void(unsigned int, unsigned int)>& func)
+    {
+        const unsigned int chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        auto chunk = [&](unsigned int i)
+        {
+            func(i * CHUNK_SIZE, std::min(count, (i + 1) * CHUNK_SIZE));
+        };
+        if (threadPool && chunkCount > 1)
+        {
+            threadPool->ParallelFor(chunkCount, chunk);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < chunkCount; ++i)
+                chunk(i);
+        }
+    }
+
+    // the angle between two (not necessarily normalized) vectors; 0 if either is degenerate.
+    static float angleBetween(const math::vec3& a, const math::vec3& b)
+    {
+        float lengths = math::length(a) * math::length(b);
+        if (lengths <= 0.0f)
+            return 0.0f;
+        float cosine = math::dot(a, b) / lengths;
+        return std::acos(cosine < -1.0f ? -1.0f : cosine > 1.0f ? 1.0f : cosine);
+    }
+
+    // an arbitrary unit vector orthogonal to unit vector n.
+    static math::vec3 orthogonal(const math::vec3& n)
+    {
+        math::vec3 axis = std::abs(n.x) < 0.9f ? math::vec3(1.0f, 0.0f, 0.0f) : math::vec3(0.0f, 1.0f, 0.0f);
+        return math::normalize(math::cross(n, axis));
+    }
+
+    // maps each vertex to the first vertex w/ the exact same key (stride floats per vertex).
+    static void weldVertices(const std::vector<float>& keys, unsigned int stride, std::vector<unsigned int>& representative)
+    {
+        struct KeyHash
+        {
+            const float* Keys; unsigned int Stride;
+            size_t operator()(unsigned int v) const
+            {
+                size_t hash = 0;
+                for (unsigned int i = 0; i < Stride; ++i)
+                {
+                    float f = Keys[v * Stride + i] + 0.0f; // -0.0 => 0.0, as they compare equal
+                    uint32_t bits;
+                    std::memcpy(&bits, &f, sizeof(bits));
+                    hash = hash * 31 + bits * 2654435761u;
+                }
+                return hash;
+            }
+        };
+        struct KeyEqual
+        {
+            const float* Keys; unsigned int Stride;
+            bool operator()(unsigned int a, unsigned int b) const
+            {
+                for (unsigned int i = 0; i < Stride; ++i)
+                {
+                    if (Keys[a * Stride + i] != Keys[b * Stride + i])
+                        return false;
+                }
+                return true;
+            }
+        };
+        const unsigned int count = (unsigned int)(keys.size() / stride);
+        std::unordered_map<unsigned int, unsigned int, KeyHash, KeyEqual> first(count, KeyHash{ &keys[0], stride }, KeyEqual{ &keys[0], stride });
+        representative.resize(count);
+        for (unsigned int v = 0; v < count; ++v)
+            representative[v] = first.insert(std::make_pair(v, v)).first->second;
+    }
+
+    // the face corners (triangle * 3 + corner) around each vertex in compressed sparse row
+    // form: the corners of vertex v are corners[offsets[v]] up to corners[offsets[v + 1]].
+    // Vertices may first be mapped to a representative vertex (e.g. to weld positions).
+    static void buildCorners(const std::vector<unsigned int>& triangles, const unsigned int* representative, unsigned int vertexCount,
+                             std::vector<unsigned int>& offsets, std::vector<unsigned int>& corners)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (unsigned int i = 0; i < triangles.size(); ++i)
+            ++offsets[(representative ? representative[triangles[i]] : triangles[i]) + 1];
+        for (unsigned int v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+        corners.resize(triangles.size());
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < triangles.size(); ++i)
+            corners[cursor[representative ? representative[triangles[i]] : triangles[i]]++] = i;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    bool TangentSpace::Triangulate(TOPOLOGY topology, const std::vector<unsigned int>& indices, unsigned int vertexCount, std::vector<unsigned int>& triangles)
+    {
+        triangles.clear();
+        const unsigned int count = indices.size() > 0 ? (unsigned int)indices.size() : vertexCount;
+        auto index = [&](unsigned int i)
+        {
+            return indices.size() > 0 ? indices[i] : i;
+        };
+        auto push = [&](unsigned int a, unsigned int b, unsigned int c)
+        {
+            if (a == b || b == c || a == c)
+                return;
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(c);
+        };
+
+        switch (topology)
+        {
+        case TRIANGLES:
+            triangles.reserve(count);
+            for (unsigned int i = 0; i + 2 < count; i += 3)
+                push(index(i), index(i + 1), index(i + 2));
+            return true;
+        case TRIANGLE_STRIP:
+            // NOTE(Joey): every other triangle of a strip has its winding order flipped.
+            triangles.reserve(count > 2 ? (count - 2) * 3 : 0);
+            for (unsigned int i = 0; i + 2 < count; ++i)
+            {
+                if (i % 2 == 0)
+                    push(index(i), index(i + 1), index(i + 2));
+                else
+                    push(index(i + 1), index(i), index(i + 2));
+            }
+            return true;
+        case TRIANGLE_FAN:
+            triangles.reserve(count > 2 ? (count - 2) * 3 : 0);
+            for (unsigned int i = 1; i + 1 < count; ++i)
+                push(index(0), index(i), index(i + 1));
+            return true;
+        default:
+            return false;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    void TangentSpace::GenerateNormals(const std::vector<math::vec3>& positions, const std::vector<unsigned int>& triangles, bool weld,
+                                       std::vector<math::vec3>& normals, ThreadPool* threadPool)
+    {
+        const unsigned int vertexCount = (unsigned int)positions.size();
+        const unsigned int faceCount   = (unsigned int)triangles.size() / 3;
+        normals.resize(vertexCount);
+
+        std::vector<unsigned int> representative;
+        if (weld && vertexCount > 0)
+        {
+            std::vector<float> keys(&positions[0].x, &positions[0].x + vertexCount * 3);
+            weldVertices(keys, 3, representative);
+        }
+
+        // the unit face normal of each face, weighted by the angle at each of its corners.
+        std::vector<math::vec3> contributions(faceCount * 3);
+        forChunks(threadPool, faceCount, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int f = begin; f < end; ++f)
+            {
+                const math::vec3& p0 = positions[triangles[f * 3 + 0]];
+                const math::vec3& p1 = positions[triangles[f * 3 + 1]];
+                const math::vec3& p2 = positions[triangles[f * 3 + 2]];
+                math::vec3 normal = math::cross(p1 - p0, p2 - p0);
+                float length = math::length(normal);
+                if (length <= 0.0f)
+                {
+                    contributions[f * 3 + 0] = contributions[f * 3 + 1] = contributions[f * 3 + 2] = math::vec3(0.0f);
+                    continue;
+                }
+                normal = normal / length;
+                contributions[f * 3 + 0] = normal * angleBetween(p1 - p0, p2 - p0);
+                contributions[f * 3 + 1] = normal * angleBetween(p2 - p1, p0 - p1);
+                contributions[f * 3 + 2] = normal * angleBetween(p0 - p2, p1 - p2);
+            }
+        });
+
+        std::vector<unsigned int> offsets, corners;
+        buildCorners(triangles, representative.size() > 0 ? &representative[0] : nullptr, vertexCount, offsets, corners);
+        forChunks(threadPool, vertexCount, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int v = begin; v < end; ++v)
+            {
+                const unsigned int r = representative.size() > 0 ? representative[v] : v;
+                math::vec3 sum(0.0f);
+                for (unsigned int i = offsets[r]; i < offsets[r + 1]; ++i)
+                    sum = sum + contributions[corners[i]];
+                float length = math::length(sum);
+                normals[v] = length > 0.0f ? sum / length : math::vec3(0.0f, 1.0f, 0.0f);
+            }
+        });
+    }
+    // --------------------------------------------------------------------------------------------
+    void TangentSpace::GenerateTangents(const std::vector<math::vec3>& positions, const std::vector<math::vec2>& uv, const std::vector<math::vec3>& normals,
+                                        const std::vector<unsigned int>& triangles, std::vector<math::vec3>& tangents, std::vector<math::vec3>& bitangents,
+                                        ThreadPool* threadPool)
+    {
+        const unsigned int vertexCount = (unsigned int)positions.size();
+        const unsigned int faceCount   = (unsigned int)triangles.size() / 3;
+        tangents.resize(vertexCount);
+        bitangents.resize(vertexCount);
+
+        // per face: the unit direction of increasing u (flipped for faces w/ mirrored UVs, as
+        // in MikkTSpace) and whether its UVs preserve the orientation of the face.
+        struct FaceTangent
+        {
+            math::vec3 Tangent;
+            float      Sign; // 0.0 for faces w/ degenerate UVs
+        };
+        std::vector<FaceTangent> faces(faceCount);
+        forChunks(threadPool, faceCount, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int f = begin; f < end; ++f)
+            {
+                const unsigned int i0 = triangles[f * 3 + 0], i1 = triangles[f * 3 + 1], i2 = triangles[f * 3 + 2];
+                math::vec3 e1 = positions[i1] - positions[i0];
+                math::vec3 e2 = positions[i2] - positions[i0];
+                float du1 = uv[i1].x - uv[i0].x, dv1 = uv[i1].y - uv[i0].y;
+                float du2 = uv[i2].x - uv[i0].x, dv2 = uv[i2].y - uv[i0].y;
+                float signedArea = du1 * dv2 - du2 * dv1;
+                math::vec3 tangent = e1 * dv2 - e2 * dv1;
+                float length = math::length(tangent);
+                if (signedArea == 0.0f || length <= 0.0f)
+                {
+                    faces[f].Tangent = math::vec3(0.0f);
+                    faces[f].Sign    = 0.0f;
+                    continue;
+                }
+                faces[f].Sign    = signedArea > 0.0f ? 1.0f : -1.0f;
+                faces[f].Tangent = tangent * (faces[f].Sign / length);
+            }
+        });
+
+        // NOTE(Joey): as in MikkTSpace, vertices w/ identical position, normal and UV share
+        // their tangent frame; meshes imported w/o vertex welding (one vertex per face corner)
+        // thus still get smooth tangents (which also lets the vertex dedup merge them again).
+        std::vector<float> keys(vertexCount * 8);
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            float* key = &keys[v * 8];
+            key[0] = positions[v].x; key[1] = positions[v].y; key[2] = positions[v].z;
+            key[3] = normals[v].x;   key[4] = normals[v].y;   key[5] = normals[v].z;
+            key[6] = uv[v].x;        key[7] = uv[v].y;
+        }
+        std::vector<unsigned int> representative;
+        if (vertexCount > 0)
+            weldVertices(keys, 8, representative);
+
+        std::vector<unsigned int> offsets, corners;
+        buildCorners(triangles, representative.size() > 0 ? &representative[0] : nullptr, vertexCount, offsets, corners);
+        forChunks(threadPool, vertexCount, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int v = begin; v < end; ++v)
+            {
+                // the frame of a welded vertex is that of its representative
+                if (representative[v] != v)
+                    continue;
+                const math::vec3& n = normals[v];
+                // accumulate both UV orientations separately; the one w/ the most weight wins.
+                math::vec3 sum[2] = { math::vec3(0.0f), math::vec3(0.0f) };
+                float weight[2] = { 0.0f, 0.0f };
+                for (unsigned int i = offsets[v]; i < offsets[v + 1]; ++i)
+                {
+                    const unsigned int corner = corners[i];
+                    const FaceTangent& face = faces[corner / 3];
+                    if (face.Sign == 0.0f)
+                        continue;
+                    math::vec3 tangent = face.Tangent - n * math::dot(n, face.Tangent);
+                    float length = math::length(tangent);
+                    if (length <= 0.0f)
+                        continue;
+
+                    // the face's angle at this corner, measured in the vertex's tangent plane
+                    const unsigned int f = corner / 3, c = corner % 3;
+                    const math::vec3& p  = positions[triangles[corner]];
+                    math::vec3 a = positions[triangles[f * 3 + (c + 1) % 3]] - p;
+                    math::vec3 b = positions[triangles[f * 3 + (c + 2) % 3]] - p;
+                    float angle = angleBetween(a - n * math::dot(n, a), b - n * math::dot(n, b));
+
+                    const unsigned int side = face.Sign > 0.0f ? 0 : 1;
+                    sum[side]    = sum[side] + tangent * (angle / length);
+                    weight[side] += angle;
+                }
+                const unsigned int side = weight[0] >= weight[1] ? 0 : 1;
+                float length = math::length(sum[side]);
+                math::vec3 t = length > 0.0f ? sum[side] / length : orthogonal(n);
+                tangents[v]   = t;
+                bitangents[v] = math::cross(n, t) * (side == 0 ? 1.0f : -1.0f);
+            }
+        });
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            tangents[v]   = tangents[representative[v]];
+            bitangents[v] = bitangents[representative[v]];
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef CELL_MESH_TANGENT_SPACE_H
+#define CELL_MESH_TANGENT_SPACE_H
+
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+
+#include "mesh.h"
+
+class ThreadPool;
+
+namespace Cell
+{
+    /*
+
+      Generates per-vertex normals and tangent frames of triangle meshes. Per-face quantities
+      are computed in parallel, after which each vertex gathers the contributions of its own
+      faces (through a vertex to face-corner adjacency list) s.t. no two threads ever write to
+      the same vertex.
+
+      Normals are weighted by the angle of each face at the vertex, which (unlike area or
+      uniform weights) is independent of how the surface around the vertex is triangulated.
+      Tangents follow the MikkTSpace conventions (Mikkelsen 2008): the per-face tangent is the
+      direction of increasing u, projected onto the vertex's tangent plane and again weighted
+      by angle; only faces w/ the same UV orientation as the majority of the vertex's faces
+      contribute and the bitangent is reconstructed as sign * cross(normal, tangent), exactly
+      as the vertex shader decodes it. Unlike the reference implementation, vertices are never
+      split: a vertex that sits on a mirrored UV seam keeps the frame of its dominant side.
+
+    */
+    class TangentSpace
+    {
+    private:
+        // disallow creation of any TangentSpace object; it's defined as a static object
+        TangentSpace();
+    public:
+        // converts a mesh's (indexed or non-indexed) triangle topology to a triangle list,
+        // dropping the degenerate triangles of strips. Returns false for non-triangle topologies.
+        static bool Triangulate(TOPOLOGY topology, const std::vector<unsigned int>& indices, unsigned int vertexCount, std::vector<unsigned int>& triangles);
+
+        // angle weighted vertex normals. If weld is set, vertices that share a position (e.g.
+        // along a UV seam) share their normal as well.
+        static void GenerateNormals(const std::vector<math::vec3>& positions, const std::vector<unsigned int>& triangles, bool weld,
+                                    std::vector<math::vec3>& normals, ThreadPool* threadPool = nullptr);
+
+        // tangents and bitangents of unit length, orthogonal to the (given) normals.
+        static void GenerateTangents(const std::vector<math::vec3>& positions, const std::vector<math::vec2>& uv, const std::vector<math::vec3>& normals,
+                                     const std::vector<unsigned int>& triangles, std::vector<math::vec3>& tangents, std::vector<math::vec3>& bitangents,
+                                     ThreadPool* threadPool = nullptr);
+    };
+}
+#endif
@@ -40,7 +40,7 @@ namespace Cell
             a += step;
         }
 
-        // generate all the vertices, UVs, Normals (and Tangents/Bitangents):
+        // generate all the vertices, UVs and Normals (Tangents/Bitangents are derived from them):
         for (int i = 0; i <= numSteps1; ++i)
         {
             // the basis vectors of the ring equal the difference  vector between the minorRing 
@@ -92,6 +92,7 @@ namespace Cell
         }
 
         Topology = TRIANGLES;
+        CalculateTangents();
         Finalize();
     }
 }
\ No newline at end of file
@@ -19,10 +19,10 @@ namespace Cell
     // --------------------------------------------------------------------------------------------
     MaterialLibrary::~MaterialLibrary()
     {
-        for (auto it = m_DefaultMaterials.begin(); it != m_DefaultMaterials.end(); ++it)
+        m_DefaultMaterials.ForEach([](StringID id, Material* material)
         {
-            delete it->second;
-        }
+            delete material;
+        });
         for (unsigned int i = 0; i < m_Materials.size(); ++i)
         {
             delete m_Materials[i];
@@ -34,10 +34,10 @@ namespace Cell
     // --------------------------------------------------------------------------------------------
     Material* MaterialLibrary::CreateMaterial(std::string base)
     {
-        auto found = m_DefaultMaterials.find(SID(base));
-        if (found != m_DefaultMaterials.end())
+        Material** found = m_DefaultMaterials.Find(SID(base));
+        if (found)
         {
-            Material copy = found->second->Copy();
+            Material copy = (*found)->Copy();
             Material* mat = new Material(copy);
             m_Materials.push_back(mat); // TODO(Joey): a bit ugly for now, come up with a bettermemory management scheme for materials
             return mat;
@@ -75,7 +75,7 @@ namespace Cell
         defaultMat->SetTexture("TexNormal", Resources::LoadTexture("default normal", "textures/norm.png"), 4);
         defaultMat->SetTexture("TexMetallic", Resources::LoadTexture("default metallic", "textures/black.png"), 5);
         defaultMat->SetTexture("TexRoughness", Resources::LoadTexture("default roughness", "textures/checkerboard.png"), 6);
-        m_DefaultMaterials[SID("default")] = defaultMat;
+        m_DefaultMaterials.Insert("default"_sid, defaultMat);
         // glass material
         Shader* glassShader = Resources::LoadShader("glass", "shaders/forward_render.vs", "shaders/forward_render.fs", { "ALPHA_BLEND" });
         glassShader->Use();
@@ -91,7 +91,7 @@ namespace Cell
         glassMat->SetTexture("TexRoughness", Cell::Resources::LoadTexture("glass roughness", "textures/pbr/plastic/roughness.png"), 3);
         glassMat->SetTexture("TexAO", Cell::Resources::LoadTexture("glass ao", "textures/pbr/plastic/ao.png"), 4);
         glassMat->Blend = true;
-        m_DefaultMaterials[SID("glass")] = glassMat;
+        m_DefaultMaterials.Insert("glass"_sid, glassMat);
         // alpha blend material
         Shader* alphaBlendShader = Resources::LoadShader("alpha blend", "shaders/forward_render.vs", "shaders/forward_render.fs", { "ALPHA_BLEND" });
         alphaBlendShader->Use();
@@ -102,7 +102,7 @@ namespace Cell
         Material* alphaBlendMaterial = new Material(alphaBlendShader);
         alphaBlendMaterial->Type = MATERIAL_CUSTOM;
         alphaBlendMaterial->Blend = true;
-        m_DefaultMaterials[SID("alpha blend")] = alphaBlendMaterial;
+        m_DefaultMaterials.Insert("alpha blend"_sid, alphaBlendMaterial);
         // alpha cutout material
         Shader* alphaDiscardShader = Resources::LoadShader("alpha discard", "shaders/forward_render.vs", "shaders/forward_render.fs", { "ALPHA_DISCARD" });
         alphaDiscardShader->Use();
@@ -113,7 +113,7 @@ namespace Cell
         Material* alphaDiscardMaterial = new Material(alphaDiscardShader);
         alphaDiscardMaterial->Type = MATERIAL_CUSTOM;
         alphaDiscardMaterial->Cull = false;
-        m_DefaultMaterials[SID("alpha discard")] = alphaDiscardMaterial;
+        m_DefaultMaterials.Insert("alpha discard"_sid, alphaDiscardMaterial);
     }
     // --------------------------------------------------------------------------------------------
     void MaterialLibrary::generateInternalMaterials(RenderTarget *gBuffer)
@@ -124,7 +124,7 @@ namespace Cell
         
         // deferred
         deferredAmbientShader     = Cell::Resources::LoadShader("deferred ambient", "shaders/deferred/screen_ambient.vs", "shaders/deferred/ambient.fs");
-        deferredIrradianceShader  = Cell::Resources::LoadShader("deferred irradiance", "shaders/deferred/ambient_irradience.vs", "shaders/deferred/ambient_irradience.fs");
+        deferredIrradianceShader  = Cell::Resources::LoadShader("deferred irradiance", "shaders/deferred/screen_ambient.vs", "shaders/deferred/ambient_irradience.fs");
         deferredDirectionalShader = Cell::Resources::LoadShader("deferred directional", "shaders/deferred/screen_directional.vs", "shaders/deferred/directional.fs");
         deferredPointShader       = Cell::Resources::LoadShader("deferred point", "shaders/deferred/point.vs", "shaders/deferred/point.fs");
 
@@ -144,6 +144,7 @@ namespace Cell
         deferredIrradianceShader->SetInt("envPrefilter", 4);
         deferredIrradianceShader->SetInt("BRDFLUT", 5);
         deferredIrradianceShader->SetInt("TexSSAO", 6);
+        deferredIrradianceShader->SetInt("IrradianceVolume", 7);
         deferredDirectionalShader->Use();
         deferredDirectionalShader->SetInt("gPositionMetallic", 0);
         deferredDirectionalShader->SetInt("gNormalRoughness", 1);
@@ -1,8 +1,10 @@
 #ifndef CELL_MATERIAL_LIBRARY_H
 #define CELL_MATERIAL_LIBRARY_H
 
+#include <utility/string_id.h>
+#include <utility/container/flat_hash_map.h>
+
 #include <vector>
-#include <map>
 
 namespace Cell
 {
@@ -22,7 +24,7 @@ namespace Cell
         friend Renderer;
     private:
         // holds a list of default material templates that other materials can derive from
-        std::map<unsigned int, Material*> m_DefaultMaterials;
+        FlatHashMap<StringID, Material*> m_DefaultMaterials;
         // stores all generated/copied materials
         std::vector<Material*> m_Materials;
 
@@ -1,10 +1,12 @@
 #include "PBR.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "renderer.h"
 #include "render_target.h"
 #include "pbr_capture.h"
+#include "irradiance_volume.h"
 
 #include "../resources/resources.h"
 #include "../mesh/cube.h"
@@ -16,14 +18,75 @@
 #include "../shading/texture_cube.h"
 #include "../camera/camera.h"
 
+#include <utility/logging/log.h>
+#include <utility/io/mapped_file.h>
+
+#include <fstream>
+
 namespace Cell
 {
+    bool PBR::UseCache = true;
+
+    static const unsigned int BRDF_LUT_SIZE   = 128;
+    static const unsigned int IRRADIANCE_SIZE = 32;
+    static const unsigned int PREFILTER_SIZE  = 128;
+    static const unsigned int PREFILTER_MIPS  = 5;
+    // importance samples per prefilter mip: the roughness 0 mip is a copy of the environment
+    // and wider lobes need more samples; filtered importance sampling keeps these low.
+    static const unsigned int PREFILTER_SAMPLES[PREFILTER_MIPS] = { 1, 64, 128, 256, 512 };
+
+    /* NOTE(Joey):
+
+      Binary PBR cache layout; all sections are stored back to back, in this order:
+
+        CacheHeader
+        BRDF lookup table     (LUTSize^2 RG floats)
+        irradiance cubemap    (6 faces of IrradianceSize^2 RGB floats)
+        prefiltered cubemap   (per mip, 6 faces of (PrefilterSize >> mip)^2 RGB floats)
+
+      The cache is keyed by a hash of the HDR file's contents (rather than its modification
+      time), s.t. copied or re-exported but identical files still hit. Like the mesh cache
+      it's written and read on the same platform and isn't meant to be distributed.
+
+    */
+    static const u32 CACHE_MAGIC   = 0x504C4543; // "CELP"
+    static const u32 CACHE_VERSION = 1;
+    struct CacheHeader
+    {
+        u32 Magic;
+        u32 Version;
+        u64 SourceHash;
+        u64 SourceSize;
+        u32 LUTSize;
+        u32 IrradianceSize;
+        u32 PrefilterSize;
+        u32 PrefilterMips;
+    };
+    static u64 cacheSize(const CacheHeader& header)
+    {
+        u64 size = sizeof(CacheHeader) + (u64)header.LUTSize * header.LUTSize * 2 * sizeof(float);
+        size += 6ull * header.IrradianceSize * header.IrradianceSize * 3 * sizeof(float);
+        for (unsigned int mip = 0; mip < header.PrefilterMips; ++mip)
+            size += 6ull * (header.PrefilterSize >> mip) * (header.PrefilterSize >> mip) * 3 * sizeof(float);
+        return size;
+    }
+    // 64-bit FNV-1a
+    static u64 hashContent(const u8* data, u64 size)
+    {
+        u64 hash = 0xcbf29ce484222325ull;
+        for (u64 i = 0; i < size; ++i)
+            hash = (hash ^ data[i]) * 0x100000001b3ull;
+        return hash;
+    }
+
     // --------------------------------------------------------------------------------------------
     PBR::PBR(Renderer* renderer)
     {
         m_Renderer = renderer;
         
-        m_RenderTargetBRDFLUT = new RenderTarget(128, 128, GL_HALF_FLOAT, 1, true);
+        // - brdf integration (deferred until the first environment is processed, as it may be
+        //   cached w/ the environment)
+        m_RenderTargetBRDFLUT = new RenderTarget(BRDF_LUT_SIZE, BRDF_LUT_SIZE, GL_HALF_FLOAT, 1, true);
         Cell::Shader *hdrToCubemap      = Cell::Resources::LoadShader("pbr:hdr_to_cubemap", "shaders/pbr/cube_sample.vs", "shaders/pbr/spherical_to_cube.fs");
         Cell::Shader *irradianceCapture = Cell::Resources::LoadShader("pbr:irradiance", "shaders/pbr/cube_sample.vs", "shaders/pbr/irradiance_capture.fs");
         Cell::Shader *prefilterCapture  = Cell::Resources::LoadShader("pbr:prefilter", "shaders/pbr/cube_sample.vs", "shaders/pbr/prefilter_capture.fs");
@@ -44,9 +107,6 @@ namespace Cell
         m_SceneEnvCube->Mesh = m_PBRCaptureCube;
         m_SceneEnvCube->Material = m_PBRHdrToCubemap;
 
-        // - brdf integration
-        m_Renderer->Blit(nullptr, m_RenderTargetBRDFLUT, m_PBRIntegrateBRDF);
-
         // capture
         m_ProbeCaptureShader = Resources::LoadShader("pbr:capture", "shaders/capture.vs", "shaders/capture.fs");
         m_ProbeCaptureShader->Use();
@@ -58,11 +118,32 @@ namespace Cell
         m_ProbeCaptureBackgroundShader->Use();
         m_ProbeCaptureBackgroundShader->SetInt("background", 0);
 
+        // single pass (layered) variants of all cubemap rendering shaders; the sampler units
+        // set through materials only apply to the material's own shader, so they're set here.
+        const char* layered = "shaders/cube_layered.gs";
+        m_Renderer->setLayeredShader(hdrToCubemap,      Resources::LoadGeometryShader("pbr:hdr_to_cubemap layered", "shaders/pbr/cube_sample.vs", layered, "shaders/pbr/spherical_to_cube.fs", { "LAYERED" }));
+        m_Renderer->setLayeredShader(irradianceCapture, Resources::LoadGeometryShader("pbr:irradiance layered", "shaders/pbr/cube_sample.vs", layered, "shaders/pbr/irradiance_capture.fs", { "LAYERED" }));
+        m_Renderer->setLayeredShader(prefilterCapture,  Resources::LoadGeometryShader("pbr:prefilter layered", "shaders/pbr/cube_sample.vs", layered, "shaders/pbr/prefilter_capture.fs", { "LAYERED" }));
+        Shader* captureLayered = Resources::LoadGeometryShader("pbr:capture layered", "shaders/capture.vs", layered, "shaders/capture.fs", { "LAYERED", "CAPTURE" });
+        captureLayered->Use();
+        captureLayered->SetInt("TexAlbedo", 0);
+        captureLayered->SetInt("TexNormal", 1);
+        captureLayered->SetInt("TexMetallic", 2);
+        captureLayered->SetInt("TexRoughness", 3);
+        m_Renderer->setLayeredShader(m_ProbeCaptureShader, captureLayered);
+        Shader* captureBackgroundLayered = Resources::LoadGeometryShader("pbr:capture background layered", "shaders/capture_background.vs", layered, "shaders/capture_background.fs", { "LAYERED", "BACKGROUND" });
+        captureBackgroundLayered->Use();
+        captureBackgroundLayered->SetInt("background", 0);
+        m_Renderer->setLayeredShader(m_ProbeCaptureBackgroundShader, captureBackgroundLayered);
+
         // debug render
         m_ProbeDebugSphere = new Sphere(32, 32);
         m_ProbeDebugShader = Cell::Resources::LoadShader("pbr:probe_render", "shaders/pbr/probe_render.vs", "shaders/pbr/probe_render.fs");
         m_ProbeDebugShader->Use();
         m_ProbeDebugShader->SetInt("PrefilterMap", 0);
+        m_ProbeDebugSHShader = Cell::Resources::LoadShader("pbr:probe_render_sh", "shaders/pbr/probe_render.vs", "shaders/pbr/probe_render.fs", { "SH_PROBE" });
+
+        m_IrradianceVolume = new IrradianceVolume;
     }
     // --------------------------------------------------------------------------------------------
     PBR::~PBR()
@@ -75,13 +156,8 @@ namespace Cell
         delete m_PBRPrefilterCapture;
         delete m_PBRIntegrateBRDF;
         delete m_SkyCapture;
-        for (int i = 0; i < m_CaptureProbes.size(); ++i)
-        {
-            delete m_CaptureProbes[i]->Irradiance;
-            delete m_CaptureProbes[i]->Prefiltered;
-            delete m_CaptureProbes[i];
-        }
         delete m_ProbeDebugSphere;
+        delete m_IrradianceVolume;
     }
     // --------------------------------------------------------------------------------------------
     void PBR::SetSkyCapture(PBRCapture* capture)
@@ -89,22 +165,9 @@ namespace Cell
         m_SkyCapture = capture;
     }
     // --------------------------------------------------------------------------------------------
-    void PBR::AddIrradianceProbe(PBRCapture* capture, math::vec3 position, float radius)
-    {
-        capture->Position = position;
-        capture->Radius = radius;
-        m_CaptureProbes.push_back(capture);
-    }
-    // --------------------------------------------------------------------------------------------
     void PBR::ClearIrradianceProbes()
     {
-        for (int i = 0; i < m_CaptureProbes.size(); ++i)
-        {
-            delete m_CaptureProbes[i]->Irradiance;
-            delete m_CaptureProbes[i]->Prefiltered;
-            delete m_CaptureProbes[i];
-        }
-        m_CaptureProbes.clear();
+        m_IrradianceVolume->Clear();
     }
     // --------------------------------------------------------------------------------------------
     PBRCapture* PBR::ProcessEquirectangular(Texture* envMap)
@@ -113,65 +176,110 @@ namespace Cell
         m_SceneEnvCube->Material = m_PBRHdrToCubemap;
         m_PBRHdrToCubemap->SetTexture("environment", envMap, 0);
         Cell::TextureCube hdrEnvMap;
-        hdrEnvMap.DefaultInitialize(128, 128, GL_RGB, GL_FLOAT);
+        hdrEnvMap.DefaultInitialize(PREFILTER_SIZE, PREFILTER_SIZE, GL_RGB, GL_FLOAT);
         m_Renderer->renderToCubemap(m_SceneEnvCube, &hdrEnvMap);
 
-        return ProcessCube(&hdrEnvMap);
+        PBRCapture* capture = ProcessCube(&hdrEnvMap);
+        // the environment cubemap is only an intermediate
+        glDeleteTextures(1, &hdrEnvMap.ID);
+        return capture;
+    }
+    // --------------------------------------------------------------------------------------------
+    PBRCapture* PBR::ProcessEquirectangular(std::string name, std::string path)
+    {
+        u64 sourceHash = 0, sourceSize = 0;
+        MappedFile source;
+        bool cacheable = UseCache && source.Open(path);
+        if (cacheable)
+        {
+            sourceHash = hashContent(source.Data(), source.Size());
+            sourceSize = source.Size();
+            source.Close();
+            if (PBRCapture* capture = loadCache(path, sourceHash, sourceSize))
+                return capture;
+        }
+
+        PBRCapture* capture = ProcessEquirectangular(Resources::LoadHDR(name, path));
+        if (cacheable)
+            writeCache(path, sourceHash, sourceSize, capture);
+        return capture;
     }
     // --------------------------------------------------------------------------------------------
     PBRCapture* PBR::ProcessCube(TextureCube* capture, bool prefilter)
     {
+        bakeBRDFLUT();
+
         PBRCapture* captureProbe = new PBRCapture;
 
         // irradiance
         captureProbe->Irradiance = new TextureCube;
-        captureProbe->Irradiance->DefaultInitialize(32, 32, GL_RGB, GL_FLOAT);
+        captureProbe->Irradiance->DefaultInitialize(IRRADIANCE_SIZE, IRRADIANCE_SIZE, GL_RGB, GL_FLOAT);
         m_PBRIrradianceCapture->SetTextureCube("environment", capture, 0);
         m_SceneEnvCube->Material = m_PBRIrradianceCapture;
         m_Renderer->renderToCubemap(m_SceneEnvCube, captureProbe->Irradiance, math::vec3(0.0f), 0);
         // prefilter 
         if (prefilter)
         {
-            captureProbe->Prefiltered = new TextureCube;;
+            // filtered importance sampling reads the environment's mips (see prefilter_capture.fs)
+            capture->FilterMin  = GL_LINEAR_MIPMAP_LINEAR;
+            capture->Mipmapping = true;
+            capture->Bind();
+            glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+
+            captureProbe->Prefiltered = new TextureCube;
             captureProbe->Prefiltered->FilterMin = GL_LINEAR_MIPMAP_LINEAR;
-            captureProbe->Prefiltered->DefaultInitialize(128, 128, GL_RGB, GL_FLOAT, true);
+            captureProbe->Prefiltered->DefaultInitialize(PREFILTER_SIZE, PREFILTER_SIZE, GL_RGB, GL_FLOAT, true);
             m_PBRPrefilterCapture->SetTextureCube("environment", capture, 0);
+            m_PBRPrefilterCapture->SetFloat("resolution", (float)capture->FaceWidth);
             m_SceneEnvCube->Material = m_PBRPrefilterCapture;
             // calculate prefilter for multiple roughness levels
-            unsigned int maxMipLevels = 5;
-            for (unsigned int i = 0; i < maxMipLevels; ++i)
+            for (unsigned int i = 0; i < PREFILTER_MIPS; ++i)
             {
-                m_PBRPrefilterCapture->SetFloat("roughness", (float)i / (float)(maxMipLevels - 1));
+                m_PBRPrefilterCapture->SetFloat("roughness", (float)i / (float)(PREFILTER_MIPS - 1));
+                m_PBRPrefilterCapture->SetInt("SampleCount", PREFILTER_SAMPLES[i]);
                 m_Renderer->renderToCubemap(m_SceneEnvCube, captureProbe->Prefiltered, math::vec3(0.0f), i);
-
             }
         }
         return captureProbe;
     }
     // --------------------------------------------------------------------------------------------
+    math::sh9 PBR::ProjectIrradiance(const float* radiance, unsigned int size, float* validity)
+    {
+        const float* faces[6];
+        for (unsigned int f = 0; f < 6; ++f)
+            faces[f] = radiance + f * size * size * 4;
+
+        // NOTE(Joey): a probe outside geometry sees a few backfaces at most (of single sided
+        // or open meshes), one inside sees mostly backfaces. Fully valid below 10% backfacing
+        // texels, invalid above 30%.
+        if (validity)
+        {
+            float frontFacing = 0.0f;
+            for (unsigned int t = 0; t < 6 * size * size; ++t)
+                frontFacing += radiance[t * 4 + 3];
+            float backFacing = 1.0f - frontFacing / (6 * size * size);
+            *validity = std::min(std::max((0.3f - backFacing) / 0.2f, 0.0f), 1.0f);
+        }
+        return math::shConvolveLambert(math::shProjectCube(faces, size, 4));
+    }
+    // --------------------------------------------------------------------------------------------
     PBRCapture* PBR::GetSkyCapture()
     {
         return m_SkyCapture;
     }
     // --------------------------------------------------------------------------------------------
-    std::vector<PBRCapture*> PBR::GetIrradianceProbes(math::vec3 queryPos, float queryRadius)
+    IrradianceVolume* PBR::GetIrradianceVolume()
     {
-        // retrieve all irradiance probes in proximity to queryPos and queryRadius
-        std::vector<PBRCapture*> capturesProximity;
-        for (int i = 0; i < m_CaptureProbes.size(); ++i)
-        {
-            float lengthSq = math::lengthSquared((m_CaptureProbes[i]->Position - queryPos));
-            if (lengthSq < queryRadius*queryRadius)
-            {
-                m_CaptureProbes.push_back(m_CaptureProbes[i]);
-            }
-        }
-        // fall back to sky capture if no irradiance probe was found
-        if (!capturesProximity.size() == 0)
-        {
-            capturesProximity.push_back(m_SkyCapture);
-        }
-        return capturesProximity;
+        return m_IrradianceVolume;
+    }
+    // --------------------------------------------------------------------------------------------
+    std::vector<const IrradianceProbe*> PBR::GetIrradianceProbes(math::vec3 queryPos, float queryRadius)
+    {
+        // retrieve all irradiance probes in proximity to queryPos and queryRadius; an empty
+        // result means the sky capture is all there is. The probes are on a grid, s.t. only
+        // the grid cells around queryPos are visited.
+        return m_IrradianceVolume->Query(queryPos, queryRadius);
     }
     // --------------------------------------------------------------------------------------------
     void PBR::RenderProbes()
@@ -187,18 +295,129 @@ namespace Cell
         m_Renderer->renderMesh(m_ProbeDebugSphere, m_ProbeDebugShader);
 
         // then do the same for each capture probe (at their respective location)
-        for (int i = 0; i < m_CaptureProbes.size(); ++i)
+        m_ProbeDebugSHShader->Use();
+        m_ProbeDebugSHShader->SetMatrix("projection", m_Renderer->GetCamera()->Projection);
+        m_ProbeDebugSHShader->SetMatrix("view", m_Renderer->GetCamera()->View);
+        for (unsigned int i = 0; i < m_IrradianceVolume->GetProbeCount(); ++i)
         {
-            m_ProbeDebugShader->SetVector("Position", m_CaptureProbes[i]->Position);
-            if (m_CaptureProbes[i]->Prefiltered)
+            const IrradianceProbe& probe = m_IrradianceVolume->GetProbe(i);
+            if (probe.Validity <= 0.0f)
+                continue;
+            m_ProbeDebugSHShader->SetVector("Position", probe.Position);
+            m_ProbeDebugSHShader->SetVectorArray("ProbeSH", 9, std::vector<math::vec3>(probe.Irradiance.c, probe.Irradiance.c + 9));
+            m_Renderer->renderMesh(m_ProbeDebugSphere, m_ProbeDebugSHShader);
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    void PBR::bakeBRDFLUT()
+    {
+        if (m_BRDFLUTBaked)
+            return;
+        m_Renderer->Blit(nullptr, m_RenderTargetBRDFLUT, m_PBRIntegrateBRDF);
+        m_BRDFLUTBaked = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    PBRCapture* PBR::loadCache(std::string path, u64 sourceHash, u64 sourceSize)
+    {
+        MappedFile file;
+        if (!file.Open(path + ".cellpbr"))
+            return nullptr;
+
+        const u8* data = file.Data();
+        const CacheHeader* header = (const CacheHeader*)data;
+        if (file.Size() < sizeof(CacheHeader) || header->Magic != CACHE_MAGIC || header->Version != CACHE_VERSION ||
+            header->LUTSize != BRDF_LUT_SIZE || header->IrradianceSize != IRRADIANCE_SIZE || header->PrefilterSize != PREFILTER_SIZE ||
+            header->PrefilterMips != PREFILTER_MIPS || file.Size() != cacheSize(*header))
+        {
+            Log::Message("PBR cache of " + path + " is invalid or of an older version; re-processing.", LOG_WARNING);
+            return nullptr;
+        }
+        if (header->SourceHash != sourceHash || header->SourceSize != sourceSize)
+        {
+            Log::Message("PBR cache of " + path + " is out of date; re-processing.", LOG_INIT);
+            return nullptr;
+        }
+
+        // NOTE(Joey): all rows are a multiple of 4 bytes, s.t. the default unpack alignment
+        // holds.
+        const float* texels = (const float*)(data + sizeof(CacheHeader));
+        m_RenderTargetBRDFLUT->GetColorTexture(0)->Bind();
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BRDF_LUT_SIZE, BRDF_LUT_SIZE, GL_RG, GL_FLOAT, texels);
+        texels += BRDF_LUT_SIZE * BRDF_LUT_SIZE * 2;
+        m_BRDFLUTBaked = true;
+
+        PBRCapture* capture = new PBRCapture;
+        capture->Irradiance = new TextureCube;
+        capture->Irradiance->DefaultInitialize(IRRADIANCE_SIZE, IRRADIANCE_SIZE, GL_RGB, GL_FLOAT);
+        for (unsigned int face = 0; face < 6; ++face)
+        {
+            capture->Irradiance->SetMipFace(face, IRRADIANCE_SIZE, IRRADIANCE_SIZE, GL_RGB, GL_FLOAT, 0, (unsigned char*)texels);
+            texels += IRRADIANCE_SIZE * IRRADIANCE_SIZE * 3;
+        }
+        capture->Prefiltered = new TextureCube;
+        capture->Prefiltered->FilterMin = GL_LINEAR_MIPMAP_LINEAR;
+        capture->Prefiltered->DefaultInitialize(PREFILTER_SIZE, PREFILTER_SIZE, GL_RGB, GL_FLOAT, true);
+        for (unsigned int mip = 0; mip < PREFILTER_MIPS; ++mip)
+        {
+            const unsigned int size = PREFILTER_SIZE >> mip;
+            for (unsigned int face = 0; face < 6; ++face)
             {
-                m_CaptureProbes[i]->Prefiltered->Bind(0);
+                capture->Prefiltered->SetMipFace(face, size, size, GL_RGB, GL_FLOAT, mip, (unsigned char*)texels);
+                texels += size * size * 3;
             }
-            else
+        }
+
+        Log::Message("Loaded PBR cache of " + path + ".", LOG_INIT);
+        return capture;
+    }
+    // --------------------------------------------------------------------------------------------
+    void PBR::writeCache(std::string path, u64 sourceHash, u64 sourceSize, PBRCapture* capture)
+    {
+        if (!capture || !capture->Irradiance || !capture->Prefiltered)
+            return;
+
+        CacheHeader header;
+        header.Magic          = CACHE_MAGIC;
+        header.Version        = CACHE_VERSION;
+        header.SourceHash     = sourceHash;
+        header.SourceSize     = sourceSize;
+        header.LUTSize        = BRDF_LUT_SIZE;
+        header.IrradianceSize = IRRADIANCE_SIZE;
+        header.PrefilterSize  = PREFILTER_SIZE;
+        header.PrefilterMips  = PREFILTER_MIPS;
+
+        // read back all pre-computed data in cache order (this stalls, but only happens once)
+        std::vector<float> texels((cacheSize(header) - sizeof(CacheHeader)) / sizeof(float));
+        float* data = &texels[0];
+        m_RenderTargetBRDFLUT->GetColorTexture(0)->Bind();
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RG, GL_FLOAT, data);
+        data += BRDF_LUT_SIZE * BRDF_LUT_SIZE * 2;
+        capture->Irradiance->Bind();
+        for (unsigned int face = 0; face < 6; ++face)
+        {
+            glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB, GL_FLOAT, data);
+            data += IRRADIANCE_SIZE * IRRADIANCE_SIZE * 3;
+        }
+        capture->Prefiltered->Bind();
+        for (unsigned int mip = 0; mip < PREFILTER_MIPS; ++mip)
+        {
+            const unsigned int size = PREFILTER_SIZE >> mip;
+            for (unsigned int face = 0; face < 6; ++face)
             {
-                m_CaptureProbes[i]->Irradiance->Bind(0);
+                glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, GL_RGB, GL_FLOAT, data);
+                data += size * size * 3;
             }
-            m_Renderer->renderMesh(m_ProbeDebugSphere, m_ProbeDebugShader);
+        }
+
+        std::ofstream file(path + ".cellpbr", std::ios::binary | std::ios::trunc);
+        if (file)
+        {
+            file.write((const char*)&header, sizeof(CacheHeader));
+            file.write((const char*)&texels[0], texels.size() * sizeof(float));
+        }
+        if (!file)
+        {
+            Log::Message("Failed to write PBR cache for: " + path + ".", LOG_WARNING);
         }
     }
-}
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #ifndef CELL_PBR_H
 #define CELL_PBR_H
 
+#include <string>
 #include <vector>
 
 #include <math/linear_algebra/vector.h>
+#include <math/trigonometry/spherical_harmonics.h>
+#include <utility/std_types.h>
 
 namespace Cell
 {
@@ -14,9 +17,12 @@ namespace Cell
     class Texture;
     class TextureCube;
     class PBRCapture;
+    struct IrradianceProbe;
+    class IrradianceVolume;
     class SceneNode;
     class Shader;
     class PostProcessor;
+    class ProbeBaker;
 
     /*
 
@@ -24,17 +30,22 @@ namespace Cell
       pipeline. This includes (pre)processing (captured) reflection data (solving the render 
       equation integral) for use in later rendering. 
 
+      The pre-computed data of an HDR environment (its sky capture and the BRDF lookup table)
+      is cached on disk next to the HDR file, s.t. later runs skip the GPU pre-computation.
+
     */
     class PBR
     {
         friend Renderer;
         friend PostProcessor;
+        friend ProbeBaker;
     private:
         Renderer* m_Renderer;
 
-        std::vector<PBRCapture*> m_CaptureProbes;
-        PBRCapture*              m_SkyCapture;
-        RenderTarget*            m_RenderTargetBRDFLUT;
+        IrradianceVolume* m_IrradianceVolume;
+        PBRCapture*       m_SkyCapture;
+        RenderTarget*     m_RenderTargetBRDFLUT;
+        bool              m_BRDFLUTBaked = false;
 
         // pbr pre-processing (irradiance/pre-filter)
         Material* m_PBRHdrToCubemap;
@@ -51,6 +62,11 @@ namespace Cell
         // debug 
         Mesh*   m_ProbeDebugSphere;
         Shader* m_ProbeDebugShader;
+        Shader* m_ProbeDebugSHShader;
+
+    public:
+        // whether ProcessEquirectangular (by path) reads and writes its binary cache
+        static bool UseCache;
 
     public:
         PBR(Renderer* renderer);
@@ -58,22 +74,36 @@ namespace Cell
 
         // sets the combined irradiance/pre-filter global environment skylight 
         void SetSkyCapture(PBRCapture* capture);
-        // adds a processed PBR capture to the list of irradiance probes
-        void AddIrradianceProbe(PBRCapture* capture, math::vec3 position, float radius);
         // removes all irradiance probe entries from the global GI grid
         void ClearIrradianceProbes();
         // generate an irradiance and pre-filter map out of a 2D equirectangular map (preferably HDR)
         PBRCapture* ProcessEquirectangular(Texture* envMap);
+        // same as above from the HDR file at path (loaded as texture name), unless its results
+        // are cached: the cache is keyed by the HDR's contents.
+        PBRCapture* ProcessEquirectangular(std::string name, std::string path);
         // generate an irradiance and pre-filter map out of a cubemap texture
         PBRCapture* ProcessCube(TextureCube *capture, bool prefilter = true);
+        // projects a probe's captured radiance (6 faces of RGBA float texels, size^2 each, in
+        // cubemap face order) onto L2 spherical harmonics and convolves it to irradiance. Alpha
+        // marks the texels that saw front faces (or the sky); a probe seeing too many
+        // backfaces is inside geometry and gets a validity (0-1) of 0.
+        math::sh9 ProjectIrradiance(const float* radiance, unsigned int size, float* validity = nullptr);
         
         // retrieves the environment skylight 
         PBRCapture* GetSkyCapture();
-        // retrieve all pushed irradiance probes
-        std::vector<PBRCapture*> GetIrradianceProbes(math::vec3 queryPos, float queryRadius);
+        // retrieves the grid of irradiance probes
+        IrradianceVolume* GetIrradianceVolume();
+        // retrieve all irradiance probes within queryRadius of queryPos
+        std::vector<const IrradianceProbe*> GetIrradianceProbes(math::vec3 queryPos, float queryRadius);
 
         // renders all reflection/irradiance probes for visualization/debugging.
         void RenderProbes();
+    private:
+        // integrates the BRDF lookup table, unless it already is (or got loaded from cache)
+        void bakeBRDFLUT();
+
+        PBRCapture* loadCache(std::string path, u64 sourceHash, u64 sourceSize);
+        void        writeCache(std::string path, u64 sourceHash, u64 sourceSize, PBRCapture* capture);
     };
 }
 
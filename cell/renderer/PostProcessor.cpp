@@ -4,8 +4,6 @@
 #include "renderer.h"
 #include "PBR.h"
 
-#include <random>
-
 #include "../resources/resources.h"
 #include "../shading/texture.h"
 #include "../shading/shader.h"
@@ -14,9 +12,17 @@
 
 #include <math/common.h>
 #include <utility/logging/log.h>
+#include <utility/random/random.h>
+
+#include <algorithm>
+#include <cmath>
+#include <math.h>
 
 namespace Cell
 {
+    // the compute stages' (work group) tile size
+    static const unsigned int POST_TILE = 16;
+
     // --------------------------------------------------------------------------------------------
     PostProcessor::PostProcessor(Renderer* renderer)
     {
@@ -25,68 +31,40 @@ namespace Cell
             m_PostProcessShader = Cell::Resources::LoadShader("post process", "shaders/screen_quad.vs", "shaders/post_processing.fs");
             m_PostProcessShader->Use();
             m_PostProcessShader->SetInt("TexSrc", 0);
-            m_PostProcessShader->SetInt("TexBloom1", 1);
-            m_PostProcessShader->SetInt("TexBloom2", 2);
-            m_PostProcessShader->SetInt("TexBloom3", 3);
-            m_PostProcessShader->SetInt("TexBloom4", 4);
-            m_PostProcessShader->SetInt("gMotion", 5);
+            m_PostProcessShader->SetInt("TexBloom", 1);
+            m_PostProcessShader->SetInt("gMotion", 2);
         }
-        // down sample
+        // down sample pyramid, blurs and bloom
         {
-            m_DownSampleRTHalf      = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false); 
-            m_DownSampleRTQuarter   = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false); 
-            m_DownSampleRTEight     = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_DownSampleRTSixteenth = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            DownSampledHalfOutput      = m_DownSampleRTHalf->GetColorTexture(0);
-            DownSampledQuarterOutput   = m_DownSampleRTQuarter->GetColorTexture(0);
-            DownSampledEightOutput     = m_DownSampleRTEight->GetColorTexture(0);
-            DownSampledSixteenthOutput = m_DownSampleRTSixteenth->GetColorTexture(0);
-
-            m_DownSampleShader = Cell::Resources::LoadShader("down sample", "shaders/screen_quad.vs", "shaders/post/down_sample.fs");
+            m_DownSampleShader = Cell::Resources::LoadComputeShader("post downsample", "shaders/compute/post_downsample.cs");
             m_DownSampleShader->Use();
             m_DownSampleShader->SetInt("TexSrc", 0);
-        }
-        // lower resolution downsample blurs
-        {
-            m_DownSampleBlurRTEight     = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_DownSampleBlurRTSixteenth = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            BlurredEightOutput     = m_DownSampleBlurRTEight->GetColorTexture(0);
-            BlurredSixteenthOutput = m_DownSampleBlurRTSixteenth->GetColorTexture(0);
-        }
-        // gaussian blur shader
-        {
-            m_GaussianRTHalf_H      = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false); 
-            m_GaussianRTQuarter_H   = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false); 
-            m_GaussianRTEight_H     = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_GaussianRTSixteenth_H = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-
-            m_OnePassGaussianShader = Cell::Resources::LoadShader("gaussian blur", "shaders/screen_quad.vs", "shaders/post/blur_guassian.fs");
-            m_OnePassGaussianShader->Use();
-            m_OnePassGaussianShader->SetInt("TexSrc", 0);
+
+            m_BlurShader = Cell::Resources::LoadComputeShader("post blur", "shaders/compute/post_blur.cs");
+            m_BlurShader->Use();
+            m_BlurShader->SetInt("TexSrc", 0);
+            m_BlurShader->SetInt("TexCoarser", 1);
         }
         // ssao
         {
-            m_SSAORenderTarget = new RenderTarget(1280, 720, GL_HALF_FLOAT, 1, false);
-            SSAOOutput = m_SSAORenderTarget->GetColorTexture(0);
-
             m_SSAOShader = Cell::Resources::LoadShader("ssao", "shaders/screen_quad.vs", "shaders/post/ssao.fs");
             m_SSAOShader->Use();
             m_SSAOShader->SetInt("gPositionMetallic", 0);
             m_SSAOShader->SetInt("gNormalRoughness", 1);
             m_SSAOShader->SetInt("texNoise", 2);
 
-            std::uniform_real_distribution<float> randomFloats(0.0f, 1.0f);
-            std::default_random_engine generator;
+            // fixed seed: the kernel/noise should be identical between runs.
+            Random::Series series = Random::Seed(SSAOKernelSize);
             std::vector<math::vec3> ssaoKernel;
             for (int i = 0; i < SSAOKernelSize; ++i)
             {
                 math::vec3 sample(
-                    randomFloats(generator) * 2.0f - 1.0f,
-                    randomFloats(generator) * 2.0f - 1.0f,
-                    randomFloats(generator)
+                    Random::Biliteral(&series),
+                    Random::Biliteral(&series),
+                    Random::Uniliteral(&series)
                 );
                 sample = math::normalize(sample);
-                sample = sample * randomFloats(generator);
+                sample = sample * Random::Uniliteral(&series);
                 float scale = (float)i / (float)SSAOKernelSize;
                 scale = math::lerp(0.1f, 1.0f, scale * scale);
                 sample = sample * scale;
@@ -96,8 +74,8 @@ namespace Cell
             for (unsigned int i = 0; i < 16; i++)
             {
                 math::vec3 noise(
-                    randomFloats(generator) * 2.0 - 1.0,
-                    randomFloats(generator) * 2.0 - 1.0,
+                    Random::Biliteral(&series),
+                    Random::Biliteral(&series),
                     0.0f);
                 ssaoNoise.push_back(noise);
             }
@@ -105,218 +83,335 @@ namespace Cell
             m_SSAONoise->Generate(4, 4, GL_RGBA16F, GL_RGB, GL_HALF_FLOAT, &ssaoNoise[0]);
 
             m_SSAOShader->SetVectorArray("kernel", ssaoKernel.size(), ssaoKernel);
-            m_SSAOShader->SetInt("sampleCount", SSAOKernelSize);
+
+            m_SSAOTemporalShader = Cell::Resources::LoadShader("ssao temporal", "shaders/screen_quad.vs", "shaders/post/ssao_temporal.fs");
+            m_SSAOTemporalShader->Use();
+            m_SSAOTemporalShader->SetInt("TexSSAO", 0);
+            m_SSAOTemporalShader->SetInt("TexHistory", 1);
+            m_SSAOTemporalShader->SetInt("gMotion", 2);
+            m_SSAOTemporalShader->SetFloat("DepthTolerance", 0.05f);
+
+            m_SSAOUpsampleShader = Cell::Resources::LoadShader("ssao upsample", "shaders/screen_quad.vs", "shaders/post/ssao_upsample.fs");
+            m_SSAOUpsampleShader->Use();
+            m_SSAOUpsampleShader->SetInt("TexSSAO", 0);
+            m_SSAOUpsampleShader->SetInt("gPositionMetallic", 1);
+
+            // sized w/ the render size (see AddPreLightingPasses)
+            m_SSAOHistory[0] = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
+            m_SSAOHistory[1] = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
         }
-        // bloom 
+        // txaa
         {
-            m_BloomRenderTarget0 = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_BloomRenderTarget1 = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_BloomRenderTarget2 = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_BloomRenderTarget3 = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            m_BloomRenderTarget4 = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
-            BloomOutput1 = m_BloomRenderTarget1->GetColorTexture(0);
-            BloomOutput2 = m_BloomRenderTarget2->GetColorTexture(0);
-            BloomOutput3 = m_BloomRenderTarget3->GetColorTexture(0);
-            BloomOutput4 = m_BloomRenderTarget4->GetColorTexture(0);
-
-            m_BloomShader = Cell::Resources::LoadShader("bloom", "shaders/screen_quad.vs", "shaders/post/bloom.fs");
-            m_SSAOShader->Use();
-            m_SSAOShader->SetInt("HDRScene", 0);
-        }      
+            m_TXAAShader = Cell::Resources::LoadShader("txaa", "shaders/screen_quad.vs", "shaders/post/taa.fs");
+            m_TXAAShader->Use();
+            m_TXAAShader->SetInt("TexSrc", 0);
+            m_TXAAShader->SetInt("TexHistory", 1);
+            m_TXAAShader->SetInt("gMotion", 2);
+
+            // sized w/ the render size (see AddResolvePass)
+            m_TXAAHistory[0] = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
+            m_TXAAHistory[1] = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, false);
+        }
     }
     // --------------------------------------------------------------------------------------------
     PostProcessor::~PostProcessor()
     {
-        delete m_DownSampleRTHalf;
-        delete m_DownSampleRTQuarter;
-        delete m_DownSampleRTEight;
-        delete m_DownSampleRTSixteenth;
-        delete m_DownSampleBlurRTEight;
-        delete m_DownSampleBlurRTSixteenth;
-        delete m_GaussianRTHalf_H;
-        delete m_GaussianRTQuarter_H;
-        delete m_GaussianRTEight_H;
-        delete m_GaussianRTSixteenth_H;
         delete m_SSAONoise;
-        delete m_SSAORenderTarget;
-        delete m_BloomRenderTarget0;
-        delete m_BloomRenderTarget1;
-        delete m_BloomRenderTarget2;
-        delete m_BloomRenderTarget3;
-        delete m_BloomRenderTarget4;
+        delete m_SSAOHistory[0];
+        delete m_SSAOHistory[1];
+        delete m_TXAAHistory[0];
+        delete m_TXAAHistory[1];
     }
     // --------------------------------------------------------------------------------------------
-    void PostProcessor::UpdateRenderSize(unsigned int width, unsigned int height)
+    RenderGraph::Resource PostProcessor::AddPreLightingPasses(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource gBuffer, Camera* camera)
     {
-        // resize all buffers
-        m_DownSampleRTHalf->Resize((int)(width * 0.5f), (int)(height * 0.5f)); 
-        m_DownSampleRTQuarter->Resize((int)(width * 0.25f), (int)(height * 0.25f));
-        m_DownSampleRTEight->Resize((int)(width * 0.125f), (int)(height * 0.125f));
-        m_DownSampleRTSixteenth->Resize((int)(width * 0.0675f), (int)(height * 0.0675f));
-
-        m_DownSampleBlurRTEight->Resize((int)(width * 0.125f), (int)(height * 0.125f));
-        m_DownSampleBlurRTSixteenth->Resize((int)(width * 0.0675f), (int)(height * 0.0675f));
-
-        m_GaussianRTHalf_H->Resize((int)(width * 0.5f), (int)(height * 0.5f));
-        m_GaussianRTQuarter_H->Resize((int)(width * 0.25f), (int)(height * 0.25f));
-        m_GaussianRTEight_H->Resize((int)(width * 0.125f), (int)(height * 0.125f));
-        m_GaussianRTSixteenth_H->Resize((int)(width * 0.0675f), (int)(height * 0.0675f));
-
-        m_BloomRenderTarget0->Resize((int)(width * 0.5f), (int)(height * 0.5f));
-        m_BloomRenderTarget1->Resize((int)(width * 0.5f), (int)(height * 0.5f));
-        m_BloomRenderTarget2->Resize((int)(width * 0.25f), (int)(height * 0.25f));
-        m_BloomRenderTarget3->Resize((int)(width * 0.125f), (int)(height * 0.125f));
-        m_BloomRenderTarget4->Resize((int)(width * 0.0675f), (int)(height * 0.0675f));
-
-        m_SSAORenderTarget->Resize((int)(width * 0.5f), (int)(height * 0.5f));
-    }
-    // --------------------------------------------------------------------------------------------
-    void PostProcessor::ProcessPreLighting(Renderer* renderer, RenderTarget* gBuffer, Camera* camera)
-    {
-        // ssao
-        if (SSAO)
-        {
-            gBuffer->GetColorTexture(0)->Bind(0);
-            gBuffer->GetColorTexture(1)->Bind(1);
+        // ssao: (occlusion, view depth) at half resolution
+        RenderGraphTextureDesc desc;
+        desc.Width  = (unsigned int)(renderer->GetRenderSize().x * 0.5f);
+        desc.Height = (unsigned int)(renderer->GetRenderSize().y * 0.5f);
+        RenderGraph::Resource ssaoRaw = graph->Create("ssao (half)", desc);
+        // only the internal resolution's part of the targets is rendered to
+        const math::vec2 scale = renderer->GetInternalSize() / renderer->GetRenderSize();
+
+        const bool temporal = SSAOQuality != SSAO_QUALITY_HIGH;
+        const int  samples  = std::min(SSAOQuality == SSAO_QUALITY_LOW ? 4 : SSAOQuality == SSAO_QUALITY_MEDIUM ? 8 : SSAOKernelSize, SSAOKernelSize);
+        RenderGraph::Pass pass = graph->AddPass("ssao", [=]() {
+            m_Timers[POST_STAGE_SSAO].Begin();
+            renderer->m_GBuffer->GetColorTexture(0)->Bind(0);
+            renderer->m_GBuffer->GetColorTexture(1)->Bind(1);
             m_SSAONoise->Bind(2);
 
+            Texture* target = graph->GetTexture(ssaoRaw);
             m_SSAOShader->Use();
-            m_SSAOShader->SetVector("renderSize", renderer->GetRenderSize());
-            m_SSAOShader->SetMatrix("projection", camera->Projection);
+            m_SSAOShader->SetVector("renderSize", math::vec2((float)target->Width, (float)target->Height));
+            m_SSAOShader->SetVector("renderScale", scale);
+            m_SSAOShader->SetMatrix("projection", renderer->m_JitteredProjection);
             m_SSAOShader->SetMatrix("view", camera->View);
+            // temporal: a different (interleaved) part of the kernel and a different noise
+            // rotation (by the golden angle) each frame
+            const int   stride = SSAOKernelSize / samples;
+            const float angle  = temporal ? (float)m_SSAOFrame * 2.39996f : 0.0f;
+            m_SSAOShader->SetInt("sampleCount", samples);
+            m_SSAOShader->SetInt("kernelStride", stride);
+            m_SSAOShader->SetInt("kernelOffset", temporal ? m_SSAOFrame % stride : 0);
+            m_SSAOShader->SetVector("noiseRotation", math::vec2(cos(angle), sin(angle)));
+            ++m_SSAOFrame;
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_SSAORenderTarget->ID);
-            glViewport(0, 0, m_SSAORenderTarget->Width, m_SSAORenderTarget->Height);
+            glBindFramebuffer(GL_FRAMEBUFFER, graph->GetFramebuffer(ssaoRaw));
+            glViewport(0, 0, std::ceil(target->Width * scale.x), std::ceil(target->Height * scale.y));
             glClear(GL_COLOR_BUFFER_BIT);
             renderer->renderMesh(renderer->m_NDCPlane, m_SSAOShader);
+        });
+        graph->Read(pass, gBuffer);
+        graph->Write(pass, ssaoRaw);
+
+        // temporal accumulation; reprojected w/ the G-buffer's motion vectors
+        RenderGraph::Resource ssaoHalf = ssaoRaw;
+        if (SSAO && temporal)
+        {
+            if (m_SSAOHistory[0]->Width != desc.Width || m_SSAOHistory[0]->Height != desc.Height)
+            {
+                m_SSAOHistory[0]->Resize(desc.Width, desc.Height);
+                m_SSAOHistory[1]->Resize(desc.Width, desc.Height);
+                m_SSAOHistoryValid = false;
+            }
+            RenderTarget* history = m_SSAOHistory[m_SSAOHistoryIndex ^ 1];
+            RenderTarget* output  = m_SSAOHistory[m_SSAOHistoryIndex];
+            RenderGraph::Resource previous = graph->Import("ssao history", history->GetColorTexture(0));
+            ssaoHalf = graph->Import("ssao accumulated", output->GetColorTexture(0));
+
+            pass = graph->AddPass("ssao temporal", [=]() {
+                graph->GetTexture(ssaoRaw)->Bind(0);
+                history->GetColorTexture(0)->Bind(1);
+                renderer->m_GBuffer->GetColorTexture(3)->Bind(2);
+
+                m_SSAOTemporalShader->Use();
+                m_SSAOTemporalShader->SetBool("HistoryValid", m_SSAOHistoryValid);
+                m_SSAOTemporalShader->SetFloat("HistoryFrames", 2.0f * SSAOKernelSize / samples);
+                m_SSAOTemporalShader->SetVector("renderScale", scale);
+                m_SSAOTemporalShader->SetVector("HistoryScale", m_SSAOHistoryScale);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, output->ID);
+                glViewport(0, 0, std::ceil(output->Width * scale.x), std::ceil(output->Height * scale.y));
+                renderer->renderMesh(renderer->m_NDCPlane, m_SSAOTemporalShader);
+
+                m_SSAOHistoryValid = true;
+                m_SSAOHistoryScale = scale;
+                m_SSAOHistoryIndex ^= 1;
+            });
+            graph->Read(pass, ssaoRaw);
+            graph->Read(pass, previous);
+            graph->Read(pass, gBuffer);
+            graph->Write(pass, ssaoHalf);
+        }
+        else
+        {
+            // the history is outdated once SSAO stopped accumulating
+            m_SSAOHistoryValid = false;
         }
+
+        // bilateral upsample to full resolution
+        desc.Width          = (unsigned int)renderer->GetRenderSize().x;
+        desc.Height         = (unsigned int)renderer->GetRenderSize().y;
+        desc.InternalFormat = GL_R8;
+        desc.Format         = GL_RED;
+        desc.Type           = GL_UNSIGNED_BYTE;
+        RenderGraph::Resource ssao = graph->Create("ssao", desc);
+        pass = graph->AddPass("ssao upsample", [=]() {
+            graph->GetTexture(ssaoHalf)->Bind(0);
+            renderer->m_GBuffer->GetColorTexture(0)->Bind(1);
+
+            m_SSAOUpsampleShader->Use();
+            m_SSAOUpsampleShader->SetMatrix("view", camera->View);
+            m_SSAOUpsampleShader->SetVector("renderScale", scale);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, graph->GetFramebuffer(ssao));
+            glViewport(0, 0, renderer->GetInternalSize().x, renderer->GetInternalSize().y);
+            renderer->renderMesh(renderer->m_NDCPlane, m_SSAOUpsampleShader);
+            m_Timers[POST_STAGE_SSAO].End();
+        });
+        graph->Read(pass, ssaoHalf);
+        graph->Read(pass, gBuffer);
+        graph->Write(pass, ssao);
+        return ssao;
     }
     // --------------------------------------------------------------------------------------------
-    void PostProcessor::ProcessPostLighting(Renderer* renderer, RenderTarget* gBuffer, RenderTarget* output, Camera* camera)
+    RenderGraph::Resource PostProcessor::AddResolvePass(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource scene, RenderGraph::Resource gBuffer)
     {
-        // downsample
+        if (!TXAA)
+        {
+            // the history is outdated once TXAA stopped accumulating
+            m_TXAAHistoryValid = false;
+            return scene;
+        }
+
+        const unsigned int width  = (unsigned int)renderer->GetRenderSize().x;
+        const unsigned int height = (unsigned int)renderer->GetRenderSize().y;
+        if (m_TXAAHistory[0]->Width != width || m_TXAAHistory[0]->Height != height)
         {
-            downsample(renderer, output->GetColorTexture(0), m_DownSampleRTHalf);
-            downsample(renderer, DownSampledHalfOutput,      m_DownSampleRTQuarter);
-            downsample(renderer, DownSampledQuarterOutput,  m_DownSampleRTEight);
-            downsample(renderer, DownSampledEightOutput,    m_DownSampleRTSixteenth);
+            m_TXAAHistory[0]->Resize(width, height);
+            m_TXAAHistory[1]->Resize(width, height);
+            m_TXAAHistoryValid = false;
         }
-        // blur (only lower resolution) down-sampled textures (for glass refraction/ssr-glossy)
+        RenderTarget* history = m_TXAAHistory[m_TXAAHistoryIndex ^ 1];
+        RenderTarget* output  = m_TXAAHistory[m_TXAAHistoryIndex];
+        RenderGraph::Resource previous = graph->Import("txaa history", history->GetColorTexture(0));
+        RenderGraph::Resource resolved = graph->Import("txaa", output->GetColorTexture(0));
+
+        RenderGraph::Pass pass = graph->AddPass("txaa", [=]() {
+            m_Timers[POST_STAGE_TXAA].Begin();
+            graph->GetTexture(scene)->Bind(0);
+            history->GetColorTexture(0)->Bind(1);
+            renderer->m_GBuffer->GetColorTexture(3)->Bind(2);
+
+            m_TXAAShader->Use();
+            m_TXAAShader->SetBool("HistoryValid", m_TXAAHistoryValid);
+            m_TXAAShader->SetFloat("Feedback", TXAAFeedback);
+            m_TXAAShader->SetFloat("ClampGamma", TXAAClampGamma);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, output->ID);
+            glViewport(0, 0, output->Width, output->Height);
+            renderer->renderMesh(renderer->m_NDCPlane, m_TXAAShader);
+            m_Timers[POST_STAGE_TXAA].End();
+
+            m_TXAAHistoryValid = true;
+            m_TXAAHistoryIndex ^= 1;
+        });
+        graph->Read(pass, scene);
+        graph->Read(pass, previous);
+        graph->Read(pass, gBuffer);
+        graph->Write(pass, resolved);
+        return resolved;
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::Resource PostProcessor::AddPostLightingPasses(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource scene)
+    {
+        // the pyramid's levels, the blurred (lower resolution) levels and the bloom per level
+        RenderGraph::Resource pyramid[PYRAMID_LEVELS], blurred[2], bloom[PYRAMID_LEVELS];
+        const char* levelNames[PYRAMID_LEVELS] = { "1/2", "1/4", "1/8", "1/16" };
+        for (unsigned int i = 0; i < PYRAMID_LEVELS; ++i)
         {
-            blur(renderer, DownSampledEightOutput,     m_DownSampleBlurRTEight,     4);
-            blur(renderer, DownSampledSixteenthOutput, m_DownSampleBlurRTSixteenth, 4);
+            // each level is exactly half its predecessor
+            RenderGraphTextureDesc desc;
+            desc.Width  = (unsigned int)renderer->GetRenderSize().x >> (i + 1);
+            desc.Height = (unsigned int)renderer->GetRenderSize().y >> (i + 1);
+            pyramid[i] = graph->Create(std::string("downsample ") + levelNames[i], desc);
+            bloom[i]   = graph->Create(std::string("bloom ") + levelNames[i], desc);
+            if (i >= 2)
+                blurred[i - 2] = graph->Create(std::string("blurred ") + levelNames[i], desc);
         }
-        // bloom
-        if (Bloom)
+
+        // downsample: all pyramid levels in a single dispatch, a 16x16 tile of the first level
+        // per work group.
+        RenderGraph::Pass pass = graph->AddPass("downsample", [=]() {
+            m_Timers[POST_STAGE_DOWNSAMPLE].Begin();
+            graph->GetTexture(scene)->Bind(0);
+            for (unsigned int i = 0; i < PYRAMID_LEVELS; ++i)
+                glBindImageTexture(i, graph->GetTexture(pyramid[i])->ID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+            Texture* level0 = graph->GetTexture(pyramid[0]);
+            m_DownSampleShader->Use();
+            m_DownSampleShader->Dispatch((level0->Width + POST_TILE - 1) / POST_TILE, (level0->Height + POST_TILE - 1) / POST_TILE);
+            m_Timers[POST_STAGE_DOWNSAMPLE].End();
+        });
+        graph->Read(pass, scene);
+        for (unsigned int i = 0; i < PYRAMID_LEVELS; ++i)
+            graph->Write(pass, pyramid[i], RenderGraph::ACCESS_IMAGE);
+
+        // blur (only lower resolution) down-sampled textures (for glass refraction/ssr-glossy);
+        // culled unless a pass reads them.
+        pass = graph->AddPass("blur", [=]() {
+            m_Timers[POST_STAGE_BLUR].Begin();
+            for (unsigned int i = 0; i < 2; ++i)
+                blur(graph->GetTexture(pyramid[i + 2]), graph->GetTexture(blurred[i]), 1.0f);
+            m_Timers[POST_STAGE_BLUR].End();
+        });
+        for (unsigned int i = 0; i < 2; ++i)
         {
-            m_BloomShader->Use();
-            output->GetColorTexture(0)->Bind(0);
+            graph->Read(pass, pyramid[i + 2]);
+            graph->Write(pass, blurred[i], RenderGraph::ACCESS_IMAGE);
+        }
 
-            glBindFramebuffer(GL_FRAMEBUFFER, m_BloomRenderTarget0->ID);
-            glViewport(0, 0, m_BloomRenderTarget0->Width, m_BloomRenderTarget0->Height);
-            glClear(GL_COLOR_BUFFER_BIT);
-            renderer->renderMesh(renderer->m_NDCPlane, m_BloomShader);
-
-            // blur bloom result
-            blur(renderer, m_BloomRenderTarget0->GetColorTexture(0), m_BloomRenderTarget1, 8);
-            blur(renderer, m_BloomRenderTarget1->GetColorTexture(0), m_BloomRenderTarget2, 8);
-            blur(renderer, m_BloomRenderTarget2->GetColorTexture(0), m_BloomRenderTarget3, 8);
-            blur(renderer, m_BloomRenderTarget3->GetColorTexture(0), m_BloomRenderTarget4, 8);
-        }       
+        /* NOTE(Joey):
+
+          Usually we render the bloom effect above a certain threshold (like all pixels that
+          have a luminence of >= 1.0 are considered part of the bloom effect). This is
+          physically inaccurate as bloom is meant to model inaccuracies of the human eye
+          lens, where some percentange of light is diffused into blurry shapes.
+
+          Since we render in an HDR render pipeline (w/ a proper tonemapping pass at the end)
+          we can allow all light to pass through the 'fake' lens: scene objects averaging a
+          brightness of around 1.0 contribute only 0.1 to the bloom output while a light of
+          intensity 1000.0 adds 100.0, keeping the relative glow we're used to.
+
+          Each level is weighted as the separate bloom textures used to be in the composite
+          pass (0.5 strength, falling off w/ 1.0, 0.75, 0.5 and 0.25 per level), and
+          accumulated from the coarsest level up s.t. the finest holds the full bloom.
+
+        */
+        const float weights[PYRAMID_LEVELS] = { 1.0f, 0.75f, 0.5f, 0.25f };
+        for (int i = PYRAMID_LEVELS - 1; i >= 0; --i)
+        {
+            const bool coarsest = i == PYRAMID_LEVELS - 1;
+            pass = graph->AddPass(std::string("bloom ") + levelNames[i], [=]() {
+                if (coarsest)
+                    m_Timers[POST_STAGE_BLOOM].Begin();
+                blur(graph->GetTexture(pyramid[i]), graph->GetTexture(bloom[i]), 0.1f * 0.5f * weights[i], coarsest ? nullptr : graph->GetTexture(bloom[i + 1]));
+                if (i == 0)
+                    m_Timers[POST_STAGE_BLOOM].End();
+            });
+            graph->Read(pass, pyramid[i]);
+            if (!coarsest)
+                graph->Read(pass, bloom[i + 1]);
+            graph->Write(pass, bloom[i], RenderGraph::ACCESS_IMAGE);
+        }
+        return bloom[0];
     }
     // --------------------------------------------------------------------------------------------
-    void PostProcessor::Blit(Renderer* renderer, Texture* source)
+    void PostProcessor::Blit(Renderer* renderer, Texture* source, Texture* bloom)
     {
+        m_Timers[POST_STAGE_COMPOSITE].Begin();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, renderer->GetRenderSize().x, renderer->GetRenderSize().y);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
         // bind input texture data
         source->Bind(0);
-        BloomOutput1->Bind(1);
-        BloomOutput2->Bind(2);
-        BloomOutput3->Bind(3);
-        BloomOutput4->Bind(4);
-        renderer->m_GBuffer->GetColorTexture(3)->Bind(5);
+        if (bloom)
+            bloom->Bind(1);
+        renderer->m_GBuffer->GetColorTexture(3)->Bind(2);
 
         // set settings 
         m_PostProcessShader->Use();
         m_PostProcessShader->SetBool("SSAO", SSAO);
         m_PostProcessShader->SetBool("Sepia", Sepia);
         m_PostProcessShader->SetBool("Vignette", Vignette);
-        m_PostProcessShader->SetBool("Bloom", Bloom);
+        m_PostProcessShader->SetBool("Bloom", bloom != nullptr);
         // motion blur
         m_PostProcessShader->SetBool("MotionBlur", MotionBlur);
         m_PostProcessShader->SetFloat("MotionScale", ImGui::GetIO().Framerate / FPSTarget * 0.8);
         m_PostProcessShader->SetInt("MotionSamples", 16);
 
         renderer->renderMesh(renderer->m_NDCPlane, m_PostProcessShader);               
+        m_Timers[POST_STAGE_COMPOSITE].End();
     }
     // --------------------------------------------------------------------------------------------
-    Texture* PostProcessor::downsample(Renderer* renderer, Texture* src, RenderTarget* dst)
-    {     
-        glViewport(0, 0, dst->Width, dst->Height);
-        glBindFramebuffer(GL_FRAMEBUFFER, dst->ID);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        src->Bind(0);
-        m_DownSampleShader->Use();
-        renderer->renderMesh(renderer->m_NDCPlane, m_DownSampleShader);
-
-        // output resulting (downsampled) texture
-        return dst->GetColorTexture(0);
+    float PostProcessor::GetGPUTime(POST_STAGE stage) const
+    {
+        if ((stage == POST_STAGE_SSAO && !SSAO) || (stage == POST_STAGE_TXAA && !TXAA) || (stage == POST_STAGE_BLOOM && !Bloom))
+            return 0.0f;
+        return m_Timers[stage].GetTime();
     }
     // --------------------------------------------------------------------------------------------
-    Texture* PostProcessor::blur(Renderer* renderer, Texture* src, RenderTarget* dst, int count)
+    void PostProcessor::blur(Texture* src, Texture* dst, float weight, Texture* coarser)
     {
-        assert(count >= 2 && count % 2 == 0); // count must be more than 2 and be even    
-
-        // pick pre-defined render targets for blur based on render size
-        RenderTarget *rtHorizontal;
-        RenderTarget *rtVertical;
-        if (dst->Width == m_GaussianRTHalf_H->Width)
-        {
-            rtHorizontal = m_GaussianRTHalf_H;
-        } 
-        else if (dst->Width == m_GaussianRTQuarter_H->Width)
-        {
-            rtHorizontal = m_GaussianRTQuarter_H;
-        } 
-        else if (dst->Width == m_GaussianRTEight_H->Width)
-        {
-            rtHorizontal = m_GaussianRTEight_H;
-        }
-        else 
-        {
-            rtHorizontal = m_GaussianRTSixteenth_H;
-        }
-        // use destination as vertical render target of ping-pong algorithm
-        rtVertical = dst; 
-        // resize viewport to destination dimensions
-        glViewport(0, 0, dst->Width, dst->Height);
-
-        bool horizontal = true;
-        m_OnePassGaussianShader->Use();
-        for (int i = 0; i < count; ++i, horizontal = !horizontal)
-        {
-            m_OnePassGaussianShader->SetBool("horizontal", horizontal);
-            if (i == 0)
-            {
-                src->Bind(0);
-            } 
-            else if(horizontal)
-            {
-                rtVertical->GetColorTexture(0)->Bind(0);
-            }
-            else if (!horizontal)
-            {
-                rtHorizontal->GetColorTexture(0)->Bind(0);
-            }
-            glBindFramebuffer(GL_FRAMEBUFFER, horizontal ? rtHorizontal->ID : rtVertical->ID);
-            renderer->renderMesh(renderer->m_NDCPlane, m_OnePassGaussianShader);
-        }
+        src->Bind(0);
+        if (coarser)
+            coarser->Bind(1);
+        glBindImageTexture(0, dst->ID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
 
-        // output resulting (blurred) texture
-        return dst->GetColorTexture(0);
+        m_BlurShader->Use();
+        m_BlurShader->SetFloat("Weight", weight);
+        m_BlurShader->SetBool("Accumulate", coarser != nullptr);
+        m_BlurShader->Dispatch((dst->Width + POST_TILE - 1) / POST_TILE, (dst->Height + POST_TILE - 1) / POST_TILE);
     }
 }
\ No newline at end of file
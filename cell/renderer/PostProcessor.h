@@ -6,6 +6,9 @@
 #include <math/linear_algebra/vector.h>
 #include <math/linear_algebra/matrix.h>
 
+#include "gpu_timer.h"
+#include "render_graph.h"
+
 namespace Cell
 {
     class Texture;
@@ -19,25 +22,47 @@ namespace Cell
       Manages and maintains all data and functionality related to end-of-frame post-processing. 
       This doesn't only include post-processing effects like SSAO, Bloom, Vignette, but also 
       includes general functionality like blitting, blurring, HDR and gammac-orrection. 
-      The post-processor's multi-pass effects support multiple resolutions and adjusts accordingly 
-      when a resolution change occurs.
+      The post-processor's multi-pass effects are declared as passes of the renderer's render
+      graph each frame, w/ transient targets sized to the current render size; passes of
+      disabled effects are culled and their targets never allocated.
+
+      The lit scene is downsampled into a pyramid of 4 levels (1/2 to 1/16th resolution) by a
+      single compute dispatch and blurred by a compute shader that keeps its separable passes
+      in shared memory. Bloom re-uses the pyramid: each level is blurred and accumulated w/ the
+      (upsampled) bloom of the level below it, s.t. the composite pass samples a single texture.
+
+      TXAA resolves the jittered frame (see Renderer::updateRenderScale) against the history
+      of the previous frames, reprojected w/ the G-buffer's motion vectors and clamped to the
+      current frame's neighbourhood. It resolves at the render size, s.t. it also upscales the
+      frame when rendered at a lower internal resolution (dynamic resolution); all passes
+      before it only render to the internal resolution's part of their targets.
+
+      Each stage is timed on the GPU (see GetGPUTime).
 
     */
     class PostProcessor
     {
     public:
-        // resulting post-processor intermediate outputs
-        Texture* DownSampledHalfOutput;
-        Texture* DownSampledQuarterOutput;
-        Texture* DownSampledEightOutput;
-        Texture* DownSampledSixteenthOutput;
-        Texture* BlurredEightOutput;
-        Texture* BlurredSixteenthOutput;
-        Texture* SSAOOutput;
-        Texture* BloomOutput1;
-        Texture* BloomOutput2;
-        Texture* BloomOutput3;
-        Texture* BloomOutput4;
+        // the timed (GPU) stages
+        enum POST_STAGE
+        {
+            POST_STAGE_SSAO,
+            POST_STAGE_TXAA,
+            POST_STAGE_DOWNSAMPLE,
+            POST_STAGE_BLUR,
+            POST_STAGE_BLOOM,
+            POST_STAGE_COMPOSITE,
+            POST_STAGE_COUNT,
+        };
+        // SSAO's quality/cost: the low and medium qualities sample a (rotated) part of the
+        // kernel each frame and accumulate the result over time, high samples the full kernel
+        // each frame.
+        enum SSAO_QUALITY
+        {
+            SSAO_QUALITY_LOW,    // 4 samples per frame, temporal
+            SSAO_QUALITY_MEDIUM, // 8 samples per frame, temporal
+            SSAO_QUALITY_HIGH,   // all SSAOKernelSize samples per frame
+        };
 
         // toggles
         bool Sepia      = false;
@@ -48,7 +73,13 @@ namespace Cell
         bool MotionBlur = true;
 
         // ssao
-        int SSAOKernelSize = 32;      
+        int          SSAOKernelSize = 32;      
+        SSAO_QUALITY SSAOQuality    = SSAO_QUALITY_MEDIUM;
+
+        // txaa; the weight of the current frame and the extent of the neighbourhood clamping
+        // the history (in standard deviations)
+        float TXAAFeedback   = 0.1f;
+        float TXAAClampGamma = 1.25f;
 
         // motion-blur
         float FPSTarget = 60.0;
@@ -57,51 +88,50 @@ namespace Cell
         Shader*       m_PostProcessShader;
         RenderTarget* m_RTOutput;
 
-        // ssao
-        RenderTarget* m_SSAORenderTarget;
+        // ssao; computed at half resolution, (optionally) accumulated into the history and
+        // upsampled to full resolution w/ a depth aware (bilateral) filter.
         Shader*       m_SSAOShader;
         Shader*       m_SSAOBlurShader;
+        Shader*       m_SSAOTemporalShader;
+        Shader*       m_SSAOUpsampleShader;
         Texture*      m_SSAONoise;
-        // bloom
-        RenderTarget* m_BloomRenderTarget0;
-        RenderTarget* m_BloomRenderTarget1;
-        RenderTarget* m_BloomRenderTarget2;
-        RenderTarget* m_BloomRenderTarget3;
-        RenderTarget* m_BloomRenderTarget4;
-        Shader*       m_BloomShader;
-        Shader*       m_BloomBlurShader;
-        // downsample
-        RenderTarget* m_DownSampleRTHalf;
-        RenderTarget* m_DownSampleRTQuarter;
-        RenderTarget* m_DownSampleRTEight;
-        RenderTarget* m_DownSampleRTSixteenth;
-        Shader*       m_DownSampleShader;
-        // (lower resolution) downsampled blurs
-        RenderTarget* m_DownSampleBlurRTEight;
-        RenderTarget* m_DownSampleBlurRTSixteenth;
-        // blur
-        RenderTarget* m_GaussianRTHalf_H; 
-        RenderTarget* m_GaussianRTQuarter_H;
-        RenderTarget* m_GaussianRTEight_H;
-        RenderTarget* m_GaussianRTSixteenth_H;
-        Shader*       m_OnePassGaussianShader;
+        RenderTarget* m_SSAOHistory[2];
+        unsigned int  m_SSAOHistoryIndex = 0; // the history written this frame
+        bool          m_SSAOHistoryValid = false;
+        unsigned int  m_SSAOFrame        = 0;
+        math::vec2    m_SSAOHistoryScale = math::vec2(1.0f); // the render scale it was written at
+        // txaa; resolved at the render size into the history of the next frame
+        Shader*       m_TXAAShader;
+        RenderTarget* m_TXAAHistory[2];
+        unsigned int  m_TXAAHistoryIndex = 0; // the history written this frame
+        bool          m_TXAAHistoryValid = false;
+        // downsample pyramid: 1/2, 1/4, 1/8 and 1/16th resolution
+        static const unsigned int PYRAMID_LEVELS = 4;
+        Shader*  m_DownSampleShader;
+        // blur; of the (lower resolution) pyramid levels and the bloom per pyramid level
+        Shader*  m_BlurShader;
+
+        GPUTimer m_Timers[POST_STAGE_COUNT];
     public:
         PostProcessor(Renderer* renderer);
         ~PostProcessor();
 
-        // updates all render targets to match new render size
-        void UpdateRenderSize(unsigned int width, unsigned int height);
+        // process stages; declare their passes on graph and return their result: the SSAO
+        // (from the GBuffer) and the accumulated bloom (from the lit scene).
+        RenderGraph::Resource AddPreLightingPasses(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource gBuffer, Camera* camera);
+        // the TXAA resolve of the lit scene (at the render size); the scene itself if disabled
+        RenderGraph::Resource AddResolvePass(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource scene, RenderGraph::Resource gBuffer);
+        RenderGraph::Resource AddPostLightingPasses(RenderGraph* graph, Renderer* renderer, RenderGraph::Resource scene);
 
-        // process stages
-        void ProcessPreLighting(Renderer* renderer, RenderTarget* gBuffer, Camera *camera);
-        void ProcessPostLighting(Renderer* renderer, RenderTarget* gBuffer, RenderTarget* output, Camera *camera);
+        // blit all combined post-processing steps to default framebuffer (w/ bloom, if set)
+        void Blit(Renderer* renderer, Texture* source, Texture* bloom);
 
-        // blit all combined post-processing steps to default framebuffer
-        void Blit(Renderer* renderer, Texture* soruce);
+        // the GPU time of a stage in milliseconds (a few frames old); 0 if the stage is disabled
+        float GetGPUTime(POST_STAGE stage) const;
 
     private:
-        Texture* downsample(Renderer* renderer, Texture* src, RenderTarget* dst);
-        Texture* blur(Renderer* renderer, Texture* src,  RenderTarget* dst, int count);
+        // blurs src into dst (of the same size), adding coarser (if any) bilinearly upsampled
+        void blur(Texture* src, Texture* dst, float weight, Texture* coarser = nullptr);
     };
 }
 #endif
\ No newline at end of file
@@ -21,7 +21,7 @@ namespace Cell
         Clear();
     }
     // --------------------------------------------------------------------------------------------
-    void CommandBuffer::Push(Mesh* mesh, Material* material, math::mat4 transform, math::mat4 prevTransform, math::vec3 boxMin, math::vec3 boxMax, RenderTarget* target)
+    void CommandBuffer::Push(Mesh* mesh, Material* material, math::mat4 transform, math::mat4 prevTransform, math::vec3 boxMin, math::vec3 boxMax, RenderTarget* target, unsigned int lod)
     {
         RenderCommand command = {};
         command.Mesh          = mesh;
@@ -30,6 +30,7 @@ namespace Cell
         command.PrevTransform = prevTransform;
         command.BoxMin        = boxMin;
         command.BoxMax        = boxMax;
+        command.Lod           = lod;
 
         // if material requires alpha support, add it to alpha render commands for later rendering.
         if (material->Blend)
@@ -72,9 +73,18 @@ namespace Cell
     }
     // --------------------------------------------------------------------------------------------
     // custom per-element sort compare function used by the CommandBuffer::Sort() function.
+    /* NOTE(Joey):
+
+      Within a shader, commands are sorted by their level of detail and then by mesh. The LOD
+      is selected by projected screen size, s.t. lower levels are (roughly) closer to the camera:
+      this gives a coarse front-to-back order that helps early depth rejection, while commands
+      w/ the same mesh and LOD end up next to each other (same vertex array and index range).
+
+    */
     bool renderSortDeferred(const RenderCommand &a, const RenderCommand &b)
     {
-        return a.Material->GetShader()->ID < b.Material->GetShader()->ID;
+        return std::make_tuple(a.Material->GetShader()->ID, a.Lod, a.Mesh) <
+               std::make_tuple(b.Material->GetShader()->ID, b.Lod, b.Mesh);
     }
     // sort render state
     bool renderSortCustom(const RenderCommand &a, const RenderCommand &b)
@@ -106,8 +116,8 @@ namespace Cell
           return false;
 
         */
-        return std::make_tuple(a.Material->Blend, a.Material->GetShader()->ID) < 
-               std::make_tuple(b.Material->Blend, b.Material->GetShader()->ID);
+        return std::make_tuple(a.Material->Blend, a.Material->GetShader()->ID, a.Lod, a.Mesh) < 
+               std::make_tuple(b.Material->Blend, b.Material->GetShader()->ID, b.Lod, b.Mesh);
     }
     bool renderSortShader(const RenderCommand &a, const RenderCommand &b)
     {
@@ -39,11 +39,11 @@ namespace Cell
         ~CommandBuffer(); 
             
         // pushes render state relevant to a single render call to the command buffer.
-        void Push(Mesh* mesh, Material* material, math::mat4 transform = math::mat4(), math::mat4 prevTransform = math::mat4(), math::vec3 boxMin = math::vec3(-99999.0f), math::vec3 boxMax = math::vec3(99999.0f), RenderTarget* target = nullptr);
+        void Push(Mesh* mesh, Material* material, math::mat4 transform = math::mat4(), math::mat4 prevTransform = math::mat4(), math::vec3 boxMin = math::vec3(-99999.0f), math::vec3 boxMax = math::vec3(99999.0f), RenderTarget* target = nullptr, unsigned int lod = 0);
 
         // clears the command buffer; usually done after issuing all the stored render commands.
         void Clear();
-        // sorts the command buffer; first by shader, then by texture bind.
+        // sorts the command buffer; first by shader, then by level of detail and mesh.
         // TODO: build an approach using texture arrays (every push would add relevant material textures
         // to texture array (if it wans't there already), and then add a texture index to each material
         // slot; profile if the added texture adjustments actually saves performance!
@@ -0,0 +1,50 @@
+#include "gpu_timer.h"
+
+#include "../glad/glad.h"
+
+namespace Cell
+{
+    // --------------------------------------------------------------------------------------------
+    GPUTimer::GPUTimer()
+    {
+        glGenQueries(LATENCY * 2, &m_Queries[0][0]);
+    }
+    // --------------------------------------------------------------------------------------------
+    GPUTimer::~GPUTimer()
+    {
+        glDeleteQueries(LATENCY * 2, &m_Queries[0][0]);
+    }
+    // --------------------------------------------------------------------------------------------
+    void GPUTimer::Begin()
+    {
+        // the oldest query is reused; read its result first if the GPU got to it (otherwise
+        // that measurement is dropped).
+        if (m_Pending[m_Current])
+        {
+            // the end timestamp being available implies the begin's is
+            GLint available = 0;
+            glGetQueryObjectiv(m_Queries[m_Current][1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                GLuint64 begin = 0, end = 0;
+                glGetQueryObjectui64v(m_Queries[m_Current][0], GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(m_Queries[m_Current][1], GL_QUERY_RESULT, &end);
+                m_Time = (float)((end - begin) / 1000000.0);
+            }
+            m_Pending[m_Current] = false;
+        }
+        glQueryCounter(m_Queries[m_Current][0], GL_TIMESTAMP);
+    }
+    // --------------------------------------------------------------------------------------------
+    void GPUTimer::End()
+    {
+        glQueryCounter(m_Queries[m_Current][1], GL_TIMESTAMP);
+        m_Pending[m_Current] = true;
+        m_Current = (m_Current + 1) % LATENCY;
+    }
+    // --------------------------------------------------------------------------------------------
+    float GPUTimer::GetTime() const
+    {
+        return m_Time;
+    }
+}
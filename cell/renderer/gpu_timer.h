@@ -0,0 +1,39 @@
+#ifndef CELL_RENDERER_GPU_TIMER_H
+#define CELL_RENDERER_GPU_TIMER_H
+
+namespace Cell
+{
+    /*
+
+      Measures the GPU time of the GL commands issued between Begin and End w/ timestamp
+      queries (s.t. timers can be nested, unlike GL's elapsed time queries). A measurement is
+      only read back a few frames later (if available by then), s.t. measuring never stalls the
+      CPU on the GPU; the reported time lags behind accordingly.
+
+    */
+    class GPUTimer
+    {
+    private:
+        static const unsigned int LATENCY = 4;
+
+        unsigned int m_Queries[LATENCY][2]; // begin and end timestamps
+        bool         m_Pending[LATENCY] = { false, false, false, false };
+        unsigned int m_Current = 0;
+        float        m_Time    = 0.0f;
+
+    public:
+        GPUTimer();
+        ~GPUTimer();
+
+        GPUTimer(const GPUTimer&) = delete;
+        GPUTimer& operator=(const GPUTimer&) = delete;
+
+        void Begin();
+        void End();
+
+        // the most recently read back GPU time in milliseconds
+        float GetTime() const;
+    };
+}
+
+#endif
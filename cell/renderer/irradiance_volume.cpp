@@ -0,0 +1,257 @@
+#include "irradiance_volume.h"
+
+#include "../shading/texture.h"
+
+#include <math/linear_algebra/operation.h>
+
+#include <algorithm>
+#include <math.h>
+
+namespace Cell
+{
+    // --------------------------------------------------------------------------------------------
+    IrradianceVolume::IrradianceVolume()
+    {
+
+    }
+    // --------------------------------------------------------------------------------------------
+    IrradianceVolume::~IrradianceVolume()
+    {
+        deleteTextures();
+    }
+    // --------------------------------------------------------------------------------------------
+    void IrradianceVolume::Place(math::vec3 boxMin, math::vec3 boxMax, float spacing, unsigned int maxProbes)
+    {
+        math::vec3 extent(std::max(boxMax.x - boxMin.x, 0.0f), std::max(boxMax.y - boxMin.y, 0.0f), std::max(boxMax.z - boxMin.z, 0.0f));
+        spacing   = std::max(spacing, 0.01f);
+        maxProbes = std::max(maxProbes, 8u);
+
+        // at least 2 probes per axis s.t. there's always a cell to interpolate in; grow the
+        // spacing until the grid fits the probe budget.
+        unsigned int resolution[3];
+        while (true)
+        {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+                resolution[axis] = std::max(2u, (unsigned int)ceil(extent[axis] / spacing) + 1);
+            if (resolution[0] * resolution[1] * resolution[2] <= maxProbes)
+                break;
+            spacing *= 1.1f;
+        }
+
+        // center the grid on the box
+        const math::vec3 center = (boxMin + boxMax) * 0.5f;
+        const math::vec3 halfSize = math::vec3((float)(resolution[0] - 1), (float)(resolution[1] - 1), (float)(resolution[2] - 1)) * (spacing * 0.5f);
+        m_BoxMin  = center - halfSize;
+        m_BoxMax  = center + halfSize;
+        m_Spacing = spacing;
+        for (unsigned int axis = 0; axis < 3; ++axis)
+            m_Resolution[axis] = resolution[axis];
+
+        m_Probes.resize(resolution[0] * resolution[1] * resolution[2]);
+        for (unsigned int z = 0; z < resolution[2]; ++z)
+        {
+            for (unsigned int y = 0; y < resolution[1]; ++y)
+            {
+                for (unsigned int x = 0; x < resolution[0]; ++x)
+                {
+                    IrradianceProbe& probe = m_Probes[probeIndex(x, y, z)];
+                    probe.Position   = m_BoxMin + math::vec3((float)x, (float)y, (float)z) * spacing;
+                    probe.Radius     = spacing;
+                    probe.Irradiance = math::sh9();
+                    probe.Validity   = 0.0f;
+                }
+            }
+        }
+        m_PendingProbes = m_Probes;
+        // the grid's dimensions likely changed
+        deleteTextures();
+        m_TextureDirty = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    void IrradianceVolume::Clear()
+    {
+        m_Probes.clear();
+        m_PendingProbes.clear();
+        for (unsigned int axis = 0; axis < 3; ++axis)
+            m_Resolution[axis] = 0;
+        deleteTextures();
+        m_TextureDirty = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int IrradianceVolume::GetProbeCount() const
+    {
+        return (unsigned int)m_Probes.size();
+    }
+    // --------------------------------------------------------------------------------------------
+    const IrradianceProbe& IrradianceVolume::GetProbe(unsigned int index) const
+    {
+        return m_Probes[index];
+    }
+    // --------------------------------------------------------------------------------------------
+    void IrradianceVolume::SetProbe(unsigned int index, const math::sh9& irradiance, float validity)
+    {
+        m_PendingProbes[index].Irradiance = irradiance;
+        m_PendingProbes[index].Validity   = validity;
+    }
+    // --------------------------------------------------------------------------------------------
+    void IrradianceVolume::Swap()
+    {
+        m_Probes = m_PendingProbes;
+        m_TextureDirty = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    math::vec3 IrradianceVolume::GetBoxMin() const
+    {
+        return m_BoxMin;
+    }
+    // --------------------------------------------------------------------------------------------
+    math::vec3 IrradianceVolume::GetBoxMax() const
+    {
+        return m_BoxMax;
+    }
+    // --------------------------------------------------------------------------------------------
+    float IrradianceVolume::GetSpacing() const
+    {
+        return m_Spacing;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int IrradianceVolume::GetResolution(unsigned int axis) const
+    {
+        return m_Resolution[axis];
+    }
+    // --------------------------------------------------------------------------------------------
+    std::vector<const IrradianceProbe*> IrradianceVolume::Query(math::vec3 position, float radius) const
+    {
+        std::vector<const IrradianceProbe*> result;
+        for (unsigned int index : QueryIndices(position, radius))
+            result.push_back(&m_Probes[index]);
+        return result;
+    }
+    // --------------------------------------------------------------------------------------------
+    std::vector<unsigned int> IrradianceVolume::QueryIndices(math::vec3 position, float radius) const
+    {
+        std::vector<unsigned int> result;
+        if (m_Probes.empty())
+            return result;
+
+        // the range of grid coordinates overlapping the query's bounding box
+        math::vec3 boxMin = m_BoxMin;
+        int from[3], to[3];
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+            from[axis] = std::max((int)ceil((position[axis] - radius - boxMin[axis]) / m_Spacing), 0);
+            to[axis]   = std::min((int)floor((position[axis] + radius - boxMin[axis]) / m_Spacing), (int)m_Resolution[axis] - 1);
+            if (from[axis] > to[axis])
+                return result;
+        }
+        for (int z = from[2]; z <= to[2]; ++z)
+        {
+            for (int y = from[1]; y <= to[1]; ++y)
+            {
+                for (int x = from[0]; x <= to[0]; ++x)
+                {
+                    const unsigned int index = probeIndex(x, y, z);
+                    if (math::lengthSquared(m_Probes[index].Position - position) < radius * radius)
+                        result.push_back(index);
+                }
+            }
+        }
+        return result;
+    }
+    // --------------------------------------------------------------------------------------------
+    float IrradianceVolume::Sample(math::vec3 position, math::sh9& irradiance) const
+    {
+        irradiance = math::sh9();
+        if (m_Probes.empty())
+            return 0.0f;
+
+        // the cell containing position and the position's (fractional) offset within
+        math::vec3 boxMin = m_BoxMin, boxMax = m_BoxMax;
+        unsigned int cell[3];
+        float        t[3];
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+            float g = (std::min(std::max(position[axis], boxMin[axis]), boxMax[axis]) - boxMin[axis]) / m_Spacing;
+            cell[axis] = std::min((unsigned int)g, m_Resolution[axis] - 2);
+            t[axis]    = std::min(g - cell[axis], 1.0f);
+        }
+
+        float validity = 0.0f;
+        for (unsigned int corner = 0; corner < 8; ++corner)
+        {
+            const unsigned int dx = corner & 1, dy = (corner >> 1) & 1, dz = corner >> 2;
+            const IrradianceProbe& probe = m_Probes[probeIndex(cell[0] + dx, cell[1] + dy, cell[2] + dz)];
+            const float weight = (dx ? t[0] : 1.0f - t[0]) * (dy ? t[1] : 1.0f - t[1]) * (dz ? t[2] : 1.0f - t[2]) * probe.Validity;
+            if (weight > 0.0f)
+            {
+                irradiance = math::shAdd(irradiance, math::shScale(probe.Irradiance, weight));
+                validity += weight;
+            }
+        }
+        if (validity > 0.0f)
+            irradiance = math::shScale(irradiance, 1.0f / validity);
+        return validity;
+    }
+    // --------------------------------------------------------------------------------------------
+    Texture* IrradianceVolume::GetTexture()
+    {
+        if (!m_TextureDirty)
+            return m_Textures[m_Front];
+        m_TextureDirty = false;
+        if (m_Probes.empty())
+            return nullptr;
+
+        // 9 slabs of the full grid stacked along z, one per coefficient (see class comment)
+        const unsigned int slab = (unsigned int)m_Probes.size();
+        std::vector<math::vec4> texels(slab * 9);
+        for (unsigned int c = 0; c < 9; ++c)
+        {
+            for (unsigned int i = 0; i < slab; ++i)
+            {
+                const IrradianceProbe& probe = m_Probes[i];
+                texels[c * slab + i] = math::vec4(probe.Irradiance.c[c] * probe.Validity, probe.Validity);
+            }
+        }
+
+        // upload to the texture not in use by the frame(s) still in flight and swap them
+        Texture*& texture = m_Textures[m_Front ^ 1];
+        if (!texture)
+        {
+            texture = new Texture;
+            texture->Target     = GL_TEXTURE_3D;
+            texture->FilterMin  = GL_LINEAR;
+            texture->FilterMax  = GL_LINEAR;
+            texture->WrapS      = GL_CLAMP_TO_EDGE;
+            texture->WrapT      = GL_CLAMP_TO_EDGE;
+            texture->WrapR      = GL_CLAMP_TO_EDGE;
+            texture->Mipmapping = false;
+            texture->Generate(m_Resolution[0], m_Resolution[1], m_Resolution[2] * 9, GL_RGBA16F, GL_RGBA, GL_FLOAT, &texels[0]);
+        }
+        else
+        {
+            texture->Bind();
+            glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, m_Resolution[0], m_Resolution[1], m_Resolution[2] * 9, GL_RGBA, GL_FLOAT, &texels[0]);
+            texture->Unbind();
+        }
+        m_Front ^= 1;
+        return texture;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int IrradianceVolume::probeIndex(unsigned int x, unsigned int y, unsigned int z) const
+    {
+        return (z * m_Resolution[1] + y) * m_Resolution[0] + x;
+    }
+    // --------------------------------------------------------------------------------------------
+    void IrradianceVolume::deleteTextures()
+    {
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            if (m_Textures[i])
+            {
+                glDeleteTextures(1, &m_Textures[i]->ID);
+                delete m_Textures[i];
+                m_Textures[i] = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef CELL_RENDERER_IRRADIANCE_VOLUME_H
+#define CELL_RENDERER_IRRADIANCE_VOLUME_H
+
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+#include <math/trigonometry/spherical_harmonics.h>
+
+#include "pbr_capture.h"
+
+namespace Cell
+{
+    class Texture;
+
+    /*
+
+      A regular grid of irradiance probes spanning an axis-aligned box, w/ its probes on the
+      corners of the grid's cells. The lighting pass looks up the irradiance at any point by
+      trilinearly interpolating the 8 probes around it, s.t. its cost is independent of the
+      number of probes.
+
+      Each probe has a validity: probes placed inside geometry (mostly seeing backfaces) are
+      invalid and don't contribute to the interpolation, s.t. they don't leak darkness into
+      the surfaces around them.
+
+      On the GPU the probes live in a single 3D texture of probes per axis (x, y, 9 * z): the
+      9 spherical harmonics coefficients are stacked along z, each as a slab of the full grid.
+      Texels store the coefficients premultiplied by the probe's validity and the validity
+      itself in alpha; hardware filtering then yields the validity weighted sum, which the
+      lighting pass normalizes by the filtered alpha.
+
+      Probes are double-buffered: (re-)baked probes are written to a pending copy of the grid
+      that only becomes visible on Swap, s.t. a partially re-baked grid is never shown.
+
+    */
+    class IrradianceVolume
+    {
+    private:
+        math::vec3   m_BoxMin;
+        math::vec3   m_BoxMax;
+        float        m_Spacing = 1.0f;
+        unsigned int m_Resolution[3] = { 0, 0, 0 };
+
+        // probes in grid order: x fastest, then y, then z
+        std::vector<IrradianceProbe> m_Probes;
+        std::vector<IrradianceProbe> m_PendingProbes;
+
+        // the probes' textures; one in use, the other receives the next upload
+        Texture*     m_Textures[2]  = { nullptr, nullptr };
+        unsigned int m_Front        = 0;
+        bool         m_TextureDirty = false;
+
+    public:
+        IrradianceVolume();
+        ~IrradianceVolume();
+
+        // places a grid of probes over [boxMin, boxMax] w/ spacing between them; the box is
+        // grown to a multiple of the spacing and the spacing itself is grown if the grid would
+        // hold more than maxProbes. Resets the probes to empty, invalid irradiance.
+        void Place(math::vec3 boxMin, math::vec3 boxMax, float spacing, unsigned int maxProbes);
+        // removes all probes
+        void Clear();
+
+        unsigned int           GetProbeCount() const;
+        const IrradianceProbe& GetProbe(unsigned int index) const;
+        // writes a probe's (re-)baked irradiance; only visible after the next Swap.
+        void                   SetProbe(unsigned int index, const math::sh9& irradiance, float validity);
+        // makes all probes written since the last swap visible at once
+        void                   Swap();
+
+        math::vec3   GetBoxMin() const;
+        math::vec3   GetBoxMax() const;
+        float        GetSpacing() const;
+        unsigned int GetResolution(unsigned int axis) const;
+
+        // retrieves all probes within radius of position; only the grid cells overlapping the
+        // query's bounds are visited.
+        std::vector<const IrradianceProbe*> Query(math::vec3 position, float radius) const;
+        std::vector<unsigned int>           QueryIndices(math::vec3 position, float radius) const;
+        // the validity weighted trilinear interpolation of the probes around position (clamped
+        // to the volume), matching the lighting pass' lookup. Returns the interpolated
+        // validity; 0 if none of the surrounding probes is valid.
+        float Sample(math::vec3 position, math::sh9& irradiance) const;
+
+        // the probes' texture for the lighting pass; (re)uploaded if the probes changed.
+        Texture* GetTexture();
+    private:
+        unsigned int probeIndex(unsigned int x, unsigned int y, unsigned int z) const;
+        void         deleteTextures();
+    };
+}
+
+#endif
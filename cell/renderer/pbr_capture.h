@@ -4,6 +4,7 @@
 #include "../shading/texture_cube.h"
 
 #include <math/linear_algebra/vector.h>
+#include <math/trigonometry/spherical_harmonics.h>
 
 namespace Cell
 {
@@ -20,6 +21,21 @@ namespace Cell
         math::vec3 Position;
         float      Radius;
     };
+
+    /*
+
+      A local irradiance probe: the diffuse lighting arriving at its position as L2 spherical
+      harmonics (see math::shConvolveLambert), blended over its radius of influence. Probes
+      w/ a validity of 0 (e.g. inside geometry) are ignored; see IrradianceVolume.
+
+    */
+    struct IrradianceProbe
+    {
+        math::vec3 Position;
+        float      Radius;
+        math::sh9  Irradiance;
+        float      Validity = 0.0f;
+    };
 }
 
 #endif
\ No newline at end of file
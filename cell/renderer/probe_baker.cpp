@@ -0,0 +1,455 @@
+#include "probe_baker.h"
+
+#include "renderer.h"
+#include "command_buffer.h"
+#include "irradiance_volume.h"
+#include "PBR.h"
+
+#include "../camera/camera.h"
+#include "../scene/scene_node.h"
+#include "../shading/material.h"
+
+#include <math/linear_algebra/operation.h>
+#include <utility/logging/log.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <chrono>
+#include <stack>
+#include <string>
+
+namespace Cell
+{
+    // --------------------------------------------------------------------------------------------
+    static float elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    // --------------------------------------------------------------------------------------------
+    ProbeBaker::ProbeBaker(Renderer* renderer)
+    {
+        m_Renderer = renderer;
+        m_CaptureCube.DefaultInitialize(CAPTURE_SIZE, CAPTURE_SIZE, GL_RGBA, GL_FLOAT);
+    }
+    // --------------------------------------------------------------------------------------------
+    ProbeBaker::~ProbeBaker()
+    {
+        for (Readback& readback : m_Readbacks)
+        {
+            glDeleteSync(readback.Fence);
+            glDeleteBuffers(1, &readback.Buffer);
+        }
+        if (!m_FreeBuffers.empty())
+            glDeleteBuffers((GLsizei)m_FreeBuffers.size(), &m_FreeBuffers[0]);
+        for (auto& it : m_Nodes)
+            delete it.second.CaptureMaterial;
+        glDeleteTextures(1, &m_CaptureCube.ID);
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::Bake(SceneNode* scene)
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+
+        // finish (and discard) a previous bake's work in flight
+        processReadbacks(true);
+        m_CaptureProbe = -1;
+
+        m_Scene = scene;
+        trackChanges(false);
+
+        // place the probe grid over the captured geometry (or the user-specified box); nodes
+        // w/o bounds, like the background, don't count.
+        if (!m_Renderer->m_ProbeVolumeFromScene)
+        {
+            volume->Place(m_Renderer->m_ProbeVolumeMin, m_Renderer->m_ProbeVolumeMax, m_Renderer->IrradianceProbeSpacing, m_Renderer->IrradianceProbeMax);
+        }
+        else
+        {
+            math::vec3 sceneMin(FLT_MAX), sceneMax(-FLT_MAX);
+            for (auto& it : m_Nodes)
+            {
+                const CaptureNode& node = it.second;
+                if (!node.Captured || !node.Bounded)
+                    continue;
+                sceneMin = math::vec3(std::min(sceneMin.x, node.BoxMin.x), std::min(sceneMin.y, node.BoxMin.y), std::min(sceneMin.z, node.BoxMin.z));
+                sceneMax = math::vec3(std::max(sceneMax.x, node.BoxMax.x), std::max(sceneMax.y, node.BoxMax.y), std::max(sceneMax.z, node.BoxMax.z));
+            }
+            if (sceneMin.x <= sceneMax.x)
+            {
+                volume->Place(sceneMin, sceneMax, m_Renderer->IrradianceProbeSpacing, m_Renderer->IrradianceProbeMax);
+            }
+            else
+            {
+                Log::Message("No bounded geometry to place irradiance probes around.", LOG_WARNING);
+                volume->Clear();
+            }
+        }
+        const unsigned int probeCount = volume->GetProbeCount();
+
+        // capture all probes as a single batch
+        auto timeStart = std::chrono::steady_clock::now();
+        m_ProbeState.assign(probeCount, PROBE_QUEUED);
+        m_ProbeStale.assign(probeCount, PROBE_BAKED);
+        m_BatchActive = true;
+        captureFaces(UINT_MAX, FLT_MAX, true);
+        processReadbacks(true);
+        volume->Swap();
+        m_BatchActive = false;
+
+        unsigned int validCount = 0;
+        for (unsigned int i = 0; i < probeCount; ++i)
+            validCount += volume->GetProbe(i).Validity > 0.0f;
+        Log::Message("Baked " + std::to_string(probeCount) + " irradiance probes (" +
+                     std::to_string(volume->GetResolution(0)) + "x" + std::to_string(volume->GetResolution(1)) + "x" + std::to_string(volume->GetResolution(2)) +
+                     ", " + std::to_string(validCount) + " valid) in " + std::to_string((int)elapsedMs(timeStart)) + " ms.", LOG_INIT);
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::Update(unsigned int maxFaces, float budgetMs)
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+        if (!m_Scene || volume->GetProbeCount() == 0 || m_ProbeState.size() != volume->GetProbeCount())
+            return;
+
+        auto timeStart = std::chrono::steady_clock::now();
+        trackChanges(true);
+        processReadbacks(false);
+        if (!m_BatchActive && GetPendingCount() > 0)
+            startBatch();
+        if (!m_BatchActive)
+            return;
+
+        captureFaces(maxFaces, budgetMs - elapsedMs(timeStart), false);
+
+        // show the batch once all of its probes are in
+        if (m_CaptureProbe < 0 && m_Readbacks.empty() && nextProbe() < 0)
+        {
+            volume->Swap();
+            m_BatchActive = false;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::Invalidate()
+    {
+        for (unsigned int i = 0; i < m_ProbeState.size(); ++i)
+        {
+            if ((m_ProbeState[i] == PROBE_BAKED || m_ProbeState[i] == PROBE_CAPTURING) && m_ProbeStale[i] == PROBE_BAKED)
+                m_ProbeStale[i] = PROBE_QUEUED;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::Invalidate(math::vec3 boxMin, math::vec3 boxMax)
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+        if (m_ProbeState.size() != volume->GetProbeCount())
+            return;
+
+        // the probes interpolated on the box's surfaces lie w/in a cell of the box
+        const math::vec3 center = (boxMin + boxMax) * 0.5f;
+        const float radius = math::length(boxMax - boxMin) * 0.5f + volume->GetSpacing() * 1.75f;
+        std::vector<unsigned int> probes = volume->QueryIndices(center, radius);
+        if (probes.empty())
+            return;
+
+        for (unsigned int probe : probes)
+        {
+            if (m_ProbeState[probe] == PROBE_QUEUED)
+                m_ProbeState[probe] = PROBE_QUEUED_GEOMETRY;
+            else if (m_ProbeState[probe] != PROBE_QUEUED_GEOMETRY)
+                m_ProbeStale[probe] = PROBE_QUEUED_GEOMETRY;
+        }
+        // w/o a batch running, geometry changes are re-baked right away
+        if (!m_BatchActive)
+            startBatch();
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int ProbeBaker::GetPendingCount() const
+    {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < m_ProbeState.size(); ++i)
+            count += m_ProbeState[i] != PROBE_BAKED || m_ProbeStale[i] != PROBE_BAKED;
+        return count;
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::trackChanges(bool invalidate)
+    {
+        // resolve pending (dirty) transforms, s.t. the nodes' transform versions are current
+        m_Scene->UpdateTransform();
+        for (auto& it : m_Nodes)
+            it.second.Visited = false;
+
+        std::stack<SceneNode*> sceneStack;
+        sceneStack.push(m_Scene);
+        while (!sceneStack.empty())
+        {
+            SceneNode* node = sceneStack.top();
+            sceneStack.pop();
+            for (unsigned int i = 0; i < node->GetChildCount(); ++i)
+                sceneStack.push(node->GetChildByIndex(i));
+            if (!node->Mesh || !node->Material)
+                continue;
+
+            auto it = m_Nodes.find(node);
+            const bool added = it == m_Nodes.end();
+            if (added)
+                it = m_Nodes.insert(std::make_pair(node, CaptureNode())).first;
+            CaptureNode& capture = it->second;
+            capture.Visited = true;
+
+            // NOTE(Joey): the common case: nothing about the node changed since the last call.
+            const bool materialChanged = added || capture.SourceMaterial != node->Material;
+            if (!materialChanged && capture.TransformVersion == node->GetTransformVersion() && capture.SourceMesh == node->Mesh)
+                continue;
+            m_CommandsDirty = true;
+
+            // invalidate the probes around where the node was, and where it is now; the
+            // background is seen by every probe.
+            if (invalidate && !added && capture.Captured && !capture.Background)
+                Invalidate(capture.BoxMin, capture.BoxMax);
+
+            // only PBR materials and the background are captured
+            auto* samplerUniforms = node->Material->GetSamplerUniforms();
+            if (materialChanged)
+            {
+                const bool albedo     = samplerUniforms->find("TexAlbedo") != samplerUniforms->end();
+                const bool background = !albedo && samplerUniforms->find("background") != samplerUniforms->end();
+                if (invalidate && capture.Captured && capture.Background)
+                    Invalidate();
+                delete capture.CaptureMaterial;
+                capture.CaptureMaterial = nullptr;
+                capture.Captured        = albedo || background;
+                capture.Background      = background;
+                if (albedo)
+                {
+                    capture.CaptureMaterial = new Material(m_Renderer->m_PBR->m_ProbeCaptureShader);
+                    // backfaces are captured as well; they mark probes inside geometry
+                    capture.CaptureMaterial->Cull = false;
+                    const char* textures[4] = { "TexAlbedo", "TexNormal", "TexMetallic", "TexRoughness" };
+                    for (unsigned int t = 0; t < 4; ++t)
+                    {
+                        auto sampler = samplerUniforms->find(textures[t]);
+                        if (sampler != samplerUniforms->end())
+                            capture.CaptureMaterial->SetTexture(textures[t], sampler->second.Texture, t);
+                    }
+                }
+                else if (background)
+                {
+                    capture.CaptureMaterial = new Material(m_Renderer->m_PBR->m_ProbeCaptureBackgroundShader);
+                    capture.CaptureMaterial->SetTextureCube("background", (*samplerUniforms)["background"].TextureCube, 0);
+                    capture.CaptureMaterial->DepthCompare = node->Material->DepthCompare;
+                }
+            }
+            capture.TransformVersion = node->GetTransformVersion();
+            capture.SourceMesh       = node->Mesh;
+            capture.SourceMaterial   = node->Material;
+            if (!capture.Captured)
+                continue;
+
+            capture.Bounded = math::length(node->BoxMax - node->BoxMin) < 99999.0f;
+            capture.BoxMin  = node->GetWorldPosition() + (capture.Bounded ? node->GetWorldScale() * node->BoxMin : math::vec3(0.0f));
+            capture.BoxMax  = node->GetWorldPosition() + (capture.Bounded ? node->GetWorldScale() * node->BoxMax : math::vec3(0.0f));
+            if (invalidate)
+            {
+                if (capture.Background)
+                    Invalidate();
+                else
+                    Invalidate(capture.BoxMin, capture.BoxMax);
+            }
+        }
+
+        // nodes that were removed from the scene
+        for (auto it = m_Nodes.begin(); it != m_Nodes.end();)
+        {
+            if (it->second.Visited)
+            {
+                ++it;
+                continue;
+            }
+            if (invalidate && it->second.Captured)
+            {
+                if (it->second.Background)
+                    Invalidate();
+                else
+                    Invalidate(it->second.BoxMin, it->second.BoxMax);
+            }
+            delete it->second.CaptureMaterial;
+            it = m_Nodes.erase(it);
+            m_CommandsDirty = true;
+        }
+
+        // the probes capture the first directional light and the sky
+        const std::vector<DirectionalLight*>& lights = m_Renderer->m_DirectionalLights;
+        math::vec3  lightDirection = lights.empty() ? math::vec3(0.0f) : lights[0]->Direction;
+        math::vec3  lightColor     = lights.empty() ? math::vec3(0.0f) : lights[0]->Color * lights[0]->Intensity;
+        PBRCapture* lightSky       = m_Renderer->m_PBR->GetSkyCapture();
+        if (invalidate && (math::lengthSquared(lightDirection - m_LightDirection) > 0.0f ||
+                           math::lengthSquared(lightColor - m_LightColor) > 0.0f || lightSky != m_LightSky))
+        {
+            Invalidate();
+        }
+        m_LightDirection = lightDirection;
+        m_LightColor     = lightColor;
+        m_LightSky       = lightSky;
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::buildCommands()
+    {
+        CommandBuffer commandBuffer(m_Renderer);
+        for (auto& it : m_Nodes)
+        {
+            const CaptureNode& capture = it.second;
+            if (!capture.Captured)
+                continue;
+            // w/ its bounds, s.t. the captures only render it to the cube faces it touches
+            const math::mat4 transform = it.first->GetTransform();
+            if (capture.Bounded)
+                commandBuffer.Push(capture.SourceMesh, capture.CaptureMaterial, transform, transform, capture.BoxMin, capture.BoxMax);
+            else
+                commandBuffer.Push(capture.SourceMesh, capture.CaptureMaterial, transform);
+        }
+        commandBuffer.Sort();
+        m_CaptureCommands = commandBuffer.GetCustomRenderCommands(nullptr);
+        m_CommandsDirty = false;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int ProbeBaker::captureFaces(unsigned int maxFaces, float budgetMs, bool block)
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+        auto timeStart = std::chrono::steady_clock::now();
+        unsigned int faces = 0;
+        while (faces < maxFaces)
+        {
+            // at least one face per call, s.t. the probes always make progress
+            if (faces > 0 && elapsedMs(timeStart) >= budgetMs)
+                break;
+            if (m_CaptureProbe < 0)
+            {
+                if (m_Readbacks.size() >= MAX_READBACKS)
+                {
+                    if (!block)
+                        break;
+                    processReadbacks(true);
+                }
+                m_CaptureProbe = nextProbe();
+                if (m_CaptureProbe < 0)
+                    break;
+                m_ProbeState[m_CaptureProbe] = PROBE_CAPTURING;
+                m_CaptureFace = 0;
+            }
+
+            if (m_CommandsDirty)
+                buildCommands();
+
+            // as many of the probe's remaining faces as the face budget allows; a full probe is
+            // rendered in a single layered pass (see Renderer::renderToCubemap).
+            const unsigned int faceCount = std::min(6 - m_CaptureFace, maxFaces - faces);
+            m_Renderer->renderToCubemap(m_CaptureCommands, &m_CaptureCube, volume->GetProbe(m_CaptureProbe).Position, 0, m_CaptureFace, faceCount);
+            faces         += faceCount;
+            m_CaptureFace += faceCount;
+            if (m_CaptureFace < 6)
+                continue;
+
+            // all faces are in: read them back into a pixel buffer, w/o waiting for the GPU
+            Readback readback;
+            readback.Probe = m_CaptureProbe;
+            const unsigned int faceSize = CAPTURE_SIZE * CAPTURE_SIZE * 4 * sizeof(float);
+            if (!m_FreeBuffers.empty())
+            {
+                readback.Buffer = m_FreeBuffers.back();
+                m_FreeBuffers.pop_back();
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+            }
+            else
+            {
+                glGenBuffers(1, &readback.Buffer);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+                glBufferData(GL_PIXEL_PACK_BUFFER, 6 * faceSize, nullptr, GL_STREAM_READ);
+            }
+            m_CaptureCube.Bind(0);
+            for (unsigned int f = 0; f < 6; ++f)
+                glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_RGBA, GL_FLOAT, (void*)(std::size_t)(f * faceSize));
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_Readbacks.push_back(readback);
+            m_CaptureProbe = -1;
+        }
+        return faces;
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::processReadbacks(bool block)
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+        const unsigned int size = 6 * CAPTURE_SIZE * CAPTURE_SIZE * 4 * sizeof(float);
+
+        // readbacks complete in order; stop at the first the GPU isn't done with
+        unsigned int done = 0;
+        for (; done < m_Readbacks.size(); ++done)
+        {
+            Readback& readback = m_Readbacks[done];
+            GLenum status = block ? glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)
+                                  : glClientWaitSync(readback.Fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+            glDeleteSync(readback.Fence);
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+            const float* radiance = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+            // the volume may have been re-placed (or cleared) since
+            if (radiance && readback.Probe < volume->GetProbeCount() && readback.Probe < m_ProbeState.size())
+            {
+                float validity;
+                math::sh9 irradiance = m_Renderer->m_PBR->ProjectIrradiance(radiance, CAPTURE_SIZE, &validity);
+                volume->SetProbe(readback.Probe, irradiance, validity);
+                if (m_ProbeState[readback.Probe] == PROBE_CAPTURING)
+                    m_ProbeState[readback.Probe] = PROBE_BAKED;
+            }
+            if (radiance)
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            m_FreeBuffers.push_back(readback.Buffer);
+        }
+        m_Readbacks.erase(m_Readbacks.begin(), m_Readbacks.begin() + done);
+    }
+    // --------------------------------------------------------------------------------------------
+    void ProbeBaker::startBatch()
+    {
+        for (unsigned int i = 0; i < m_ProbeStale.size(); ++i)
+        {
+            if (m_ProbeStale[i] == PROBE_BAKED)
+                continue;
+            // a probe still being captured is re-captured from the start
+            if ((int)i == m_CaptureProbe)
+                m_CaptureProbe = -1;
+            if (m_ProbeState[i] != PROBE_QUEUED_GEOMETRY)
+                m_ProbeState[i] = m_ProbeStale[i];
+            m_ProbeStale[i] = PROBE_BAKED;
+        }
+        m_BatchActive = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    int ProbeBaker::nextProbe() const
+    {
+        IrradianceVolume* volume = m_Renderer->m_PBR->GetIrradianceVolume();
+        Camera* camera = m_Renderer->GetCamera();
+        const math::vec3 eye = camera ? camera->Position : math::vec3(0.0f);
+
+        // probes near changed geometry first, then the ones closest to the camera
+        int   best = -1;
+        bool  bestGeometry = false;
+        float bestDistance = FLT_MAX;
+        for (unsigned int i = 0; i < m_ProbeState.size(); ++i)
+        {
+            if (m_ProbeState[i] != PROBE_QUEUED && m_ProbeState[i] != PROBE_QUEUED_GEOMETRY)
+                continue;
+            const bool  geometry = m_ProbeState[i] == PROBE_QUEUED_GEOMETRY;
+            const float distance = math::lengthSquared(volume->GetProbe(i).Position - eye);
+            if (best < 0 || (geometry && !bestGeometry) || (geometry == bestGeometry && distance < bestDistance))
+            {
+                best         = (int)i;
+                bestGeometry = geometry;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef CELL_RENDERER_PROBE_BAKER_H
+#define CELL_RENDERER_PROBE_BAKER_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <math/linear_algebra/vector.h>
+
+#include "render_command.h"
+#include "../shading/texture_cube.h"
+
+namespace Cell
+{
+    class Renderer;
+    class SceneNode;
+    class Mesh;
+    class Material;
+    struct PBRCapture;
+
+    /*
+
+      Bakes the irradiance probe grid (see IrradianceVolume) and keeps it up to date.
+
+      Bake places the probes and captures all of them at once. Afterwards, Update re-bakes the
+      probes affected by changes a few cube faces per frame: a change in (directional/sky)
+      lighting affects all probes, a scene node that moved (see SceneNode::GetTransformVersion),
+      appeared or disappeared the probes around its old and new bounds.
+
+      Probes are re-baked in batches: a batch holds all probes invalidated before it started
+      and is shown at once (see IrradianceVolume::Swap) when its last probe is done, s.t. the
+      lighting never shows a mix of two states. Probes near changed geometry go first, then the
+      probes closest to the camera. Invalidated probes join the running batch if they're still
+      queued in it; otherwise they wait for the next, s.t. a batch always completes (even w/
+      geometry that moves every frame).
+
+      Captured faces are read back w/ pixel buffers, s.t. the readback doesn't stall the frame;
+      the spherical harmonics projection runs once the GPU is done w/ them.
+
+    */
+    class ProbeBaker
+    {
+    private:
+        // capture state of a scene node, s.t. changes can be detected and its capture material
+        // is only created once. Nodes w/ a material that isn't captured are tracked as well, s.t.
+        // their material is only inspected when it changes.
+        struct CaptureNode
+        {
+            Material*    CaptureMaterial  = nullptr;
+            Mesh*        SourceMesh       = nullptr;
+            Material*    SourceMaterial   = nullptr;
+            unsigned int TransformVersion = 0;
+            math::vec3   BoxMin;
+            math::vec3   BoxMax;
+            bool         Captured   = false; // w/ a PBR or background material
+            bool         Bounded    = false; // w/ a bounding box (otherwise the box is its position)
+            bool         Background = false;
+            bool         Visited    = false;
+        };
+        // a probe's captured faces, being read back
+        struct Readback
+        {
+            unsigned int Probe;
+            unsigned int Buffer;
+            GLsync       Fence;
+        };
+        enum PROBE_STATE
+        {
+            PROBE_BAKED,
+            PROBE_QUEUED,          // in the current batch
+            PROBE_QUEUED_GEOMETRY, // in the current batch, near changed geometry
+            PROBE_CAPTURING,
+        };
+
+        static const unsigned int CAPTURE_SIZE  = 32;
+        static const unsigned int MAX_READBACKS = 4;
+
+        Renderer*  m_Renderer;
+        SceneNode* m_Scene = nullptr;
+
+        std::unordered_map<SceneNode*, CaptureNode> m_Nodes;
+        std::vector<RenderCommand>                  m_CaptureCommands;
+        // whether a node was added, removed or changed since the capture commands were built
+        bool                                        m_CommandsDirty = true;
+
+        std::vector<unsigned char> m_ProbeState;
+        // invalidated probes: the state they're queued w/ in the next batch (or PROBE_BAKED)
+        std::vector<unsigned char> m_ProbeStale;
+        bool                       m_BatchActive = false;
+
+        // the probe being captured, one face at a time
+        int          m_CaptureProbe = -1;
+        unsigned int m_CaptureFace  = 0;
+        TextureCube  m_CaptureCube;
+
+        std::vector<Readback>     m_Readbacks;
+        std::vector<unsigned int> m_FreeBuffers;
+
+        // the lighting the probes were last invalidated w/
+        math::vec3  m_LightDirection;
+        math::vec3  m_LightColor;
+        PBRCapture* m_LightSky = nullptr;
+
+    public:
+        ProbeBaker(Renderer* renderer);
+        ~ProbeBaker();
+
+        // places the probes over scene and captures them all before returning
+        void Bake(SceneNode* scene);
+        // re-bakes invalidated probes: at most maxFaces cube faces (at least one), stopping
+        // early once budgetMs (CPU time) is spent.
+        void Update(unsigned int maxFaces, float budgetMs);
+
+        // invalidates all probes (e.g. after a lighting change that isn't detected)
+        void Invalidate();
+        // invalidates the probes w/in a cell of a world space box (e.g. around changed geometry)
+        void Invalidate(math::vec3 boxMin, math::vec3 boxMax);
+
+        // the number of probes waiting to be re-baked
+        unsigned int GetPendingCount() const;
+    private:
+        // detects changed nodes and lighting since the last call
+        void trackChanges(bool invalidate);
+        // (re)builds the sorted capture commands from the tracked nodes
+        void buildCommands();
+        // renders the next faces of the current (or next) probe, returns the faces rendered
+        unsigned int captureFaces(unsigned int maxFaces, float budgetMs, bool block);
+        // projects read back captures; waits for the GPU if block is set
+        void processReadbacks(bool block);
+        // queues all stale probes as a new batch
+        void startBatch();
+        // the queued probe of the highest priority, -1 if none
+        int nextProbe() const;
+    };
+}
+
+#endif
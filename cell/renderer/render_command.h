@@ -21,6 +21,7 @@ namespace Cell
         Material*  Material;
         math::vec3 BoxMin;
         math::vec3 BoxMax;
+        unsigned int Lod = 0; // level of detail of the mesh to render
     };
 }
 
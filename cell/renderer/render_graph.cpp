@@ -0,0 +1,403 @@
+#include "render_graph.h"
+
+#include "../shading/texture.h"
+
+#include <utility/logging/log.h>
+
+#include <algorithm>
+
+namespace Cell
+{
+    // the size of a texel of the (internal) formats the renderer uses
+    static size_t texelSize(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+        case GL_RGBA:    return 4;
+        case GL_R8:      return 1;
+        case GL_R16F:    return 2;
+        case GL_RG16F:   return 4;
+        case GL_RGBA8:   return 4;
+        case GL_R32F:    return 4;
+        case GL_RGB16F:  return 6;
+        case GL_RGBA16F: return 8;
+        case GL_RG32F:   return 8;
+        case GL_RGB32F:  return 12;
+        case GL_RGBA32F: return 16;
+        default:         return 4;
+        }
+    }
+    static const char* formatName(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+        case GL_RGBA:    return "RGBA";
+        case GL_R8:      return "R8";
+        case GL_R16F:    return "R16F";
+        case GL_RG16F:   return "RG16F";
+        case GL_RGBA8:   return "RGBA8";
+        case GL_R32F:    return "R32F";
+        case GL_RGB16F:  return "RGB16F";
+        case GL_RGBA16F: return "RGBA16F";
+        case GL_RG32F:   return "RG32F";
+        case GL_RGB32F:  return "RGB32F";
+        case GL_RGBA32F: return "RGBA32F";
+        default:         return "?";
+        }
+    }
+    static size_t textureSize(const RenderGraphTextureDesc& desc)
+    {
+        return (size_t)desc.Width * desc.Height * texelSize(desc.InternalFormat);
+    }
+    static bool matches(const RenderGraphTextureDesc& a, const RenderGraphTextureDesc& b)
+    {
+        return a.Width == b.Width && a.Height == b.Height && a.InternalFormat == b.InternalFormat && a.Format == b.Format && a.Type == b.Type;
+    }
+    // the barrier making image stores visible to an access
+    static GLbitfield accessBarrier(RenderGraph::ACCESS access)
+    {
+        if (access == RenderGraph::ACCESS_SAMPLE)
+            return GL_TEXTURE_FETCH_BARRIER_BIT;
+        else if (access == RenderGraph::ACCESS_ATTACHMENT)
+            return GL_FRAMEBUFFER_BARRIER_BIT;
+        return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    }
+    static const char* accessName(RenderGraph::ACCESS access)
+    {
+        if (access == RenderGraph::ACCESS_SAMPLE)
+            return "sample";
+        else if (access == RenderGraph::ACCESS_ATTACHMENT)
+            return "attachment";
+        return "image";
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::RenderGraph()
+    {
+
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::~RenderGraph()
+    {
+        for (unsigned int i = 0; i < m_Physical.size(); ++i)
+            m_Physical[i].Used = false;
+        releaseUnused();
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::Reset()
+    {
+        m_Passes.clear();
+        m_Resources.clear();
+        m_Compiled = false;
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::Resource RenderGraph::Import(std::string name, Texture* texture, bool output)
+    {
+        ResourceNode resource;
+        resource.Name     = name;
+        resource.Imported = texture;
+        resource.Output   = output;
+        if (texture)
+        {
+            resource.Desc.Width          = texture->Width;
+            resource.Desc.Height         = texture->Height;
+            resource.Desc.InternalFormat = texture->InternalFormat;
+            resource.Desc.Format         = texture->Format;
+            resource.Desc.Type           = texture->Type;
+        }
+        m_Resources.push_back(resource);
+        m_Compiled = false;
+        return (Resource)m_Resources.size() - 1;
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::Resource RenderGraph::Create(std::string name, const RenderGraphTextureDesc& desc)
+    {
+        ResourceNode resource;
+        resource.Name      = name;
+        resource.Desc      = desc;
+        resource.Transient = true;
+        resource.Desc.Width  = std::max(desc.Width, 1u);
+        resource.Desc.Height = std::max(desc.Height, 1u);
+        m_Resources.push_back(resource);
+        m_Compiled = false;
+        return (Resource)m_Resources.size() - 1;
+    }
+    // --------------------------------------------------------------------------------------------
+    RenderGraph::Pass RenderGraph::AddPass(std::string name, Execute callback)
+    {
+        PassNode pass;
+        pass.Name     = name;
+        pass.Callback = callback;
+        m_Passes.push_back(pass);
+        m_Compiled = false;
+        return (Pass)m_Passes.size() - 1;
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::Read(Pass pass, Resource resource, ACCESS access)
+    {
+        m_Passes[pass].Reads.push_back({ resource, access });
+        m_Compiled = false;
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::Write(Pass pass, Resource resource, ACCESS access)
+    {
+        m_Passes[pass].Writes.push_back({ resource, access });
+        m_Compiled = false;
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::Compile()
+    {
+        m_Stats = RenderGraphStats();
+        m_Stats.Passes = (unsigned int)m_Passes.size();
+
+        // cull: walking back from the outputs, a pass is live if a later live pass (or the
+        // frame's output) needs one of the resources it writes; its reads are then needed too.
+        std::vector<bool> needed(m_Resources.size());
+        for (unsigned int i = 0; i < m_Resources.size(); ++i)
+            needed[i] = m_Resources[i].Output;
+        for (int p = (int)m_Passes.size() - 1; p >= 0; --p)
+        {
+            PassNode& pass = m_Passes[p];
+            pass.Live = false;
+            for (const ResourceAccess& write : pass.Writes)
+                pass.Live = pass.Live || needed[write.Target];
+            if (!pass.Live)
+            {
+                ++m_Stats.PassesCulled;
+                continue;
+            }
+            for (const ResourceAccess& read : pass.Reads)
+                needed[read.Target] = true;
+        }
+
+        // lifetimes: the first and last live pass using each resource
+        for (ResourceNode& resource : m_Resources)
+        {
+            resource.Live      = false;
+            resource.FirstPass = -1;
+            resource.LastPass  = -1;
+        }
+        for (unsigned int p = 0; p < m_Passes.size(); ++p)
+        {
+            if (!m_Passes[p].Live)
+                continue;
+            for (unsigned int i = 0; i < 2; ++i)
+            {
+                for (const ResourceAccess& access : i == 0 ? m_Passes[p].Reads : m_Passes[p].Writes)
+                {
+                    ResourceNode& resource = m_Resources[access.Target];
+                    resource.Live      = true;
+                    resource.FirstPass = resource.FirstPass < 0 ? (int)p : std::min(resource.FirstPass, (int)p);
+                    resource.LastPass  = std::max(resource.LastPass, (int)p);
+                }
+            }
+        }
+
+        // aliasing: assign the live transients (in order of first use) a pooled texture of
+        // their description that's free by then, or a new one.
+        std::vector<Resource> transients;
+        for (unsigned int i = 0; i < m_Resources.size(); ++i)
+        {
+            ResourceNode& resource = m_Resources[i];
+            resource.Physical = -1;
+            if (!resource.Transient)
+                continue;
+            ++m_Stats.Transients;
+            m_Stats.DeclaredBytes += textureSize(resource.Desc);
+            if (resource.Live)
+                transients.push_back(i);
+        }
+        std::sort(transients.begin(), transients.end(), [this](Resource a, Resource b) {
+            return m_Resources[a].FirstPass < m_Resources[b].FirstPass;
+        });
+        for (unsigned int i = 0; i < m_Physical.size(); ++i)
+        {
+            m_Physical[i].Used      = false;
+            m_Physical[i].FreeAfter = -1;
+        }
+        for (Resource index : transients)
+        {
+            ResourceNode& resource = m_Resources[index];
+            int physical = -1;
+            for (unsigned int i = 0; i < m_Physical.size() && physical < 0; ++i)
+            {
+                if (matches(m_Physical[i].Desc, resource.Desc) && (!m_Physical[i].Used || m_Physical[i].FreeAfter < resource.FirstPass))
+                    physical = i;
+            }
+            if (physical < 0)
+            {
+                PhysicalTexture texture;
+                texture.Desc    = resource.Desc;
+                texture.Storage = new Texture;
+                texture.Storage->FilterMin  = GL_LINEAR;
+                texture.Storage->FilterMax  = GL_LINEAR;
+                texture.Storage->WrapS      = GL_CLAMP_TO_EDGE;
+                texture.Storage->WrapT      = GL_CLAMP_TO_EDGE;
+                texture.Storage->Mipmapping = false;
+                texture.Storage->Generate(resource.Desc.Width, resource.Desc.Height, resource.Desc.InternalFormat, resource.Desc.Format, resource.Desc.Type, nullptr);
+                m_Physical.push_back(texture);
+                physical = (int)m_Physical.size() - 1;
+            }
+            m_Physical[physical].Used      = true;
+            m_Physical[physical].FreeAfter = resource.LastPass;
+            resource.Physical = physical;
+        }
+
+        // textures not used this frame (e.g. after a resize or a disabled feature) are released
+        std::vector<int> remap(m_Physical.size(), -1);
+        for (unsigned int i = 0, j = 0; i < m_Physical.size(); ++i)
+        {
+            if (m_Physical[i].Used)
+                remap[i] = j++;
+        }
+        releaseUnused();
+        for (ResourceNode& resource : m_Resources)
+        {
+            if (resource.Physical >= 0)
+                resource.Physical = remap[resource.Physical];
+        }
+        m_Stats.Textures = (unsigned int)m_Physical.size();
+        for (const PhysicalTexture& texture : m_Physical)
+            m_Stats.AllocatedBytes += textureSize(texture.Desc);
+
+        m_Compiled = true;
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::Run()
+    {
+        if (!m_Compiled)
+            Compile();
+
+        for (PassNode& pass : m_Passes)
+        {
+            if (!pass.Live)
+                continue;
+
+            GLbitfield required = barriers(pass);
+            if (required)
+            {
+                glMemoryBarrier(required);
+                for (ResourceNode& resource : m_Resources)
+                    resource.Visible |= required;
+                for (PhysicalTexture& texture : m_Physical)
+                    texture.Visible |= required;
+            }
+
+            pass.Callback();
+
+            // image stores are only visible to later passes after a barrier
+            for (const ResourceAccess& write : pass.Writes)
+                visible(write.Target) = write.Access == ACCESS_IMAGE ? 0 : ~0u;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    Texture* RenderGraph::GetTexture(Resource resource)
+    {
+        const ResourceNode& node = m_Resources[resource];
+        if (!node.Transient)
+            return node.Imported;
+        return node.Physical >= 0 ? m_Physical[node.Physical].Storage : nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int RenderGraph::GetFramebuffer(Resource resource)
+    {
+        const ResourceNode& node = m_Resources[resource];
+        if (!node.Transient || node.Physical < 0)
+        {
+            Log::Message("Render graph: " + node.Name + " has no framebuffer (not a live transient).", LOG_WARNING);
+            return 0;
+        }
+        PhysicalTexture& texture = m_Physical[node.Physical];
+        if (!texture.Framebuffer)
+        {
+            glGenFramebuffers(1, &texture.Framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, texture.Framebuffer);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.Storage->ID, 0);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                Log::Message("Render graph: framebuffer of " + node.Name + " not complete!", LOG_WARNING);
+        }
+        return texture.Framebuffer;
+    }
+    // --------------------------------------------------------------------------------------------
+    const RenderGraphStats& RenderGraph::GetStats() const
+    {
+        return m_Stats;
+    }
+    // --------------------------------------------------------------------------------------------
+    std::string RenderGraph::Serialize() const
+    {
+        std::string result;
+        result += "// " + std::to_string(m_Stats.Passes - m_Stats.PassesCulled) + "/" + std::to_string(m_Stats.Passes) + " passes, ";
+        result += std::to_string(m_Stats.Transients) + " transients in " + std::to_string(m_Stats.Textures) + " textures, ";
+        result += std::to_string(m_Stats.AllocatedBytes / 1024) + " KB allocated of " + std::to_string(m_Stats.DeclaredBytes / 1024) + " KB declared\n";
+        result += "digraph RenderGraph\n{\n    rankdir=LR;\n";
+
+        // passes (in order), culled passes/resources dashed
+        for (unsigned int p = 0; p < m_Passes.size(); ++p)
+        {
+            const PassNode& pass = m_Passes[p];
+            result += "    p" + std::to_string(p) + " [shape=box, label=\"" + std::to_string(p) + ": " + pass.Name + "\"";
+            result += pass.Live ? "];\n" : ", style=dashed];\n";
+        }
+        for (unsigned int r = 0; r < m_Resources.size(); ++r)
+        {
+            const ResourceNode& resource = m_Resources[r];
+            std::string label = resource.Name;
+            if (resource.Transient || resource.Imported)
+                label += "\\n" + std::to_string(resource.Desc.Width) + "x" + std::to_string(resource.Desc.Height) + " " + formatName(resource.Desc.InternalFormat);
+            if (resource.Transient && resource.Live)
+                label += "\\ntexture " + std::to_string(resource.Physical) + ", passes " + std::to_string(resource.FirstPass) + "-" + std::to_string(resource.LastPass);
+            else if (!resource.Transient)
+                label += resource.Output ? "\\nimported (output)" : "\\nimported";
+            result += "    r" + std::to_string(r) + " [shape=ellipse, label=\"" + label + "\"";
+            result += resource.Live || resource.Output ? "];\n" : ", style=dashed];\n";
+        }
+        for (unsigned int p = 0; p < m_Passes.size(); ++p)
+        {
+            for (const ResourceAccess& read : m_Passes[p].Reads)
+                result += "    r" + std::to_string(read.Target) + " -> p" + std::to_string(p) + " [label=\"" + accessName(read.Access) + "\"];\n";
+            for (const ResourceAccess& write : m_Passes[p].Writes)
+                result += "    p" + std::to_string(p) + " -> r" + std::to_string(write.Target) + " [label=\"" + accessName(write.Access) + "\"];\n";
+        }
+        result += "}\n";
+        return result;
+    }
+    // --------------------------------------------------------------------------------------------
+    GLbitfield RenderGraph::barriers(const PassNode& pass)
+    {
+        GLbitfield required = 0;
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            for (const ResourceAccess& access : i == 0 ? pass.Reads : pass.Writes)
+            {
+                GLbitfield barrier = accessBarrier(access.Access);
+                if (!(visible(access.Target) & barrier))
+                    required |= barrier;
+            }
+        }
+        return required;
+    }
+    // --------------------------------------------------------------------------------------------
+    GLbitfield& RenderGraph::visible(Resource resource)
+    {
+        // aliased transients share their texture's state
+        ResourceNode& node = m_Resources[resource];
+        return node.Transient ? m_Physical[node.Physical].Visible : node.Visible;
+    }
+    // --------------------------------------------------------------------------------------------
+    void RenderGraph::releaseUnused()
+    {
+        for (unsigned int i = 0; i < m_Physical.size(); ++i)
+        {
+            PhysicalTexture& texture = m_Physical[i];
+            if (texture.Used)
+                continue;
+            if (texture.Framebuffer)
+                glDeleteFramebuffers(1, &texture.Framebuffer);
+            glDeleteTextures(1, &texture.Storage->ID);
+            delete texture.Storage;
+        }
+        m_Physical.erase(std::remove_if(m_Physical.begin(), m_Physical.end(), [](const PhysicalTexture& texture) {
+            return !texture.Used;
+        }), m_Physical.end());
+    }
+}
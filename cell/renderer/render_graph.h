@@ -0,0 +1,156 @@
+#ifndef CELL_RENDERER_RENDER_GRAPH_H
+#define CELL_RENDERER_RENDER_GRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../glad/glad.h"
+
+namespace Cell
+{
+    class Texture;
+
+    // describes a transient (2D) texture of the render graph
+    struct RenderGraphTextureDesc
+    {
+        unsigned int Width          = 1;
+        unsigned int Height         = 1;
+        GLenum       InternalFormat = GL_RGBA16F;
+        GLenum       Format         = GL_RGBA;
+        GLenum       Type           = GL_HALF_FLOAT;
+    };
+
+    // memory statistics of the last compiled render graph
+    struct RenderGraphStats
+    {
+        unsigned int Passes         = 0;
+        unsigned int PassesCulled   = 0;
+        unsigned int Transients     = 0;
+        unsigned int Textures       = 0; // allocated (aliased) textures backing the transients
+        size_t       DeclaredBytes  = 0; // all transients if each had its own texture
+        size_t       AllocatedBytes = 0;
+    };
+
+    /*
+
+      A frame's render passes declared up front, together w/ the resources each pass reads and
+      writes, instead of being run in a hand-written order w/ all their targets pre-allocated.
+
+      Resources are either imported (textures/targets owned elsewhere, like the GBuffer) or
+      transient: textures that only live for the duration of the frame and are created by the
+      graph. Each frame the graph is rebuilt (Reset, then Import/Create/AddPass) and compiled:
+
+      - Passes that don't contribute to an output resource (directly or through the passes
+        reading their results) are culled, and so are the transients only they use. Features
+        that are disabled simply aren't read by anyone.
+      - Transients are backed by a pool of textures: two transients of the same description
+        whose lifetimes (first to last pass using them) don't overlap share the same texture.
+        The pool persists between frames; textures no longer used are released.
+      - Passes run in declaration order; memory barriers are issued where a pass accesses a
+        resource that a previous pass wrote w/ image stores (which GL doesn't synchronize).
+
+      The compiled graph can be serialized (as a Graphviz graph) to inspect the passes, their
+      resources and the memory saved by culling and aliasing.
+
+    */
+    class RenderGraph
+    {
+    public:
+        typedef unsigned int          Resource;
+        typedef unsigned int          Pass;
+        typedef std::function<void()> Execute;
+
+        // how a pass accesses a resource
+        enum ACCESS
+        {
+            ACCESS_SAMPLE,     // through a sampler
+            ACCESS_ATTACHMENT, // as framebuffer attachment (or blit/clear)
+            ACCESS_IMAGE,      // w/ image load/store
+        };
+    private:
+        struct ResourceAccess
+        {
+            Resource Target;
+            ACCESS   Access;
+        };
+        struct PassNode
+        {
+            std::string                 Name;
+            Execute                     Callback;
+            std::vector<ResourceAccess> Reads;
+            std::vector<ResourceAccess> Writes;
+            bool                        Live = false;
+        };
+        struct ResourceNode
+        {
+            std::string            Name;
+            RenderGraphTextureDesc Desc;
+            Texture*               Imported  = nullptr;
+            bool                   Transient = false;
+            bool                   Output    = false;
+            bool                   Live      = false;
+            int                    FirstPass = -1;
+            int                    LastPass  = -1;
+            int                    Physical  = -1;
+            GLbitfield             Visible   = ~0u; // (imported) barriers issued since its last image write
+        };
+        struct PhysicalTexture
+        {
+            RenderGraphTextureDesc Desc;
+            Texture*               Storage     = nullptr;
+            unsigned int           Framebuffer = 0;
+            int                    FreeAfter   = -1; // the last pass of the transient it backs
+            bool                   Used        = false;
+            GLbitfield             Visible     = ~0u; // barriers issued since its last image write
+        };
+
+        std::vector<PassNode>        m_Passes;
+        std::vector<ResourceNode>    m_Resources;
+        std::vector<PhysicalTexture> m_Physical;
+        RenderGraphStats             m_Stats;
+        bool                         m_Compiled = false;
+
+    public:
+        RenderGraph();
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        // removes all passes and resources (keeping the texture pool) to declare a new frame
+        void Reset();
+
+        // a resource owned outside the graph (texture may be null, e.g. for the default
+        // framebuffer); passes writing an output resource are never culled.
+        Resource Import(std::string name, Texture* texture = nullptr, bool output = false);
+        // a texture that only lives for this frame
+        Resource Create(std::string name, const RenderGraphTextureDesc& desc);
+
+        // adds a pass, run in declaration order (unless culled)
+        Pass AddPass(std::string name, Execute callback);
+        void Read(Pass pass, Resource resource, ACCESS access = ACCESS_SAMPLE);
+        void Write(Pass pass, Resource resource, ACCESS access = ACCESS_ATTACHMENT);
+
+        // culls passes/resources and assigns the transients' textures
+        void Compile();
+        // runs all live passes (compiles first if needed)
+        void Run();
+
+        // the texture backing a resource; only valid while the graph runs (null if culled)
+        Texture*     GetTexture(Resource resource);
+        // a framebuffer w/ the transient as its single color attachment
+        unsigned int GetFramebuffer(Resource resource);
+
+        const RenderGraphStats& GetStats() const;
+        // the compiled graph as a Graphviz (dot) graph
+        std::string Serialize() const;
+    private:
+        // the barriers required before a pass may run
+        GLbitfield barriers(const PassNode& pass);
+        GLbitfield& visible(Resource resource);
+        void releaseUnused();
+    };
+}
+
+#endif
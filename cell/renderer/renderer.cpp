@@ -4,9 +4,14 @@
 #include "MaterialLibrary.h"
 #include "PBR.h"
 #include "PostProcessor.h"
+#include "irradiance_volume.h"
+#include "probe_baker.h"
+#include "render_graph.h"
+#include "gpu_timer.h"
 
 #include "../mesh/mesh.h"
 #include "../mesh/cube.h"
+#include "../mesh/meshlet_builder.h"
 #include "../shading/material.h"
 #include "../scene/scene.h"
 #include "../scene/scene_node.h"
@@ -17,14 +22,49 @@
 
 #include <math/linear_algebra/vector.h>
 #include <math/linear_algebra/matrix.h>
+#include <math/geometry/light_binning.h>
 
 #include <utility/logging/log.h>
 #include <utility/string_id.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <stack>
 
 namespace Cell
 {
+    // the number of (TXAA) jitter offsets before the sequence repeats
+    static const unsigned int JITTER_SAMPLES = 8;
+    // tiled deferred lighting: the tile size (the compute shader's work group size) and the
+    // directional lights it shades (any others get their own pass)
+    static const unsigned int LIGHT_TILE_SIZE      = 16;
+    static const unsigned int TILED_DIR_LIGHTS_MAX = 4;
+
+    // a point light of tiled deferred lighting w/ its screen footprint (see tiled_deferred.cs;
+    // std430)
+    struct TiledLight
+    {
+        math::vec4 PositionRadius;
+        math::vec4 Color;
+        int        Tiles[4];
+        math::vec4 Depth;
+    };
+
+    // the index-th element of the Halton sequence of a (prime) base: a low-discrepancy
+    // sequence in [0, 1), s.t. consecutive jitter offsets evenly cover the pixel.
+    static float halton(unsigned int index, unsigned int base)
+    {
+        float result   = 0.0f;
+        float fraction = 1.0f;
+        while (index > 0)
+        {
+            fraction /= base;
+            result   += fraction * (index % base);
+            index    /= base;
+        }
+        return result;
+    }
     // ------------------------------------------------------------------------
     Renderer::Renderer()
     {
@@ -51,11 +91,18 @@ namespace Cell
         // lighting
         delete m_DebugLightMesh;
 
+        // meshlets
+        glDeleteBuffers(1, &m_MeshletDrawBuffer);
+        glDeleteBuffers(1, &m_TiledLightBuffer);
+
         // post-processing
         delete m_PostProcessTarget1;
         delete m_PostProcessor;
+        delete m_RenderGraph;
+        delete m_FrameTimer;
 
         // pbr
+        delete m_ProbeBaker;
         delete m_PBR;      
     }
     // ------------------------------------------------------------------------
@@ -75,11 +122,17 @@ namespace Cell
 
         m_NDCPlane = new Quad;
         glGenFramebuffers(1, &m_FramebufferCubemap);
-        glGenRenderbuffers(1, &m_CubemapDepthRBO);
+        glGenTextures(1, &m_CubemapDepth);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapDepth);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
         m_CustomTarget       = new RenderTarget(1, 1, GL_HALF_FLOAT, 1, true);
         m_PostProcessTarget1 = new RenderTarget(1, 1, GL_UNSIGNED_BYTE, 1, false);
         m_PostProcessor      = new PostProcessor(this);
+        m_RenderGraph        = new RenderGraph;
+        m_FrameTimer         = new GPUTimer;
 
         // lights
         m_DebugLightMesh    = new Sphere(16, 16);
@@ -106,16 +159,30 @@ namespace Cell
        
         // pbr
         m_PBR = new PBR(this);
+        m_ProbeBaker = new ProbeBaker(this);
+
+        // meshlets
+        m_MeshletCullShader = Resources::LoadComputeShader("meshlet cull", "shaders/compute/meshlet_cull.cs");
+        glGenBuffers(1, &m_MeshletDrawBuffer);
+
+        // tiled deferred lighting
+        m_TiledLightingShader = Resources::LoadComputeShader("tiled deferred", "shaders/compute/tiled_deferred.cs");
+        m_TiledLightingShader->Use();
+        m_TiledLightingShader->SetInt("gPositionMetallic", 0);
+        m_TiledLightingShader->SetInt("gNormalRoughness", 1);
+        m_TiledLightingShader->SetInt("gAlbedoAO", 2);
+        for (unsigned int i = 0; i < TILED_DIR_LIGHTS_MAX; ++i)
+            m_TiledLightingShader->SetInt("DirLightShadowMap[" + std::to_string(i) + "]", 3 + i);
+        glGenBuffers(1, &m_TiledLightBuffer);
 
         // ubo
         glGenBuffers(1, &m_GlobalUBO);
         glBindBuffer(GL_UNIFORM_BUFFER, m_GlobalUBO);
-        glBufferData(GL_UNIFORM_BUFFER, 720, nullptr, GL_STREAM_DRAW);
+        glBufferData(GL_UNIFORM_BUFFER, 736, nullptr, GL_STREAM_DRAW);
         glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_GlobalUBO);
 
         // default PBR pre-compute (get a more default oriented HDR map for this)
-        Cell::Texture *hdrMap = Cell::Resources::LoadHDR("sky env", "textures/backgrounds/alley.hdr");
-        Cell::PBRCapture *envBridge = m_PBR->ProcessEquirectangular(hdrMap);
+        Cell::PBRCapture *envBridge = m_PBR->ProcessEquirectangular("sky env", "textures/backgrounds/alley.hdr");
         SetSkyCapture(envBridge);
     }
     // ------------------------------------------------------------------------
@@ -123,13 +190,12 @@ namespace Cell
     {
         m_RenderSize.x = width;
         m_RenderSize.y = height;
+        m_InternalSize = m_RenderSize;
 
         m_GBuffer->Resize(width, height);
 
         m_CustomTarget->Resize(width, height);
         m_PostProcessTarget1->Resize(width, height);
-        
-        m_PostProcessor->UpdateRenderSize(width, height);
     }
     // ------------------------------------------------------------------------
     math::vec2 Renderer::GetRenderSize()
@@ -137,6 +203,21 @@ namespace Cell
         return m_RenderSize;
     }
     // ------------------------------------------------------------------------
+    math::vec2 Renderer::GetInternalSize()
+    {
+        return m_InternalSize;
+    }
+    // ------------------------------------------------------------------------
+    float Renderer::GetRenderScale()
+    {
+        return m_RenderScale;
+    }
+    // ------------------------------------------------------------------------
+    float Renderer::GetGPUFrameTime()
+    {
+        return m_FrameTimer->GetTime();
+    }
+    // ------------------------------------------------------------------------
     void Renderer::SetTarget(RenderTarget* renderTarget, GLenum target)
     {
         m_CurrentRenderTargetCustom = renderTarget;
@@ -165,6 +246,11 @@ namespace Cell
         return m_PostProcessor;
     }
     // ------------------------------------------------------------------------
+    const RenderGraph* Renderer::GetRenderGraph() const
+    {
+        return m_RenderGraph;
+    }
+    // ------------------------------------------------------------------------
     Material* Renderer::CreateMaterial(std::string base)
     {
         return m_MaterialLibrary->CreateMaterial(base);      
@@ -210,7 +296,8 @@ namespace Cell
             {
                 math::vec3 boxMinWorld = node->GetWorldPosition() + (node->GetWorldScale() * node->BoxMin);
                 math::vec3 boxMaxWorld = node->GetWorldPosition() + (node->GetWorldScale() * node->BoxMax);
-                 m_CommandBuffer->Push(node->Mesh, node->Material, node->GetTransform(), node->GetPrevTransform(), boxMinWorld, boxMaxWorld, target);
+                unsigned int lod = selectLod(node, boxMinWorld, boxMaxWorld);
+                m_CommandBuffer->Push(node->Mesh, node->Material, node->GetTransform(), node->GetPrevTransform(), boxMinWorld, boxMaxWorld, target, lod);
             }
             for(unsigned int i = 0; i < node->GetChildCount(); ++i)
                 nodeStack.push(node->GetChildByIndex(i));
@@ -235,7 +322,19 @@ namespace Cell
     // ------------------------------------------------------------------------
     void Renderer::RenderPushedCommands()
     {      
+        m_FrameTimer->Begin();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_MeshletStats = MeshletStats();
+
+        // the meshlet draw commands of the previous frame may still be in flight: orphan the
+        // buffer s.t. this frame's commands get fresh storage from the start.
+        m_MeshletDrawOffset = 0;
+        if (m_MeshletDrawCapacity > 0)
+        {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_MeshletDrawBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, m_MeshletDrawCapacity * 5 * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
 
         /* 
         
@@ -249,6 +348,8 @@ namespace Cell
             own shaders and render stuff as they want, not sacrifcing flexibility; this 
             includes custom render targets.
           - Then we render all alpha blended materials last.
+          - (Optionally) resolve the jittered frame w/ temporal anti-aliasing, upscaling it
+            from the internal to the output resolution.
           - Then we do post-processing, one can supply their own post-processing materials 
             by setting the 'post-processing' flag of the material.
             Each material flagged as post-processing will run after the default post-processing 
@@ -258,9 +359,14 @@ namespace Cell
         // sort all pushed render commands by heavy state-switches e.g. shader switches.
         m_CommandBuffer->Sort();
 
-        // update (global) uniform buffers
+        // pick this frame's internal resolution and update (global) uniform buffers
+        updateRenderScale();
         updateGlobalUBOs();
 
+        // re-bake (part of) the irradiance probes affected by changes since the last frame
+        if (IrradianceProbeUpdates)
+            m_ProbeBaker->Update(IrradianceProbeFaces, IrradianceProbeBudget);
+
         // set default GL state
         m_GLCache.SetBlend(false);
         m_GLCache.SetCull(true);
@@ -268,29 +374,52 @@ namespace Cell
         m_GLCache.SetDepthTest(true);
         m_GLCache.SetDepthFunc(GL_LESS);
 
+        /* NOTE(Joey):
+
+          The frame's passes are declared on the render graph w/ the resources they read and
+          write; the graph culls what doesn't contribute to the final image (e.g. the shadow
+          pass w/o shadows, the SSAO/bloom passes when disabled), allocates the transient
+          targets and runs the remaining passes in the order declared here.
+
+          All passes up to the (TXAA) resolve render to the m_InternalSize sub-rect of the
+          screen targets, which are always allocated at the (maximum) render size s.t. dynamic
+          resolution never re-allocates them.
+
+        */
+        RenderGraph* graph = m_RenderGraph;
+        graph->Reset();
+        const RenderGraph::Resource gBuffer       = graph->Import("gbuffer", m_GBuffer->GetColorTexture(0));
+        const RenderGraph::Resource shadowMaps    = graph->Import("shadow maps");
+        const RenderGraph::Resource scene         = graph->Import("scene", m_CustomTarget->GetColorTexture(0));
+        const RenderGraph::Resource postTarget    = graph->Import("post target", m_PostProcessTarget1->GetColorTexture(0));
+        const RenderGraph::Resource customTargets = graph->Import("custom targets", nullptr, true);
+        const RenderGraph::Resource backBuffer    = graph->Import("backbuffer", nullptr, true);
+
         // 1. Geometry buffer
-        std::vector<RenderCommand> deferredRenderCommands = m_CommandBuffer->GetDeferredRenderCommands(true);
-        glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_GBuffer->ID);
-        unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
-        glDrawBuffers(4, attachments);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        m_GLCache.SetPolygonMode(Wireframe ? GL_LINE : GL_FILL);
-        for (unsigned int i = 0; i < deferredRenderCommands.size(); ++i)
-        {
-            renderCustomCommand(&deferredRenderCommands[i], nullptr, false);
-        }
-        m_GLCache.SetPolygonMode(GL_FILL);
+        RenderGraph::Pass pass = graph->AddPass("gbuffer", [&]() {
+            std::vector<RenderCommand> deferredRenderCommands = m_CommandBuffer->GetDeferredRenderCommands(true);
+            glViewport(0, 0, m_InternalSize.x, m_InternalSize.y);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_GBuffer->ID);
+            unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+            glDrawBuffers(4, attachments);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            m_GLCache.SetPolygonMode(Wireframe ? GL_LINE : GL_FILL);
+            for (unsigned int i = 0; i < deferredRenderCommands.size(); ++i)
+            {
+                renderCustomCommand(&deferredRenderCommands[i], nullptr, false);
+            }
+            m_GLCache.SetPolygonMode(GL_FILL);
 
-        //attachments[0] = GL_NONE; // disable for next pass (shadow map generation)
-        attachments[1] = GL_NONE;
-        attachments[2] = GL_NONE;
-        attachments[3] = GL_NONE;
-        glDrawBuffers(4, attachments);
+            //attachments[0] = GL_NONE; // disable for next pass (shadow map generation)
+            attachments[1] = GL_NONE;
+            attachments[2] = GL_NONE;
+            attachments[3] = GL_NONE;
+            glDrawBuffers(4, attachments);
+        });
+        graph->Write(pass, gBuffer);
 
         // 2. render all shadow casters to light shadow buffers
-        if (Shadows)
-        {
+        pass = graph->AddPass("shadows", [&]() {
             m_GLCache.SetCullFace(GL_FRONT);
             std::vector<RenderCommand> shadowRenderCommands = m_CommandBuffer->GetShadowCastRenderCommands();
             m_ShadowViewProjections.clear();
@@ -319,175 +448,222 @@ namespace Cell
                 }
             }
             m_GLCache.SetCullFace(GL_BACK);
-        }
-        attachments[0] = GL_COLOR_ATTACHMENT0;
-        glDrawBuffers(4, attachments);
 
-        // 3. do post-processing steps before lighting stage (e.g. SSAO)
-        m_PostProcessor->ProcessPreLighting(this, m_GBuffer, m_Camera);
+            unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_NONE };
+            glDrawBuffers(4, attachments);
+        });
+        graph->Write(pass, shadowMaps);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
-        glViewport(0, 0, m_CustomTarget->Width, m_CustomTarget->Height);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        // 3. do post-processing steps before lighting stage (e.g. SSAO)
+        const RenderGraph::Resource ssao = m_PostProcessor->AddPreLightingPasses(graph, this, gBuffer, m_Camera);
 
         // 4. Render deferred shader for each light (full quad for directional, spheres for point lights)
-        m_GLCache.SetDepthTest(false);
-        m_GLCache.SetBlend(true);
-        m_GLCache.SetBlendFunc(GL_ONE, GL_ONE);
-
-        // bind gbuffer
-        m_GBuffer->GetColorTexture(0)->Bind(0);
-        m_GBuffer->GetColorTexture(1)->Bind(1);
-        m_GBuffer->GetColorTexture(2)->Bind(2);
-        
-        // ambient lighting
-        renderDeferredAmbient();
+        pass = graph->AddPass("lighting", [&]() {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
+            glViewport(0, 0, m_InternalSize.x, m_InternalSize.y);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-        if (Lights)
-        {
-            // directional lights
-            for (auto it = m_DirectionalLights.begin(); it != m_DirectionalLights.end(); ++it)
+            m_GLCache.SetDepthTest(false);
+            m_GLCache.SetBlend(true);
+            m_GLCache.SetBlendFunc(GL_ONE, GL_ONE);
+
+            // bind gbuffer
+            m_GBuffer->GetColorTexture(0)->Bind(0);
+            m_GBuffer->GetColorTexture(1)->Bind(1);
+            m_GBuffer->GetColorTexture(2)->Bind(2);
+
+            // ambient lighting
+            renderDeferredAmbient(m_PostProcessor->SSAO ? graph->GetTexture(ssao) : nullptr);
+
+            if (Lights && TiledLighting)
             {
-                renderDeferredDirLight(*it);
+                renderDeferredTiled();
             }
-            // point lights
-            m_GLCache.SetCullFace(GL_FRONT);
-            for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
+            else if (Lights)
             {
-                // only render point lights if within frustum
-                if (m_Camera->Frustum.Intersect((*it)->Position, (*it)->Radius))
+                // directional lights
+                for (auto it = m_DirectionalLights.begin(); it != m_DirectionalLights.end(); ++it)
+                {
+                    renderDeferredDirLight(*it);
+                }
+                // point lights
+                m_GLCache.SetCullFace(GL_FRONT);
+                for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
                 {
-                    renderDeferredPointLight(*it);
+                    // only render point lights if within frustum
+                    if (m_Camera->Frustum.Intersect((*it)->Position, (*it)->Radius))
+                    {
+                        renderDeferredPointLight(*it);
+                    }
                 }
+                m_GLCache.SetCullFace(GL_BACK);
             }
-            m_GLCache.SetCullFace(GL_BACK);
-        }
 
-        m_GLCache.SetDepthTest(true);
-        m_GLCache.SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-        m_GLCache.SetBlend(false);
-
-        // 5. blit depth buffer to default for forward rendering
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_GBuffer->ID);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_CustomTarget->ID); // write to default framebuffer
-        glBlitFramebuffer(
-            0, 0, m_GBuffer->Width, m_GBuffer->Height, 0, 0, m_RenderSize.x, m_RenderSize.y, GL_DEPTH_BUFFER_BIT, GL_NEAREST
-        );
+            m_GLCache.SetDepthTest(true);
+            m_GLCache.SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            m_GLCache.SetBlend(false);
+
+            // 5. blit depth buffer to default for forward rendering
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, m_GBuffer->ID);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_CustomTarget->ID); // write to default framebuffer
+            glBlitFramebuffer(
+                0, 0, m_InternalSize.x, m_InternalSize.y, 0, 0, m_InternalSize.x, m_InternalSize.y, GL_DEPTH_BUFFER_BIT, GL_NEAREST
+            );
+        });
+        graph->Read(pass, gBuffer);
+        if (Shadows)
+            graph->Read(pass, shadowMaps);
+        if (m_PostProcessor->SSAO)
+            graph->Read(pass, ssao);
+        graph->Write(pass, scene);
 
         // 6. custom forward render pass 
-        // push default render target to the end of the render target buffer s.t. we always render 
-        // the default buffer last.
-        m_RenderTargetsCustom.push_back(nullptr);        
-        for (unsigned int targetIndex = 0; targetIndex < m_RenderTargetsCustom.size(); ++targetIndex)
-        {
-            RenderTarget *renderTarget = m_RenderTargetsCustom[targetIndex];
-            if (renderTarget)
+        pass = graph->AddPass("forward", [&]() {
+            // push default render target to the end of the render target buffer s.t. we always render 
+            // the default buffer last.
+            m_RenderTargetsCustom.push_back(nullptr);        
+            for (unsigned int targetIndex = 0; targetIndex < m_RenderTargetsCustom.size(); ++targetIndex)
             {
-                glViewport(0, 0, renderTarget->Width, renderTarget->Height);
-                glBindFramebuffer(GL_FRAMEBUFFER, renderTarget->ID);
-                if (renderTarget->HasDepthAndStencil)
-                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+                RenderTarget *renderTarget = m_RenderTargetsCustom[targetIndex];
+                if (renderTarget)
+                {
+                    glViewport(0, 0, renderTarget->Width, renderTarget->Height);
+                    glBindFramebuffer(GL_FRAMEBUFFER, renderTarget->ID);
+                    if (renderTarget->HasDepthAndStencil)
+                        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+                    else
+                        glClear(GL_COLOR_BUFFER_BIT);
+                    m_Camera->SetPerspective(m_Camera->FOV, 
+                                             (float)renderTarget->Width / (float)renderTarget->Height, 
+                                             0.1, 100.0f); 
+                }
                 else
-                    glClear(GL_COLOR_BUFFER_BIT);
-                m_Camera->SetPerspective(m_Camera->FOV, 
-                                         (float)renderTarget->Width / (float)renderTarget->Height, 
-                                         0.1, 100.0f); 
-            }
-            else
-            {
-                // don't render to default framebuffer, but to custom target framebuffer which 
-                // we'll use for post-processing.
-                glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
-                glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
-                m_Camera->SetPerspective(m_Camera->FOV, m_RenderSize.x / m_RenderSize.y, 0.1, 
-                                         100.0f);
-            }
+                {
+                    // don't render to default framebuffer, but to custom target framebuffer which 
+                    // we'll use for post-processing.
+                    glViewport(0, 0, m_InternalSize.x, m_InternalSize.y);
+                    glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
+                    m_Camera->SetPerspective(m_Camera->FOV, m_RenderSize.x / m_RenderSize.y, 0.1, 
+                                             100.0f);
+                }
 
-            // sort all render commands and retrieve the sorted array
-            std::vector<RenderCommand> renderCommands = m_CommandBuffer->GetCustomRenderCommands(renderTarget);
+                // sort all render commands and retrieve the sorted array
+                std::vector<RenderCommand> renderCommands = m_CommandBuffer->GetCustomRenderCommands(renderTarget);
 
-            // terate over all the render commands and execute
-            m_GLCache.SetPolygonMode(Wireframe ? GL_LINE : GL_FILL);
-            for (unsigned int i = 0; i < renderCommands.size(); ++i)
-            {
-                renderCustomCommand(&renderCommands[i], nullptr);
+                // terate over all the render commands and execute
+                m_GLCache.SetPolygonMode(Wireframe ? GL_LINE : GL_FILL);
+                for (unsigned int i = 0; i < renderCommands.size(); ++i)
+                {
+                    renderCustomCommand(&renderCommands[i], nullptr);
+                }
+                m_GLCache.SetPolygonMode(GL_FILL);
             }
-            m_GLCache.SetPolygonMode(GL_FILL);
-        }
 
-        // 7. alpha material pass
-        glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
-        std::vector<RenderCommand> alphaRenderCommands = m_CommandBuffer->GetAlphaRenderCommands(true);
-        for (unsigned int i = 0; i < alphaRenderCommands.size(); ++i)
-        {
-            renderCustomCommand(&alphaRenderCommands[i], nullptr);
-        }
+            // 7. alpha material pass
+            glViewport(0, 0, m_InternalSize.x, m_InternalSize.y);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
+            std::vector<RenderCommand> alphaRenderCommands = m_CommandBuffer->GetAlphaRenderCommands(true);
+            for (unsigned int i = 0; i < alphaRenderCommands.size(); ++i)
+            {
+                renderCustomCommand(&alphaRenderCommands[i], nullptr);
+            }
 
-        // render light mesh (as visual cue), if requested
-        for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
-        {
-            if ((*it)->RenderMesh)
+            // render light mesh (as visual cue), if requested
+            for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
             {
-                m_MaterialLibrary->debugLightMaterial->SetVector("lightColor", (*it)->Color * (*it)->Intensity * 0.25f);
+                if ((*it)->RenderMesh)
+                {
+                    m_MaterialLibrary->debugLightMaterial->SetVector("lightColor", (*it)->Color * (*it)->Intensity * 0.25f);
 
-                RenderCommand command;
-                command.Material = m_MaterialLibrary->debugLightMaterial;
-                command.Mesh = m_DebugLightMesh;
-                math::mat4 model;
-                math::translate(model, (*it)->Position);
-                math::scale(model, math::vec3(0.25f));
-                command.Transform = model;
+                    RenderCommand command;
+                    command.Material = m_MaterialLibrary->debugLightMaterial;
+                    command.Mesh = m_DebugLightMesh;
+                    math::mat4 model;
+                    math::translate(model, (*it)->Position);
+                    math::scale(model, math::vec3(0.25f));
+                    command.Transform = model;
 
-                renderCustomCommand(&command, nullptr);
+                    renderCustomCommand(&command, nullptr);
+                }
             }
-        }
+        });
+        if (Shadows)
+            graph->Read(pass, shadowMaps);
+        graph->Write(pass, scene);
+        graph->Write(pass, customTargets);
+
+        // 8. render debug visuals
+        pass = graph->AddPass("debug", [&]() {
+            glViewport(0, 0, m_InternalSize.x, m_InternalSize.y);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
+            if (LightVolumes)
+            {
+                m_GLCache.SetPolygonMode(GL_LINE);
+                m_GLCache.SetCullFace(GL_FRONT);
+                for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
+                {
+                    m_MaterialLibrary->debugLightMaterial->SetVector("lightColor", (*it)->Color);
 
-        // 8. post-processing stage after all lighting calculations 
-        m_PostProcessor->ProcessPostLighting(this, m_GBuffer, m_CustomTarget, m_Camera);
+                    RenderCommand command;
+                    command.Material = m_MaterialLibrary->debugLightMaterial;
+                    command.Mesh = m_DebugLightMesh;
+                    math::mat4 model;
+                    math::translate(model, (*it)->Position);
+                    math::scale(model, math::vec3((*it)->Radius));
+                    command.Transform = model;
 
-        // 9. render debug visuals
-        glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
-        if (LightVolumes)
-        {
-            m_GLCache.SetPolygonMode(GL_LINE);
-            m_GLCache.SetCullFace(GL_FRONT);
-            for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
+                    renderCustomCommand(&command, nullptr);
+                }
+                m_GLCache.SetPolygonMode(GL_FILL);
+                m_GLCache.SetCullFace(GL_BACK);
+            }
+            if (RenderProbes)
             {
-                m_MaterialLibrary->debugLightMaterial->SetVector("lightColor", (*it)->Color);
+                m_PBR->RenderProbes();
+            }
+        });
+        graph->Write(pass, scene);
 
-                RenderCommand command;
-                command.Material = m_MaterialLibrary->debugLightMaterial;
-                command.Mesh = m_DebugLightMesh;
-                math::mat4 model;
-                math::translate(model, (*it)->Position);
-                math::scale(model, math::vec3((*it)->Radius));
-                command.Transform = model;
+        // 9. temporal anti-aliasing (if enabled): from here on the frame is at the render size
+        const RenderGraph::Resource resolved = m_PostProcessor->AddResolvePass(graph, this, scene, gBuffer);
 
-                renderCustomCommand(&command, nullptr);
-            }
-            m_GLCache.SetPolygonMode(GL_FILL);
-            m_GLCache.SetCullFace(GL_BACK);
-        }
-        if (RenderProbes)
-        {
-            m_PBR->RenderProbes();
-        }
+        // 10. post-processing stage after all lighting calculations 
+        const RenderGraph::Resource bloom = m_PostProcessor->AddPostLightingPasses(graph, this, resolved);
 
-        // 10. custom post-processing pass
+        // 11. custom post-processing pass
         std::vector<RenderCommand> postProcessingCommands = m_CommandBuffer->GetPostProcessingRenderCommands();
-        for (unsigned int i = 0; i < postProcessingCommands.size(); ++i)
+        if (!postProcessingCommands.empty())
         {
-            // ping-pong between render textures
-            bool even = i % 2 == 0;
-            Blit(even ? m_CustomTarget->GetColorTexture(0) : m_PostProcessTarget1->GetColorTexture(0),
-                 even ? m_PostProcessTarget1 : m_CustomTarget, 
-                 postProcessingCommands[i].Material);
+            pass = graph->AddPass("custom post-processing", [&]() {
+                for (unsigned int i = 0; i < postProcessingCommands.size(); ++i)
+                {
+                    // ping-pong between render textures, starting from the resolved frame
+                    bool even = i % 2 == 0;
+                    Texture* source = i == 0 ? graph->GetTexture(resolved) : even ? m_CustomTarget->GetColorTexture(0) : m_PostProcessTarget1->GetColorTexture(0);
+                    Blit(source,
+                         even ? m_PostProcessTarget1 : m_CustomTarget, 
+                         postProcessingCommands[i].Material);
+                }
+            });
+            graph->Read(pass, resolved);
+            graph->Write(pass, scene);
+            graph->Write(pass, postTarget);
         }
 
-        // 11. final post-processing steps, blitting to default framebuffer
-        m_PostProcessor->Blit(this, postProcessingCommands.size() % 2 == 0 ? m_CustomTarget->GetColorTexture(0) : m_PostProcessTarget1->GetColorTexture(0));
+        // 12. final post-processing steps, blitting to default framebuffer
+        const RenderGraph::Resource result = postProcessingCommands.empty() ? resolved : postProcessingCommands.size() % 2 == 0 ? scene : postTarget;
+        pass = graph->AddPass("composite", [&]() {
+            m_PostProcessor->Blit(this, graph->GetTexture(result), m_PostProcessor->Bloom ? graph->GetTexture(bloom) : nullptr);
+        });
+        graph->Read(pass, result);
+        graph->Read(pass, gBuffer);
+        if (m_PostProcessor->Bloom)
+            graph->Read(pass, bloom);
+        graph->Write(pass, backBuffer);
+
+        graph->Compile();
+        graph->Run();
+        m_FrameTimer->End();
 
         // store view projection as previous view projection for next frame's motion blur
         m_PrevViewProjection = m_Camera->Projection * m_Camera->View;
@@ -549,9 +725,16 @@ namespace Cell
         return m_PBR->GetSkyCapture();
     }
     // ------------------------------------------------------------------------
-    void Renderer::AddIrradianceProbe(math::vec3 position, float radius)
+    void Renderer::SetIrradianceVolume(math::vec3 boxMin, math::vec3 boxMax)
     {
-        m_ProbeSpatials.push_back(math::vec4(position, radius));
+        m_ProbeVolumeMin = boxMin;
+        m_ProbeVolumeMax = boxMax;
+        m_ProbeVolumeFromScene = false;
+    }
+    // ------------------------------------------------------------------------
+    const MeshletStats& Renderer::GetMeshletStats() const
+    {
+        return m_MeshletStats;
     }
     // ------------------------------------------------------------------------
     void Renderer::BakeProbes(SceneNode* scene)
@@ -561,75 +744,25 @@ namespace Cell
             // if no scene node was provided, use root node (capture all)
             scene = Scene::Root;
         }
-        scene->UpdateTransform();
-        // build a command list of nodes within the reflection probe's capture box/radius.
-        CommandBuffer commandBuffer(this);
-        std::vector<Material*> materials;
-     
-        // originally a recursive function but transformed to iterative version
-        std::stack<SceneNode*> sceneStack;
-        sceneStack.push(scene);
-        while (!sceneStack.empty())
-        {
-            SceneNode *node = sceneStack.top();
-            sceneStack.pop();
-            if (node->Mesh)
-            {
-                auto samplerUniforms = *(node->Material->GetSamplerUniforms());
-                if (samplerUniforms.find("TexAlbedo") != samplerUniforms.end())
-                {
-                    materials.push_back(new Material(m_PBR->m_ProbeCaptureShader));
-                    materials[materials.size() - 1]->SetTexture("TexAlbedo", samplerUniforms["TexAlbedo"].Texture, 0);
-                    if (samplerUniforms.find("TexNormal") != samplerUniforms.end())
-                    {
-                        materials[materials.size() - 1]->SetTexture("TexNormal", samplerUniforms["TexNormal"].Texture, 1);
-                    }
-                    if (samplerUniforms.find("TexMetallic") != samplerUniforms.end())
-                    {
-                        materials[materials.size() - 1]->SetTexture("TexMetallic", samplerUniforms["TexMetallic"].Texture, 2);
-                    }
-                    if (samplerUniforms.find("TexRoughness") != samplerUniforms.end())
-                    {
-                        materials[materials.size() - 1]->SetTexture("TexRoughness", samplerUniforms["TexRoughness"].Texture, 3);
-                    }
-                    commandBuffer.Push(node->Mesh, materials[materials.size() - 1], node->GetTransform());
-                }
-                else if (samplerUniforms.find("background") != samplerUniforms.end())
-                {   // we have a background scene node, add those as well
-                    materials.push_back(new Material(m_PBR->m_ProbeCaptureBackgroundShader));
-                    materials[materials.size() - 1]->SetTextureCube("background", samplerUniforms["background"].TextureCube, 0);
-                    materials[materials.size() - 1]->DepthCompare = node->Material->DepthCompare;
-                    commandBuffer.Push(node->Mesh, materials[materials.size() - 1], node->GetTransform());
-                }
-            }
-            for (unsigned int i = 0; i < node->GetChildCount(); ++i)
-                sceneStack.push(node->GetChildByIndex(i));
-        }
-        commandBuffer.Sort();
-        std::vector<RenderCommand> renderCommands = commandBuffer.GetCustomRenderCommands(nullptr);
-
-        m_PBR->ClearIrradianceProbes();
-        for (int i = 0; i < m_ProbeSpatials.size(); ++i)
-        {
-            TextureCube renderResult;
-            renderResult.DefaultInitialize(32, 32, GL_RGB, GL_FLOAT);
-
-            renderToCubemap(renderCommands, &renderResult, m_ProbeSpatials[i].xyz);
-
-            PBRCapture* capture = m_PBR->ProcessCube(&renderResult, false);
-            m_PBR->AddIrradianceProbe(capture, m_ProbeSpatials[i].xyz, m_ProbeSpatials[i].w);
-        }
-
-        for (int i = 0; i < materials.size(); ++i)
-        {
-            delete materials[i];
-        }
-    }  
+        m_ProbeBaker->Bake(scene);
+    }
+    // ------------------------------------------------------------------------
+    void Renderer::InvalidateProbes()
+    {
+        m_ProbeBaker->Invalidate();
+    }
     // ------------------------------------------------------------------------
-    void Renderer::renderCustomCommand(RenderCommand* command, Camera* customCamera, bool updateGLSettings)
+    unsigned int Renderer::GetPendingProbeCount()
+    {
+        return m_ProbeBaker->GetPendingCount();
+    }
+    // ------------------------------------------------------------------------
+    void Renderer::renderCustomCommand(RenderCommand* command, Camera* customCamera, bool updateGLSettings, Shader* shader)
     {
         Material *material = command->Material;
         Mesh     *mesh     = command->Mesh;
+        if (!shader)
+            shader = material->GetShader();
 
         // update global GL blend state based on material
         if (updateGLSettings)
@@ -647,24 +780,24 @@ namespace Cell
 
         // default uniforms that are always configured regardless of shader configuration (see them 
         // as a default set of shader uniform variables always there); with UBO
-        material->GetShader()->Use();
+        shader->Use();
         if (customCamera) // pass custom camera specific uniform
         {
-            material->GetShader()->SetMatrix("projection", customCamera->Projection);
-            material->GetShader()->SetMatrix("view",       customCamera->View);
-            material->GetShader()->SetVector("CamPos",     customCamera->Position);
+            shader->SetMatrix("projection", customCamera->Projection);
+            shader->SetMatrix("view",       customCamera->View);
+            shader->SetVector("CamPos",     customCamera->Position);
         }
-        material->GetShader()->SetMatrix("model", command->Transform);
-        material->GetShader()->SetMatrix("prevModel", command->PrevTransform);
+        shader->SetMatrix("model", command->Transform);
+        shader->SetMatrix("prevModel", command->PrevTransform);
 
-        material->GetShader()->SetBool("ShadowsEnabled", Shadows);
+        shader->SetBool("ShadowsEnabled", Shadows);
         if (Shadows && material->Type == MATERIAL_CUSTOM && material->ShadowReceive)
         {
             for (int i = 0; i < m_DirectionalLights.size(); ++i)
             {
                 if (m_DirectionalLights[i]->ShadowMapRT)
                 {
-                    material->GetShader()->SetMatrix("lightShadowViewProjection" + std::to_string(i + 1), m_DirectionalLights[i]->LightSpaceViewProjection);
+                    shader->SetMatrix("lightShadowViewProjection" + std::to_string(i + 1), m_DirectionalLights[i]->LightSpaceViewProjection);
                     m_DirectionalLights[i]->ShadowMapRT->GetDepthStencilTexture()->Bind(10 + i);
                 }
             }
@@ -687,31 +820,31 @@ namespace Cell
             switch (it->second.Type)
             {
             case SHADER_TYPE_BOOL:
-                material->GetShader()->SetBool(it->first, it->second.Bool);
+                shader->SetBool(it->first, it->second.Bool);
                 break;
             case SHADER_TYPE_INT:
-                material->GetShader()->SetInt(it->first, it->second.Int);
+                shader->SetInt(it->first, it->second.Int);
                 break;
             case SHADER_TYPE_FLOAT:
-                material->GetShader()->SetFloat(it->first, it->second.Float);
+                shader->SetFloat(it->first, it->second.Float);
                 break;
             case SHADER_TYPE_VEC2:
-                material->GetShader()->SetVector(it->first, it->second.Vec2);
+                shader->SetVector(it->first, it->second.Vec2);
                 break;
             case SHADER_TYPE_VEC3:
-                material->GetShader()->SetVector(it->first, it->second.Vec3);
+                shader->SetVector(it->first, it->second.Vec3);
                 break;
             case SHADER_TYPE_VEC4:
-                material->GetShader()->SetVector(it->first, it->second.Vec4);
+                shader->SetVector(it->first, it->second.Vec4);
                 break;
             case SHADER_TYPE_MAT2:
-                material->GetShader()->SetMatrix(it->first, it->second.Mat2);
+                shader->SetMatrix(it->first, it->second.Mat2);
                 break;
             case SHADER_TYPE_MAT3:
-                material->GetShader()->SetMatrix(it->first, it->second.Mat3);
+                shader->SetMatrix(it->first, it->second.Mat3);
                 break;
             case SHADER_TYPE_MAT4:
-                material->GetShader()->SetMatrix(it->first, it->second.Mat4);
+                shader->SetMatrix(it->first, it->second.Mat4);
                 break;
             default:
                 Log::Message("Unrecognized Uniform type set.", LOG_ERROR);
@@ -719,7 +852,12 @@ namespace Cell
             }
         }
 
-        renderMesh(mesh, material->GetShader());
+        // NOTE(Joey): meshlets are culled against the main camera; custom cameras (e.g. cubemap
+        // captures) render the mesh in full.
+        if (MeshletCulling && !customCamera && command->Lod == 0 && !mesh->m_Meshlets.empty())
+            renderMeshlets(mesh, material, command->Transform);
+        else
+            renderMesh(mesh, shader, command->Lod);
     }
     // ------------------------------------------------------------------------
     void Renderer::renderToCubemap(SceneNode* scene,
@@ -730,7 +868,9 @@ namespace Cell
         // create a command buffer specifically for this operation (as to not conflict with main 
         // command buffer)
         CommandBuffer commandBuffer(this);
-        commandBuffer.Push(scene->Mesh, scene->Material, scene->GetTransform());
+        // (w/ world space bounds for culling the cubemap's faces)
+        commandBuffer.Push(scene->Mesh, scene->Material, scene->GetTransform(), scene->GetTransform(),
+                           scene->GetWorldPosition() + scene->GetWorldScale() * scene->BoxMin, scene->GetWorldPosition() + scene->GetWorldScale() * scene->BoxMax);
         // recursive function transformed to iterative version by maintaining a stack
         std::stack<SceneNode*> childStack;
         for (unsigned int i = 0; i < scene->GetChildCount(); ++i)
@@ -739,7 +879,8 @@ namespace Cell
         {
             SceneNode *child = childStack.top();
             childStack.pop();
-            commandBuffer.Push(child->Mesh, child->Material, child->GetTransform());
+            commandBuffer.Push(child->Mesh, child->Material, child->GetTransform(), child->GetTransform(),
+                               child->GetWorldPosition() + child->GetWorldScale() * child->BoxMin, child->GetWorldPosition() + child->GetWorldScale() * child->BoxMax);
             for (unsigned int i = 0; i < child->GetChildCount(); ++i)
                 childStack.push(child->GetChildByIndex(i));
         }
@@ -749,7 +890,8 @@ namespace Cell
         renderToCubemap(renderCommands, target, position, mipLevel);
     }
     // ------------------------------------------------------------------------
-    void Renderer::renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, math::vec3 position, unsigned int mipLevel)
+    void Renderer::renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, math::vec3 position, unsigned int mipLevel,
+                                   unsigned int firstFace, unsigned int faceCount)
     {
         // define 6 camera directions/lookup vectors
         Camera faceCameras[6] = {
@@ -762,55 +904,319 @@ namespace Cell
         };
 
         // resize target dimensions based on mip level we're rendering.
-        float width = (float)target->FaceWidth * pow(0.5, mipLevel);
-        float height = (float)target->FaceHeight * pow(0.5, mipLevel);
+        unsigned int width  = std::max(target->FaceWidth >> mipLevel, 1u);
+        unsigned int height = std::max(target->FaceHeight >> mipLevel, 1u);
 
+        // NOTE(Joey): the depth cubemap only ever grows: a framebuffer renders to the
+        // intersection of its attachments, s.t. smaller targets and mip levels reuse it as is
+        // instead of reallocating its storage on every capture.
         glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferCubemap);
-        glBindRenderbuffer(GL_RENDERBUFFER, m_CubemapDepthRBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
-            m_CubemapDepthRBO);
-
-        // resize relevant buffers
+        if (std::max(width, height) > m_CubemapDepthSize)
+        {
+            m_CubemapDepthSize = std::max(width, height);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapDepth);
+            for (unsigned int i = 0; i < 6; ++i)
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT24, m_CubemapDepthSize, m_CubemapDepthSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        }
         glViewport(0, 0, width, height);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferCubemap);
 
-        for (unsigned int i = 0; i < 6; ++i)
+        // cull the commands against each face's frustum first; a command is only rendered to
+        // the faces it touches.
+        for (unsigned int i = firstFace; i < firstFace + faceCount; ++i)
+        {
+            faceCameras[i].SetPerspective(math::Deg2Rad(90.0f), (float)width / height, 0.1f, 100.0f);
+            faceCameras[i].Right = math::cross(faceCameras[i].Forward, faceCameras[i].Up);
+            faceCameras[i].Frustum.Update(&faceCameras[i]);
+        }
+        // a full cubemap is rendered in a single layered pass if all shaders support it
+        bool layered = LayeredCubemaps && firstFace == 0 && faceCount == 6;
+        std::vector<unsigned int> commandFaces(renderCommands.size(), 0);
+        for (unsigned int c = 0; c < renderCommands.size(); ++c)
+        {
+            // cubemap generation only works w/ custom materials 
+            assert(renderCommands[c].Material->Type == MATERIAL_CUSTOM);
+            for (unsigned int i = firstFace; i < firstFace + faceCount; ++i)
+            {
+                if (faceCameras[i].Frustum.Intersect(renderCommands[c].BoxMin, renderCommands[c].BoxMax))
+                    commandFaces[c] |= 1 << i;
+            }
+            if (commandFaces[c])
+                layered = layered && m_LayeredShaders.find(renderCommands[c].Material->GetShader()) != m_LayeredShaders.end();
+        }
+
+        if (layered)
         {
-            Camera *camera = &faceCameras[i];
-            camera->SetPerspective(math::Deg2Rad(90.0f), width / height, 0.1f, 100.0f);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, target->ID, mipLevel);
+            // attach all faces at once: each draw is submitted once and the geometry shader
+            // (cube_layered.gs) routes its triangles to the faces in its mask.
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target->ID, mipLevel);
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_CubemapDepth, 0);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            for (unsigned int i = 0; i < renderCommands.size(); ++i)
+
+            math::mat4 faceViews[6];
+            for (unsigned int i = 0; i < 6; ++i)
+                faceViews[i] = faceCameras[i].View;
+            std::vector<Shader*> prepared;
+            for (unsigned int c = 0; c < renderCommands.size(); ++c)
             {
-                // cubemap generation only works w/ custom materials 
-                assert(renderCommands[i].Material->Type == MATERIAL_CUSTOM);
-                renderCustomCommand(&renderCommands[i], camera);
+                if (!commandFaces[c])
+                    continue;
+                Shader* shader = m_LayeredShaders[renderCommands[c].Material->GetShader()];
+                shader->Use();
+                // the face transforms are shared by all draws; upload them once per shader
+                if (std::find(prepared.begin(), prepared.end(), shader) == prepared.end())
+                {
+                    shader->SetMatrixArray("FaceView", 6, faceViews);
+                    prepared.push_back(shader);
+                }
+                shader->SetInt("FaceMask", commandFaces[c]);
+                renderCustomCommand(&renderCommands[c], &faceCameras[0], true, shader);
             }
         }
+        else
+        {
+            for (unsigned int i = firstFace; i < firstFace + faceCount; ++i)
+            {
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, target->ID, mipLevel);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, m_CubemapDepth, 0);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                for (unsigned int c = 0; c < renderCommands.size(); ++c)
+                {
+                    if (commandFaces[c] & (1 << i))
+                        renderCustomCommand(&renderCommands[c], &faceCameras[i]);
+                }
+            }
+        }
+    }
+    // ------------------------------------------------------------------------
+    void Renderer::setLayeredShader(Shader* shader, Shader* layered)
+    {
+        m_LayeredShaders[shader] = layered;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Renderer::renderMesh(Mesh* mesh, Shader* shader, unsigned int lod)
+    {
+        bindMesh(mesh, shader);
+        if (mesh->m_IndexCount > 0)
+        {
+            // w/ levels of detail the index buffer holds all levels; only draw the selected one.
+            unsigned int offset = 0, count = mesh->m_IndexCount;
+            if (!mesh->m_Lods.empty())
+            {
+                const LodRange& range = mesh->m_Lods[std::min(lod, (unsigned int)mesh->m_Lods.size() - 1)];
+                offset = range.IndexOffset;
+                count  = range.IndexCount;
+            }
+            glDrawElements(mesh->Topology == TRIANGLE_STRIP ? GL_TRIANGLE_STRIP : GL_TRIANGLES, count, GL_UNSIGNED_INT, (GLvoid*)(offset * sizeof(unsigned int)));
+        }
+        else
+        {
+            glDrawArrays(mesh->Topology == TRIANGLE_STRIP ? GL_TRIANGLE_STRIP : GL_TRIANGLES, 0, mesh->m_VertexCount);
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    void Renderer::renderMeshlets(Mesh* mesh, Material* material, const math::mat4& transform)
+    {
+        const std::vector<Meshlet>& meshlets = mesh->m_Meshlets;
+        const unsigned int meshletCount = (unsigned int)meshlets.size();
+        // NOTE(Joey): deferred commands don't configure the material's GL state, but render w/
+        // back face culling enabled (and materials default to it) so its cull state holds for both.
+        const bool backfaceCulling = material->Cull && material->CullFace == GL_BACK;
+        MeshletView view = MeshletBuilder::ObjectSpaceView(transform, m_Camera->Frustum, m_Camera->Position, backfaceCulling);
+
+        // the CPU path culls each meshlet and coalesces the visible ranges that are adjacent in
+        // the index buffer into as few draws as possible.
+        const bool cpuCulling = !GPUMeshletCulling;
+        if (cpuCulling || MeshletStatistics)
+        {
+            m_MeshletCounts.clear();
+            m_MeshletOffsets.clear();
+            unsigned int rangeEnd = 0xFFFFFFFF;
+            for (unsigned int i = 0; i < meshletCount; ++i)
+            {
+                const Meshlet& meshlet = meshlets[i];
+                MESHLET_CULL result = MeshletBuilder::Cull(meshlet, view);
+                if (MeshletStatistics)
+                {
+                    m_MeshletStats.Meshlets  += 1;
+                    m_MeshletStats.Triangles += meshlet.IndexCount / 3;
+                    m_MeshletStats.CulledFrustum   += result == MESHLET_CULLED_FRUSTUM ? 1 : 0;
+                    m_MeshletStats.CulledCone      += result == MESHLET_CULLED_CONE ? 1 : 0;
+                    m_MeshletStats.TrianglesCulled += result != MESHLET_VISIBLE ? meshlet.IndexCount / 3 : 0;
+                }
+                if (result != MESHLET_VISIBLE || !cpuCulling)
+                    continue;
+                if (meshlet.IndexOffset == rangeEnd)
+                    m_MeshletCounts.back() += meshlet.IndexCount;
+                else
+                {
+                    m_MeshletCounts.push_back(meshlet.IndexCount);
+                    m_MeshletOffsets.push_back((const void*)(meshlet.IndexOffset * sizeof(unsigned int)));
+                }
+                rangeEnd = meshlet.IndexOffset + meshlet.IndexCount;
+            }
+        }
+
+        if (cpuCulling)
+        {
+            if (m_MeshletCounts.empty())
+                return;
+            bindMesh(mesh, material->GetShader());
+            glMultiDrawElements(GL_TRIANGLES, &m_MeshletCounts[0], GL_UNSIGNED_INT, &m_MeshletOffsets[0], (GLsizei)m_MeshletCounts.size());
+            return;
+        }
+
+        // the GPU path writes an indirect draw command per meshlet (w/ a zero count if culled)
+        // to a range of the draw buffer that's shared by all meshes of the frame (and reset at
+        // the start of each frame). Only if a frame's meshlets don't fit is the buffer orphaned
+        // (the draws already issued keep their storage) and grown, s.t. its size settles at
+        // the largest frame's meshlet count.
+        const unsigned int commandSize = 5 * sizeof(unsigned int);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_MeshletDrawBuffer);
+        if (m_MeshletDrawOffset + meshletCount > m_MeshletDrawCapacity)
+        {
+            m_MeshletDrawCapacity = std::max(m_MeshletDrawCapacity * 2, std::max(m_MeshletDrawOffset + meshletCount, 4096u));
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, m_MeshletDrawCapacity * commandSize, nullptr, GL_STREAM_DRAW);
+            m_MeshletDrawOffset = 0;
+        }
+        std::vector<math::vec4> planes(view.Planes, view.Planes + 6);
+        m_MeshletCullShader->Use();
+        m_MeshletCullShader->SetInt("MeshletCount", meshletCount);
+        m_MeshletCullShader->SetInt("DrawOffset", m_MeshletDrawOffset);
+        m_MeshletCullShader->SetVectorArray("FrustumPlanes", 6, planes);
+        m_MeshletCullShader->SetVector("EyePosition", view.Eye);
+        m_MeshletCullShader->SetBool("ConeCulling", view.ConeCulling);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mesh->m_MeshletBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_MeshletDrawBuffer);
+        m_MeshletCullShader->Dispatch((meshletCount + 63) / 64);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+        // the material's uniform state is kept by its program; only re-activate it.
+        material->GetShader()->Use();
+        bindMesh(mesh, material->GetShader());
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)(uintptr_t)((GLintptr)m_MeshletDrawOffset * commandSize), meshletCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        m_MeshletDrawOffset += meshletCount;
     }
     // --------------------------------------------------------------------------------------------
-    void Renderer::renderMesh(Mesh* mesh, Shader* shader)
+    void Renderer::bindMesh(Mesh* mesh, Shader* shader)
     {
+        // NOTE(Joey): vertex shaders that support compact vertex formats decode them based on
+        // these uniforms (see shaders/common/vertex.glsl); other shaders simply ignore them.
+        const VertexLayout& layout = mesh->m_Layout;
+        shader->SetInt("VertexFormat", layout.Format);
+        if (layout.Format == VERTEX_FORMAT_QUANTIZED)
+        {
+            shader->SetVector("VertexOffset", layout.PositionOffset);
+            shader->SetVector("VertexScale",  layout.PositionScale);
+        }
         glBindVertexArray(mesh->m_VAO);
-        if (mesh->Indices.size() > 0)
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int Renderer::selectLod(SceneNode* node, const math::vec3& boxMin, const math::vec3& boxMax)
+    {
+        const std::vector<LodRange>& lods = node->Mesh->m_Lods;
+        if (!LodSelection || lods.size() < 2 || !m_Camera)
+            return 0;
+
+        /* 
+
+          Each level's geometric error (in object space, scaled by the node's scale) is projected
+          to pixels at the distance of the node's bounding sphere closest to the camera; the
+          selected level is the coarsest level whose projected error stays within LodPixelError
+          pixels. Nodes w/o proper bounds (the default +-99999 box) thus always use level 0.
+
+          To prevent popping back and forth around the switch distance, a coarser level is only
+          selected once its error drops below (1 - LodHysteresis) times the threshold, while a
+          finer level is selected as soon as the current level exceeds the threshold.
+
+        */
+        math::vec3 center = (boxMin + boxMax) * 0.5f;
+        float radius = math::length(boxMax - boxMin) * 0.5f;
+        // projection[1][1] = 1 / tan(fov / 2) (perspective) or 2 / height (orthographic)
+        float pixelsPerUnit = 0.5f * m_InternalSize.y * m_Camera->Projection[1][1];
+        if (m_Camera->Perspective)
+        {
+            float distance = math::length(center - m_Camera->Position) - radius;
+            pixelsPerUnit /= std::max(distance, m_Camera->Near);
+        }
+        math::vec3 scale = node->GetWorldScale();
+        float worldScale = std::max(std::max(std::abs(scale.x), std::abs(scale.y)), std::abs(scale.z));
+
+        auto coarsest = [&](float threshold)
+        {
+            unsigned int level = 0;
+            while (level + 1 < lods.size() && lods[level + 1].Error * worldScale * pixelsPerUnit <= threshold)
+                ++level;
+            return level;
+        };
+        unsigned int fine   = coarsest(LodPixelError);
+        unsigned int coarse = coarsest(LodPixelError * (1.0f - LodHysteresis));
+        unsigned int lod    = std::min(node->Lod, (unsigned int)lods.size() - 1);
+        if (lod > fine)
+            lod = fine;
+        else if (lod < coarse)
+            lod = coarse;
+        node->Lod = lod;
+        return lod;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Renderer::updateRenderScale()
+    {
+        /* NOTE(Joey):
+
+          The GPU frame time is only known a few frames later (see GPUTimer) and the cost of
+          a frame roughly scales w/ its pixel count, so the scale (of each axis) moves a
+          fraction of the way towards sqrt(target / time) each frame; this converges w/o
+          oscillating on the delayed measurements. Only TXAA can upscale the frame, so w/o it
+          the frame always renders at the full render size.
+
+        */
+        const bool txaa = m_PostProcessor->TXAA;
+        if (txaa && DynamicResolution)
         {
-            glDrawElements(mesh->Topology == TRIANGLE_STRIP ? GL_TRIANGLE_STRIP : GL_TRIANGLES, mesh->Indices.size(), GL_UNSIGNED_INT, 0);
+            const float frameTime = m_FrameTimer->GetTime();
+            if (frameTime > 0.0f)
+            {
+                float ideal = m_RenderScale * std::sqrt(DynamicResolutionTarget / frameTime);
+                m_RenderScale = math::lerp(m_RenderScale, ideal, 0.1f);
+            }
+            m_RenderScale = math::clamp(m_RenderScale, std::min(std::max(DynamicResolutionMin, 0.1f), 1.0f), 1.0f);
         }
         else
         {
-            glDrawArrays(mesh->Topology == TRIANGLE_STRIP ? GL_TRIANGLE_STRIP : GL_TRIANGLES, 0, mesh->Positions.size());
+            m_RenderScale = 1.0f;
+        }
+        m_InternalSize.x = std::max(std::floor(m_RenderSize.x * m_RenderScale), 1.0f);
+        m_InternalSize.y = std::max(std::floor(m_RenderSize.y * m_RenderScale), 1.0f);
+
+        // sub-pixel jitter of the internal resolution's pixels: [-1, 1] pixel in NDC
+        if (txaa)
+        {
+            m_JitterIndex = (m_JitterIndex + 1) % JITTER_SAMPLES;
+            m_Jitter.x = (halton(m_JitterIndex + 1, 2) - 0.5f) * 2.0f / m_InternalSize.x;
+            m_Jitter.y = (halton(m_JitterIndex + 1, 3) - 0.5f) * 2.0f / m_InternalSize.y;
+        }
+        else
+        {
+            m_Jitter = math::vec2(0.0f);
+        }
+        // offset the projected (clip space) positions by the jitter in NDC: x' = x + jitter * w
+        m_JitteredProjection = m_Camera->Projection;
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            m_JitteredProjection[i][0] += m_Jitter.x * m_JitteredProjection[i][3];
+            m_JitteredProjection[i][1] += m_Jitter.y * m_JitteredProjection[i][3];
         }
     }
     // --------------------------------------------------------------------------------------------
     void Renderer::updateGlobalUBOs()
     {
         glBindBuffer(GL_UNIFORM_BUFFER, m_GlobalUBO);
-        // transformation matrices
+        // transformation matrices; the jitter only applies to the projection rasterizing the
+        // scene, s.t. the motion vectors (from (prev)viewProjection) don't include it.
         glBufferSubData(GL_UNIFORM_BUFFER,   0, sizeof(math::mat4), &(m_Camera->Projection * m_Camera->View)[0][0]); // sizeof(math::mat4) = 64 bytes
         glBufferSubData(GL_UNIFORM_BUFFER,  64, sizeof(math::mat4), &m_PrevViewProjection[0][0]); 
-        glBufferSubData(GL_UNIFORM_BUFFER, 128, sizeof(math::mat4), &m_Camera->Projection[0][0]);
+        glBufferSubData(GL_UNIFORM_BUFFER, 128, sizeof(math::mat4), &m_JitteredProjection[0][0]);
         glBufferSubData(GL_UNIFORM_BUFFER, 192, sizeof(math::mat4), &m_Camera->View[0][0]);
         glBufferSubData(GL_UNIFORM_BUFFER, 256, sizeof(math::mat4), &m_Camera->View[0][0]); // TODO: make inv function in math library
         // scene data
@@ -827,6 +1233,9 @@ namespace Cell
             glBufferSubData(GL_UNIFORM_BUFFER, 464 + i * stride,                      sizeof(math::vec4), &m_PointLights[i]->Position[0]);
             glBufferSubData(GL_UNIFORM_BUFFER, 464 + i * stride + sizeof(math::vec4), sizeof(math::vec4), &m_PointLights[i]->Color[0]);
         }
+        // dynamic resolution
+        math::vec4 renderScale(m_InternalSize.x / m_RenderSize.x, m_InternalSize.y / m_RenderSize.y, m_Jitter.x, m_Jitter.y);
+        glBufferSubData(GL_UNIFORM_BUFFER, 720, sizeof(math::vec4), &renderScale[0]);
     }
     // --------------------------------------------------------------------------------------------
     RenderTarget* Renderer::getCurrentRenderTarget()
@@ -834,43 +1243,31 @@ namespace Cell
         return m_CurrentRenderTargetCustom;
     }
     // --------------------------------------------------------------------------------------------
-    void Renderer::renderDeferredAmbient()
+    void Renderer::renderDeferredAmbient(Texture* ssao)
     {
         PBRCapture* skyCapture = m_PBR->GetSkyCapture();
-        auto irradianceProbes = m_PBR->m_CaptureProbes;
+        IrradianceVolume* volume = m_PBR->m_IrradianceVolume;
+        Texture* volumeTexture = IrradianceGI ? volume->GetTexture() : nullptr;
 
-        // if irradiance probes are present, use these as ambient lighting
-        if (IrradianceGI && irradianceProbes.size() > 0)
+        // if irradiance probes are present, use these as ambient lighting: a single full-screen
+        // pass interpolates the probe grid at each pixel, regardless of the number of probes.
+        if (volumeTexture)
         {
+            skyCapture->Irradiance->Bind(3);
             skyCapture->Prefiltered->Bind(4);
             m_PBR->m_RenderTargetBRDFLUT->GetColorTexture(0)->Bind(5);
-            m_PostProcessor->SSAOOutput->Bind(6);
-
-            m_GLCache.SetCullFace(GL_FRONT);
-            for (int i = 0; i < irradianceProbes.size(); ++i)
-            {
-                PBRCapture* probe = irradianceProbes[i];
-                // only render probe if within frustum
-                if (m_Camera->Frustum.Intersect(probe->Position, probe->Radius))
-                {
-                    probe->Irradiance->Bind(3);
-
-                    Shader* irradianceShader = m_MaterialLibrary->deferredIrradianceShader;
-                    irradianceShader->Use();
-                    irradianceShader->SetVector("camPos", m_Camera->Position);
-                    irradianceShader->SetVector("probePos", probe->Position);
-                    irradianceShader->SetFloat("probeRadius", probe->Radius);
-                    irradianceShader->SetInt("SSAO", m_PostProcessor->SSAO);
-
-                    math::mat4 model;
-                    math::translate(model, probe->Position);
-                    math::scale(model, math::vec3(probe->Radius));
-                    irradianceShader->SetMatrix("model", model);
-
-                    renderMesh(m_DeferredPointMesh, irradianceShader);
-                }
-            }
-            m_GLCache.SetCullFace(GL_BACK);
+            if (ssao)
+                ssao->Bind(6);
+            volumeTexture->Bind(7);
+
+            Shader* irradianceShader = m_MaterialLibrary->deferredIrradianceShader;
+            irradianceShader->Use();
+            irradianceShader->SetVector("VolumeMin", volume->GetBoxMin());
+            irradianceShader->SetVector("VolumeMax", volume->GetBoxMax());
+            irradianceShader->SetVector("VolumeResolution", math::vec3((float)volume->GetResolution(0), (float)volume->GetResolution(1), (float)volume->GetResolution(2)));
+            irradianceShader->SetFloat("VolumeSpacing", volume->GetSpacing());
+            irradianceShader->SetInt("SSAO", ssao != nullptr);
+            renderMesh(m_NDCPlane, irradianceShader);
         }
         // otherwise do a full-screen ambient pass
         else
@@ -878,11 +1275,12 @@ namespace Cell
             skyCapture->Irradiance->Bind(3);
             skyCapture->Prefiltered->Bind(4);
             m_PBR->m_RenderTargetBRDFLUT->GetColorTexture(0)->Bind(5);
-            m_PostProcessor->SSAOOutput->Bind(6);
+            if (ssao)
+                ssao->Bind(6);
 
             Shader* ambientShader = m_MaterialLibrary->deferredAmbientShader;
             ambientShader->Use();
-            ambientShader->SetInt("SSAO", m_PostProcessor->SSAO);
+            ambientShader->SetInt("SSAO", ssao != nullptr);
             renderMesh(m_NDCPlane, ambientShader);
         }
     }
@@ -924,6 +1322,78 @@ namespace Cell
         renderMesh(m_DeferredPointMesh, pointShader);    
     }
     // --------------------------------------------------------------------------------------------
+    void Renderer::renderDeferredTiled()
+    {
+        /* NOTE(Joey):
+
+          The point lights' screen footprints (the tiles covered and their view depth range)
+          are computed here, the tiles they're binned to on the GPU: each tile's depth bounds
+          are only known there (reduced from the G-buffer by the tile's work group), after
+          which the work group tests all footprints against its tile exactly as
+          math::binLights does on the CPU. Lights outside the view don't make it to the GPU.
+
+        */
+        const unsigned int width  = (unsigned int)m_InternalSize.x;
+        const unsigned int height = (unsigned int)m_InternalSize.y;
+
+        std::vector<TiledLight> lights;
+        lights.reserve(m_PointLights.size());
+        for (auto it = m_PointLights.begin(); it != m_PointLights.end(); ++it)
+        {
+            PointLight* light = *it;
+            if (!m_Camera->Frustum.Intersect(light->Position, light->Radius))
+                continue;
+            math::vec4 position(light->Position, 1.0f);
+            math::vec4 center = m_Camera->View * position;
+            math::light_bounds bounds = math::lightBounds(center.xyz, light->Radius, m_JitteredProjection, width, height, LIGHT_TILE_SIZE, m_Camera->Near);
+            if (bounds.empty())
+                continue;
+
+            TiledLight tiled;
+            tiled.PositionRadius = math::vec4(light->Position, light->Radius);
+            tiled.Color          = math::vec4(math::normalize(light->Color) * light->Intensity, 1.0f);
+            tiled.Tiles[0]       = bounds.TileMinX;
+            tiled.Tiles[1]       = bounds.TileMinY;
+            tiled.Tiles[2]       = bounds.TileMaxX;
+            tiled.Tiles[3]       = bounds.TileMaxY;
+            tiled.Depth          = math::vec4(bounds.DepthMin, bounds.DepthMax, 0.0f, 0.0f);
+            lights.push_back(tiled);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_TiledLightBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(lights.size(), (size_t)1) * sizeof(TiledLight), lights.empty() ? nullptr : &lights[0], GL_STREAM_DRAW);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_TiledLightBuffer);
+
+        Shader* shader = m_TiledLightingShader;
+        shader->Use();
+        shader->SetVector("RenderSize", m_InternalSize);
+        shader->SetInt("LightCount", (int)lights.size());
+        shader->SetBool("ShadowsEnabled", Shadows);
+        unsigned int dirLights = std::min((unsigned int)m_DirectionalLights.size(), TILED_DIR_LIGHTS_MAX);
+        shader->SetInt("DirLightCount", dirLights);
+        for (unsigned int i = 0; i < dirLights; ++i)
+        {
+            DirectionalLight* light = m_DirectionalLights[i];
+            std::string index = "[" + std::to_string(i) + "]";
+            shader->SetVector("DirLightDirection" + index, light->Direction);
+            shader->SetVector("DirLightColor" + index, math::normalize(light->Color) * light->Intensity);
+            shader->SetBool("DirLightShadow" + index, light->ShadowMapRT != nullptr);
+            if (light->ShadowMapRT)
+            {
+                shader->SetMatrix("DirLightShadowViewProjection" + index, light->LightSpaceViewProjection);
+                light->ShadowMapRT->GetDepthStencilTexture()->Bind(3 + i);
+            }
+        }
+
+        // the G-buffer is bound by the lighting pass; the ambient lighting is in the scene
+        glBindImageTexture(0, m_CustomTarget->GetColorTexture(0)->ID, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+        shader->Dispatch(math::tileCount(width, LIGHT_TILE_SIZE), math::tileCount(height, LIGHT_TILE_SIZE));
+        glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        // directional lights beyond what the tiled pass handles
+        for (unsigned int i = dirLights; i < m_DirectionalLights.size(); ++i)
+            renderDeferredDirLight(m_DirectionalLights[i]);
+    }
+    // --------------------------------------------------------------------------------------------
     void Renderer::renderShadowCastCommand(RenderCommand* command, const math::mat4& projection, const math::mat4& view)
     {
         Shader* shadowShader = m_MaterialLibrary->dirShadowShader;
@@ -932,6 +1402,6 @@ namespace Cell
         shadowShader->SetMatrix("view", view);
         shadowShader->SetMatrix("model", command->Transform);
 
-        renderMesh(command->Mesh, shadowShader);
+        renderMesh(command->Mesh, shadowShader, command->Lod);
     }
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <math/linear_algebra/matrix.h>
 
+#include <unordered_map>
+
 #include "../lighting/point_light.h"
 #include "../lighting/directional_light.h"
 #include "../mesh/quad.h"
@@ -30,6 +32,20 @@ namespace Cell
     class MaterialLibrary;
     class PBR;
     class PostProcessor;
+    class ProbeBaker;
+    class RenderGraph;
+    class GPUTimer;
+    class Shader;
+
+    // per-frame meshlet culling results (see Renderer::MeshletStatistics)
+    struct MeshletStats
+    {
+        unsigned int Meshlets        = 0;
+        unsigned int CulledFrustum   = 0;
+        unsigned int CulledCone      = 0;
+        unsigned int Triangles       = 0;
+        unsigned int TrianglesCulled = 0;
+    };
 
     /*
 
@@ -42,6 +58,7 @@ namespace Cell
     {
         friend PostProcessor;
         friend PBR;
+        friend ProbeBaker;
     public:
         // configuration
         bool IrradianceGI = true;
@@ -51,17 +68,60 @@ namespace Cell
         bool LightVolumes = false;
         bool RenderProbes = false;
         bool Wireframe    = false;
+        // level of detail selection of scene nodes; see PushRender(SceneNode*)
+        bool  LodSelection  = true;
+        float LodPixelError = 1.0f;  // maximum projected error (in pixels) of the selected level
+        float LodHysteresis = 0.25f; // relative margin before switching to a coarser level
+        // meshlet culling of the (full detail) meshes that have meshlets, see MeshletBuilder;
+        // either on the CPU or w/ a compute shader generating indirect draws.
+        bool MeshletCulling    = true;
+        bool GPUMeshletCulling = false;
+        bool MeshletStatistics = false; // gathers MeshletStats (always culled on the CPU)
+        // irradiance probe grid placed by BakeProbes; the spacing grows if the scene would
+        // need more than IrradianceProbeMax probes.
+        float        IrradianceProbeSpacing = 2.0f;
+        unsigned int IrradianceProbeMax     = 512;
+        // re-bakes the probes affected by lighting/geometry changes, at most
+        // IrradianceProbeFaces cube faces per frame w/in IrradianceProbeBudget ms (see ProbeBaker)
+        bool         IrradianceProbeUpdates = true;
+        unsigned int IrradianceProbeFaces   = 6;
+        float        IrradianceProbeBudget  = 1.0f;
+        // renders full cubemaps (captures, environment pre-processing) in a single layered pass
+        // if all of their shaders have a layered variant; see renderToCubemap
+        bool LayeredCubemaps = true;
+        // tiled deferred lighting: a single compute pass shades the directional lights and the
+        // point lights binned per screen tile (see math::binLights), instead of a full-screen
+        // pass per directional light and a light volume per point light.
+        bool TiledLighting = true;
+        // dynamic resolution (requires the post-processor's TXAA, which upscales the frame to
+        // the render size): the internal resolution adapts each frame s.t. the GPU frame time
+        // approaches DynamicResolutionTarget ms, down to DynamicResolutionMin times the render
+        // size.
+        bool  DynamicResolution       = false;
+        float DynamicResolutionTarget = 16.0f;
+        float DynamicResolutionMin    = 0.5f;
     private:       
         // render state
         CommandBuffer* m_CommandBuffer;
         GLCache        m_GLCache;
-        math::vec2     m_RenderSize;
+        math::vec2     m_RenderSize;   // the output size, and the size of all (screen) targets
+        math::vec2     m_InternalSize; // the size rendered at: a sub-rect of the targets
+        float          m_RenderScale = 1.0f;
+        GPUTimer*      m_FrameTimer;
+
+        // temporal anti-aliasing: the projection is offset by a different sub-pixel jitter
+        // (in NDC) each frame
+        math::vec2   m_Jitter;
+        math::mat4   m_JitteredProjection;
+        unsigned int m_JitterIndex = 0;
 
         // lighting
         std::vector<DirectionalLight*> m_DirectionalLights;
         std::vector<PointLight*>       m_PointLights;
         RenderTarget* m_GBuffer = nullptr;
         Mesh*         m_DeferredPointMesh;
+        Shader*       m_TiledLightingShader;
+        unsigned int  m_TiledLightBuffer;
 
         // materials
         MaterialLibrary* m_MaterialLibrary;
@@ -76,9 +136,13 @@ namespace Cell
         RenderTarget*              m_CustomTarget;
         RenderTarget*              m_PostProcessTarget1;
         PostProcessor*             m_PostProcessor;
+        RenderGraph*               m_RenderGraph;
         Quad*                      m_NDCPlane;
         unsigned int m_FramebufferCubemap; 
-        unsigned int m_CubemapDepthRBO;
+        unsigned int m_CubemapDepth;         // depth cubemap, s.t. it can be attached layered
+        unsigned int m_CubemapDepthSize = 0;
+        // shaders (of cubemap captures) -> their layered variant (see cube_layered.gs)
+        std::unordered_map<Shader*, Shader*> m_LayeredShaders;
 
         // shadow buffers
         std::vector<RenderTarget*> m_ShadowRenderTargets;
@@ -86,12 +150,24 @@ namespace Cell
        
         // pbr
         PBR* m_PBR;
+        ProbeBaker* m_ProbeBaker;
         unsigned int m_PBREnvironmentIndex;
-        std::vector<math::vec4> m_ProbeSpatials;
+        math::vec3 m_ProbeVolumeMin;
+        math::vec3 m_ProbeVolumeMax;
+        bool       m_ProbeVolumeFromScene = true;
 
         // ubo
         unsigned int m_GlobalUBO;
 
+        // meshlets
+        Shader*      m_MeshletCullShader;
+        unsigned int m_MeshletDrawBuffer;
+        unsigned int m_MeshletDrawCapacity = 0; // in draw commands
+        unsigned int m_MeshletDrawOffset   = 0; // reset each frame
+        std::vector<GLsizei>     m_MeshletCounts;
+        std::vector<const void*> m_MeshletOffsets;
+        MeshletStats             m_MeshletStats;
+
         // debug
         Mesh* m_DebugLightMesh;
 
@@ -103,6 +179,11 @@ namespace Cell
 
         void SetRenderSize(unsigned int width, unsigned int height);
         math::vec2 GetRenderSize();
+        // the resolution the scene is rendered at before (TXAA) upscaling to the render size
+        math::vec2 GetInternalSize();
+        float      GetRenderScale();
+        // the GPU time of a whole frame in milliseconds (a few frames old)
+        float      GetGPUFrameTime();
 
         void SetTarget(RenderTarget* renderTarget, GLenum target = GL_TEXTURE_2D);
 
@@ -110,6 +191,8 @@ namespace Cell
         void    SetCamera(Camera* camera);
 
         PostProcessor* GetPostProcessor();
+        // the render graph of the last rendered frame (see RenderPushedCommands)
+        const RenderGraph* GetRenderGraph() const;
 
         // create either a deferred default material (based on default set of materials available (like glass)), or a custom material (with custom you have to supply your own shader)
         Material* CreateMaterial(std::string base = "default"); // these don't have the custom flag set (default material has default state and uses checkerboard texture as albedo (and black metallic, half roughness, purple normal, white ao)
@@ -130,28 +213,52 @@ namespace Cell
         // pbr
         void        SetSkyCapture(PBRCapture* pbrEnvironment);
         PBRCapture* GetSkypCature();
-        void        AddIrradianceProbe(math::vec3 position, float radius);
+        // restricts the irradiance probe grid to a world space box; by default the grid spans
+        // the bounds of the baked scene.
+        void        SetIrradianceVolume(math::vec3 boxMin, math::vec3 boxMax);
         void        BakeProbes(SceneNode* scene = nullptr);
+        // re-bakes all irradiance probes over the next frames (e.g. after lighting changes that
+        // aren't detected automatically, like emissive materials)
+        void        InvalidateProbes();
+        // the number of irradiance probes waiting to be re-baked
+        unsigned int GetPendingProbeCount();
+
+        // meshlet culling results of the last rendered frame; only gathered w/ MeshletStatistics
+        const MeshletStats& GetMeshletStats() const;
     private:
         // renderer-specific logic for rendering a custom (forward-pass) command
-        void renderCustomCommand(RenderCommand* command, Camera* customCamera, bool updateGLSettings = true);
+        // (w/ shader instead of the material's shader, if set)
+        void renderCustomCommand(RenderCommand* command, Camera* customCamera, bool updateGLSettings = true, Shader* shader = nullptr);
         // renderer-specific logic for rendering a list of commands to a target cubemap
         void renderToCubemap(SceneNode* scene, TextureCube* target, math::vec3 position = math::vec3(0.0f), unsigned int mipLevel = 0);
-        void renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, math::vec3 position = math::vec3(0.0f), unsigned int mipLevel = 0);
-        // minimal render logic to render a mesh 
-        void renderMesh(Mesh* mesh, Shader* shader);
+        void renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, math::vec3 position = math::vec3(0.0f), unsigned int mipLevel = 0,
+                             unsigned int firstFace = 0, unsigned int faceCount = 6);
+        // registers the layered variant of a shader used for cubemap rendering
+        void setLayeredShader(Shader* shader, Shader* layered);
+        // minimal render logic to render a mesh (at the given level of detail)
+        void renderMesh(Mesh* mesh, Shader* shader, unsigned int lod = 0);
+        // renders only the meshlets of a mesh (w/ the given transform) that pass culling
+        void renderMeshlets(Mesh* mesh, Material* material, const math::mat4& transform);
+        // binds a mesh's vertex array and configures the shader for its vertex format
+        void bindMesh(Mesh* mesh, Shader* shader);
+        // selects the level of detail of a scene node's mesh by its projected screen size
+        unsigned int selectLod(SceneNode* node, const math::vec3& boxMin, const math::vec3& boxMax);
+        // picks the frame's internal resolution and (TXAA) projection jitter
+        void updateRenderScale();
         // updates the global uniform buffer objects
         void updateGlobalUBOs();
         // returns the currently active render target
         RenderTarget* getCurrentRenderTarget();
 
         // deferred logic:
-        // renders all ambient lighting (including indirect IBL)
-        void renderDeferredAmbient();
+        // renders all ambient lighting (including indirect IBL), w/ ssao if set
+        void renderDeferredAmbient(Texture* ssao);
         // render directional light
         void renderDeferredDirLight(DirectionalLight* light);
         // render point light
         void renderDeferredPointLight(PointLight* light);
+        // render all lights w/ tiled deferred lighting
+        void renderDeferredTiled();
 
         // render mesh for shadow buffer generation
         void renderShadowCastCommand(RenderCommand* command, const math::mat4& projection, const math::mat4& view);
@@ -8,15 +8,172 @@
 #include "../scene/scene_node.h"
 #include "../shading/texture.h"
 
+#include <math/linear_algebra/soa.h>
 #include <utility/logging/log.h>
+#include <utility/io/mapped_file.h>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
 namespace Cell
 {
     std::vector<Mesh*> MeshLoader::meshStore = std::vector<Mesh*>();
+    bool               MeshLoader::UseCache  = true;
+    bool               MeshLoader::Optimize  = true;
+    bool               MeshLoader::GenerateLods = true;
+    bool               MeshLoader::BuildMeshlets = true;
+    VERTEX_FORMAT      MeshLoader::VertexFormat = VERTEX_FORMAT_COMPACT;
+
+    // NOTE(Joey): missing normals and tangents are generated by Mesh::CalculateNormals and
+    // CalculateTangents instead of aiProcess_GenNormals/aiProcess_CalcTangentSpace, as those run
+    // single threaded.
+    const unsigned int MeshLoader::ImportFlags = aiProcess_Triangulate;
+
+    /* NOTE(Joey):
+
+      About texture types:
+
+      We use a PBR metallic/roughness workflow so the loaded models are expected to have 
+      textures conform the workflow: albedo, (normal), metallic, roughness, (ao). Since Assimp
+      made certain assumptions regarding possible types of loaded textures it doesn't directly
+      translate to our model thus we make some assumptions as well which the 3D author has to
+      comply with if he wants the mesh(es) to directly render with its specified textures:
+        
+        - aiTextureType_DIFFUSE:      Albedo
+        - aiTextureType_DISPLACEMENT: Normal
+        - aiTextureType_SPECULAR:     metallic
+        - aiTextureType_SHININESS:    roughness 
+        - aiTextureType_AMBIENT:      AO (ambient occlusion)
+
+    */
+    struct MaterialSlot
+    {
+        aiTextureType Type;
+        const char*   Uniform;
+        unsigned int  Unit;
+    };
+    static const MaterialSlot materialSlots[] =
+    {
+        { aiTextureType_DIFFUSE,      "TexAlbedo",    3 },
+        { aiTextureType_DISPLACEMENT, "TexNormal",    4 },
+        { aiTextureType_SPECULAR,     "TexMetallic",  5 },
+        { aiTextureType_SHININESS,    "TexRoughness", 6 },
+        { aiTextureType_AMBIENT,      "TexAO",        7 },
+    };
+
+    /* NOTE(Joey):
+
+      Binary mesh cache layout; all sections are stored back to back, in this order:
+
+        CacheHeader
+        CacheMesh[MeshCount]         (indexed by the source file's mesh index)
+        CacheMaterial[MaterialCount]
+        CacheNode[NodeCount]
+        string data                  (texture paths, referenced by CacheMaterial)
+        vertex/index data            (per mesh; 16-byte aligned)
+
+      A mesh's index data holds all of its levels of detail back to back, starting w/ the full
+      detail mesh; LodIndexCount gives the number of indices of each level.
+
+      Vertex data is stored in the exact (interleaved) layout uploaded to the GPU, s.t. it can be
+      handed to the driver straight from the memory mapped file. The cache is written and read
+      on the same (little-endian) platform and isn't meant to be distributed.
+
+    */
+    static const u32 CACHE_MAGIC   = 0x4D4C4543; // "CELM"
+    static const u32 CACHE_VERSION = 5;
+    struct CacheHeader
+    {
+        u32 Magic;
+        u32 Version;
+        u32 ImportFlags;
+        u32 MeshCount;
+        u64 SourceTime;
+        u64 SourceSize;
+        u32 MaterialCount;
+        u32 NodeCount;
+        u32 Optimized;
+        u32 VertexFormat;
+        u32 Lods;
+        u32 Meshlets;
+        u64 StringOffset;
+        u64 StringSize;
+    };
+    struct CacheMesh
+    {
+        u32   Present; // whether the mesh is referenced (and thus stored) at all
+        u32   Attributes;
+        u32   VertexCount;
+        u32   IndexCount;
+        u64   VertexOffset;
+        u64   IndexOffset;
+        float BoxMin[3];
+        float BoxMax[3];
+        float PositionOffset[3];
+        float PositionScale[3];
+        u32   LodCount; // 0 if the mesh has no levels of detail
+        u32   LodIndexCount[MeshSimplifier::MAX_LODS];
+        float LodError[MeshSimplifier::MAX_LODS];
+        u32   MeshletCount; // meshlets of level 0; 0 if the mesh has none
+        u32   Padding;
+        u64   MeshletOffset;
+    };
+    struct CacheMaterial
+    {
+        u32 Alpha;
+        u32 TextureOffset[5];
+        u32 TextureLength[5];
+        u32 Padding;
+    };
+    struct CacheNode
+    {
+        i32   Parent;
+        i32   Mesh;
+        i32   Material;
+        float BoxMin[3];
+        float BoxMax[3];
+    };
+    static u64 alignCache(u64 offset)
+    {
+        return (offset + 15) & ~(u64)15;
+    }
+    // the mesh, material and node tables following the header; End is their end offset.
+    struct CacheSections
+    {
+        const CacheMesh*     Meshes;
+        const CacheMaterial* Materials;
+        const CacheNode*     Nodes;
+        u64                  End;
+    };
+    static CacheSections cacheSections(const u8* data)
+    {
+        const CacheHeader* header = (const CacheHeader*)data;
+        const u64 meshOffset     = sizeof(CacheHeader);
+        const u64 materialOffset = meshOffset + header->MeshCount * sizeof(CacheMesh);
+        const u64 nodeOffset     = materialOffset + header->MaterialCount * sizeof(CacheMaterial);
+
+        CacheSections sections;
+        sections.Meshes    = (const CacheMesh*)(data + meshOffset);
+        sections.Materials = (const CacheMaterial*)(data + materialOffset);
+        sections.Nodes     = (const CacheNode*)(data + nodeOffset);
+        sections.End       = nodeOffset + header->NodeCount * sizeof(CacheNode);
+        return sections;
+    }
+    static VertexLayout cacheLayout(const CacheMesh& mesh, u32 format)
+    {
+        VertexLayout layout;
+        layout.Attributes     = mesh.Attributes;
+        layout.Format         = (VERTEX_FORMAT)format;
+        layout.Interleaved    = true;
+        layout.PositionOffset = math::vec3(mesh.PositionOffset[0], mesh.PositionOffset[1], mesh.PositionOffset[2]);
+        layout.PositionScale  = math::vec3(mesh.PositionScale[0], mesh.PositionScale[1], mesh.PositionScale[2]);
+        return layout;
+    }
     // --------------------------------------------------------------------------------------------
     void MeshLoader::Clean()
     {
@@ -26,75 +183,311 @@ namespace Cell
         }
     }
     // --------------------------------------------------------------------------------------------
+    void MeshLoader::Free(SceneNode* node)
+    {
+        std::vector<SceneNode*> nodes = { node };
+        for (unsigned int i = 0; i < nodes.size(); ++i)
+        {
+            for (unsigned int c = 0; c < nodes[i]->GetChildCount(); ++c)
+                nodes.push_back(nodes[i]->GetChildByIndex(c));
+
+            Mesh* mesh = nodes[i]->Mesh;
+            if (!mesh)
+                continue;
+            auto it = std::find(meshStore.begin(), meshStore.end(), mesh);
+            if (it == meshStore.end())
+                continue; // already freed (meshes may be shared between nodes)
+            meshStore.erase(it);
+            if (mesh->m_VAO)
+            {
+                glDeleteVertexArrays(1, &mesh->m_VAO);
+                glDeleteBuffers(1, &mesh->m_VBO);
+                glDeleteBuffers(1, &mesh->m_EBO);
+            }
+            if (mesh->m_MeshletBuffer)
+                glDeleteBuffers(1, &mesh->m_MeshletBuffer);
+            delete mesh;
+        }
+        // NOTE(Joey): the scene node deletes its children; materials are owned by the renderer.
+        delete node;
+    }
+    // --------------------------------------------------------------------------------------------
     SceneNode* MeshLoader::LoadMesh(Renderer *renderer, std::string path, bool setDefaultMaterial)
     {
         Log::Message("Loading mesh file at: " + path + ".", LOG_INIT);
 
+        /* NOTE(Joey):
+
+          Mesh loading is split in several stages:
+
+            1. import:    Assimp reads and post-processes the file.
+            2. convert:   each aiMesh referenced by the scene is converted to our own vertex data
+                          and packed into its vertex buffer layout. Meshes are independent of
+                          each other so this runs in parallel on the resource thread pool.
+            3. hierarchy: the scene node hierarchy and its materials are built on the calling
+                          thread (materials are created through the renderer).
+            4. upload:    all mesh buffers are committed to the GPU in a single batch.
+
+          The result of the first two stages (and the flattened node hierarchy) is written to the
+          mesh cache; if an up-to-date cache exists, stage 1 and 2 are replaced by memory mapping
+          the cache and uploading its vertex data directly.
+
+        */
+        auto timeStart = std::chrono::steady_clock::now();
+        auto ms = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+        {
+            return std::to_string(std::chrono::duration<float, std::milli>(to - from).count());
+        };
+
+        std::string directory = path.substr(0, path.find_last_of("/"));
+
+        std::vector<ParsedMesh>   meshes;
+        std::vector<MaterialDesc> materials;
+        std::vector<NodeDesc>     nodes;
+
+        u64 sourceTime = 0, sourceSize = 0;
+        bool cacheable = UseCache && FileInfo(path, sourceTime, sourceSize);
+        if (cacheable && MeshLoader::loadCache(path, sourceTime, sourceSize, meshes, materials, nodes))
+        {
+            auto timeCache = std::chrono::steady_clock::now();
+            SceneNode* root = MeshLoader::buildHierarchy(renderer, nodes, meshes, materials, directory, setDefaultMaterial);
+            auto timeHierarchy = std::chrono::steady_clock::now();
+
+            Log::Message("Mesh " + path + " (" + std::to_string(meshes.size()) + " meshes): cache " + ms(timeStart, timeCache) +
+                         " ms | hierarchy " + ms(timeCache, timeHierarchy) + " ms.", LOG_INIT);
+            return root;
+        }
+
+        std::vector<unsigned int> meshIndices;
+        if (!MeshLoader::importMesh(path, meshes, materials, nodes, meshIndices))
+        {
+            return nullptr;
+        }
+        auto timeConvert = std::chrono::steady_clock::now();
+
+        if (cacheable)
+        {
+            MeshLoader::writeCache(path, sourceTime, sourceSize, meshes, materials, nodes);
+        }
+        auto timeWrite = std::chrono::steady_clock::now();
+
+        SceneNode* root = MeshLoader::buildHierarchy(renderer, nodes, meshes, materials, directory, setDefaultMaterial);
+        auto timeHierarchy = std::chrono::steady_clock::now();
+
+        // generate all GL objects in one go, then commit each mesh's packed vertex data
+        const unsigned int meshCount = (unsigned int)meshIndices.size();
+        std::vector<unsigned int> vaos(meshCount), vbos(meshCount), ebos(meshCount);
+        if (meshCount > 0)
+        {
+            glGenVertexArrays(meshCount, &vaos[0]);
+            glGenBuffers(meshCount, &vbos[0]);
+            glGenBuffers(meshCount, &ebos[0]);
+        }
+        for (unsigned int i = 0; i < meshCount; ++i)
+        {
+            ParsedMesh& parsed = meshes[meshIndices[i]];
+            parsed.Mesh->m_VAO = vaos[i];
+            parsed.Mesh->m_VBO = vbos[i];
+            parsed.Mesh->m_EBO = ebos[i];
+            parsed.Mesh->Upload(parsed.VertexData, parsed.Layout);
+            std::vector<u8>().swap(parsed.VertexData);
+
+            // store newly generated mesh in globally stored mesh store for memory de-allocation 
+            // when a clean is required.
+            MeshLoader::meshStore.push_back(parsed.Mesh);
+        }
+        auto timeUpload = std::chrono::steady_clock::now();
+
+        Log::Message("Mesh " + path + " (" + std::to_string(meshCount) + " meshes): import " + ms(timeStart, timeConvert) +
+                     " ms | cache write " + ms(timeConvert, timeWrite) + " ms | hierarchy " + ms(timeWrite, timeHierarchy) +
+                     " ms | upload " + ms(timeHierarchy, timeUpload) + " ms.", LOG_INIT);
+
+        return root;
+    }
+    // --------------------------------------------------------------------------------------------
+    bool MeshLoader::importMesh(std::string path, std::vector<ParsedMesh>& meshes, std::vector<MaterialDesc>& materials, std::vector<NodeDesc>& nodes, std::vector<unsigned int>& meshIndices)
+    {
+        auto timeStart = std::chrono::steady_clock::now();
+        auto ms = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+        {
+            return std::to_string(std::chrono::duration<float, std::milli>(to - from).count());
+        };
+
         Assimp::Importer importer;
-        const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_CalcTangentSpace);
+        const aiScene *scene = importer.ReadFile(path, ImportFlags);
 
         if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
         {
             Log::Message("Assimp failed to load model at path: " + path, LOG_ERROR);   
-            return nullptr;
+            return false;
         }
 
-        std::string directory = path.substr(0, path.find_last_of("/"));
-
         Log::Message("Succesfully loaded: " + path + ".", LOG_INIT);
+        auto timeImport = std::chrono::steady_clock::now();
 
-        return MeshLoader::processNode(renderer, scene->mRootNode, scene, directory, setDefaultMaterial);
+        // only convert the meshes that are referenced from the node hierarchy; a mesh referenced
+        // by multiple nodes is converted (and stored) once.
+        std::vector<bool> referenced(scene->mNumMeshes, false);
+        std::vector<aiNode*> aNodes = { scene->mRootNode };
+        for (unsigned int i = 0; i < aNodes.size(); ++i)
+        {
+            for (unsigned int m = 0; m < aNodes[i]->mNumMeshes; ++m)
+                referenced[aNodes[i]->mMeshes[m]] = true;
+            for (unsigned int c = 0; c < aNodes[i]->mNumChildren; ++c)
+                aNodes.push_back(aNodes[i]->mChildren[c]);
+        }
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+        {
+            if (referenced[i])
+                meshIndices.push_back(i);
+        }
+
+        meshes.resize(scene->mNumMeshes);
+        auto convert = [&](unsigned int i)
+        {
+            ParsedMesh& parsed = meshes[meshIndices[i]];
+            parsed.Mesh       = MeshLoader::parseMesh(scene->mMeshes[meshIndices[i]], scene, parsed.BoxMin, parsed.BoxMax);
+            if (Optimize)
+                MeshOptimizer::Optimize(parsed.Mesh, &parsed.CacheBefore, &parsed.CacheAfter);
+            if (GenerateLods)
+                MeshSimplifier::GenerateLods(parsed.Mesh);
+            if (BuildMeshlets)
+                MeshletBuilder::Build(parsed.Mesh);
+            parsed.Mesh->Format = VertexFormat;
+            parsed.VertexData = parsed.Mesh->PackVertexData(parsed.Layout, true);
+        };
+        ThreadPool* threadPool = Resources::GetThreadPool();
+        if (threadPool)
+        {
+            threadPool->ParallelFor((unsigned int)meshIndices.size(), convert);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < meshIndices.size(); ++i)
+                convert(i);
+        }
+        if (Optimize)
+        {
+            MeshOptimizer::CacheStatistics before, after;
+            for (unsigned int i = 0; i < meshIndices.size(); ++i)
+            {
+                before.Add(meshes[meshIndices[i]].CacheBefore);
+                after.Add(meshes[meshIndices[i]].CacheAfter);
+            }
+            Log::Message("Mesh " + path + " vertex cache (FIFO " + std::to_string(MeshOptimizer::CACHE_SIZE) + "): ACMR " +
+                         std::to_string(before.ACMR) + " -> " + std::to_string(after.ACMR) + " | ATVR " +
+                         std::to_string(before.ATVR) + " -> " + std::to_string(after.ATVR) + ".", LOG_INIT);
+        }
+        for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+        {
+            materials.push_back(MeshLoader::parseMaterial(scene->mMaterials[i]));
+        }
+        MeshLoader::flattenNode(scene->mRootNode, scene, -1, nodes, meshes);
+        auto timeConvert = std::chrono::steady_clock::now();
+
+        Log::Message("Mesh " + path + " (" + std::to_string(meshIndices.size()) + " meshes): import " + ms(timeStart, timeImport) +
+                     " ms | convert " + ms(timeImport, timeConvert) + " ms (" + std::to_string(threadPool ? threadPool->GetThreadCount() + 1 : 1) +
+                     " threads).", LOG_INIT);
+        return true;
     }
     // --------------------------------------------------------------------------------------------
-    SceneNode* MeshLoader::processNode(Renderer* renderer, aiNode* aNode, const aiScene* aScene, std::string directory, bool setDefaultMaterial)
+    bool MeshLoader::BakeCache(std::string path)
     {
-        // note that we allocate memory ourselves and pass memory responsibility to calling 
-        // resource manager. The resource manager is responsible for holding the scene node 
-        // pointer and deleting where appropriate.
-        SceneNode* node = new SceneNode(0);
+        u64 sourceTime = 0, sourceSize = 0;
+        if (!FileInfo(path, sourceTime, sourceSize))
+        {
+            Log::Message("Failed to bake mesh cache; no mesh file at: " + path + ".", LOG_ERROR);
+            return false;
+        }
+
+        std::vector<ParsedMesh>   meshes;
+        std::vector<MaterialDesc> materials;
+        std::vector<NodeDesc>     nodes;
+        std::vector<unsigned int> meshIndices;
+        if (!MeshLoader::importMesh(path, meshes, materials, nodes, meshIndices))
+        {
+            return false;
+        }
+        MeshLoader::writeCache(path, sourceTime, sourceSize, meshes, materials, nodes);
+
+        // the converted meshes were never uploaded, so there's no GPU memory to release.
+        for (unsigned int i = 0; i < meshes.size(); ++i)
+        {
+            delete meshes[i].Mesh;
+        }
+        return true;
+    }
+    // --------------------------------------------------------------------------------------------
+    bool MeshLoader::MapCache(std::string path, MappedFile& file)
+    {
+        u64 sourceTime = 0, sourceSize = 0;
+        return FileInfo(path, sourceTime, sourceSize) && MeshLoader::mapCache(path, sourceTime, sourceSize, file);
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshLoader::flattenNode(aiNode* aNode, const aiScene* aScene, int parent, std::vector<NodeDesc>& nodes, const std::vector<ParsedMesh>& meshes)
+    {
+        int index = (int)nodes.size();
+        nodes.push_back(NodeDesc());
+        nodes[index].Parent = parent;
 
         for (unsigned int i = 0; i < aNode->mNumMeshes; ++i)
         {
-            math::vec3 boxMin, boxMax;
-            aiMesh*     assimpMesh = aScene->mMeshes[aNode->mMeshes[i]];
-            aiMaterial* assimpMat  = aScene->mMaterials[assimpMesh->mMaterialIndex];
-            Mesh*       mesh       = MeshLoader::parseMesh(assimpMesh, aScene, boxMin, boxMax);
-            Material*   material   = nullptr;
-            if (setDefaultMaterial)
-            {
-                material = MeshLoader::parseMaterial(renderer, assimpMat, aScene, directory);
-            }
+            unsigned int meshIndex = aNode->mMeshes[i];
+            NodeDesc desc;
+            desc.Mesh     = meshIndex;
+            desc.Material = aScene->mMeshes[meshIndex]->mMaterialIndex;
+            desc.BoxMin   = meshes[meshIndex].BoxMin;
+            desc.BoxMax   = meshes[meshIndex].BoxMax;
 
             // if we only have one mesh, this node itself contains the mesh/material.
             if (aNode->mNumMeshes == 1)
             {
-                node->Mesh = mesh;
-                if (setDefaultMaterial)
-                {
-                    node->Material = material;
-                }
-                node->BoxMin = boxMin;
-                node->BoxMax = boxMax;
+                desc.Parent = parent;
+                nodes[index] = desc;
             }
             // otherwise, the meshes are considered on equal depth of its children
             else
             {
-                SceneNode* child = new SceneNode(0);
-                child->Mesh = mesh;
-                child->Material = material;
-                child->BoxMin = boxMin;
-                child->BoxMax = boxMax;
-                node->AddChild(child);
+                desc.Parent = index;
+                nodes.push_back(desc);
             }
         }
 
         // also recursively parse this node's children 
         for (unsigned int i = 0; i < aNode->mNumChildren; ++i)
         {
-            node->AddChild(MeshLoader::processNode(renderer, aNode->mChildren[i], aScene, directory, setDefaultMaterial));
+            MeshLoader::flattenNode(aNode->mChildren[i], aScene, index, nodes, meshes);
         }
-
-        return node;
+    }
+    // --------------------------------------------------------------------------------------------
+    SceneNode* MeshLoader::buildHierarchy(Renderer* renderer, const std::vector<NodeDesc>& nodes, const std::vector<ParsedMesh>& meshes, const std::vector<MaterialDesc>& materials, std::string directory, bool setDefaultMaterial)
+    {
+        // note that we allocate memory ourselves and pass memory responsibility to calling 
+        // resource manager. The resource manager is responsible for holding the scene node 
+        // pointer and deleting where appropriate.
+        std::vector<SceneNode*> sceneNodes(nodes.size());
+        for (unsigned int i = 0; i < nodes.size(); ++i)
+        {
+            const NodeDesc& desc = nodes[i];
+            SceneNode* node = new SceneNode(0);
+            if (desc.Mesh >= 0)
+            {
+                node->Mesh   = meshes[desc.Mesh].Mesh;
+                node->BoxMin = desc.BoxMin;
+                node->BoxMax = desc.BoxMax;
+                // create a unique default material for each loaded mesh.
+                if (setDefaultMaterial && desc.Material >= 0)
+                {
+                    node->Material = MeshLoader::createMaterial(renderer, materials[desc.Material], directory);
+                }
+            }
+            if (desc.Parent >= 0)
+            {
+                sceneNodes[desc.Parent]->AddChild(node);
+            }
+            sceneNodes[i] = node;
+        }
+        return sceneNodes.size() > 0 ? sceneNodes[0] : nullptr;
     }
     // --------------------------------------------------------------------------------------------
     Mesh* MeshLoader::parseMesh(aiMesh* aMesh, const aiScene* aScene, math::vec3& out_Min, math::vec3& out_Max)
@@ -107,42 +500,52 @@ namespace Cell
         std::vector<unsigned int> indices;
 
         positions.resize(aMesh->mNumVertices);
-        normals.resize(aMesh->mNumVertices);
-        if (aMesh->mNumUVComponents > 0)
+        if (aMesh->mNormals)
+        {
+            normals.resize(aMesh->mNumVertices);
+        }
+        if (aMesh->mNumUVComponents[0] > 0)
         {
             uv.resize(aMesh->mNumVertices);
-            tangents.resize(aMesh->mNumVertices);
-            bitangents.resize(aMesh->mNumVertices);
+            if (aMesh->mTangents)
+            {
+                tangents.resize(aMesh->mNumVertices);
+                bitangents.resize(aMesh->mNumVertices);
+            }
         }
         // we assume a constant of 3 vertex indices per face as we always triangulate in Assimp's
         // post-processing step; otherwise you'll want transform this to a more  flexible scheme.
         indices.resize(aMesh->mNumFaces * 3);
 
-        // store min/max point in local coordinates for calculating approximate bounding box.
-        math::vec3 pMin( 99999.0);
-        math::vec3 pMax(-99999.0);
-        
-        for (unsigned int i = 0; i < aMesh->mNumVertices; ++i)
+        // Assimp stores its vertex attributes as tightly packed aiVector3D (3 floats) arrays; copy
+        // them in bulk to our own vertex arrays (dropping the 3rd uv component).
+        const unsigned int vertexCount = aMesh->mNumVertices;
+        if (vertexCount > 0)
         {
-            positions[i] = math::vec3(aMesh->mVertices[i].x, aMesh->mVertices[i].y, aMesh->mVertices[i].z);
-            normals[i] = math::vec3(aMesh->mNormals[i].x, aMesh->mNormals[i].y, aMesh->mNormals[i].z);
-            if (aMesh->mTextureCoords[0])
+            math::interleave(&positions[0].x, 3, &aMesh->mVertices[0].x, 3, 3, vertexCount);
+            if (aMesh->mNormals)
             {
-                uv[i] = math::vec2(aMesh->mTextureCoords[0][i].x, aMesh->mTextureCoords[0][i].y);
-
+                math::interleave(&normals[0].x, 3, &aMesh->mNormals[0].x, 3, 3, vertexCount);
             }
-            if (aMesh->mTangents)
+            if (aMesh->mTextureCoords[0] && uv.size() > 0)
             {
-                tangents[i] = math::vec3(aMesh->mTangents[i].x, aMesh->mTangents[i].y, aMesh->mTangents[i].z);
-                bitangents[i] = math::vec3(aMesh->mBitangents[i].x, aMesh->mBitangents[i].y, aMesh->mBitangents[i].z);
+                math::interleave(&uv[0].x, 2, &aMesh->mTextureCoords[0][0].x, 3, 2, vertexCount);
+            }
+            if (aMesh->mTangents && tangents.size() > 0)
+            {
+                math::interleave(&tangents[0].x, 3, &aMesh->mTangents[0].x, 3, 3, vertexCount);
+                math::interleave(&bitangents[0].x, 3, &aMesh->mBitangents[0].x, 3, 3, vertexCount);
             }
-            if (positions[i].x < pMin.x) pMin.x = positions[i].x;
-            if (positions[i].y < pMin.y) pMin.y = positions[i].y;
-            if (positions[i].z < pMin.z) pMin.z = positions[i].z;
-            if (positions[i].x > pMax.x) pMax.x = positions[i].x;
-            if (positions[i].y > pMax.y) pMax.y = positions[i].y;
-            if (positions[i].z > pMax.z) pMax.z = positions[i].z;
         }
+
+        // calculate min/max point in local coordinates for the approximate bounding box; the
+        // strided kernel reads Assimp's positions in place.
+        math::vec3 pMin(0.0f), pMax(0.0f);
+        if (vertexCount > 0)
+        {
+            math::aabb(&aMesh->mVertices[0].x, 3, vertexCount, pMin, pMax);
+        }
+
         for (unsigned int f = 0; f < aMesh->mNumFaces; ++f)
         {
             // we know we're always working with triangles due to TRIANGULATE option.
@@ -153,14 +556,24 @@ namespace Cell
         }
 
         Mesh *mesh = new Mesh;
-        mesh->Positions = positions;
-        mesh->UV = uv;
-        mesh->Normals = normals;
-        mesh->Tangents = tangents;
-        mesh->Bitangents = bitangents;
-        mesh->Indices = indices;
+        mesh->Positions  = std::move(positions);
+        mesh->UV         = std::move(uv);
+        mesh->Normals    = std::move(normals);
+        mesh->Tangents   = std::move(tangents);
+        mesh->Bitangents = std::move(bitangents);
+        mesh->Indices    = std::move(indices);
         mesh->Topology = TRIANGLES;
-        mesh->Finalize(true);
+        // generate whatever the source file didn't provide (most formats don't store tangents).
+        if (mesh->Normals.size() == 0)
+        {
+            mesh->CalculateNormals(true, Resources::GetThreadPool());
+        }
+        if (mesh->UV.size() > 0 && mesh->Tangents.size() == 0)
+        {
+            mesh->CalculateTangents(Resources::GetThreadPool());
+        }
+        // NOTE(Joey): no GL calls in here, as meshes are parsed on worker threads; the mesh is
+        // uploaded by LoadMesh once all meshes are parsed.
 
         out_Min.x = pMin.x;
         out_Min.y = pMin.y;
@@ -169,120 +582,347 @@ namespace Cell
         out_Max.y = pMax.y;
         out_Max.z = pMax.z;
 
-        // store newly generated mesh in globally stored mesh store for memory de-allocation when 
-        // a clean is required.
-        MeshLoader::meshStore.push_back(mesh);
-
         return mesh;
     }
     // --------------------------------------------------------------------------------------------
-    Material *MeshLoader::parseMaterial(Renderer* renderer, aiMaterial* aMaterial, const aiScene* aScene, std::string directory)
+    MeshLoader::MaterialDesc MeshLoader::parseMaterial(aiMaterial* aMaterial)
     {
-        // create a unique default material for each loaded mesh.     
-        Material* material;
+        MaterialDesc desc;
+
         // check if diffuse texture has alpha, if so: make alpha blend material; 
         aiString file;
         aMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &file);
         std::string diffPath = std::string(file.C_Str());
-        bool alpha = false;
-        if (diffPath.find("_alpha") != std::string::npos)
-        {
-            material = renderer->CreateMaterial("alpha discard");
-            alpha = true;
-        }
-        else  // else, make default deferred material
+        desc.Alpha = diffPath.find("_alpha") != std::string::npos;
+
+        // we only load the first of the list of textures of each type, we don't really care 
+        // about meshes with multiple diffuse layers; same holds for other texture types.
+        for (unsigned int i = 0; i < MATERIAL_SLOT_COUNT; ++i)
         {
-            material = renderer->CreateMaterial();
+            if (aMaterial->GetTextureCount(materialSlots[i].Type) > 0)
+            {
+                aiString file;
+                aMaterial->GetTexture(materialSlots[i].Type, 0, &file);
+                desc.Textures[i] = std::string(file.C_Str());
+            }
         }
+        return desc;
+    }
+    // --------------------------------------------------------------------------------------------
+    Material *MeshLoader::createMaterial(Renderer* renderer, const MaterialDesc& desc, std::string directory)
+    {
+        // alpha textured materials get an alpha discard material; otherwise default deferred.
+        Material* material = desc.Alpha ? renderer->CreateMaterial("alpha discard") : renderer->CreateMaterial();
 
         /* NOTE(Joey):
 
-          About texture types:
-
-          We use a PBR metallic/roughness workflow so the loaded models are expected to have 
-          textures conform the workflow: albedo, (normal), metallic, roughness, (ao). Since Assimp
-          made certain assumptions regarding possible types of loaded textures it doesn't directly
-          translate to our model thus we make some assumptions as well which the 3D author has to
-          comply with if he wants the mesh(es) to directly render with its specified textures:
-            
-            - aiTextureType_DIFFUSE:   Albedo
-            - aiTextureType_NORMALS:   Normal
-            - aiTextureType_SPECULAR:  metallic
-            - aiTextureType_SHININESS: roughness 
-            - aiTextureType_AMBIENT:   AO (ambient occlusion)
-            - aiTextureType_EMISSIVE:  Emissive
+          Textures are loaded asynchronously; until a texture is streamed in, the material keeps
+          displaying the texture it inherited from its default material (if any). Materials keep
+          their textures for the lifetime of the renderer, so we never release their handles.
 
         */
-        if (aMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        std::map<std::string, UniformValueSampler>* samplers = material->GetSamplerUniforms();
+        for (unsigned int i = 0; i < MATERIAL_SLOT_COUNT; ++i)
         {
-            // we only load the first of the list of diffuse textures, we don't really care about 
-            // meshes with multiple diffuse layers; same holds for other texture types.
-            aiString file;
-            aMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &file);
-            std::string fileName = MeshLoader::processPath(&file, directory);
+            if (desc.Textures[i].empty())
+                continue;
+
+            auto it = samplers->find(materialSlots[i].Uniform);
+            Texture* placeholder = it != samplers->end() ? it->second.Texture : nullptr;
+
             // we name the texture the same as the filename as to reduce naming conflicts while 
-            // still only loading unique textures.
-            Texture* texture = Resources::LoadTexture(fileName, fileName, GL_TEXTURE_2D, alpha ? GL_RGBA : GL_RGB, true);
+            // still only loading unique textures. Only albedo textures are stored in sRGB.
+            std::string fileName = MeshLoader::processPath(desc.Textures[i], directory);
+            bool albedo = materialSlots[i].Type == aiTextureType_DIFFUSE;
+            GLenum format = albedo && !desc.Alpha ? GL_RGB : GL_RGBA;
+            Texture* texture = Resources::GetTexture(Resources::LoadTextureAsync(fileName, fileName, GL_TEXTURE_2D, format, albedo, placeholder));
             if (texture)
             {
-                material->SetTexture("TexAlbedo", texture, 3);
+                material->SetTexture(materialSlots[i].Uniform, texture, materialSlots[i].Unit);
             }
         }
-        if (aMaterial->GetTextureCount(aiTextureType_DISPLACEMENT) > 0)
+
+        return material;
+    }
+    // --------------------------------------------------------------------------------------------
+    bool MeshLoader::mapCache(std::string path, u64 sourceTime, u64 sourceSize, MappedFile& file)
+    {
+        if (!file.Open(path + ".cellmesh"))
+            return false;
+
+        const u8* data = file.Data();
+        const u64 size = file.Size();
+        const CacheHeader* header = (const CacheHeader*)data;
+        if (size < sizeof(CacheHeader) || header->Magic != CACHE_MAGIC || header->Version != CACHE_VERSION || header->ImportFlags != ImportFlags ||
+            header->Optimized != (Optimize ? 1u : 0u) || header->VertexFormat != (u32)VertexFormat || header->Lods != (GenerateLods ? 1u : 0u) ||
+            header->Meshlets != (BuildMeshlets ? 1u : 0u))
+        {
+            Log::Message("Mesh cache of " + path + " is invalid or of an older version; re-importing.", LOG_WARNING);
+            file.Close();
+            return false;
+        }
+        if (header->SourceTime != sourceTime || header->SourceSize != sourceSize)
         {
-            aiString file;
-            aMaterial->GetTexture(aiTextureType_DISPLACEMENT, 0, &file);
-            std::string fileName = MeshLoader::processPath(&file, directory);
+            Log::Message("Mesh cache of " + path + " is out of date; re-importing.", LOG_INIT);
+            file.Close();
+            return false;
+        }
 
-            Texture* texture = Resources::LoadTexture(fileName, fileName);
-            if (texture)
+        // validate all section bounds before touching any of the data
+        const CacheSections sections = cacheSections(data);
+        bool valid = sections.End <= size && header->StringOffset + header->StringSize <= size && header->NodeCount > 0;
+        const CacheMesh*     cacheMeshes    = sections.Meshes;
+        const CacheMaterial* cacheMaterials = sections.Materials;
+        const CacheNode*     cacheNodes     = sections.Nodes;
+        for (unsigned int i = 0; valid && i < header->MeshCount; ++i)
+        {
+            const CacheMesh& mesh = cacheMeshes[i];
+            valid = !mesh.Present || (mesh.VertexOffset % 4 == 0 && mesh.IndexOffset % 4 == 0 &&
+                    mesh.VertexOffset + (u64)mesh.VertexCount * cacheLayout(mesh, header->VertexFormat).VertexSize() <= size &&
+                    mesh.IndexOffset + (u64)mesh.IndexCount * sizeof(u32) <= size && mesh.LodCount <= MeshSimplifier::MAX_LODS &&
+                    mesh.MeshletOffset % 4 == 0 && mesh.MeshletOffset + (u64)mesh.MeshletCount * sizeof(Meshlet) <= size);
+            u64 lodIndices = 0;
+            for (unsigned int l = 0; valid && l < mesh.LodCount; ++l)
+                lodIndices += mesh.LodIndexCount[l];
+            valid = valid && (!mesh.Present || mesh.LodCount == 0 || lodIndices == mesh.IndexCount);
+            // meshlets must stay within the full detail level of the index buffer
+            const Meshlet* meshlets = (const Meshlet*)(data + mesh.MeshletOffset);
+            const u64 levelIndices  = mesh.LodCount > 0 ? mesh.LodIndexCount[0] : mesh.IndexCount;
+            for (unsigned int m = 0; valid && mesh.Present && m < mesh.MeshletCount; ++m)
+                valid = (u64)meshlets[m].IndexOffset + meshlets[m].IndexCount <= levelIndices;
+        }
+        for (unsigned int i = 0; valid && i < header->MaterialCount; ++i)
+        {
+            for (unsigned int t = 0; t < MATERIAL_SLOT_COUNT; ++t)
+                valid = valid && (u64)cacheMaterials[i].TextureOffset[t] + cacheMaterials[i].TextureLength[t] <= header->StringSize;
+        }
+        // the hierarchy is stored parents first with the root at index 0: the root is the only
+        // node without a parent, all others refer to a node stored before them.
+        for (unsigned int i = 0; valid && i < header->NodeCount; ++i)
+        {
+            const i32 parent = cacheNodes[i].Parent;
+            valid = (i == 0 ? parent == -1 : (parent >= 0 && parent < (i32)i)) && cacheNodes[i].Mesh < (i32)header->MeshCount && cacheNodes[i].Material < (i32)header->MaterialCount &&
+                    (cacheNodes[i].Mesh < 0 || cacheMeshes[cacheNodes[i].Mesh].Present);
+        }
+        if (!valid)
+        {
+            Log::Message("Mesh cache of " + path + " is corrupt; re-importing.", LOG_WARNING);
+            file.Close();
+            return false;
+        }
+        return true;
+    }
+    // --------------------------------------------------------------------------------------------
+    bool MeshLoader::loadCache(std::string path, u64 sourceTime, u64 sourceSize, std::vector<ParsedMesh>& meshes, std::vector<MaterialDesc>& materials, std::vector<NodeDesc>& nodes)
+    {
+        MappedFile file;
+        if (!MeshLoader::mapCache(path, sourceTime, sourceSize, file))
+            return false;
+
+        const u8* data = file.Data();
+        const CacheHeader*   header         = (const CacheHeader*)data;
+        const CacheSections  sections       = cacheSections(data);
+        const CacheMesh*     cacheMeshes    = sections.Meshes;
+        const CacheMaterial* cacheMaterials = sections.Materials;
+        const CacheNode*     cacheNodes     = sections.Nodes;
+        const char*          strings        = (const char*)(data + header->StringOffset);
+
+        materials.resize(header->MaterialCount);
+        for (unsigned int i = 0; i < header->MaterialCount; ++i)
+        {
+            materials[i].Alpha = cacheMaterials[i].Alpha != 0;
+            for (unsigned int t = 0; t < MATERIAL_SLOT_COUNT; ++t)
+                materials[i].Textures[t] = std::string(strings + cacheMaterials[i].TextureOffset[t], cacheMaterials[i].TextureLength[t]);
+        }
+
+        nodes.resize(header->NodeCount);
+        for (unsigned int i = 0; i < header->NodeCount; ++i)
+        {
+            nodes[i].Parent   = cacheNodes[i].Parent;
+            nodes[i].Mesh     = cacheNodes[i].Mesh;
+            nodes[i].Material = cacheNodes[i].Material;
+            nodes[i].BoxMin   = math::vec3(cacheNodes[i].BoxMin[0], cacheNodes[i].BoxMin[1], cacheNodes[i].BoxMin[2]);
+            nodes[i].BoxMax   = math::vec3(cacheNodes[i].BoxMax[0], cacheNodes[i].BoxMax[1], cacheNodes[i].BoxMax[2]);
+        }
+
+        // NOTE(Joey): the vertex and index data is handed to the driver directly from the mapped
+        // file; the meshes' CPU-side vertex arrays stay empty.
+        meshes.resize(header->MeshCount);
+        std::vector<unsigned int> vaos(header->MeshCount), vbos(header->MeshCount), ebos(header->MeshCount);
+        if (header->MeshCount > 0)
+        {
+            glGenVertexArrays(header->MeshCount, &vaos[0]);
+            glGenBuffers(header->MeshCount, &vbos[0]);
+            glGenBuffers(header->MeshCount, &ebos[0]);
+        }
+        for (unsigned int i = 0; i < header->MeshCount; ++i)
+        {
+            const CacheMesh& cacheMesh = cacheMeshes[i];
+            if (!cacheMesh.Present)
             {
-                material->SetTexture("TexNormal", texture, 4);
+                glDeleteVertexArrays(1, &vaos[i]);
+                glDeleteBuffers(1, &vbos[i]);
+                glDeleteBuffers(1, &ebos[i]);
+                continue;
             }
+            Mesh* mesh = new Mesh;
+            mesh->Topology = TRIANGLES;
+            mesh->m_VAO = vaos[i];
+            mesh->m_VBO = vbos[i];
+            mesh->m_EBO = ebos[i];
+            LodRange lods[MeshSimplifier::MAX_LODS];
+            for (unsigned int l = 0, offset = 0; l < cacheMesh.LodCount; ++l)
+            {
+                lods[l].IndexOffset = offset;
+                lods[l].IndexCount  = cacheMesh.LodIndexCount[l];
+                lods[l].Error       = cacheMesh.LodError[l];
+                offset += cacheMesh.LodIndexCount[l];
+            }
+            mesh->Upload(data + cacheMesh.VertexOffset, cacheMesh.VertexCount, cacheLayout(cacheMesh, header->VertexFormat),
+                         (const unsigned int*)(data + cacheMesh.IndexOffset), cacheMesh.IndexCount, lods, cacheMesh.LodCount,
+                         (const Meshlet*)(data + cacheMesh.MeshletOffset), cacheMesh.MeshletCount);
+            meshes[i].Mesh   = mesh;
+            meshes[i].BoxMin = math::vec3(cacheMesh.BoxMin[0], cacheMesh.BoxMin[1], cacheMesh.BoxMin[2]);
+            meshes[i].BoxMax = math::vec3(cacheMesh.BoxMax[0], cacheMesh.BoxMax[1], cacheMesh.BoxMax[2]);
+            MeshLoader::meshStore.push_back(mesh);
         }
-        if (aMaterial->GetTextureCount(aiTextureType_SPECULAR) > 0)
-        {
-            aiString file;
-            aMaterial->GetTexture(aiTextureType_SPECULAR, 0, &file);
-            std::string fileName = MeshLoader::processPath(&file, directory);
+        return true;
+    }
+    // --------------------------------------------------------------------------------------------
+    void MeshLoader::writeCache(std::string path, u64 sourceTime, u64 sourceSize, const std::vector<ParsedMesh>& meshes, const std::vector<MaterialDesc>& materials, const std::vector<NodeDesc>& nodes)
+    {
+        CacheHeader header;
+        header.Magic         = CACHE_MAGIC;
+        header.Version       = CACHE_VERSION;
+        header.ImportFlags   = ImportFlags;
+        header.Optimized     = Optimize ? 1 : 0;
+        header.VertexFormat  = (u32)VertexFormat;
+        header.Lods          = GenerateLods ? 1 : 0;
+        header.Meshlets      = BuildMeshlets ? 1 : 0;
+        header.MeshCount     = (u32)meshes.size();
+        header.SourceTime    = sourceTime;
+        header.SourceSize    = sourceSize;
+        header.MaterialCount = (u32)materials.size();
+        header.NodeCount     = (u32)nodes.size();
 
-            Texture* texture = Resources::LoadTexture(fileName, fileName);
-            if (texture)
+        std::string strings;
+        std::vector<CacheMaterial> cacheMaterials(materials.size());
+        for (unsigned int i = 0; i < materials.size(); ++i)
+        {
+            cacheMaterials[i].Alpha   = materials[i].Alpha ? 1 : 0;
+            cacheMaterials[i].Padding = 0;
+            for (unsigned int t = 0; t < MATERIAL_SLOT_COUNT; ++t)
             {
-                material->SetTexture("TexMetallic", texture, 5);
+                cacheMaterials[i].TextureOffset[t] = (u32)strings.size();
+                cacheMaterials[i].TextureLength[t] = (u32)materials[i].Textures[t].size();
+                strings += materials[i].Textures[t];
             }
         }
-        if (aMaterial->GetTextureCount(aiTextureType_SHININESS) > 0)
+        std::vector<CacheNode> cacheNodes(nodes.size());
+        for (unsigned int i = 0; i < nodes.size(); ++i)
         {
-            aiString file;
-            aMaterial->GetTexture(aiTextureType_SHININESS, 0, &file);
-            std::string fileName = MeshLoader::processPath(&file, directory);
-          
-            Texture* texture = Resources::LoadTexture(fileName, fileName);
-            if (texture)
+            cacheNodes[i].Parent   = nodes[i].Parent;
+            cacheNodes[i].Mesh     = nodes[i].Mesh;
+            cacheNodes[i].Material = nodes[i].Material;
+            for (unsigned int c = 0; c < 3; ++c)
             {
-                material->SetTexture("TexRoughness", texture, 6);
+                cacheNodes[i].BoxMin[c] = nodes[i].BoxMin[c];
+                cacheNodes[i].BoxMax[c] = nodes[i].BoxMax[c];
             }
         }
-        if (aMaterial->GetTextureCount(aiTextureType_AMBIENT) > 0)
+        header.StringOffset = sizeof(CacheHeader) + meshes.size() * sizeof(CacheMesh) + materials.size() * sizeof(CacheMaterial) + nodes.size() * sizeof(CacheNode);
+        header.StringSize   = strings.size();
+
+        u64 offset = alignCache(header.StringOffset + header.StringSize);
+        std::vector<CacheMesh> cacheMeshes(meshes.size());
+        for (unsigned int i = 0; i < meshes.size(); ++i)
         {
-            aiString file;
-            aMaterial->GetTexture(aiTextureType_AMBIENT, 0, &file);
-            std::string fileName = MeshLoader::processPath(&file, directory);
-         
-            Texture* texture = Resources::LoadTexture(fileName, fileName);
-            if (texture)
+            CacheMesh& cacheMesh = cacheMeshes[i];
+            memset(&cacheMesh, 0, sizeof(CacheMesh));
+            Mesh* mesh = meshes[i].Mesh;
+            if (!mesh)
+                continue;
+            const VertexLayout& layout = meshes[i].Layout;
+            cacheMesh.Present      = 1;
+            cacheMesh.Attributes   = layout.Attributes;
+            cacheMesh.VertexCount  = (u32)mesh->Positions.size();
+            cacheMesh.IndexCount   = (u32)mesh->Indices.size();
+            if (!mesh->Lods.empty())
+            {
+                cacheMesh.LodCount         = (u32)mesh->Lods.size() + 1;
+                cacheMesh.LodIndexCount[0] = (u32)mesh->Indices.size();
+                for (unsigned int l = 0; l < mesh->Lods.size(); ++l)
+                {
+                    cacheMesh.LodIndexCount[l + 1] = (u32)mesh->Lods[l].Indices.size();
+                    cacheMesh.LodError[l + 1]      = mesh->Lods[l].Error;
+                    cacheMesh.IndexCount          += (u32)mesh->Lods[l].Indices.size();
+                }
+            }
+            cacheMesh.VertexOffset = offset;
+            offset = alignCache(offset + meshes[i].VertexData.size());
+            cacheMesh.IndexOffset  = offset;
+            offset = alignCache(offset + cacheMesh.IndexCount * sizeof(u32));
+            cacheMesh.MeshletCount  = (u32)mesh->Meshlets.size();
+            cacheMesh.MeshletOffset = offset;
+            offset = alignCache(offset + cacheMesh.MeshletCount * sizeof(Meshlet));
+            for (unsigned int c = 0; c < 3; ++c)
             {
-                material->SetTexture("TexAO", texture, 7);
+                cacheMesh.BoxMin[c] = meshes[i].BoxMin[c];
+                cacheMesh.BoxMax[c] = meshes[i].BoxMax[c];
             }
-        }     
+            cacheMesh.PositionOffset[0] = layout.PositionOffset.x;
+            cacheMesh.PositionOffset[1] = layout.PositionOffset.y;
+            cacheMesh.PositionOffset[2] = layout.PositionOffset.z;
+            cacheMesh.PositionScale[0]  = layout.PositionScale.x;
+            cacheMesh.PositionScale[1]  = layout.PositionScale.y;
+            cacheMesh.PositionScale[2]  = layout.PositionScale.z;
+        }
 
-        return material;
+        std::ofstream file(path + ".cellmesh", std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            Log::Message("Failed to write mesh cache for: " + path + ".", LOG_WARNING);
+            return;
+        }
+        auto padTo = [&file](u64 position)
+        {
+            static const char zeros[16] = { 0 };
+            u64 current = (u64)file.tellp();
+            if (position > current)
+                file.write(zeros, position - current);
+        };
+        file.write((const char*)&header, sizeof(CacheHeader));
+        if (!cacheMeshes.empty())    file.write((const char*)&cacheMeshes[0], cacheMeshes.size() * sizeof(CacheMesh));
+        if (!cacheMaterials.empty()) file.write((const char*)&cacheMaterials[0], cacheMaterials.size() * sizeof(CacheMaterial));
+        if (!cacheNodes.empty())     file.write((const char*)&cacheNodes[0], cacheNodes.size() * sizeof(CacheNode));
+        file.write(strings.data(), strings.size());
+        for (unsigned int i = 0; i < meshes.size(); ++i)
+        {
+            if (!cacheMeshes[i].Present)
+                continue;
+            padTo(cacheMeshes[i].VertexOffset);
+            if (!meshes[i].VertexData.empty())
+                file.write((const char*)&meshes[i].VertexData[0], meshes[i].VertexData.size());
+            padTo(cacheMeshes[i].IndexOffset);
+            if (!meshes[i].Mesh->Indices.empty())
+                file.write((const char*)&meshes[i].Mesh->Indices[0], meshes[i].Mesh->Indices.size() * sizeof(u32));
+            for (const MeshLod& lod : meshes[i].Mesh->Lods)
+            {
+                if (!lod.Indices.empty())
+                    file.write((const char*)&lod.Indices[0], lod.Indices.size() * sizeof(u32));
+            }
+            padTo(cacheMeshes[i].MeshletOffset);
+            if (!meshes[i].Mesh->Meshlets.empty())
+                file.write((const char*)&meshes[i].Mesh->Meshlets[0], meshes[i].Mesh->Meshlets.size() * sizeof(Meshlet));
+        }
+        if (!file)
+        {
+            Log::Message("Failed to write mesh cache for: " + path + ".", LOG_WARNING);
+        }
     }
     // --------------------------------------------------------------------------------------------
-    std::string MeshLoader::processPath(aiString *aPath, std::string directory)
+    std::string MeshLoader::processPath(std::string path, std::string directory)
     {
-        std::string path = std::string(aPath->C_Str());
         // parse path directly if path contains "/" indicating it is an absolute path;  otherwise 
         // parse as relative.
         if(path.find(":/") == std::string::npos || path.find(":\\") == std::string::npos)
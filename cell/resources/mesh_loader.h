@@ -4,7 +4,13 @@
 #include <string>
 #include <vector>
 
+#include "../mesh/mesh.h"
+#include "../mesh/mesh_optimizer.h"
+#include "../mesh/mesh_simplifier.h"
+#include "../mesh/meshlet_builder.h"
+
 #include <math/linear_algebra/vector.h>
+#include <utility/std_types.h>
 
 struct aiNode;
 struct aiScene;
@@ -12,11 +18,12 @@ struct aiMesh;
 struct aiMaterial;
 struct aiString;
 
+class MappedFile;
+
 namespace Cell
 {
     class Renderer;
     class SceneNode;
-    class Mesh;
     class Material;
 
     /* 
@@ -30,14 +37,82 @@ namespace Cell
         // NOTE(Joey): keep track of all loaded mesh
         static std::vector<Mesh*> meshStore;
     public:
+        // when enabled, each imported mesh file is baked into a binary cache file next to it
+        // (<path>.cellmesh) which is memory mapped on subsequent loads instead of re-importing
+        // the source file; see LoadMesh.
+        static bool UseCache;
+        // runs the MeshOptimizer stages (vertex dedup, cache/overdraw/fetch ordering) on each
+        // imported mesh; cached meshes are stored optimized.
+        static bool Optimize;
+        // generates a chain of simplified levels of detail for each imported mesh (see
+        // MeshSimplifier), stored in the cache as well.
+        static bool GenerateLods;
+        // partitions each imported mesh into meshlets for finer grained culling (see
+        // MeshletBuilder), stored in the cache as well.
+        static bool BuildMeshlets;
+        // GPU vertex encoding of imported meshes; see VERTEX_FORMAT.
+        static VERTEX_FORMAT VertexFormat;
+        // the Assimp post-processing steps meshes are imported with; part of the cache key.
+        static const unsigned int ImportFlags;
+
         static void       Clean();
         static SceneNode* LoadMesh(Renderer* renderer, std::string path, bool setDefaultMaterial = true);
+        // releases the GPU memory of all meshes within a loaded scene hierarchy and deletes it
+        static void       Free(SceneNode* node);
+
+        // the GL-free halves of LoadMesh (e.g. for offline baking or benchmarking): BakeCache
+        // imports the file at path and (re)writes its mesh cache, MapCache memory maps the cache
+        // of path into file and validates it against the source file and current settings.
+        static bool BakeCache(std::string path);
+        static bool MapCache(std::string path, MappedFile& file);
     private:
-        static SceneNode* processNode(Renderer* renderer, aiNode* aNode, const aiScene* aScene, std::string directory, bool setDefaultMaterial);
-        static Mesh*      parseMesh(aiMesh* aMesh, const aiScene* aScene, math::vec3& out_Min, math::vec3& out_Max);
-        static Material*  parseMaterial(Renderer* renderer, aiMaterial* aMaterial, const aiScene* aScene, std::string directory);
+        static const unsigned int MATERIAL_SLOT_COUNT = 5;
+
+        // result of the (CPU-side) conversion of a single aiMesh, before it's uploaded.
+        struct ParsedMesh
+        {
+            Cell::Mesh*        Mesh = nullptr;
+            math::vec3         BoxMin;
+            math::vec3         BoxMax;
+            VertexLayout       Layout;
+            std::vector<u8>    VertexData;
+            // vertex cache statistics before and after optimization
+            MeshOptimizer::CacheStatistics CacheBefore;
+            MeshOptimizer::CacheStatistics CacheAfter;
+        };
+        // material as described by the source file: its type and the (relative) texture path of
+        // each material slot; empty if the slot has no texture.
+        struct MaterialDesc
+        {
+            bool        Alpha = false;
+            std::string Textures[MATERIAL_SLOT_COUNT];
+        };
+        // node of the loaded scene hierarchy, flattened in depth-first order. Mesh and Material
+        // index the loaded meshes/materials (-1 if none); Parent always refers to an earlier node.
+        struct NodeDesc
+        {
+            int        Parent   = -1;
+            int        Mesh     = -1;
+            int        Material = -1;
+            math::vec3 BoxMin;
+            math::vec3 BoxMax;
+        };
+
+        static void         flattenNode(aiNode* aNode, const aiScene* aScene, int parent, std::vector<NodeDesc>& nodes, const std::vector<ParsedMesh>& meshes);
+        static SceneNode*   buildHierarchy(Renderer* renderer, const std::vector<NodeDesc>& nodes, const std::vector<ParsedMesh>& meshes, const std::vector<MaterialDesc>& materials, std::string directory, bool setDefaultMaterial);
+        static Mesh*        parseMesh(aiMesh* aMesh, const aiScene* aScene, math::vec3& out_Min, math::vec3& out_Max);
+        static MaterialDesc parseMaterial(aiMaterial* aMaterial);
+        static Material*    createMaterial(Renderer* renderer, const MaterialDesc& desc, std::string directory);
+        // import and convert stages of LoadMesh; meshIndices lists the meshes that were converted.
+        static bool         importMesh(std::string path, std::vector<ParsedMesh>& meshes, std::vector<MaterialDesc>& materials, std::vector<NodeDesc>& nodes, std::vector<unsigned int>& meshIndices);
+
+        // binary mesh cache; keyed on the source file's modification time/size, the importer
+        // settings and the cache format version.
+        static bool mapCache(std::string path, u64 sourceTime, u64 sourceSize, MappedFile& file);
+        static bool loadCache(std::string path, u64 sourceTime, u64 sourceSize, std::vector<ParsedMesh>& meshes, std::vector<MaterialDesc>& materials, std::vector<NodeDesc>& nodes);
+        static void writeCache(std::string path, u64 sourceTime, u64 sourceSize, const std::vector<ParsedMesh>& meshes, const std::vector<MaterialDesc>& materials, const std::vector<NodeDesc>& nodes);
 
-        static std::string processPath(aiString* path, std::string directory);
+        static std::string processPath(std::string path, std::string directory);
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef CELL_RESOURCES_RESOURCE_HANDLE_H
+#define CELL_RESOURCES_RESOURCE_HANDLE_H
+
+#include <utility/std_types.h>
+
+namespace Cell
+{
+    class Shader;
+    class Texture;
+    class TextureCube;
+    class SceneNode;
+
+    /*
+
+      Typed generational handle to a resource managed by Resources. The index identifies the
+      resource's slot in its resource pool, and the generation the resource that occupied that
+      slot at the time the handle was created. Once a resource is unloaded its slot's generation
+      is increased, so a stale handle can always be told apart from a handle to whichever
+      resource re-uses the slot later.
+
+      Handles are plain values; the reference count of a resource is only updated through
+      Resources (Acquire, Retain and Release), never by copying a handle.
+
+    */
+    template <typename T>
+    struct ResourceHandle
+    {
+        static const u32 INVALID = 0xFFFFFFFF;
+
+        u32 Index      = INVALID;
+        u32 Generation = 0;
+
+        bool IsValid() const { return Index != INVALID; }
+
+        bool operator==(const ResourceHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+        bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+    };
+
+    typedef ResourceHandle<Shader>      ShaderHandle;
+    typedef ResourceHandle<Texture>     TextureHandle;
+    typedef ResourceHandle<TextureCube> TextureCubeHandle;
+    typedef ResourceHandle<SceneNode>   MeshHandle;
+}
+
+#endif
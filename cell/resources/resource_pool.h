@@ -0,0 +1,225 @@
+#ifndef CELL_RESOURCES_RESOURCE_POOL_H
+#define CELL_RESOURCES_RESOURCE_POOL_H
+
+#include "resource_handle.h"
+
+#include <utility/string_id.h>
+#include <utility/container/flat_hash_map.h>
+#include <utility/logging/log.h>
+
+#include <vector>
+#include <assert.h>
+
+namespace Cell
+{
+    /*
+
+      Storage of a single type of resource, as used internally by Resources. Resources are
+      indexed by their string ID and stay at a fixed memory location for as long as they're
+      loaded. Next to the resource itself the pool keeps track of:
+
+        - a reference count, modified through Retain/Release of a handle.
+        - whether the resource is pinned: resources handed out as raw pointers (the name based
+          Load functions) can't be tracked and are thus never unloaded.
+        - the resource's estimated (GPU) memory footprint.
+
+      The entries that can be unloaded (unreferenced and not pinned) are kept in an intrusive
+      list ordered from most to least recently used. Whenever the pool's memory usage exceeds
+      its budget, entries are unloaded from the tail of that list (see Evict), s.t. eviction
+      never has to search the pool. HandleType is the type the pool's handles are typed on
+      (e.g. mesh hierarchies are stored as SceneNode*, but handed out as MeshHandle).
+
+    */
+    template <typename T, typename HandleType = T>
+    class ResourcePool
+    {
+    public:
+        // NOTE(Joey): RefCount and Pinned determine whether the entry is in the LRU list; only
+        // modify them through Retain/Release/Pin.
+        struct Entry
+        {
+            T        Resource;
+            StringID ID;
+            u32      Index    = 0; // value index in the pool's map
+            u32      RefCount = 0;
+            bool     Pinned   = false;
+            size_t   Bytes    = 0;
+            // LRU list links; only valid while the entry is unreferenced and not pinned
+            Entry*   LruPrev  = nullptr;
+            Entry*   LruNext  = nullptr;
+        };
+    private:
+        FlatHashMap<StringID, Entry> m_Entries;
+        // generation per entry (value) index of m_Entries; increased on each unload.
+        std::vector<u32> m_Generations;
+        // unloadable entries; head is the most, tail the least recently used
+        Entry* m_LruHead = nullptr;
+        Entry* m_LruTail = nullptr;
+
+        size_t m_MemoryUsage  = 0;
+        size_t m_MemoryBudget = 0; // 0: unlimited
+        const char* m_TypeName;
+
+    public:
+        ResourcePool(const char* typeName) : m_TypeName(typeName) { }
+
+        Entry* Find(StringID id)
+        {
+            return m_Entries.Find(id);
+        }
+        // stores a resource under an ID that isn't loaded yet; the entry starts out
+        // unreferenced (and thus evictable) until retained or pinned.
+        Entry* Insert(StringID id, const T& resource, size_t bytes)
+        {
+            assert(!m_Entries.Find(id));
+            Entry entry;
+            entry.Resource = resource;
+            entry.ID       = id;
+            entry.Bytes    = bytes;
+            u32 index;
+            Entry* stored = m_Entries.Insert(id, entry, &index);
+            stored->Index = index;
+            if (index >= m_Generations.size())
+                m_Generations.resize(index + 1, 0);
+            m_MemoryUsage += bytes;
+            lruPush(stored);
+            return stored;
+        }
+        // returns the (unreferenced) handle of a loaded resource
+        ResourceHandle<HandleType> HandleOf(const Entry* entry)
+        {
+            ResourceHandle<HandleType> handle;
+            handle.Index      = entry->Index;
+            handle.Generation = m_Generations[entry->Index];
+            return handle;
+        }
+        // returns the entry a handle refers to; nullptr if the handle is invalid or stale.
+        Entry* Resolve(ResourceHandle<HandleType> handle)
+        {
+            if (!handle.IsValid())
+                return nullptr;
+            if (handle.Index >= m_Generations.size() || m_Generations[handle.Index] != handle.Generation)
+            {
+                // NOTE(Joey): a stale handle means the resource was unloaded while someone still
+                // held on to it: a use-after-free in any other setting; loudly report in debug.
+                Log::Message(std::string("Use of unloaded ") + m_TypeName + " resource (stale handle " + std::to_string(handle.Index) + ":" + std::to_string(handle.Generation) + ").", LOG_ERROR);
+#ifdef _DEBUG
+                assert(!"stale resource handle");
+#endif
+                return nullptr;
+            }
+            Entry* entry = m_Entries.At(handle.Index);
+            Touch(entry);
+            return entry;
+        }
+
+        // marks the entry as most recently used
+        void Touch(Entry* entry)
+        {
+            if (evictable(entry) && entry != m_LruHead)
+            {
+                lruRemove(entry);
+                lruPush(entry);
+            }
+        }
+        void Retain(Entry* entry)
+        {
+            if (evictable(entry))
+                lruRemove(entry);
+            ++entry->RefCount;
+        }
+        // returns true if this released the last reference; over-releasing is reported as it
+        // indicates a handle that's still in use somewhere without holding a reference.
+        bool Release(Entry* entry)
+        {
+            if (entry->RefCount == 0)
+            {
+                Log::Message("Resource " + StringIDName(entry->ID) + " released more often than acquired.", LOG_WARNING);
+                return false;
+            }
+            if (--entry->RefCount > 0)
+                return false;
+            if (!entry->Pinned)
+                lruPush(entry);
+            return true;
+        }
+        // keeps the resource loaded for the lifetime of the pool
+        void Pin(Entry* entry)
+        {
+            if (evictable(entry))
+                lruRemove(entry);
+            entry->Pinned = true;
+        }
+        // updates the memory footprint of an entry (e.g. once an asynchronous load completes)
+        void SetBytes(Entry* entry, size_t bytes)
+        {
+            m_MemoryUsage = m_MemoryUsage - entry->Bytes + bytes;
+            entry->Bytes  = bytes;
+        }
+
+        // unloads unreferenced resources in least-recently-used order until the pool fits its
+        // memory budget again; freeFunc(T&) is responsible for releasing the GPU memory.
+        template <typename FreeFunc>
+        void Evict(FreeFunc freeFunc)
+        {
+            // if the list runs empty everything left is in use; we can't do better than this.
+            while (m_MemoryBudget > 0 && m_MemoryUsage > m_MemoryBudget && m_LruTail)
+            {
+                Log::Message(std::string("Unloading ") + m_TypeName + ": " + StringIDName(m_LruTail->ID) + ".", LOG_DEBUG);
+                unload(m_LruTail, freeFunc);
+            }
+        }
+        // unloads all resources regardless of their reference count
+        template <typename FreeFunc>
+        void Clear(FreeFunc freeFunc)
+        {
+            std::vector<Entry*> entries;
+            m_Entries.ForEach([&](StringID id, Entry& entry) { entries.push_back(&entry); });
+            for (unsigned int i = 0; i < entries.size(); ++i)
+                unload(entries[i], freeFunc);
+        }
+
+        void   SetMemoryBudget(size_t bytes) { m_MemoryBudget = bytes; }
+        size_t GetMemoryBudget() const { return m_MemoryBudget; }
+        size_t GetMemoryUsage()  const { return m_MemoryUsage; }
+        u32    GetCount()        const { return m_Entries.Size(); }
+
+    private:
+        static bool evictable(const Entry* entry)
+        {
+            return entry->RefCount == 0 && !entry->Pinned;
+        }
+        void lruPush(Entry* entry)
+        {
+            entry->LruPrev = nullptr;
+            entry->LruNext = m_LruHead;
+            if (m_LruHead)
+                m_LruHead->LruPrev = entry;
+            else
+                m_LruTail = entry;
+            m_LruHead = entry;
+        }
+        void lruRemove(Entry* entry)
+        {
+            if (entry->LruPrev) entry->LruPrev->LruNext = entry->LruNext;
+            else                m_LruHead = entry->LruNext;
+            if (entry->LruNext) entry->LruNext->LruPrev = entry->LruPrev;
+            else                m_LruTail = entry->LruPrev;
+            entry->LruPrev = entry->LruNext = nullptr;
+        }
+
+        template <typename FreeFunc>
+        void unload(Entry* entry, FreeFunc freeFunc)
+        {
+            if (evictable(entry))
+                lruRemove(entry);
+            StringID id = entry->ID;
+            freeFunc(entry->Resource);
+            m_MemoryUsage -= entry->Bytes;
+            ++m_Generations[entry->Index];
+            m_Entries.Erase(id);
+        }
+    };
+}
+
+#endif
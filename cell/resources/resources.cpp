@@ -3,6 +3,7 @@
 #include "shader_loader.h"
 #include "texture_loader.h"
 #include "mesh_loader.h"
+#include "texture_streamer.h"
 
 #include "../scene/scene.h"
 #include "../scene/scene_node.h"
@@ -10,82 +11,111 @@
 #include <utility/string_id.h>
 #include <utility/logging/log.h>
 
+#include <algorithm>
 #include <stack>
 #include <vector>
 
 namespace Cell
 {
-    std::map<unsigned int, Shader>      Resources::m_Shaders      = std::map<unsigned int, Shader>();
-    std::map<unsigned int, Texture>     Resources::m_Textures     = std::map<unsigned int, Texture>();
-    std::map<unsigned int, TextureCube> Resources::m_TexturesCube = std::map<unsigned int, TextureCube>();
-    std::map<unsigned int, SceneNode*>  Resources::m_Meshes       = std::map<unsigned int, SceneNode*>();
+    ResourcePool<Shader>                Resources::m_Shaders("shader");
+    ResourcePool<Texture>               Resources::m_Textures("texture");
+    ResourcePool<TextureCube>           Resources::m_TexturesCube("texture cube");
+    ResourcePool<SceneNode*, SceneNode> Resources::m_Meshes("mesh");
+    Texture                             Resources::m_Placeholder;
+    ThreadPool*                         Resources::m_ThreadPool = nullptr;
     // --------------------------------------------------------------------------------------------
     void Resources::Init()
     {
         // initialize default assets/resources that should  always be available, regardless of 
         // configuration.        
-        Texture placeholderTexture;
+        unsigned char white[] = { 255, 255, 255, 255 };
+        m_Placeholder.Mipmapping = false;
+        m_Placeholder.FilterMin  = GL_NEAREST;
+        m_Placeholder.FilterMax  = GL_NEAREST;
+        m_Placeholder.Generate(1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, white);
+
+        m_ThreadPool = new ThreadPool;
+        Log::Message("Resource loading w/ " + std::to_string(m_ThreadPool->GetThreadCount()) + " worker thread(s).", LOG_INIT);
+        TextureStreamer::Init(m_ThreadPool);
     }
     void Resources::Clean()
     {
+        // finish all in-flight loading jobs before cleaning up their consumers
+        delete m_ThreadPool;
+        m_ThreadPool = nullptr;
+        TextureStreamer::Clean();
+        glDeleteTextures(1, &m_Placeholder.ID);
+
         // traverse all stored mesh scene nodes and delete accordingly.
         // Note that this time we don't care about deleting dangling pointers as each scene node is
         // unique and shouldn't reference other scene nodes than their children.
-        for(auto it = m_Meshes.begin(); it != m_Meshes.end(); it++)
+        m_Meshes.Clear([](SceneNode* node)
         {
-            delete it->second;
-        }
+            delete node;
+        });
     }
 
     // --------------------------------------------------------------------------------------------
-    Shader* Resources::LoadShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines)
+    ThreadPool* Resources::GetThreadPool()
     {
-        unsigned int id = SID(name);
-
-        // if shader already exists, return that handle
-        if(Resources::m_Shaders.find(id) != Resources::m_Shaders.end())
-            return &Resources::m_Shaders[id];
+        return m_ThreadPool;
+    }
 
-        Shader shader = ShaderLoader::Load(name, vsPath, fsPath, defines);
-        Resources::m_Shaders[id] = shader;
-        return &Resources::m_Shaders[id];
+    // --------------------------------------------------------------------------------------------
+    Shader* Resources::LoadShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines)
+    {
+        auto entry = loadShader(name, vsPath, fsPath, defines);
+        m_Shaders.Pin(entry);
+        return &entry->Resource;
+    }
+    // --------------------------------------------------------------------------------------------
+    Shader* Resources::LoadGeometryShader(std::string name, std::string vsPath, std::string gsPath, std::string fsPath, std::vector<std::string> defines)
+    {
+        StringID id = SID(name);
+        auto entry = Resources::m_Shaders.Find(id);
+        if (!entry)
+            entry = Resources::m_Shaders.Insert(id, ShaderLoader::LoadGeometry(name, vsPath, gsPath, fsPath, defines), 0);
+        m_Shaders.Pin(entry);
+        return &entry->Resource;
+    }
+    // --------------------------------------------------------------------------------------------
+    Shader* Resources::LoadComputeShader(std::string name, std::string csPath, std::vector<std::string> defines)
+    {
+        StringID id = SID(name);
+        auto entry = Resources::m_Shaders.Find(id);
+        if (!entry)
+            entry = Resources::m_Shaders.Insert(id, ShaderLoader::LoadCompute(name, csPath, defines), 0);
+        m_Shaders.Pin(entry);
+        return &entry->Resource;
     }
     // --------------------------------------------------------------------------------------------
     Shader* Resources::GetShader(std::string name)
     {
-        unsigned int id = SID(name);
-
+        return Resources::GetShader(SID(name));
+    }
+    // --------------------------------------------------------------------------------------------
+    Shader* Resources::GetShader(StringID id)
+    {
         // if shader exists, return that handle
-        if (Resources::m_Shaders.find(id) != Resources::m_Shaders.end())
+        if (auto found = Resources::m_Shaders.Find(id))
         {
-            return &Resources::m_Shaders[id];
+            Resources::m_Shaders.Touch(found);
+            return &found->Resource;
         }
         else
         {
-            Log::Message("Requested shader: " + name + " not found!", LOG_WARNING);
+            Log::Message("Requested shader: " + StringIDName(id) + " not found!", LOG_WARNING);
             return nullptr;
         }
     }
     // --------------------------------------------------------------------------------------------
     Texture* Resources::LoadTexture(std::string name, std::string path, GLenum target, GLenum format, bool srgb)
     {
-        unsigned int id = SID(name);
-
-        // if texture already exists, return that handle
-        if (Resources::m_Textures.find(id) != Resources::m_Textures.end())
-            return &Resources::m_Textures[id];
-
-        Log::Message("Loading texture file at: " + path + ".", LOG_INIT);
-
-        Texture texture = TextureLoader::LoadTexture(path, target, format, srgb);
-
-        Log::Message("Succesfully loaded: " + path + ".", LOG_INIT);
-
-        // make sure texture got properly loaded
-        if (texture.Width > 0)
+        auto entry = loadTexture(name, path, target, format, srgb);
+        if (entry)
         {
-            Resources::m_Textures[id] = texture;
-            return &Resources::m_Textures[id];
+            m_Textures.Pin(entry);
+            return &entry->Resource;
         }
         else
         {
@@ -95,18 +125,11 @@ namespace Cell
     // --------------------------------------------------------------------------------------------
     Texture* Resources::LoadHDR(std::string name, std::string path)
     {
-        unsigned int id = SID(name);
-
-        // if texture already exists, return that handle
-        if (Resources::m_Textures.find(id) != Resources::m_Textures.end())
-            return &Resources::m_Textures[id];
-
-        Texture texture = TextureLoader::LoadHDRTexture(path);
-        // make sure texture got properly loaded
-        if (texture.Width > 0)
+        auto entry = loadHDR(name, path);
+        if (entry)
         {
-            Resources::m_Textures[id] = texture;
-            return &Resources::m_Textures[id];
+            m_Textures.Pin(entry);
+            return &entry->Resource;
         }
         else
         {
@@ -116,88 +139,490 @@ namespace Cell
     // --------------------------------------------------------------------------------------------
     Texture* Resources::GetTexture(std::string name)
     {
-        unsigned int id = SID(name);
-
+        return Resources::GetTexture(SID(name));
+    }
+    // --------------------------------------------------------------------------------------------
+    Texture* Resources::GetTexture(StringID id)
+    {
         // if shader exists, return that handle
-        if (Resources::m_Textures.find(id) != Resources::m_Textures.end())
+        if (auto found = Resources::m_Textures.Find(id))
         {
-            return &Resources::m_Textures[id];
+            Resources::m_Textures.Touch(found);
+            return &found->Resource;
         }
         else
         {
-            Log::Message("Requested texture: " + name + " not found!", LOG_WARNING);
+            Log::Message("Requested texture: " + StringIDName(id) + " not found!", LOG_WARNING);
             return nullptr;
         }
     }
     // --------------------------------------------------------------------------------------------
     TextureCube* Resources::LoadTextureCube(std::string name, std::string folder)
     {
-        unsigned int id = SID(name);
-
-        // if texture already exists, return that handle
-        if (Resources::m_TexturesCube.find(id) != Resources::m_TexturesCube.end())
-            return &Resources::m_TexturesCube[id];
-
-        TextureCube texture = TextureLoader::LoadTextureCube(folder);
-        Resources::m_TexturesCube[id] = texture;
-        return &Resources::m_TexturesCube[id];
+        auto entry = loadTextureCube(name, folder);
+        m_TexturesCube.Pin(entry);
+        return &entry->Resource;
     }
     // --------------------------------------------------------------------------------------------
     TextureCube* Resources::GetTextureCube(std::string name)
     {
-        unsigned int id = SID(name);
-
+        return Resources::GetTextureCube(SID(name));
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureCube* Resources::GetTextureCube(StringID id)
+    {
         // if shader exists, return that handle
-        if (Resources::m_TexturesCube.find(id) != Resources::m_TexturesCube.end())
+        if (auto found = Resources::m_TexturesCube.Find(id))
         {
-            return &Resources::m_TexturesCube[id];
+            Resources::m_TexturesCube.Touch(found);
+            return &found->Resource;
         }
         else
         {
-            Log::Message("Requested texture cube: " + name + " not found!", LOG_WARNING);
+            Log::Message("Requested texture cube: " + StringIDName(id) + " not found!", LOG_WARNING);
             return nullptr;
         }
     }
     // --------------------------------------------------------------------------------------------
     SceneNode* Resources::LoadMesh(Renderer* renderer, std::string name, std::string path)
     {
-        unsigned int id = SID(name);
+        auto entry = loadMesh(renderer, name, path);
+        if (!entry)
+            return nullptr;
+        m_Meshes.Pin(entry);
 
-        // if mesh's scene node was already loaded before, copy the scene node's memory and return 
-        // the copied reference. We return a copy as the moment the global scene deletes the 
+        // return a copied reference through the scene to prevent dangling pointers.
+        // See loadMesh.
+        return Scene::MakeSceneNode(entry->Resource);
+    }
+    // --------------------------------------------------------------------------------------------
+    SceneNode* Resources::GetMesh(std::string name)
+    {
+        return Resources::GetMesh(SID(name));
+    }
+    // --------------------------------------------------------------------------------------------
+    SceneNode* Resources::GetMesh(StringID id)
+    {
+        // if mesh's scene node was already loaded before, copy the scene node's memory and return
+        // the copied reference. We return a copy as the moment the global scene deletes the
         // returned node, all other and next requested scene nodes of this model will end up as
         // dangling pointers.
-        if (Resources::m_Meshes.find(id) != Resources::m_Meshes.end())
+        if (auto found = Resources::m_Meshes.Find(id))
         {
-            return Scene::MakeSceneNode(Resources::m_Meshes[id]);
+            Resources::m_Meshes.Touch(found);
+            return Scene::MakeSceneNode(found->Resource);
         }
+        else
+        {
+            Log::Message("Requested mesh: " + StringIDName(id) + " not found!", LOG_WARNING);
+            return nullptr;
+        }
+    }
 
-        // MeshLoader::LoadMesh initializes a scene node hierarchy on the heap. We are responsible 
-        // for managing the memory; keep a reference to the root node of the model scene. 
-        SceneNode* node = MeshLoader::LoadMesh(renderer, path);
-        Resources::m_Meshes[id] = node;
+    // --------------------------------------------------------------------------------------------
+    ShaderHandle Resources::AcquireShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines)
+    {
+        auto entry = loadShader(name, vsPath, fsPath, defines);
+        m_Shaders.Retain(entry);
+        ShaderHandle handle = m_Shaders.HandleOf(entry);
+        evict(RESOURCE_SHADER);
+        return handle;
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureHandle Resources::AcquireTexture(std::string name, std::string path, GLenum target, GLenum format, bool srgb)
+    {
+        auto entry = loadTexture(name, path, target, format, srgb);
+        if (!entry)
+            return TextureHandle();
+        m_Textures.Retain(entry);
+        TextureHandle handle = m_Textures.HandleOf(entry);
+        evict(RESOURCE_TEXTURE);
+        return handle;
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureHandle Resources::AcquireHDR(std::string name, std::string path)
+    {
+        auto entry = loadHDR(name, path);
+        if (!entry)
+            return TextureHandle();
+        m_Textures.Retain(entry);
+        TextureHandle handle = m_Textures.HandleOf(entry);
+        evict(RESOURCE_TEXTURE);
+        return handle;
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureCubeHandle Resources::AcquireTextureCube(std::string name, std::string folder)
+    {
+        auto entry = loadTextureCube(name, folder);
+        m_TexturesCube.Retain(entry);
+        TextureCubeHandle handle = m_TexturesCube.HandleOf(entry);
+        evict(RESOURCE_TEXTURE_CUBE);
+        return handle;
+    }
+    // --------------------------------------------------------------------------------------------
+    MeshHandle Resources::AcquireMesh(Renderer* renderer, std::string name, std::string path)
+    {
+        auto entry = loadMesh(renderer, name, path);
+        if (!entry)
+            return MeshHandle();
+        m_Meshes.Retain(entry);
+        MeshHandle handle = m_Meshes.HandleOf(entry);
+        evict(RESOURCE_MESH);
+        return handle;
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureHandle Resources::LoadTextureAsync(std::string name, std::string path, GLenum target, GLenum format, bool srgb, Texture* placeholder)
+    {
+        StringID id = SID(name);
+
+        // if texture already exists (or is already loading), return that handle
+        if (auto found = Resources::m_Textures.Find(id))
+        {
+            m_Textures.Retain(found);
+            return m_Textures.HandleOf(found);
+        }
+        if (target != GL_TEXTURE_2D)
+            return AcquireTexture(name, path, target, format, srgb);
+
+        // NOTE(Joey): the stored texture starts out referring to the placeholder's GPU texture;
+        // the texture is generated in-place once uploaded s.t. each pointer to it (e.g. from a
+        // material) automatically picks up the actual texture.
+        Texture* source = placeholder ? placeholder : &m_Placeholder;
+        Texture texture;
+        texture.ID             = source->ID;
+        texture.Width          = source->Width;
+        texture.Height         = source->Height;
+        texture.InternalFormat = TextureLoader::ResolveInternalFormat(format, srgb);
 
-        // return a copied reference through the scene to prevent dangling pointers. 
-        // See description above.
-        return Scene::MakeSceneNode(node);
+        auto entry = m_Textures.Insert(id, texture, 0);
+        // hold an additional reference while the texture is in flight, s.t. it can't be unloaded
+        // before its upload completes.
+        m_Textures.Retain(entry);
+        m_Textures.Retain(entry);
+        TextureHandle handle = m_Textures.HandleOf(entry);
+
+        Log::Message("Loading texture file at: " + path + " (async).", LOG_INIT);
+        TextureStreamer::Load(&entry->Resource, path, false, [handle](Texture* texture, bool success)
+        {
+            auto entry = m_Textures.Resolve(handle);
+            if (success)
+            {
+                m_Textures.SetBytes(entry, memoryUsage(*texture));
+                // the texture's memory only counts from here on; make room for it right away
+                evict(RESOURCE_TEXTURE);
+            }
+            else
+            {
+                m_Textures.Pin(entry); // still refers to the (shared) placeholder; never free it
+            }
+            Resources::Release(handle);
+        });
+        return handle;
     }
     // --------------------------------------------------------------------------------------------
-    SceneNode* Resources::GetMesh(std::string name)
+    Shader* Resources::GetShader(ShaderHandle handle)
+    {
+        auto entry = m_Shaders.Resolve(handle);
+        return entry ? &entry->Resource : nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    Texture* Resources::GetTexture(TextureHandle handle)
+    {
+        auto entry = m_Textures.Resolve(handle);
+        return entry ? &entry->Resource : nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    TextureCube* Resources::GetTextureCube(TextureCubeHandle handle)
+    {
+        auto entry = m_TexturesCube.Resolve(handle);
+        return entry ? &entry->Resource : nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    SceneNode* Resources::GetMesh(MeshHandle handle)
+    {
+        auto entry = m_Meshes.Resolve(handle);
+        return entry ? Scene::MakeSceneNode(entry->Resource) : nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Retain(ShaderHandle handle)
+    {
+        if (auto entry = m_Shaders.Resolve(handle))
+            m_Shaders.Retain(entry);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Retain(TextureHandle handle)
+    {
+        if (auto entry = m_Textures.Resolve(handle))
+            m_Textures.Retain(entry);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Retain(TextureCubeHandle handle)
+    {
+        if (auto entry = m_TexturesCube.Resolve(handle))
+            m_TexturesCube.Retain(entry);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Retain(MeshHandle handle)
+    {
+        if (auto entry = m_Meshes.Resolve(handle))
+            m_Meshes.Retain(entry);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Release(ShaderHandle handle)
+    {
+        auto entry = m_Shaders.Resolve(handle);
+        if (entry && m_Shaders.Release(entry))
+            evict(RESOURCE_SHADER);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Release(TextureHandle handle)
+    {
+        auto entry = m_Textures.Resolve(handle);
+        if (entry && m_Textures.Release(entry))
+            evict(RESOURCE_TEXTURE);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Release(TextureCubeHandle handle)
+    {
+        auto entry = m_TexturesCube.Resolve(handle);
+        if (entry && m_TexturesCube.Release(entry))
+            evict(RESOURCE_TEXTURE_CUBE);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::Release(MeshHandle handle)
     {
-        unsigned int id = SID(name);
+        auto entry = m_Meshes.Resolve(handle);
+        if (entry && m_Meshes.Release(entry))
+            evict(RESOURCE_MESH);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::SetMemoryBudget(RESOURCE_TYPE type, size_t bytes)
+    {
+        switch (type)
+        {
+        case RESOURCE_SHADER:       m_Shaders.SetMemoryBudget(bytes);      break;
+        case RESOURCE_TEXTURE:      m_Textures.SetMemoryBudget(bytes);     break;
+        case RESOURCE_TEXTURE_CUBE: m_TexturesCube.SetMemoryBudget(bytes); break;
+        case RESOURCE_MESH:         m_Meshes.SetMemoryBudget(bytes);       break;
+        }
+        evict(type);
+    }
+    // --------------------------------------------------------------------------------------------
+    size_t Resources::GetMemoryBudget(RESOURCE_TYPE type)
+    {
+        switch (type)
+        {
+        case RESOURCE_SHADER:       return m_Shaders.GetMemoryBudget();
+        case RESOURCE_TEXTURE:      return m_Textures.GetMemoryBudget();
+        case RESOURCE_TEXTURE_CUBE: return m_TexturesCube.GetMemoryBudget();
+        case RESOURCE_MESH:         return m_Meshes.GetMemoryBudget();
+        }
+        return 0;
+    }
+    // --------------------------------------------------------------------------------------------
+    size_t Resources::GetMemoryUsage(RESOURCE_TYPE type)
+    {
+        switch (type)
+        {
+        case RESOURCE_SHADER:       return m_Shaders.GetMemoryUsage();
+        case RESOURCE_TEXTURE:      return m_Textures.GetMemoryUsage();
+        case RESOURCE_TEXTURE_CUBE: return m_TexturesCube.GetMemoryUsage();
+        case RESOURCE_MESH:         return m_Meshes.GetMemoryUsage();
+        }
+        return 0;
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int Resources::GetResourceCount(RESOURCE_TYPE type)
+    {
+        switch (type)
+        {
+        case RESOURCE_SHADER:       return m_Shaders.GetCount();
+        case RESOURCE_TEXTURE:      return m_Textures.GetCount();
+        case RESOURCE_TEXTURE_CUBE: return m_TexturesCube.GetCount();
+        case RESOURCE_MESH:         return m_Meshes.GetCount();
+        }
+        return 0;
+    }
 
-        // if mesh's scene node was already loaded before, copy the scene node's memory and return 
-        // the copied reference. We return a copy as the moment the global scene deletes the 
-        // returned node, all other and next requested scene nodes of this model will end up as
-        // dangling pointers.
-        if (Resources::m_Meshes.find(id) != Resources::m_Meshes.end())
+    // --------------------------------------------------------------------------------------------
+    ResourcePool<Shader>::Entry* Resources::loadShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines)
+    {
+        StringID id = SID(name);
+
+        // if shader already exists, return that handle
+        if (auto found = Resources::m_Shaders.Find(id))
+            return found;
+
+        Shader shader = ShaderLoader::Load(name, vsPath, fsPath, defines);
+        // NOTE(Joey): shaders are tiny w/ respect to GPU memory; we only track their count.
+        return Resources::m_Shaders.Insert(id, shader, 0);
+    }
+    // --------------------------------------------------------------------------------------------
+    ResourcePool<Texture>::Entry* Resources::loadTexture(std::string name, std::string path, GLenum target, GLenum format, bool srgb)
+    {
+        StringID id = SID(name);
+
+        // if texture already exists, return that handle
+        if (auto found = Resources::m_Textures.Find(id))
+            return found;
+
+        Log::Message("Loading texture file at: " + path + ".", LOG_INIT);
+
+        Texture texture = TextureLoader::LoadTexture(path, target, format, srgb);
+
+        Log::Message("Succesfully loaded: " + path + ".", LOG_INIT);
+
+        // make sure texture got properly loaded
+        if (texture.Width > 0)
         {
-            return Scene::MakeSceneNode(Resources::m_Meshes[id]);
+            return Resources::m_Textures.Insert(id, texture, memoryUsage(texture));
         }
         else
         {
-            Log::Message("Requested mesh: " + name + " not found!", LOG_WARNING);
             return nullptr;
         }
     }
-}
\ No newline at end of file
+    // --------------------------------------------------------------------------------------------
+    ResourcePool<Texture>::Entry* Resources::loadHDR(std::string name, std::string path)
+    {
+        StringID id = SID(name);
+
+        // if texture already exists, return that handle
+        if (auto found = Resources::m_Textures.Find(id))
+            return found;
+
+        Texture texture = TextureLoader::LoadHDRTexture(path);
+        // make sure texture got properly loaded
+        if (texture.Width > 0)
+        {
+            return Resources::m_Textures.Insert(id, texture, memoryUsage(texture));
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    ResourcePool<TextureCube>::Entry* Resources::loadTextureCube(std::string name, std::string folder)
+    {
+        StringID id = SID(name);
+
+        // if texture already exists, return that handle
+        if (auto found = Resources::m_TexturesCube.Find(id))
+            return found;
+
+        TextureCube texture = TextureLoader::LoadTextureCube(folder);
+        return Resources::m_TexturesCube.Insert(id, texture, memoryUsage(texture));
+    }
+    // --------------------------------------------------------------------------------------------
+    ResourcePool<SceneNode*, SceneNode>::Entry* Resources::loadMesh(Renderer* renderer, std::string name, std::string path)
+    {
+        StringID id = SID(name);
+
+        // if mesh's scene node was already loaded before, return the stored root node. Note that
+        // callers should only ever hand out copies of this node: the moment the global scene
+        // deletes a returned node, all other and next requested scene nodes of this model would
+        // end up as dangling pointers.
+        if (auto found = Resources::m_Meshes.Find(id))
+            return found;
+
+        // MeshLoader::LoadMesh initializes a scene node hierarchy on the heap. We are responsible
+        // for managing the memory; keep a reference to the root node of the model scene.
+        SceneNode* node = MeshLoader::LoadMesh(renderer, path);
+        if (!node)
+            return nullptr;
+        return Resources::m_Meshes.Insert(id, node, memoryUsage(node));
+    }
+    // --------------------------------------------------------------------------------------------
+    // NOTE(Joey): approximate size in bytes per texel of the internal formats we use; 3 component
+    // formats are generally padded to 4 components by the driver.
+    static size_t bytesPerTexel(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+        case GL_RED:
+        case GL_R8:
+            return 1;
+        case GL_RG:
+        case GL_RG8:
+        case GL_R16F:
+            return 2;
+        case GL_RG16F:
+        case GL_R32F:
+            return 4;
+        case GL_RGB16F:
+        case GL_RGBA16F:
+        case GL_RG32F:
+            return 8;
+        case GL_RGB32F:
+        case GL_RGBA32F:
+            return 16;
+        default: // GL_RGB(A), GL_SRGB(_ALPHA), depth formats
+            return 4;
+        }
+    }
+    // --------------------------------------------------------------------------------------------
+    size_t Resources::memoryUsage(Texture& texture)
+    {
+        size_t texels = (size_t)texture.Width * std::max(texture.Height, 1u) * std::max(texture.Depth, 1u);
+        size_t bytes  = texels * bytesPerTexel(texture.InternalFormat);
+        // a full mip chain adds roughly a third to the base level's memory
+        return texture.Mipmapping ? bytes + bytes / 3 : bytes;
+    }
+    // --------------------------------------------------------------------------------------------
+    size_t Resources::memoryUsage(TextureCube& texture)
+    {
+        size_t bytes = (size_t)texture.FaceWidth * texture.FaceHeight * bytesPerTexel(texture.InternalFormat) * 6;
+        return texture.Mipmapping ? bytes + bytes / 3 : bytes;
+    }
+    // --------------------------------------------------------------------------------------------
+    size_t Resources::memoryUsage(SceneNode* node)
+    {
+        size_t bytes = 0;
+        std::stack<SceneNode*> nodeStack;
+        nodeStack.push(node);
+        while (!nodeStack.empty())
+        {
+            SceneNode* current = nodeStack.top();
+            nodeStack.pop();
+            if (Mesh* mesh = current->Mesh)
+            {
+                bytes += mesh->m_BufferSize;
+            }
+            for (unsigned int i = 0; i < current->GetChildCount(); ++i)
+                nodeStack.push(current->GetChildByIndex(i));
+        }
+        return bytes;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::free(Shader& shader)
+    {
+        glDeleteProgram(shader.ID);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::free(Texture& texture)
+    {
+        glDeleteTextures(1, &texture.ID);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::free(TextureCube& texture)
+    {
+        glDeleteTextures(1, &texture.ID);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::free(SceneNode* node)
+    {
+        MeshLoader::Free(node);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Resources::evict(RESOURCE_TYPE type)
+    {
+        switch (type)
+        {
+        case RESOURCE_SHADER:       m_Shaders.Evict([](Shader& shader) { free(shader); });                break;
+        case RESOURCE_TEXTURE:      m_Textures.Evict([](Texture& texture) { free(texture); });            break;
+        case RESOURCE_TEXTURE_CUBE: m_TexturesCube.Evict([](TextureCube& texture) { free(texture); });    break;
+        case RESOURCE_MESH:         m_Meshes.Evict([](SceneNode*& node) { free(node); });                 break;
+        }
+    }
+}
@@ -1,8 +1,8 @@
 #ifndef CELL_RESOURCES_RESOURCES
 #define CELL_RESOURCES_RESOURCES
 
-//class ShaderLoader;  class Shader; 
-//class TextureLoader; class Texture; 
+//class ShaderLoader;  class Shader;
+//class TextureLoader; class Texture;
 //class MeshLoader;    class Mesh
 #include "../shading/shader.h"
 #include "../shading/material.h"
@@ -10,7 +10,12 @@
 #include "../shading/texture_cube.h"
 #include "../mesh/mesh.h"
 
-#include <map>
+#include "resource_handle.h"
+#include "resource_pool.h"
+
+#include <utility/string_id.h>
+#include <utility/threading/thread_pool.h>
+
 #include <string>
 
 namespace Cell
@@ -18,42 +23,131 @@ namespace Cell
     class SceneNode;
     class Renderer;
 
-    /* 
+    /*
+
+      The types of resources managed by Resources; used for memory accounting.
+
+    */
+    enum RESOURCE_TYPE
+    {
+        RESOURCE_SHADER,
+        RESOURCE_TEXTURE,
+        RESOURCE_TEXTURE_CUBE,
+        RESOURCE_MESH,
+    };
+
+    /*
+
+      Global resource manager. Manages and maintains all resource memory used throughout the
+      rendering application. New resources are loaded from here, and duplicate resource loads
+      are prevented. Every resource is referenced by a hashed string ID; resources can be
+      retrieved either by name or directly by ID (e.g. GetShader("pbr"_sid)), the latter of
+      which skips hashing at run-time altogether.
 
-      Global resource manager. Manages and maintains all resource memory used throughout the 
-      rendering application. New resources are loaded from here, and duplicate resource loads 
-      are prevented. Every resource is referenced by a hashed string ID.
+      Resources can be accessed in two ways:
+
+        - by raw pointer (Load* by name): the resource stays loaded for the lifetime of the
+          application, as we can't know when the pointer is no longer in use. Get* by name or
+          ID is a plain lookup that doesn't change a resource's lifetime: its pointer stays
+          valid for as long as the resource is loaded through Load* or referenced by a handle.
+        - by reference counted handle (Acquire*): each Acquire/Retain has to be matched by a
+          Release. Unreferenced resources stay cached, but are unloaded (least recently used
+          first) whenever the memory budget of their resource type is exceeded. Get*(handle)
+          resolves a handle and detects handles to already unloaded resources.
 
     */
     class Resources
     {
     private:
-        // we index all resources w/ a hashed string ID
-        static std::map<unsigned int, Shader>      m_Shaders;
-        static std::map<unsigned int, Texture>     m_Textures;
-        static std::map<unsigned int, TextureCube> m_TexturesCube;
-        static std::map<unsigned int, SceneNode*>  m_Meshes;
+        // we index all resources w/ a hashed string ID; the resource pools keep each resource at
+        // a fixed address, s.t. returned resource pointers stay valid as new resources get added.
+        static ResourcePool<Shader>                m_Shaders;
+        static ResourcePool<Texture>               m_Textures;
+        static ResourcePool<TextureCube>           m_TexturesCube;
+        static ResourcePool<SceneNode*, SceneNode> m_Meshes;
+        // 1x1 white texture shown by asynchronously loaded textures until they're uploaded
+        static Texture m_Placeholder;
+        // worker threads shared by all (CPU-side) resource loading
+        static ThreadPool* m_ThreadPool;
     public:
 
     private:
         // disallow creation of any Resources object; it's defined as a static object
-        Resources(); 
+        Resources();
     public:
         static void Init();
         static void Clean();
 
+        // the worker pool for resource loading; nullptr before Init.
+        static ThreadPool* GetThreadPool();
+
         // shader resources
         static Shader*      LoadShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines = std::vector<std::string>());
+        static Shader*      LoadGeometryShader(std::string name, std::string vsPath, std::string gsPath, std::string fsPath, std::vector<std::string> defines = std::vector<std::string>());
+        static Shader*      LoadComputeShader(std::string name, std::string csPath, std::vector<std::string> defines = std::vector<std::string>());
         static Shader*      GetShader(std::string name);
+        static Shader*      GetShader(StringID id);
         // texture resources
         static Texture*     LoadTexture(std::string name, std::string path, GLenum target = GL_TEXTURE_2D, GLenum format = GL_RGBA, bool srgb = false);
         static Texture*     LoadHDR(std::string name, std::string path);
         static TextureCube* LoadTextureCube(std::string name, std::string folder);
         static Texture*     GetTexture(std::string name);
+        static Texture*     GetTexture(StringID id);
         static TextureCube* GetTextureCube(std::string name);
+        static TextureCube* GetTextureCube(StringID id);
         // mesh/scene resources
         static SceneNode*  LoadMesh(Renderer* renderer, std::string name, std::string path);
         static SceneNode*  GetMesh(std::string name);
+        static SceneNode*  GetMesh(StringID id);
+
+        // reference counted resources; each acquire increases the resource's reference count.
+        static ShaderHandle      AcquireShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines = std::vector<std::string>());
+        static TextureHandle     AcquireTexture(std::string name, std::string path, GLenum target = GL_TEXTURE_2D, GLenum format = GL_RGBA, bool srgb = false);
+        static TextureHandle     AcquireHDR(std::string name, std::string path);
+        static TextureCubeHandle AcquireTextureCube(std::string name, std::string folder);
+        static MeshHandle        AcquireMesh(Renderer* renderer, std::string name, std::string path);
+        // returns (an acquired handle to) the texture immediately; the texture shows placeholder
+        // (or a plain white texture) until the texture is loaded in the background (see
+        // TextureStreamer). Only 2D textures are loaded asynchronously.
+        static TextureHandle     LoadTextureAsync(std::string name, std::string path, GLenum target = GL_TEXTURE_2D, GLenum format = GL_RGBA, bool srgb = false, Texture* placeholder = nullptr);
+        static Shader*           GetShader(ShaderHandle handle);
+        static Texture*          GetTexture(TextureHandle handle);
+        static TextureCube*      GetTextureCube(TextureCubeHandle handle);
+        // NOTE(Joey): returns a copy of the mesh's scene hierarchy (see LoadMesh); the copy
+        // shares the mesh's GPU data, so keep the handle acquired for as long as it's in use.
+        static SceneNode*        GetMesh(MeshHandle handle);
+        static void Retain(ShaderHandle handle);
+        static void Retain(TextureHandle handle);
+        static void Retain(TextureCubeHandle handle);
+        static void Retain(MeshHandle handle);
+        static void Release(ShaderHandle handle);
+        static void Release(TextureHandle handle);
+        static void Release(TextureCubeHandle handle);
+        static void Release(MeshHandle handle);
+
+        // memory accounting/budget (in bytes) per resource type; a budget of 0 is unlimited.
+        static void         SetMemoryBudget(RESOURCE_TYPE type, size_t bytes);
+        static size_t       GetMemoryBudget(RESOURCE_TYPE type);
+        static size_t       GetMemoryUsage(RESOURCE_TYPE type);
+        static unsigned int GetResourceCount(RESOURCE_TYPE type);
+    private:
+        // load (or find the already loaded) resource without touching its reference count
+        static ResourcePool<Shader>::Entry*                loadShader(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines);
+        static ResourcePool<Texture>::Entry*               loadTexture(std::string name, std::string path, GLenum target, GLenum format, bool srgb);
+        static ResourcePool<Texture>::Entry*               loadHDR(std::string name, std::string path);
+        static ResourcePool<TextureCube>::Entry*           loadTextureCube(std::string name, std::string folder);
+        static ResourcePool<SceneNode*, SceneNode>::Entry* loadMesh(Renderer* renderer, std::string name, std::string path);
+        // estimated GPU memory footprint of each resource type
+        static size_t memoryUsage(Texture& texture);
+        static size_t memoryUsage(TextureCube& texture);
+        static size_t memoryUsage(SceneNode* node);
+        // release the GPU memory of each resource type
+        static void free(Shader& shader);
+        static void free(Texture& texture);
+        static void free(TextureCube& texture);
+        static void free(SceneNode* node);
+        // unloads unreferenced resources of the given type while over budget
+        static void evict(RESOURCE_TYPE type);
     };
 }
-#endif 
\ No newline at end of file
+#endif
@@ -33,6 +33,44 @@ namespace Cell
         return shader;
     }
     // --------------------------------------------------------------------------------------------
+    Shader ShaderLoader::LoadGeometry(std::string name, std::string vsPath, std::string gsPath, std::string fsPath, std::vector<std::string> defines)
+    {
+        std::ifstream vsFile, gsFile, fsFile;
+        vsFile.open(vsPath);
+        gsFile.open(gsPath);
+        fsFile.open(fsPath);
+        if (!vsFile.is_open() || !gsFile.is_open() || !fsFile.is_open())
+        {
+            Log::Message("Shader failed to load at path: " + vsPath + ", " + gsPath + " and " + fsPath, LOG_ERROR);
+            return Shader();
+        }
+
+        Shader shader;
+        shader.LoadGeometry(name, readShader(vsFile, name, vsPath), readShader(gsFile, name, gsPath), readShader(fsFile, name, fsPath), defines);
+        vsFile.close();
+        gsFile.close();
+        fsFile.close();
+
+        return shader;
+    }
+    // --------------------------------------------------------------------------------------------
+    Shader ShaderLoader::LoadCompute(std::string name, std::string csPath, std::vector<std::string> defines)
+    {
+        std::ifstream csFile;
+        csFile.open(csPath);
+        if (!csFile.is_open())
+        {
+            Log::Message("Compute shader failed to load at path: " + csPath, LOG_ERROR);
+            return Shader();
+        }
+
+        Shader shader;
+        shader.LoadCompute(name, readShader(csFile, name, csPath), defines);
+        csFile.close();
+
+        return shader;
+    }
+    // --------------------------------------------------------------------------------------------
     std::string ShaderLoader::readShader(std::ifstream& file, const std::string& name, std::string path)
     {
         std::string directory = path.substr(0, path.find_last_of("/\\"));
@@ -18,6 +18,8 @@ namespace Cell
     {
     public:
         static Shader Load(std::string name, std::string vsPath, std::string fsPath, std::vector<std::string> defines = std::vector<std::string>());
+        static Shader LoadGeometry(std::string name, std::string vsPath, std::string gsPath, std::string fsPath, std::vector<std::string> defines = std::vector<std::string>());
+        static Shader LoadCompute(std::string name, std::string csPath, std::vector<std::string> defines = std::vector<std::string>());
     private:
         static std::string readShader(std::ifstream& file, const std::string& name, std::string path);
     };
@@ -9,46 +9,81 @@
 
 namespace Cell
 {
+    // --------------------------------------------------------------------------------------------
+    bool TextureLoader::DecodeTexture(std::string path, TextureData& data, bool hdr, bool flip)
+    {
+        // NOTE(Joey): the flip state is thread local (see stb_image.h), s.t. decoding on worker
+        // threads doesn't interfere w/ textures loaded at the same time on other threads.
+        stbi_set_flip_vertically_on_load(flip);
+
+        int width, height, nrComponents;
+        if (hdr)
+        {
+            if (!stbi_is_hdr(path.c_str()))
+                return false;
+            data.Pixels = stbi_loadf(path.c_str(), &width, &height, &nrComponents, 0);
+            data.Type   = GL_FLOAT;
+        }
+        else
+        {
+            data.Pixels = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
+            data.Type   = GL_UNSIGNED_BYTE;
+        }
+        if (!data.Pixels)
+            return false;
+
+        data.Width      = width;
+        data.Height     = height;
+        data.Components = nrComponents;
+        if (nrComponents == 1)
+            data.Format = GL_RED;
+        else if (nrComponents == 2)
+            data.Format = GL_RG;
+        else if (nrComponents == 3)
+            data.Format = GL_RGB;
+        else
+            data.Format = GL_RGBA;
+        return true;
+    }
+    // --------------------------------------------------------------------------------------------
+    void TextureLoader::FreeTextureData(TextureData& data)
+    {
+        stbi_image_free(data.Pixels);
+        data.Pixels = nullptr;
+    }
+    // --------------------------------------------------------------------------------------------
+    GLenum TextureLoader::ResolveInternalFormat(GLenum internalFormat, bool srgb)
+    {
+        if (internalFormat == GL_RGB || internalFormat == GL_SRGB)
+            return srgb ? GL_SRGB : GL_RGB;
+        if (internalFormat == GL_RGBA || internalFormat == GL_SRGB_ALPHA)
+            return srgb ? GL_SRGB_ALPHA : GL_RGBA;
+        return internalFormat;
+    }
     // --------------------------------------------------------------------------------------------
     Texture TextureLoader::LoadTexture(std::string path, GLenum target, GLenum internalFormat, bool srgb)
     {
         Texture texture;
         texture.Target = target;
-        texture.InternalFormat = internalFormat;
-        if(texture.InternalFormat == GL_RGB || texture.InternalFormat == GL_SRGB)
-            texture.InternalFormat = srgb ? GL_SRGB : GL_RGB;
-        if (texture.InternalFormat == GL_RGBA || texture.InternalFormat == GL_SRGB_ALPHA)
-            texture.InternalFormat = srgb ? GL_SRGB_ALPHA : GL_RGBA;
+        texture.InternalFormat = ResolveInternalFormat(internalFormat, srgb);
 
         // flip textures on their y coordinate while loading
-        stbi_set_flip_vertically_on_load(true);
-
-        int width, height, nrComponents;
-        unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
-        if (data)
+        TextureData data;
+        if (DecodeTexture(path, data))
         {
-            GLenum format;
-            if(nrComponents == 1)
-                format = GL_RED;
-            else if (nrComponents == 3)
-                format = GL_RGB;
-            else if (nrComponents == 4)
-                format = GL_RGBA;
-
             if(target == GL_TEXTURE_1D)
-                texture.Generate(width, texture.InternalFormat, format, GL_UNSIGNED_BYTE, data);
+                texture.Generate(data.Width, texture.InternalFormat, data.Format, data.Type, data.Pixels);
             else if (target == GL_TEXTURE_2D)
-                texture.Generate(width, height, texture.InternalFormat, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
+                texture.Generate(data.Width, data.Height, texture.InternalFormat, data.Format, data.Type, data.Pixels);
+            FreeTextureData(data);
         }
         else
         {
             Log::Message("Texture failed to load at path: " + path, LOG_WARNING);
-            stbi_image_free(data);
             return texture;
         }
-        texture.Width = width;
-        texture.Height = height;
+        texture.Width = data.Width;
+        texture.Height = data.Height;
 
         return texture;
     }
@@ -60,31 +95,14 @@ namespace Cell
 		texture.FilterMin = GL_LINEAR;
 		texture.Mipmapping = false; 
 
-        stbi_set_flip_vertically_on_load(true);
-
-        if (stbi_is_hdr(path.c_str()))
+        TextureData data;
+        if (DecodeTexture(path, data, true))
         {
-            int width, height, nrComponents;
-            float *data = stbi_loadf(path.c_str(), &width, &height, &nrComponents, 0);
-            if (data)
-            {
-                GLenum internalFormat, format;
-                if (nrComponents == 3)
-                {
-                    internalFormat = GL_RGB32F;
-                    format = GL_RGB;
-                }
-                else if (nrComponents == 4)
-                {
-                    internalFormat = GL_RGBA32F;
-                    format = GL_RGBA;
-                }
-
-                texture.Generate(width, height, internalFormat, format, GL_FLOAT, data);
-                stbi_image_free(data);
-            }
-            texture.Width = width;
-            texture.Height = height;
+            GLenum internalFormat = data.Components == 4 ? GL_RGBA32F : GL_RGB32F;
+            texture.Generate(data.Width, data.Height, internalFormat, data.Format, data.Type, data.Pixels);
+            FreeTextureData(data);
+            texture.Width = data.Width;
+            texture.Height = data.Height;
         }
         else
         {
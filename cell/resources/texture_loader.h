@@ -11,6 +11,24 @@ namespace Cell
     class Texture;
     class TextureCube;
 
+    /*
+
+      Decoded (CPU-side) image data, as produced by TextureLoader::DecodeTexture. Owns its pixel
+      memory until released w/ TextureLoader::FreeTextureData.
+
+    */
+    struct TextureData
+    {
+        unsigned int Width      = 0;
+        unsigned int Height     = 0;
+        unsigned int Components = 0;
+        GLenum       Format     = GL_RGBA;
+        GLenum       Type       = GL_UNSIGNED_BYTE;
+        void*        Pixels     = nullptr;
+
+        size_t Size() const { return (size_t)Width * Height * Components * (Type == GL_FLOAT ? sizeof(float) : 1); }
+    };
+
     /* 
 
       Manages all custom logic for loading a variety of different texture files.
@@ -19,6 +37,12 @@ namespace Cell
     class TextureLoader
     {
     public:
+        // decodes an image file to memory w/o touching the GPU; safe to call from any thread.
+        static bool DecodeTexture(std::string path, TextureData& data, bool hdr = false, bool flip = true);
+        static void FreeTextureData(TextureData& data);
+        // returns the (sRGB or linear) internal format a texture of the given format is stored in
+        static GLenum ResolveInternalFormat(GLenum internalFormat, bool srgb);
+
         static Texture LoadTexture(std::string path, GLenum target, GLenum internalFormat, bool srgb = false);
         static Texture LoadHDRTexture(std::string path);
         // TODO(Joey): read and copy original cubemap order from GL specification
@@ -0,0 +1,158 @@
+#include "texture_streamer.h"
+
+#include "../shading/texture.h"
+
+#include <utility/logging/log.h>
+
+#include <string.h>
+
+namespace Cell
+{
+    ThreadPool*                           TextureStreamer::m_Workers = nullptr;
+    std::mutex                            TextureStreamer::m_Mutex;
+    std::deque<TextureStreamer::Job>      TextureStreamer::m_Decoded;
+    unsigned int                          TextureStreamer::m_Pending = 0;
+    unsigned int                          TextureStreamer::m_PBOs[TextureStreamer::PBO_COUNT];
+    unsigned int                          TextureStreamer::m_PBOIndex = 0;
+    unsigned int                          TextureStreamer::m_BatchCount = 0;
+    size_t                                TextureStreamer::m_BatchBytes = 0;
+    std::chrono::steady_clock::time_point TextureStreamer::m_BatchStart;
+    // --------------------------------------------------------------------------------------------
+    void TextureStreamer::Init(ThreadPool* workers)
+    {
+        m_Workers = workers;
+        glGenBuffers(PBO_COUNT, m_PBOs);
+    }
+    // --------------------------------------------------------------------------------------------
+    void TextureStreamer::Clean()
+    {
+        // NOTE(Joey): the worker pool is already shut down at this point, so no more decoded jobs
+        // can come in; release whatever didn't get uploaded.
+        m_Workers = nullptr;
+        for (unsigned int i = 0; i < m_Decoded.size(); ++i)
+            TextureLoader::FreeTextureData(m_Decoded[i].Data);
+        m_Decoded.clear();
+        m_Pending = 0;
+
+        glDeleteBuffers(PBO_COUNT, m_PBOs);
+    }
+    // --------------------------------------------------------------------------------------------
+    void TextureStreamer::Load(Texture* texture, std::string path, bool hdr, Callback onLoaded)
+    {
+        if (m_Pending == 0)
+        {
+            m_BatchCount = 0;
+            m_BatchBytes = 0;
+            m_BatchStart = std::chrono::steady_clock::now();
+        }
+        ++m_Pending;
+
+        m_Workers->Submit([texture, path, hdr, onLoaded]()
+        {
+            Job job;
+            job.Target   = texture;
+            job.Path     = path;
+            job.HDR      = hdr;
+            job.OnLoaded = onLoaded;
+            job.Success  = TextureLoader::DecodeTexture(path, job.Data, hdr);
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Decoded.push_back(std::move(job));
+        });
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int TextureStreamer::Update(size_t maxBytes)
+    {
+        unsigned int uploaded = 0;
+        size_t       bytes    = 0;
+        while (true)
+        {
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (m_Decoded.empty())
+                    break;
+                // always upload at least one texture, regardless of its size, to guarantee
+                // progress; otherwise stop once the frame's upload budget is spent.
+                size_t size = m_Decoded.front().Data.Size();
+                if (uploaded > 0 && bytes + size > maxBytes)
+                    break;
+                job = std::move(m_Decoded.front());
+                m_Decoded.pop_front();
+            }
+
+            upload(job);
+            bytes += job.Data.Size();
+            ++uploaded;
+            --m_Pending;
+
+            if (job.OnLoaded)
+                job.OnLoaded(job.Target, job.Success);
+            TextureLoader::FreeTextureData(job.Data);
+        }
+
+        m_BatchCount += uploaded;
+        m_BatchBytes += bytes;
+        if (uploaded > 0 && m_Pending == 0)
+        {
+            float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_BatchStart).count();
+            Log::Message("Streamed " + std::to_string(m_BatchCount) + " textures (" + std::to_string(m_BatchBytes / (1024 * 1024)) + " MB) in " + std::to_string(ms) + " ms.", LOG_INIT);
+        }
+        return uploaded;
+    }
+    // --------------------------------------------------------------------------------------------
+    void TextureStreamer::Flush()
+    {
+        m_Workers->Wait();
+        Update((size_t)-1);
+    }
+    // --------------------------------------------------------------------------------------------
+    unsigned int TextureStreamer::GetPendingCount()
+    {
+        return m_Pending;
+    }
+    // --------------------------------------------------------------------------------------------
+    void TextureStreamer::upload(Job& job)
+    {
+        if (!job.Success)
+        {
+            Log::Message("Texture failed to load at path: " + job.Path, LOG_WARNING);
+            return;
+        }
+
+        Texture* texture = job.Target;
+        TextureData& data = job.Data;
+        size_t size = data.Size();
+
+        GLenum internalFormat = texture->InternalFormat;
+        if (job.HDR)
+            internalFormat = data.Components == 4 ? GL_RGBA32F : GL_RGB32F;
+
+        // NOTE(Joey): copy the pixels into a pixel buffer object and source the texture from
+        // there; the driver can then transfer the texture data asynchronously instead of
+        // stalling on a copy from client memory. We cycle through a few PBOs and orphan their
+        // storage before mapping, s.t. we never wait on a previous upload still in flight.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PBOs[m_PBOIndex]);
+        m_PBOIndex = (m_PBOIndex + 1) % PBO_COUNT;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        void* source = nullptr; // offset into the bound PBO
+        if (mapped)
+        {
+            memcpy(mapped, data.Pixels, size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            source = data.Pixels;
+        }
+
+        // rows of 1 and 3 component textures aren't necessarily 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        texture->Generate(data.Width, data.Height, internalFormat, data.Format, data.Type, source);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CELL_RESOURCES_TEXTURE_STREAMER_H
+#define CELL_RESOURCES_TEXTURE_STREAMER_H
+
+#include "texture_loader.h"
+
+#include <utility/threading/thread_pool.h>
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+namespace Cell
+{
+    class Texture;
+
+    /*
+
+      Asynchronous texture loading. Image files are decoded on a pool of worker threads, after
+      which the decoded pixel data is queued for upload. As only the render thread owns the GL
+      context, uploads happen from Update (called once per frame) through a small ring of pixel
+      buffer objects; the amount of texture data uploaded per frame is bounded s.t. streaming
+      in a large set of textures doesn't cause frame spikes.
+
+      The requested texture object is generated in-place once uploaded, s.t. all materials that
+      reference the texture automatically switch from their placeholder to the actual texture.
+
+    */
+    class TextureStreamer
+    {
+    public:
+        // invoked on the render thread once a texture is uploaded, or failed to load.
+        typedef std::function<void(Texture* texture, bool success)> Callback;
+
+        static const size_t UPLOAD_BUDGET = 16 * 1024 * 1024; // default per-frame upload limit (bytes)
+    private:
+        struct Job
+        {
+            Texture*    Target;
+            std::string Path;
+            bool        HDR;
+            bool        Success;
+            TextureData Data;
+            Callback    OnLoaded;
+        };
+        static const unsigned int PBO_COUNT = 3;
+
+        static ThreadPool*     m_Workers;
+        static std::mutex      m_Mutex;
+        static std::deque<Job> m_Decoded; // decoded by a worker; waiting for upload
+        static unsigned int    m_Pending; // requested, but not yet uploaded
+
+        static unsigned int m_PBOs[PBO_COUNT];
+        static unsigned int m_PBOIndex;
+
+        // statistics of the current batch of streamed textures
+        static unsigned int                          m_BatchCount;
+        static size_t                                m_BatchBytes;
+        static std::chrono::steady_clock::time_point m_BatchStart;
+
+    private:
+        // disallow creation of any TextureStreamer object; it's defined as a static object
+        TextureStreamer();
+    public:
+        // decodes on the given worker pool (see Resources::GetThreadPool); the pool is expected
+        // to be shut down (finishing all its jobs) before calling Clean.
+        static void Init(ThreadPool* workers);
+        static void Clean();
+
+        // queues the image file at path for loading into texture; texture's target, internal
+        // format and sampler state are expected to be configured before requesting the load.
+        static void Load(Texture* texture, std::string path, bool hdr = false, Callback onLoaded = nullptr);
+
+        // uploads decoded textures until maxBytes is reached (at least one texture is uploaded
+        // per call); returns the number of uploaded textures. Render thread only.
+        static unsigned int Update(size_t maxBytes = UPLOAD_BUDGET);
+        // blocks until all requested textures are decoded and uploaded.
+        static void Flush();
+
+        static unsigned int GetPendingCount();
+
+    private:
+        static void upload(Job& job);
+    };
+}
+#endif
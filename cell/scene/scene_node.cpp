@@ -82,6 +82,11 @@ namespace Cell
         return scale;
     }
     // --------------------------------------------------------------------------------------------
+    unsigned int SceneNode::GetTransformVersion()
+    {
+        return m_TransformVersion;
+    }
+    // --------------------------------------------------------------------------------------------
     unsigned int SceneNode::GetID()
     {
         return m_ID;
@@ -169,6 +174,7 @@ namespace Cell
             {
                 m_Transform = m_Parent->m_Transform * m_Transform;
             }        
+            ++m_TransformVersion;
         }
         for (int i = 0; i < m_Children.size(); ++i)
         {
@@ -34,6 +34,10 @@ namespace Cell
         // bounding box 
         math::vec3 BoxMin = math::vec3(-99999.0f);
         math::vec3 BoxMax = math::vec3( 99999.0f);
+
+        // level of detail the renderer selected for this node's mesh last; kept s.t. the LOD
+        // selection can apply hysteresis.
+        unsigned int Lod = 0;
     private:
         std::vector<SceneNode*> m_Children;
         SceneNode *m_Parent;
@@ -47,6 +51,9 @@ namespace Cell
 
         // mark the current node's tranform as dirty if it needs to be re-calculated this frame
         bool m_Dirty;
+        // incremented each time the transform is re-calculated, s.t. data derived from it
+        // elsewhere (e.g. baked irradiance probes) can tell the node moved since.
+        unsigned int m_TransformVersion = 0;
 
         // each node is uniquely identified by a 32-bit incrementing unsigned integer
         unsigned int m_ID;
@@ -66,6 +73,7 @@ namespace Cell
         math::vec3 GetLocalScale();
         math::vec3 GetWorldPosition();
         math::vec3 GetWorldScale();
+        unsigned int GetTransformVersion();
 
         // scene graph 
         unsigned int GetID();
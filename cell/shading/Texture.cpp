@@ -103,6 +103,9 @@ namespace Cell
             assert(height > 0 && depth > 0);
             glTexImage3D(GL_TEXTURE_3D, 0, InternalFormat, width, height, depth, 0, Format, Type, 0);
         }
+        Width  = width;
+        Height = height;
+        Depth  = depth;
     }
     // --------------------------------------------------------------------------------------------
     void Texture::Bind(int unit)
@@ -20,91 +20,107 @@ namespace Cell
         Load(name, vsCode, fsCode, defines);
     }
     // --------------------------------------------------------------------------------------------
-    void Shader::Load(std::string name, std::string vsCode, std::string fsCode, std::vector<std::string> defines)
+    // compiles a single shader stage; if a list of define statements is specified, these are
+    // added to the start of the shader source s.t. we can selectively compile different shaders
+    // based on the defines we set.
+    static unsigned int compileStage(GLenum type, std::string code, const std::vector<std::string>& defines, const std::string& name, const std::string& stageName)
     {
-        Name = name;
-        // compile both shaders and link them
-        unsigned int vs = glCreateShader(GL_VERTEX_SHADER);
-        unsigned int fs = glCreateShader(GL_FRAGMENT_SHADER);
-        ID = glCreateProgram();
-        int status;
-        char log[1024];
-
-        // if a list of define statements is specified, add these  to the start of the shader 
-        // source, s.t. we can selectively compile different shaders based on the defines we set.
+        unsigned int shader = glCreateShader(type);
         if (defines.size() > 0)
         {
-            std::vector<std::string> vsMergedCode;
-            std::vector<std::string> fsMergedCode;
+            std::vector<std::string> mergedCode;
             // first determine if the user supplied a #version  directive at the top of the shader 
             // code, in which case we  extract it and add it 'before' the list of define code.
             // the GLSL version specifier is only valid as the first line of the GLSL code; 
             // otherwise the GLSL version defaults to 1.1.
-            std::string firstLine = vsCode.substr(0, vsCode.find("\n"));
+            std::string firstLine = code.substr(0, code.find("\n"));
             if (firstLine.find("#version") != std::string::npos)
             {
                 // strip shader code of first line and add to list of shader code strings.
-                vsCode = vsCode.substr(vsCode.find("\n") + 1, vsCode.length() - 1);
-                vsMergedCode.push_back(firstLine + "\n");
-            }
-            firstLine = fsCode.substr(0, fsCode.find("\n"));
-            if (firstLine.find("#version") != std::string::npos)
-            {
-                // strip shader code of first line and add to list of shader code strings.
-                fsCode = fsCode.substr(fsCode.find("\n") + 1, fsCode.length() - 1);
-                fsMergedCode.push_back(firstLine + "\n");
+                code = code.substr(code.find("\n") + 1, code.length() - 1);
+                mergedCode.push_back(firstLine + "\n");
             }
             // then add define statements to the shader string list.
             for (unsigned int i = 0; i < defines.size(); ++i)
-            {
-                std::string define = "#define " + defines[i] + "\n";
-                vsMergedCode.push_back(define);
-                fsMergedCode.push_back(define);
-            }
+                mergedCode.push_back("#define " + defines[i] + "\n");
             // then addremaining shader code to merged result and pass result to glShaderSource.
-            vsMergedCode.push_back(vsCode);
-            fsMergedCode.push_back(fsCode);
+            mergedCode.push_back(code);
             // note that we manually build an array of C style  strings as glShaderSource doesn't 
             // expect it in any other format.
             // all strings are null-terminated so pass NULL as glShaderSource's final argument.
-            const char **vsStringsC = new const char*[vsMergedCode.size()];
-            const char **fsStringsC = new const char*[fsMergedCode.size()];
-            for (unsigned int i = 0; i < vsMergedCode.size(); ++i)
-                vsStringsC[i] = vsMergedCode[i].c_str();
-            for (unsigned int i = 0; i < fsMergedCode.size(); ++i)
-                fsStringsC[i] = fsMergedCode[i].c_str();
-            glShaderSource(vs, vsMergedCode.size(), vsStringsC, NULL);
-            glShaderSource(fs, fsMergedCode.size(), fsStringsC, NULL);
-            delete[] vsStringsC;
-            delete[] fsStringsC;
+            std::vector<const char*> stringsC(mergedCode.size());
+            for (unsigned int i = 0; i < mergedCode.size(); ++i)
+                stringsC[i] = mergedCode[i].c_str();
+            glShaderSource(shader, (GLsizei)stringsC.size(), &stringsC[0], NULL);
         }
         else
         {
-            const char *vsSourceC = vsCode.c_str();
-            const char *fsSourceC = fsCode.c_str();
-            glShaderSource(vs, 1, &vsSourceC, NULL);
-            glShaderSource(fs, 1, &fsSourceC, NULL);
+            const char *sourceC = code.c_str();
+            glShaderSource(shader, 1, &sourceC, NULL);
         }
-        glCompileShader(vs);
-        glCompileShader(fs);
+        glCompileShader(shader);
 
-        glGetShaderiv(vs, GL_COMPILE_STATUS, &status);
-        if (!status)
-        {
-            glGetShaderInfoLog(vs, 1024, NULL, log);
-            Log::Message("Vertex shader compilation error at: " + name + "!\n" + std::string(log), LOG_ERROR);
-        }
-        glGetShaderiv(fs, GL_COMPILE_STATUS, &status);
+        int status;
+        char log[1024];
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
         if (!status)
         {
-            glGetShaderInfoLog(fs, 1024, NULL, log);
-            Log::Message("Fragment shader compilation error at: " + name + "!\n" + std::string(log), LOG_ERROR);
+            glGetShaderInfoLog(shader, 1024, NULL, log);
+            Log::Message(stageName + " shader compilation error at: " + name + "!\n" + std::string(log), LOG_ERROR);
         }
-
+        return shader;
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::Load(std::string name, std::string vsCode, std::string fsCode, std::vector<std::string> defines)
+    {
+        Name = name;
+        // compile both shaders and link them
+        unsigned int vs = compileStage(GL_VERTEX_SHADER, vsCode, defines, name, "Vertex");
+        unsigned int fs = compileStage(GL_FRAGMENT_SHADER, fsCode, defines, name, "Fragment");
+        ID = glCreateProgram();
+        glAttachShader(ID, vs);
+        glAttachShader(ID, fs);
+        link();
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::LoadGeometry(std::string name, std::string vsCode, std::string gsCode, std::string fsCode, std::vector<std::string> defines)
+    {
+        Name = name;
+        unsigned int vs = compileStage(GL_VERTEX_SHADER, vsCode, defines, name, "Vertex");
+        unsigned int gs = compileStage(GL_GEOMETRY_SHADER, gsCode, defines, name, "Geometry");
+        unsigned int fs = compileStage(GL_FRAGMENT_SHADER, fsCode, defines, name, "Fragment");
+        ID = glCreateProgram();
         glAttachShader(ID, vs);
+        glAttachShader(ID, gs);
         glAttachShader(ID, fs);
+        link();
+        glDeleteShader(vs);
+        glDeleteShader(gs);
+        glDeleteShader(fs);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::LoadCompute(std::string name, std::string csCode, std::vector<std::string> defines)
+    {
+        Name = name;
+        unsigned int cs = compileStage(GL_COMPUTE_SHADER, csCode, defines, name, "Compute");
+        ID = glCreateProgram();
+        glAttachShader(ID, cs);
+        link();
+        glDeleteShader(cs);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ)
+    {
+        glDispatchCompute(groupsX, groupsY, groupsZ);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::link()
+    {
+        int status;
+        char log[1024];
         glLinkProgram(ID);
-
         glGetProgramiv(ID, GL_LINK_STATUS, &status);
         if (!status)
         {
@@ -112,9 +128,6 @@ namespace Cell
             Log::Message("Shader program linking error: \n" + std::string(log), LOG_ERROR);
         }
 
-        glDeleteShader(vs);
-        glDeleteShader(fs);
-
         // query the number of active uniforms and attributes
         int nrAttributes, nrUniforms;
         glGetProgramiv(ID, GL_ACTIVE_ATTRIBUTES, &nrAttributes);
@@ -251,6 +264,27 @@ namespace Cell
             glUniformMatrix4fv(loc, 1, GL_FALSE, &value[0][0]);
     }
     // --------------------------------------------------------------------------------------------
+    void Shader::SetMatrixArray(std::string location, int size, math::mat2* values)
+    {
+        int loc = glGetUniformLocation(ID, location.c_str());
+        if (loc >= 0)
+            glUniformMatrix2fv(loc, size, GL_FALSE, &values[0][0][0]);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::SetMatrixArray(std::string location, int size, math::mat3* values)
+    {
+        int loc = glGetUniformLocation(ID, location.c_str());
+        if (loc >= 0)
+            glUniformMatrix3fv(loc, size, GL_FALSE, &values[0][0][0]);
+    }
+    // --------------------------------------------------------------------------------------------
+    void Shader::SetMatrixArray(std::string location, int size, math::mat4* values)
+    {
+        int loc = glGetUniformLocation(ID, location.c_str());
+        if (loc >= 0)
+            glUniformMatrix4fv(loc, size, GL_FALSE, &values[0][0][0]);
+    }
+    // --------------------------------------------------------------------------------------------
     int Shader::getUniformLocation(std::string name)
     {
         // read from uniform/attribute array as originally obtained from OpenGL
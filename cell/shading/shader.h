@@ -32,8 +32,13 @@ namespace Cell
         Shader(std::string name, std::string vsCode, std::string fsCode, std::vector<std::string> defines = std::vector<std::string>());
 
         void Load(std::string name, std::string vsCode, std::string fsCode, std::vector<std::string> defines = std::vector<std::string>());
+        // w/ a geometry shader stage in between the vertex and fragment stage
+        void LoadGeometry(std::string name, std::string vsCode, std::string gsCode, std::string fsCode, std::vector<std::string> defines = std::vector<std::string>());
+        // compute shaders are a program of their own; they're run w/ Dispatch after Use.
+        void LoadCompute(std::string name, std::string csCode, std::vector<std::string> defines = std::vector<std::string>());
 
         void Use();
+        void Dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1);
 
         bool HasUniform(std::string name);
 
@@ -53,6 +58,8 @@ namespace Cell
         void SetMatrixArray(std::string location, int size, math::mat3* values);
         void SetMatrixArray(std::string location, int size, math::mat4* values);
     private:
+        // links the program's attached shaders and extracts its attributes and uniforms.
+        void link();
         // retrieves uniform location from pre-stored uniform locations and reports an error if a 
         // non-uniform is set.
         int getUniformLocation(std::string name);
@@ -928,7 +928,15 @@ static float   *stbi__ldr_to_hdr(stbi_uc *data, int x, int y, int comp);
 static stbi_uc *stbi__hdr_to_ldr(float   *data, int x, int y, int comp);
 #endif
 
-static int stbi__vertically_flip_on_load = 0;
+// NOTE: thread local (as in later stb_image versions) s.t. images can be decoded from multiple
+// threads that each set their own flip state.
+#if defined(__cplusplus)
+static thread_local int stbi__vertically_flip_on_load = 0;
+#elif defined(_MSC_VER)
+static __declspec(thread) int stbi__vertically_flip_on_load = 0;
+#else
+static __thread int stbi__vertically_flip_on_load = 0;
+#endif
 
 STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip)
 {
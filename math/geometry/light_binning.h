@@ -0,0 +1,169 @@
+#ifndef MATH_GEOMETRY_LIGHT_BINNING_H
+#define MATH_GEOMETRY_LIGHT_BINNING_H
+
+#include <algorithm>
+#include <vector>
+
+#include "../linear_algebra/vector.h"
+#include "../linear_algebra/matrix.h"
+
+namespace math
+{
+    /* NOTE(Joey):
+
+      Binning of (spherical) lights into the screen tiles of tiled deferred lighting. The
+      screen is divided in tiles of tileSize x tileSize pixels; each tile gets the list of
+      lights that may affect any of its pixels.
+
+      A light's screen footprint is the range of tiles covered by the projection of its view
+      space bounding box, together w/ the range of view depths (distance along -z) its sphere
+      spans. A tile's lights are those whose tile range contains the tile and whose depth range
+      overlaps the tile's depth bounds (the min/max view depth of the tile's geometry): the
+      depth test rejects the lights in front of or behind all of a tile's surfaces, which the
+      screen-space test alone can't. Tiles w/o geometry have empty bounds (min > max).
+
+      The same test runs per tile on the GPU (see tiled_deferred.cs, w/ the footprints from
+      lightBounds); binLights is its CPU reference, s.t. the tile assignment can be tested and
+      benchmarked w/o a GPU. The result is conservative: a light is never missing from a tile
+      w/ a pixel in its sphere.
+
+    */
+    struct light_bounds
+    {
+        int   TileMinX = 0, TileMinY = 0;
+        int   TileMaxX = -1, TileMaxY = -1; // inclusive; empty if min > max
+        float DepthMin = 0.0f, DepthMax = 0.0f;
+
+        bool empty() const { return TileMinX > TileMaxX || TileMinY > TileMaxY; }
+    };
+
+    // the lights of tile (x, y) (w/ index t = y * TilesX + x) are
+    // Indices[Offsets[t]] .. Indices[Offsets[t + 1] - 1], in ascending light order.
+    struct light_tiles
+    {
+        unsigned int TilesX = 0;
+        unsigned int TilesY = 0;
+        std::vector<unsigned int> Offsets;
+        std::vector<unsigned int> Indices;
+
+        unsigned int count(unsigned int x, unsigned int y) const
+        {
+            unsigned int t = y * TilesX + x;
+            return Offsets[t + 1] - Offsets[t];
+        }
+        const unsigned int* lights(unsigned int x, unsigned int y) const
+        {
+            return Indices.data() + Offsets[y * TilesX + x];
+        }
+    };
+
+    inline unsigned int tileCount(unsigned int pixels, unsigned int tileSize)
+    {
+        return (pixels + tileSize - 1) / tileSize;
+    }
+
+    // NOTE(Joey): the screen footprint of a light w/ a view space center and radius under
+    // projection (perspective or orthographic) on a width x height screen. Lights entirely
+    // behind the near plane are empty; lights crossing it cover the whole screen, as their
+    // projection is unbounded.
+    inline light_bounds lightBounds(const vec3& center, float radius, const mat4& projection, unsigned int width, unsigned int height,
+                                    unsigned int tileSize, float near)
+    {
+        light_bounds bounds;
+        bounds.DepthMin = -center.z - radius;
+        bounds.DepthMax = -center.z + radius;
+        if (bounds.DepthMax < near)
+            return bounds;
+
+        const int tilesX = (int)tileCount(width, tileSize);
+        const int tilesY = (int)tileCount(height, tileSize);
+        vec2 ndcMin(-1.0f), ndcMax(1.0f);
+        if (bounds.DepthMin >= near)
+        {
+            // the projected corners of the view space box around the sphere
+            ndcMin = vec2( 1e30f);
+            ndcMax = vec2(-1e30f);
+            for (int i = 0; i < 8; ++i)
+            {
+                float x = center.x + (i & 1 ? radius : -radius);
+                float y = center.y + (i & 2 ? radius : -radius);
+                float z = center.z + (i & 4 ? radius : -radius);
+                // column-major: e[col][row]
+                const auto& e = projection.e;
+                float clipX = e[0][0] * x + e[1][0] * y + e[2][0] * z + e[3][0];
+                float clipY = e[0][1] * x + e[1][1] * y + e[2][1] * z + e[3][1];
+                float clipW = e[0][3] * x + e[1][3] * y + e[2][3] * z + e[3][3];
+                vec2 ndc(clipX / clipW, clipY / clipW);
+                ndcMin.x = std::min(ndcMin.x, ndc.x); ndcMax.x = std::max(ndcMax.x, ndc.x);
+                ndcMin.y = std::min(ndcMin.y, ndc.y); ndcMax.y = std::max(ndcMax.y, ndc.y);
+            }
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                return bounds;
+        }
+
+        // to pixels, then (clamped) tiles
+        auto tile = [&](float ndc, unsigned int pixels, int tiles)
+        {
+            float pixel = (std::min(std::max(ndc, -1.0f), 1.0f) * 0.5f + 0.5f) * pixels;
+            return std::min((int)(pixel / tileSize), tiles - 1);
+        };
+        bounds.TileMinX = tile(ndcMin.x, width,  tilesX);
+        bounds.TileMaxX = tile(ndcMax.x, width,  tilesX);
+        bounds.TileMinY = tile(ndcMin.y, height, tilesY);
+        bounds.TileMaxY = tile(ndcMax.y, height, tilesY);
+        return bounds;
+    }
+
+    // NOTE(Joey): whether a light belongs to a tile w/ the given depth bounds; identical to the
+    // GPU's test.
+    inline bool lightInTile(const light_bounds& light, int x, int y, float tileDepthMin, float tileDepthMax)
+    {
+        return x >= light.TileMinX && x <= light.TileMaxX && y >= light.TileMinY && y <= light.TileMaxY &&
+               light.DepthMin <= tileDepthMax && light.DepthMax >= tileDepthMin;
+    }
+
+    // NOTE(Joey): bins count lights into a tilesX x tilesY grid w/ per-tile depth bounds
+    // (tileDepthMin/Max hold tilesX * tilesY values each). Each light only visits the tiles of
+    // its footprint: a counting pass sizes the lists, a second pass fills them.
+    inline void binLights(light_tiles& out, const light_bounds* lights, std::size_t count, unsigned int tilesX, unsigned int tilesY,
+                          const float* tileDepthMin, const float* tileDepthMax)
+    {
+        out.TilesX = tilesX;
+        out.TilesY = tilesY;
+        out.Offsets.assign(tilesX * tilesY + 1, 0);
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const light_bounds& light = lights[i];
+                for (int y = std::max(light.TileMinY, 0); y <= std::min(light.TileMaxY, (int)tilesY - 1); ++y)
+                {
+                    for (int x = std::max(light.TileMinX, 0); x <= std::min(light.TileMaxX, (int)tilesX - 1); ++x)
+                    {
+                        unsigned int t = y * tilesX + x;
+                        if (!lightInTile(light, x, y, tileDepthMin[t], tileDepthMax[t]))
+                            continue;
+                        if (pass == 0)
+                            ++out.Offsets[t + 1];
+                        else
+                            out.Indices[out.Offsets[t]++] = (unsigned int)i;
+                    }
+                }
+            }
+            if (pass == 0)
+            {
+                // exclusive prefix sum; the fill pass advances Offsets[t] to the start of t + 1
+                for (unsigned int t = 0; t < tilesX * tilesY; ++t)
+                    out.Offsets[t + 1] += out.Offsets[t];
+                out.Indices.resize(out.Offsets[tilesX * tilesY]);
+            }
+        }
+        // restore the starts shifted by the fill pass
+        for (unsigned int t = tilesX * tilesY; t > 0; --t)
+            out.Offsets[t] = out.Offsets[t - 1];
+        out.Offsets[0] = 0;
+    }
+} // namespace math
+
+#endif
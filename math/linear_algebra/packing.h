@@ -0,0 +1,165 @@
+#ifndef MATH_LINEAR_ALGEBRA_PACKING_H
+#define MATH_LINEAR_ALGEBRA_PACKING_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "vector.h"
+
+namespace math
+{
+    /*
+
+      Encoders/decoders for compact vertex attribute formats. Each pack function rounds to the
+      nearest representable value; the matching unpack function mirrors the conversion the GPU
+      applies when the data is bound as a (normalized) vertex attribute, s.t. the CPU can verify
+      the error of the encoded data.
+
+    */
+
+    // NOTE(Joey): normalized integers (OpenGL 4.2+ conversion rules for signed values, which
+    // all GL 3.3 drivers we care about use as well: -1.0 and 1.0 are both exact).
+    inline int16_t packSnorm16(float v)
+    {
+        v = v < -1.0f ? -1.0f : v > 1.0f ? 1.0f : v;
+        return (int16_t)std::lround(v * 32767.0f);
+    }
+    inline float unpackSnorm16(int16_t v)
+    {
+        float f = v / 32767.0f;
+        return f < -1.0f ? -1.0f : f;
+    }
+    inline uint16_t packUnorm16(float v)
+    {
+        v = v < 0.0f ? 0.0f : v > 1.0f ? 1.0f : v;
+        return (uint16_t)std::lround(v * 65535.0f);
+    }
+    inline float unpackUnorm16(uint16_t v)
+    {
+        return v / 65535.0f;
+    }
+
+    // IEEE 754 half precision float; rounds to nearest even and values beyond the half range
+    // become infinity.
+    inline uint16_t packHalf(float v)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(float));
+        uint32_t sign     = (bits >> 16) & 0x8000;
+        int32_t  exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (((bits >> 23) & 0xFF) == 0xFF) // infinity/NaN
+            return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+        if (exponent >= 31)
+            return (uint16_t)(sign | 0x7C00);
+        if (exponent < -10)
+            return (uint16_t)sign;
+
+        // denormals shift the (now explicit) leading bit into the mantissa
+        uint32_t shift = 13;
+        if (exponent <= 0)
+        {
+            mantissa |= 0x800000;
+            shift += 1 - exponent;
+            exponent = 0;
+        }
+        uint32_t half = (exponent << 10) | (mantissa >> shift);
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            ++half; // may carry into the exponent, which correctly rounds up to the next power (or infinity)
+        return (uint16_t)(sign | half);
+    }
+    inline float unpackHalf(uint16_t v)
+    {
+        uint32_t sign     = (uint32_t)(v & 0x8000) << 16;
+        uint32_t exponent = (v >> 10) & 0x1F;
+        uint32_t mantissa = v & 0x3FF;
+        uint32_t bits;
+        if (exponent == 0)
+        {
+            // zero or denormal: renormalize
+            if (mantissa == 0)
+            {
+                bits = sign;
+            }
+            else
+            {
+                int32_t e = -1;
+                do { ++e; mantissa <<= 1; } while (!(mantissa & 0x400));
+                bits = sign | ((uint32_t)(127 - 15 - e) << 23) | ((mantissa & 0x3FF) << 13);
+            }
+        }
+        else if (exponent == 31)
+        {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else
+        {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+        float f;
+        std::memcpy(&f, &bits, sizeof(float));
+        return f;
+    }
+
+    // NOTE(Joey): octahedral mapping of unit vectors to [-1, 1]^2 (Meyer et al. 2010): project
+    // onto the octahedron |x| + |y| + |z| = 1 and fold the lower hemisphere over the diagonals.
+    inline vector<2, float> octEncode(const vector<3, float>& n)
+    {
+        float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 <= 0.0f)
+            return vector<2, float>(0.0f, 0.0f);
+        float x = n.x / l1;
+        float y = n.y / l1;
+        if (n.z < 0.0f)
+        {
+            float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = fx;
+            y = fy;
+        }
+        return vector<2, float>(x, y);
+    }
+    inline vector<3, float> octDecode(const vector<2, float>& e)
+    {
+        float x = e.x, y = e.y;
+        float z = 1.0f - std::abs(x) - std::abs(y);
+        if (z < 0.0f)
+        {
+            float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = fx;
+            y = fy;
+        }
+        float length = std::sqrt(x * x + y * y + z * z);
+        return vector<3, float>(x / length, y / length, z / length);
+    }
+
+    // packs a normalized (signed) 4 component vector in GL_INT_2_10_10_10_REV order: x in the
+    // lowest 10 bits, w in the highest 2 bits.
+    inline uint32_t packSnorm1010102(const vector<4, float>& v)
+    {
+        auto pack = [](float f, float scale, uint32_t mask) -> uint32_t
+        {
+            f = f < -1.0f ? -1.0f : f > 1.0f ? 1.0f : f;
+            return (uint32_t)(int32_t)std::lround(f * scale) & mask;
+        };
+        return pack(v.x, 511.0f, 0x3FF) | (pack(v.y, 511.0f, 0x3FF) << 10) | (pack(v.z, 511.0f, 0x3FF) << 20) | (pack(v.w, 1.0f, 0x3) << 30);
+    }
+    inline vector<4, float> unpackSnorm1010102(uint32_t v)
+    {
+        auto unpack = [](uint32_t bits, unsigned int width, float scale) -> float
+        {
+            int32_t i = (int32_t)(bits << (32 - width)) >> (32 - width); // sign extend
+            float f = i / scale;
+            return f < -1.0f ? -1.0f : f;
+        };
+        return vector<4, float>(unpack(v & 0x3FF, 10, 511.0f), unpack((v >> 10) & 0x3FF, 10, 511.0f),
+                                unpack((v >> 20) & 0x3FF, 10, 511.0f), unpack(v >> 30, 2, 1.0f));
+    }
+}
+
+#endif
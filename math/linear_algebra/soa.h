@@ -0,0 +1,514 @@
+#ifndef MATH_LINEAR_ALGEBRA_SOA_H
+#define MATH_LINEAR_ALGEBRA_SOA_H
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <assert.h>
+
+#include "vector.h"
+#include "matrix.h"
+#include "packing.h"
+
+// NOTE(Joey): all x64 targets are guaranteed to support SSE2; 32-bit builds fall back to the
+// scalar path unless the compiler tells us otherwise.
+#if defined(_M_X64) || defined(__SSE2__)
+    #define MATH_SOA_SSE
+    #include <emmintrin.h>
+#endif
+
+namespace math
+{
+    /*
+
+      Structure-of-arrays container for large arrays of 3D vectors. Where a std::vector<vec3>
+      stores its data as xyzxyzxyz (array-of-structures), the soa_vec3 stores each component in
+      its own contiguous array (xxx, yyy, zzz). This allows the bulk kernels below to process 4
+      vectors at a time with SIMD instructions, without any shuffling of the data.
+
+      The soa_vec3 is meant as an intermediate format for heavy mesh processing (loading,
+      bounding box generation, transformations etc.); individual element access is supported,
+      but shouldn't be used in hot loops.
+
+    */
+    struct soa_vec3
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+
+        soa_vec3() { }
+        soa_vec3(std::size_t count) { resize(count); }
+
+        std::size_t size() const { return x.size(); }
+
+        void resize(std::size_t count)
+        {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+        }
+
+        vec3 get(std::size_t index) const
+        {
+            assert(index < x.size());
+            return vec3(x[index], y[index], z[index]);
+        }
+
+        void set(std::size_t index, const vec3& v)
+        {
+            assert(index < x.size());
+            x[index] = v.x;
+            y[index] = v.y;
+            z[index] = v.z;
+        }
+    };
+
+    // NOTE(Joey): layout conversion
+    // -----------------------------
+    // NOTE(Joey): copies a strided stream of float components into another strided stream. This
+    // is the generic building block for (de)interleaving vertex data: e.g. copying a tightly
+    // packed std::vector<vec3> (srcStride 3) into an interleaved vertex buffer (dstStride of the
+    // full vertex). Strides are given in floats, not bytes.
+    inline void interleave(float* dst, std::size_t dstStride, const float* src, std::size_t srcStride, std::size_t components, std::size_t count)
+    {
+        // NOTE(Joey): a tightly packed source/destination pair is a straight copy.
+        if (dstStride == components && srcStride == components)
+        {
+            std::memcpy(dst, src, count * components * sizeof(float));
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t c = 0; c < components; ++c)
+                dst[c] = src[c];
+            dst += dstStride;
+            src += srcStride;
+        }
+    }
+    // NOTE(Joey): scatters the structure-of-arrays data into a strided float buffer (e.g. the
+    // position slot of an interleaved vertex buffer; offset the dst pointer accordingly).
+    inline void interleave(float* dst, std::size_t dstStride, const soa_vec3& src)
+    {
+        const std::size_t count = src.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            dst[0] = src.x[i];
+            dst[1] = src.y[i];
+            dst[2] = src.z[i];
+            dst += dstStride;
+        }
+    }
+    // NOTE(Joey): gathers count strided xyz triplets into structure-of-arrays layout.
+    inline void deinterleave(soa_vec3& dst, const float* src, std::size_t srcStride, std::size_t count)
+    {
+        dst.resize(count);
+        float* x = dst.x.data();
+        float* y = dst.y.data();
+        float* z = dst.z.data();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            x[i] = src[0];
+            y[i] = src[1];
+            z[i] = src[2];
+            src += srcStride;
+        }
+    }
+
+    // NOTE(Joey): bulk kernels
+    // ------------------------
+    // NOTE(Joey): min/max reduction over all vectors; the resulting axis-aligned bounding box is
+    // stored in out_Min and out_Max. An empty array results in a zero-sized box at the origin.
+    inline void aabb(const soa_vec3& v, vec3& out_Min, vec3& out_Max)
+    {
+        const std::size_t count = v.size();
+        if (count == 0)
+        {
+            out_Min = vec3(0.0f);
+            out_Max = vec3(0.0f);
+            return;
+        }
+        const float* x = v.x.data();
+        const float* y = v.y.data();
+        const float* z = v.z.data();
+
+        float minX = x[0], minY = y[0], minZ = z[0];
+        float maxX = x[0], maxY = y[0], maxZ = z[0];
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        if (count >= 4)
+        {
+            __m128 vMinX = _mm_set1_ps(minX), vMinY = _mm_set1_ps(minY), vMinZ = _mm_set1_ps(minZ);
+            __m128 vMaxX = vMinX, vMaxY = vMinY, vMaxZ = vMinZ;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 px = _mm_loadu_ps(x + i);
+                __m128 py = _mm_loadu_ps(y + i);
+                __m128 pz = _mm_loadu_ps(z + i);
+                vMinX = _mm_min_ps(vMinX, px); vMaxX = _mm_max_ps(vMaxX, px);
+                vMinY = _mm_min_ps(vMinY, py); vMaxY = _mm_max_ps(vMaxY, py);
+                vMinZ = _mm_min_ps(vMinZ, pz); vMaxZ = _mm_max_ps(vMaxZ, pz);
+            }
+            // horizontal reduction of the 4 lanes
+            float lanes[6][4];
+            _mm_storeu_ps(lanes[0], vMinX); _mm_storeu_ps(lanes[1], vMinY); _mm_storeu_ps(lanes[2], vMinZ);
+            _mm_storeu_ps(lanes[3], vMaxX); _mm_storeu_ps(lanes[4], vMaxY); _mm_storeu_ps(lanes[5], vMaxZ);
+            for (int l = 0; l < 4; ++l)
+            {
+                minX = lanes[0][l] < minX ? lanes[0][l] : minX;
+                minY = lanes[1][l] < minY ? lanes[1][l] : minY;
+                minZ = lanes[2][l] < minZ ? lanes[2][l] : minZ;
+                maxX = lanes[3][l] > maxX ? lanes[3][l] : maxX;
+                maxY = lanes[4][l] > maxY ? lanes[4][l] : maxY;
+                maxZ = lanes[5][l] > maxZ ? lanes[5][l] : maxZ;
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            minX = x[i] < minX ? x[i] : minX;
+            minY = y[i] < minY ? y[i] : minY;
+            minZ = z[i] < minZ ? z[i] : minZ;
+            maxX = x[i] > maxX ? x[i] : maxX;
+            maxY = y[i] > maxY ? y[i] : maxY;
+            maxZ = z[i] > maxZ ? z[i] : maxZ;
+        }
+        out_Min = vec3(minX, minY, minZ);
+        out_Max = vec3(maxX, maxY, maxZ);
+    }
+    // NOTE(Joey): transforms all vectors by the 4x4 matrix m with w as the implied homogeneous
+    // coordinate (1.0 for points, 0.0 for directions). The perspective divide is not applied.
+    // in and out are allowed to be the same container.
+    inline void transform(soa_vec3& out, const soa_vec3& in, const mat4& m, float w = 1.0f)
+    {
+        const std::size_t count = in.size();
+        out.resize(count);
+        const float* ix = in.x.data();
+        const float* iy = in.y.data();
+        const float* iz = in.z.data();
+        float* ox = out.x.data();
+        float* oy = out.y.data();
+        float* oz = out.z.data();
+        // column-major: e[col][row]
+        const float m00 = m.e[0][0], m01 = m.e[1][0], m02 = m.e[2][0], m03 = m.e[3][0] * w;
+        const float m10 = m.e[0][1], m11 = m.e[1][1], m12 = m.e[2][1], m13 = m.e[3][1] * w;
+        const float m20 = m.e[0][2], m21 = m.e[1][2], m22 = m.e[2][2], m23 = m.e[3][2] * w;
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        const __m128 c00 = _mm_set1_ps(m00), c01 = _mm_set1_ps(m01), c02 = _mm_set1_ps(m02), c03 = _mm_set1_ps(m03);
+        const __m128 c10 = _mm_set1_ps(m10), c11 = _mm_set1_ps(m11), c12 = _mm_set1_ps(m12), c13 = _mm_set1_ps(m13);
+        const __m128 c20 = _mm_set1_ps(m20), c21 = _mm_set1_ps(m21), c22 = _mm_set1_ps(m22), c23 = _mm_set1_ps(m23);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(ix + i);
+            __m128 py = _mm_loadu_ps(iy + i);
+            __m128 pz = _mm_loadu_ps(iz + i);
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c00, px), _mm_mul_ps(c01, py)), _mm_add_ps(_mm_mul_ps(c02, pz), c03));
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c10, px), _mm_mul_ps(c11, py)), _mm_add_ps(_mm_mul_ps(c12, pz), c13));
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c20, px), _mm_mul_ps(c21, py)), _mm_add_ps(_mm_mul_ps(c22, pz), c23));
+            _mm_storeu_ps(ox + i, rx);
+            _mm_storeu_ps(oy + i, ry);
+            _mm_storeu_ps(oz + i, rz);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float px = ix[i], py = iy[i], pz = iz[i];
+            ox[i] = m00 * px + m01 * py + m02 * pz + m03;
+            oy[i] = m10 * px + m11 * py + m12 * pz + m13;
+            oz[i] = m20 * px + m21 * py + m22 * pz + m23;
+        }
+    }
+    // NOTE(Joey): normalizes all vectors in place; zero-length vectors are left untouched (as
+    // opposed to producing NaNs).
+    inline void normalize(soa_vec3& v)
+    {
+        const std::size_t count = v.size();
+        float* x = v.x.data();
+        float* y = v.y.data();
+        float* z = v.z.data();
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one  = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+            __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(pz, pz));
+            // NOTE(Joey): full precision sqrt + div instead of _mm_rsqrt_ps; normals are stored
+            // for rendering so the 12-bit estimate isn't accurate enough.
+            __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(lenSq));
+            __m128 mask   = _mm_cmpgt_ps(lenSq, zero);
+            invLen = _mm_or_ps(_mm_and_ps(mask, invLen), _mm_andnot_ps(mask, one));
+            _mm_storeu_ps(x + i, _mm_mul_ps(px, invLen));
+            _mm_storeu_ps(y + i, _mm_mul_ps(py, invLen));
+            _mm_storeu_ps(z + i, _mm_mul_ps(pz, invLen));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float lenSq = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            if (lenSq > 0.0f)
+            {
+                const float invLen = 1.0f / std::sqrt(lenSq);
+                x[i] *= invLen;
+                y[i] *= invLen;
+                z[i] *= invLen;
+            }
+        }
+    }
+    // NOTE(Joey): per-element cross product: out[i] = cross(lhs[i], rhs[i]). out is allowed to
+    // alias with either of the inputs.
+    inline void cross(soa_vec3& out, const soa_vec3& lhs, const soa_vec3& rhs)
+    {
+        assert(lhs.size() == rhs.size());
+        const std::size_t count = lhs.size();
+        out.resize(count);
+        const float* ax = lhs.x.data(); const float* ay = lhs.y.data(); const float* az = lhs.z.data();
+        const float* bx = rhs.x.data(); const float* by = rhs.y.data(); const float* bz = rhs.z.data();
+        float* ox = out.x.data(); float* oy = out.y.data(); float* oz = out.z.data();
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 lx = _mm_loadu_ps(ax + i), ly = _mm_loadu_ps(ay + i), lz = _mm_loadu_ps(az + i);
+            __m128 rx = _mm_loadu_ps(bx + i), ry = _mm_loadu_ps(by + i), rz = _mm_loadu_ps(bz + i);
+            _mm_storeu_ps(ox + i, _mm_sub_ps(_mm_mul_ps(ly, rz), _mm_mul_ps(lz, ry)));
+            _mm_storeu_ps(oy + i, _mm_sub_ps(_mm_mul_ps(lz, rx), _mm_mul_ps(lx, rz)));
+            _mm_storeu_ps(oz + i, _mm_sub_ps(_mm_mul_ps(lx, ry), _mm_mul_ps(ly, rx)));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float lx = ax[i], ly = ay[i], lz = az[i];
+            const float rx = bx[i], ry = by[i], rz = bz[i];
+            ox[i] = ly * rz - lz * ry;
+            oy[i] = lz * rx - lx * rz;
+            oz[i] = lx * ry - ly * rx;
+        }
+    }
+    // NOTE(Joey): per-element dot product: out[i] = dot(lhs[i], rhs[i]); out must hold at least
+    // lhs.size() floats.
+    inline void dot(float* out, const soa_vec3& lhs, const soa_vec3& rhs)
+    {
+        assert(lhs.size() == rhs.size());
+        const std::size_t count = lhs.size();
+        const float* ax = lhs.x.data(); const float* ay = lhs.y.data(); const float* az = lhs.z.data();
+        const float* bx = rhs.x.data(); const float* by = rhs.y.data(); const float* bz = rhs.z.data();
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i)),
+                                             _mm_mul_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i))),
+                                             _mm_mul_ps(_mm_loadu_ps(az + i), _mm_loadu_ps(bz + i)));
+            _mm_storeu_ps(out + i, d);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+        }
+    }
+
+    // NOTE(Joey): strided kernels
+    // ---------------------------
+    // NOTE(Joey): the kernels below read vec3 streams in place, in their array-of-structures
+    // layout (e.g. Assimp's attribute arrays or a mesh's std::vector<vec3>; srcStride floats
+    // apart), and transpose them into SoA registers on the fly. For single passes over the data
+    // (as when loading a mesh) this saves the soa_vec3 copy, which costs more than the kernel.
+    // Each vector is loaded as 4 floats (w/ the next vector's x as 4th component), s.t. the last
+    // vector is always left to the scalar tail to never read past the end of the stream.
+#ifdef MATH_SOA_SSE
+    // NOTE(Joey): std::lround for 4 floats: _mm_cvtps_epi32 rounds half to even, so ties that
+    // were rounded towards zero are moved away from it.
+    inline __m128i soaRound(__m128 v)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128i r    = _mm_cvtps_epi32(v);
+        __m128  diff = _mm_sub_ps(v, _mm_cvtepi32_ps(r));
+        __m128  up   = _mm_and_ps(_mm_cmpeq_ps(diff, half), _mm_cmpgt_ps(v, zero));
+        __m128  down = _mm_and_ps(_mm_cmpeq_ps(diff, _mm_sub_ps(zero, half)), _mm_cmplt_ps(v, zero));
+        r = _mm_sub_epi32(r, _mm_castps_si128(up)); // masks are -1
+        return _mm_add_epi32(r, _mm_castps_si128(down));
+    }
+    inline __m128 soaSelect(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    // NOTE(Joey): loads the 4 vectors starting at src as x, y and z registers.
+    inline void soaLoad(const float* src, std::size_t srcStride, __m128& x, __m128& y, __m128& z)
+    {
+        __m128 r0 = _mm_loadu_ps(src);
+        __m128 r1 = _mm_loadu_ps(src + srcStride);
+        __m128 r2 = _mm_loadu_ps(src + srcStride * 2);
+        __m128 r3 = _mm_loadu_ps(src + srcStride * 3);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        x = r0; y = r1; z = r2;
+    }
+    // NOTE(Joey): octEncode of 4 vectors at once; bit-identical to the scalar version.
+    inline void soaOctEncode(__m128 x, __m128 y, __m128 z, __m128& out_X, __m128& out_Y)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 zero     = _mm_setzero_ps();
+        const __m128 one      = _mm_set1_ps(1.0f);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        __m128 l1    = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+        __m128 valid = _mm_cmpgt_ps(l1, zero);
+        __m128 ex    = _mm_and_ps(valid, _mm_div_ps(x, l1));
+        __m128 ey    = _mm_and_ps(valid, _mm_div_ps(y, l1));
+        __m128 fx    = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, ey)), soaSelect(_mm_cmpge_ps(ex, zero), one, minusOne));
+        __m128 fy    = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, ex)), soaSelect(_mm_cmpge_ps(ey, zero), one, minusOne));
+        __m128 fold  = _mm_cmplt_ps(z, zero);
+        out_X = soaSelect(fold, fx, ex);
+        out_Y = soaSelect(fold, fy, ey);
+    }
+    // NOTE(Joey): as packSnorm16/packSnorm1010102's components w/ the given scale.
+    inline __m128i soaPackSnorm(__m128 v, float scale)
+    {
+        v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+        return soaRound(_mm_mul_ps(v, _mm_set1_ps(scale)));
+    }
+#endif
+    // NOTE(Joey): min/max reduction over count strided vectors; equal to aabb over the same
+    // vectors in soa_vec3 layout.
+    inline void aabb(const float* src, std::size_t srcStride, std::size_t count, vec3& out_Min, vec3& out_Max)
+    {
+        if (count == 0)
+        {
+            out_Min = vec3(0.0f);
+            out_Max = vec3(0.0f);
+            return;
+        }
+        float minX = src[0], minY = src[1], minZ = src[2];
+        float maxX = src[0], maxY = src[1], maxZ = src[2];
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        if (count > 4)
+        {
+            // two accumulators per bound, s.t. consecutive iterations don't wait on each other
+            __m128 vMin0 = _mm_loadu_ps(src), vMax0 = vMin0;
+            __m128 vMin1 = vMin0, vMax1 = vMin0;
+            for (; i + 4 < count; i += 4)
+            {
+                const float* p = src + i * srcStride;
+                __m128 p0 = _mm_loadu_ps(p);
+                __m128 p1 = _mm_loadu_ps(p + srcStride);
+                __m128 p2 = _mm_loadu_ps(p + srcStride * 2);
+                __m128 p3 = _mm_loadu_ps(p + srcStride * 3);
+                vMin0 = _mm_min_ps(vMin0, _mm_min_ps(p0, p1)); vMax0 = _mm_max_ps(vMax0, _mm_max_ps(p0, p1));
+                vMin1 = _mm_min_ps(vMin1, _mm_min_ps(p2, p3)); vMax1 = _mm_max_ps(vMax1, _mm_max_ps(p2, p3));
+            }
+            // lane 3 holds the next vectors' x components and is ignored
+            float lanes[2][4];
+            _mm_storeu_ps(lanes[0], _mm_min_ps(vMin0, vMin1));
+            _mm_storeu_ps(lanes[1], _mm_max_ps(vMax0, vMax1));
+            minX = lanes[0][0]; minY = lanes[0][1]; minZ = lanes[0][2];
+            maxX = lanes[1][0]; maxY = lanes[1][1]; maxZ = lanes[1][2];
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float* p = src + i * srcStride;
+            minX = p[0] < minX ? p[0] : minX;
+            minY = p[1] < minY ? p[1] : minY;
+            minZ = p[2] < minZ ? p[2] : minZ;
+            maxX = p[0] > maxX ? p[0] : maxX;
+            maxY = p[1] > maxY ? p[1] : maxY;
+            maxZ = p[2] > maxZ ? p[2] : maxZ;
+        }
+        out_Min = vec3(minX, minY, minZ);
+        out_Max = vec3(maxX, maxY, maxZ);
+    }
+    // NOTE(Joey): encodes count strided unit vectors as octahedral 2 x snorm16 (octEncode +
+    // packSnorm16) into a vertex buffer; dstStride is given in bytes.
+    inline void packOctSnorm16(void* dst, std::size_t dstStride, const float* src, std::size_t srcStride, std::size_t count)
+    {
+        unsigned char* out = (unsigned char*)dst;
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        for (; i + 4 < count; i += 4)
+        {
+            __m128 x, y, z, ex, ey;
+            soaLoad(src + i * srcStride, srcStride, x, y, z);
+            soaOctEncode(x, y, z, ex, ey);
+            int16_t packed[8]; // x0..x3, y0..y3
+            _mm_storeu_si128((__m128i*)packed, _mm_packs_epi32(soaPackSnorm(ex, 32767.0f), soaPackSnorm(ey, 32767.0f)));
+            for (int j = 0; j < 4; ++j, out += dstStride)
+            {
+                int16_t e[2] = { packed[j], packed[4 + j] };
+                std::memcpy(out, e, sizeof(e));
+            }
+        }
+#endif
+        for (; i < count; ++i, out += dstStride)
+        {
+            const float* n = src + i * srcStride;
+            vec2 e = octEncode(vec3(n[0], n[1], n[2]));
+            int16_t packed[2] = { packSnorm16(e.x), packSnorm16(e.y) };
+            std::memcpy(out, packed, sizeof(packed));
+        }
+    }
+    // NOTE(Joey): encodes count strided tangents as octahedral 10_10_10_2 (packSnorm1010102),
+    // w/ the bitangent's handedness w.r.t. normal and tangent (the sign of
+    // dot(cross(normal, tangent), bitangent)) in w; positive if normals or bitangents are
+    // absent (nullptr). All three streams share srcStride; dstStride is given in bytes.
+    inline void packOctTangents(void* dst, std::size_t dstStride, const float* tangents, const float* normals, const float* bitangents,
+                                std::size_t srcStride, std::size_t count)
+    {
+        const bool handedness = normals && bitangents;
+        unsigned char* out = (unsigned char*)dst;
+        std::size_t i = 0;
+#ifdef MATH_SOA_SSE
+        const __m128i mask10 = _mm_set1_epi32(0x3FF);
+        const __m128i wPositive = _mm_set1_epi32(1 << 30);
+        const __m128i wNegative = _mm_set1_epi32(3 << 30);
+        for (; i + 4 < count; i += 4)
+        {
+            __m128 tx, ty, tz, ex, ey;
+            soaLoad(tangents + i * srcStride, srcStride, tx, ty, tz);
+            soaOctEncode(tx, ty, tz, ex, ey);
+            __m128i w = wPositive;
+            if (handedness)
+            {
+                __m128 nx, ny, nz, bx, by, bz;
+                soaLoad(normals + i * srcStride, srcStride, nx, ny, nz);
+                soaLoad(bitangents + i * srcStride, srcStride, bx, by, bz);
+                __m128 cx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty));
+                __m128 cy = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz));
+                __m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx));
+                __m128 d  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, bx), _mm_mul_ps(cy, by)), _mm_mul_ps(cz, bz));
+                __m128i negative = _mm_castps_si128(_mm_cmplt_ps(d, _mm_setzero_ps()));
+                w = _mm_or_si128(_mm_and_si128(negative, wNegative), _mm_andnot_si128(negative, wPositive));
+            }
+            __m128i px = _mm_and_si128(soaPackSnorm(ex, 511.0f), mask10);
+            __m128i py = _mm_slli_epi32(_mm_and_si128(soaPackSnorm(ey, 511.0f), mask10), 10);
+            uint32_t packed[4];
+            _mm_storeu_si128((__m128i*)packed, _mm_or_si128(_mm_or_si128(px, py), w));
+            for (int j = 0; j < 4; ++j, out += dstStride)
+                std::memcpy(out, &packed[j], sizeof(uint32_t));
+        }
+#endif
+        for (; i < count; ++i, out += dstStride)
+        {
+            const float* t = tangents + i * srcStride;
+            vec3 tangent(t[0], t[1], t[2]);
+            float sign = 1.0f;
+            if (handedness)
+            {
+                const float* n = normals + i * srcStride;
+                const float* b = bitangents + i * srcStride;
+                vec3 c = cross(vec3(n[0], n[1], n[2]), tangent);
+                sign = c.x * b[0] + c.y * b[1] + c.z * b[2] < 0.0f ? -1.0f : 1.0f;
+            }
+            vec2 e = octEncode(tangent);
+            uint32_t packed = packSnorm1010102(vec4(e.x, e.y, 0.0f, sign));
+            std::memcpy(out, &packed, sizeof(uint32_t));
+        }
+    }
+} // namespace math
+
+#endif
@@ -9,11 +9,17 @@
 #include "linear_algebra/operation.h"
 #include "linear_algebra/transformation.h" 
 #include "linear_algebra/quaternion.h"
+#include "linear_algebra/soa.h"
+#include "linear_algebra/packing.h"
 
 // NOTE(Joey): trigonometry
 #include "trigonometry/conversions.h"
 #include "trigonometry/polar.h"
 #include "trigonometry/spherical.h"
+#include "trigonometry/spherical_harmonics.h"
+
+// NOTE(Joey): geometry
+#include "geometry/light_binning.h"
 
 // NOTE(Joey): common operations
 #include "common.h"
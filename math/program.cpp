@@ -5,6 +5,10 @@
 #include "test/test_operations.h"
 #include "test/test_common.h"
 #include "test/test_transformations.h"
+#include "test/test_soa.h"
+#include "test/test_packing.h"
+#include "test/test_spherical_harmonics.h"
+#include "test/test_light_binning.h"
 
 // todo: check googletest for testing.
 
@@ -37,6 +41,24 @@ int main(int argc, int *argv[])
     // run transformations matrix/vector math tests
     TEST(MatrixTransformation);
 
+    // run structure-of-arrays kernel tests
+    TEST(SoALayout);
+    TEST(SoAKernels);
+    TEST(SoAStridedKernels);
+    TEST(SoABenchmark);
+
+    // run vertex attribute packing tests
+    TEST(PackingScalars);
+    TEST(PackingDirections);
+
+    // run spherical harmonics tests
+    TEST(SHBasis);
+    TEST(SHIrradiance);
+
+    // run tiled light binning tests
+    TEST(LightBinning);
+    TEST(LightBinningBenchmark);
+
 	std::cout << std::endl;
 	if (TEST_SUCCESS)
 		std::cout << "|O| Tests succesfully completed." << std::endl;
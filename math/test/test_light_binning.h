@@ -0,0 +1,214 @@
+#ifndef MATH_TEST_LIGHT_BINNING_H
+#define MATH_TEST_LIGHT_BINNING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../math.h"
+
+// NOTE(Joey): a synthetic screen of view space positions: a floor receding into the distance
+// w/ a few boxes standing on it and the sky (no geometry, w = 0) above the horizon.
+struct LightBinningScene
+{
+    unsigned int Width, Height, TileSize, TilesX, TilesY;
+    math::mat4 Projection;
+    std::vector<math::vec4> Positions;
+    std::vector<float> TileDepthMin, TileDepthMax;
+    std::vector<math::light_bounds> Lights;
+    std::vector<math::vec4> Spheres; // view space center, radius
+};
+
+static void LightBinningSetup(LightBinningScene& scene, unsigned int width, unsigned int height, unsigned int lightCount)
+{
+    const float near = 0.1f;
+    scene.Width      = width;
+    scene.Height     = height;
+    scene.TileSize   = 16;
+    scene.TilesX     = math::tileCount(width, scene.TileSize);
+    scene.TilesY     = math::tileCount(height, scene.TileSize);
+    scene.Projection = math::perspective(math::Deg2Rad(60.0f), (float)width / (float)height, near, 100.0f);
+
+    // ray cast each pixel (center) against the floor (y = -2) and the boxes
+    scene.Positions.assign(width * height, math::vec4(0.0f));
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            float ndcX = ((x + 0.5f) / width)  * 2.0f - 1.0f;
+            float ndcY = ((y + 0.5f) / height) * 2.0f - 1.0f;
+            math::vec3 ray(ndcX / scene.Projection[0][0], ndcY / scene.Projection[1][1], -1.0f); // z = -1: t is the view depth
+            float depth = ray.y < 0.0f ? -2.0f / ray.y : 1e30f;
+            for (int i = 0; i < 3; ++i)
+            {
+                // boxes facing the camera: a quad at depth 6 + 5i, 2 wide and 3 high
+                float boxDepth = 6.0f + 5.0f * i;
+                float boxX     = -3.0f + 3.0f * i;
+                math::vec3 p = ray * boxDepth;
+                if (boxDepth < depth && p.x >= boxX - 1.0f && p.x <= boxX + 1.0f && p.y >= -2.0f && p.y <= 1.0f)
+                    depth = boxDepth;
+            }
+            if (depth < 100.0f)
+                scene.Positions[y * width + x] = math::vec4(ray * depth, 1.0f);
+        }
+    }
+
+    // the tiles' depth bounds, as the GPU's depth reduction finds them
+    scene.TileDepthMin.assign(scene.TilesX * scene.TilesY,  1e30f);
+    scene.TileDepthMax.assign(scene.TilesX * scene.TilesY, -1e30f);
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            const math::vec4& p = scene.Positions[y * width + x];
+            if (p.w == 0.0f)
+                continue;
+            unsigned int t = (y / scene.TileSize) * scene.TilesX + x / scene.TileSize;
+            scene.TileDepthMin[t] = std::min(scene.TileDepthMin[t], -p.z);
+            scene.TileDepthMax[t] = std::max(scene.TileDepthMax[t], -p.z);
+        }
+    }
+
+    // deterministic pseudo-random lights in and around the view frustum, a few crossing the
+    // near plane or behind the camera.
+    scene.Lights.clear();
+    scene.Spheres.clear();
+    for (unsigned int i = 0; i < lightCount; ++i)
+    {
+        float f = (float)i;
+        math::vec3 center(std::sin(f * 12.9898f) * 12.0f,
+                          std::cos(f * 78.233f) * 3.0f - 1.0f,
+                          -std::abs(std::sin(f * 37.719f)) * 30.0f + 1.0f);
+        float radius = 0.5f + std::abs(std::cos(f * 4.1414f)) * 3.0f;
+        scene.Spheres.push_back(math::vec4(center, radius));
+        scene.Lights.push_back(math::lightBounds(center, radius, scene.Projection, width, height, scene.TileSize, near));
+    }
+}
+
+static bool LightBinningContains(const math::light_tiles& tiles, unsigned int x, unsigned int y, unsigned int light)
+{
+    const unsigned int* lights = tiles.lights(x, y);
+    return std::binary_search(lights, lights + tiles.count(x, y), light);
+}
+
+bool LightBinning()
+{
+    bool result = true;
+
+    LightBinningScene scene;
+    LightBinningSetup(scene, 320, 200, 256); // 20 x 13 tiles, the last row partially covered
+    if (scene.TilesX != 20 || scene.TilesY != 13) result = false;
+
+    math::light_tiles tiles;
+    math::binLights(tiles, &scene.Lights[0], scene.Lights.size(), scene.TilesX, scene.TilesY, &scene.TileDepthMin[0], &scene.TileDepthMax[0]);
+    if (tiles.Offsets.size() != scene.TilesX * scene.TilesY + 1 || tiles.Offsets.back() != tiles.Indices.size()) result = false;
+
+    // each tile's list equals the brute-force test of every light against it (in light order)
+    for (unsigned int y = 0; y < scene.TilesY; ++y)
+    {
+        for (unsigned int x = 0; x < scene.TilesX; ++x)
+        {
+            unsigned int t = y * scene.TilesX + x;
+            std::vector<unsigned int> reference;
+            for (unsigned int i = 0; i < scene.Lights.size(); ++i)
+                if (math::lightInTile(scene.Lights[i], x, y, scene.TileDepthMin[t], scene.TileDepthMax[t]))
+                    reference.push_back(i);
+            if (tiles.count(x, y) != reference.size() || !std::equal(reference.begin(), reference.end(), tiles.lights(x, y)))
+                result = false;
+        }
+    }
+
+    // conservative: a pixel w/in a light's sphere always finds the light in its tile
+    unsigned int lit = 0;
+    for (unsigned int y = 0; y < scene.Height; ++y)
+    {
+        for (unsigned int x = 0; x < scene.Width; ++x)
+        {
+            const math::vec4& p = scene.Positions[y * scene.Width + x];
+            if (p.w == 0.0f)
+                continue;
+            for (unsigned int i = 0; i < scene.Spheres.size(); ++i)
+            {
+                math::vec3 d = p.xyz - scene.Spheres[i].xyz;
+                if (math::dot(d, d) < scene.Spheres[i].w * scene.Spheres[i].w)
+                {
+                    ++lit;
+                    if (!LightBinningContains(tiles, x / scene.TileSize, y / scene.TileSize, i))
+                        result = false;
+                }
+            }
+        }
+    }
+    if (lit == 0) result = false; // the test lights should reach some geometry
+
+    // sky tiles (empty depth bounds) get no lights; neither do tiles a light is hidden behind
+    // (and doesn't reach): a light behind the first box, in front of the last one's depth.
+    if (tiles.count(scene.TilesX / 2, scene.TilesY - 1) != 0) result = false;
+    unsigned int boxX = 0, boxY = 0;
+    {
+        // the tile at the center of the first box (x = -3, y = -0.5 at depth 6)
+        math::vec4 center(-3.0f, -0.5f, -6.0f, 1.0f);
+        math::vec4 clip = scene.Projection * center;
+        boxX = (unsigned int)((clip.x / clip.w * 0.5f + 0.5f) * scene.Width)  / scene.TileSize;
+        boxY = (unsigned int)((clip.y / clip.w * 0.5f + 0.5f) * scene.Height) / scene.TileSize;
+    }
+    math::light_bounds hidden = math::lightBounds(math::vec3(-3.0f, -0.5f, -9.0f), 1.0f, scene.Projection, scene.Width, scene.Height, scene.TileSize, 0.1f);
+    math::light_bounds front  = math::lightBounds(math::vec3(-3.0f, -0.5f, -5.5f), 1.0f, scene.Projection, scene.Width, scene.Height, scene.TileSize, 0.1f);
+    unsigned int t = boxY * scene.TilesX + boxX;
+    if (math::lightInTile(hidden, boxX, boxY, scene.TileDepthMin[t], scene.TileDepthMax[t])) result = false;
+    if (!math::lightInTile(front, boxX, boxY, scene.TileDepthMin[t], scene.TileDepthMax[t])) result = false;
+
+    // lights behind the camera have no footprint; those crossing the near plane cover all tiles
+    if (!math::lightBounds(math::vec3(0.0f, 0.0f, 5.0f), 1.0f, scene.Projection, scene.Width, scene.Height, scene.TileSize, 0.1f).empty()) result = false;
+    math::light_bounds crossing = math::lightBounds(math::vec3(0.0f, 0.0f, 0.0f), 1.0f, scene.Projection, scene.Width, scene.Height, scene.TileSize, 0.1f);
+    if (crossing.TileMinX != 0 || crossing.TileMinY != 0 || crossing.TileMaxX != 19 || crossing.TileMaxY != 12) result = false;
+
+    return result;
+}
+
+// NOTE(Joey): not a correctness test, but reports the timing of binning 1024 lights into the
+// tiles of a 1080p screen (footprints + binning) versus testing each light against each tile.
+bool LightBinningBenchmark()
+{
+    LightBinningScene scene;
+    LightBinningSetup(scene, 1920, 1080, 0);
+    const unsigned int lightCount = 1024;
+    const float near = 0.1f;
+
+    std::vector<math::vec4> spheres;
+    for (unsigned int i = 0; i < lightCount; ++i)
+    {
+        float f = (float)i;
+        spheres.push_back(math::vec4(std::sin(f * 12.9898f) * 12.0f, std::cos(f * 78.233f) * 3.0f - 1.0f,
+                                     -std::abs(std::sin(f * 37.719f)) * 30.0f - 1.0f, 0.5f + std::abs(std::cos(f * 4.1414f)) * 3.0f));
+    }
+
+    // every light against every tile
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<math::light_bounds> lights(lightCount);
+    for (unsigned int i = 0; i < lightCount; ++i)
+        lights[i] = math::lightBounds(spheres[i].xyz, spheres[i].w, scene.Projection, scene.Width, scene.Height, scene.TileSize, near);
+    std::vector<std::vector<unsigned int>> naive(scene.TilesX * scene.TilesY);
+    for (unsigned int t = 0; t < naive.size(); ++t)
+        for (unsigned int i = 0; i < lightCount; ++i)
+            if (math::lightInTile(lights[i], t % scene.TilesX, t / scene.TilesX, scene.TileDepthMin[t], scene.TileDepthMax[t]))
+                naive[t].push_back(i);
+    auto naiveTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // footprints, then binning
+    start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < lightCount; ++i)
+        lights[i] = math::lightBounds(spheres[i].xyz, spheres[i].w, scene.Projection, scene.Width, scene.Height, scene.TileSize, near);
+    math::light_tiles tiles;
+    math::binLights(tiles, &lights[0], lightCount, scene.TilesX, scene.TilesY, &scene.TileDepthMin[0], &scene.TileDepthMax[0]);
+    auto binTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "    1024 lights, " << scene.TilesX * scene.TilesY << " tiles - per tile: " << naiveTime << " ms | binned: " << binTime
+              << " ms (" << tiles.Indices.size() << " light/tile pairs)" << std::endl;
+
+    return tiles.Indices.size() == [&]() { std::size_t n = 0; for (auto& l : naive) n += l.size(); return n; }();
+}
+
+#endif
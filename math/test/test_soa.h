@@ -0,0 +1,270 @@
+#ifndef MATH_TEST_SOA_H
+#define MATH_TEST_SOA_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "../math.h"
+
+// NOTE(Joey): deterministic pseudo-random data; odd sizes make sure the scalar tails of the
+// SIMD kernels are exercised as well.
+static void SoAFill(math::soa_vec3& v, std::size_t count, float seed)
+{
+    v.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float f = (float)i + seed;
+        v.x[i] = std::sin(f * 12.9898f) * 10.0f;
+        v.y[i] = std::cos(f * 78.233f)  * 10.0f;
+        v.z[i] = std::sin(f * 37.719f)  * 10.0f - 2.0f;
+    }
+}
+
+static bool SoAEqual(float a, float b)
+{
+    return std::abs(a - b) <= 1e-4f * (1.0f + std::abs(a));
+}
+
+static void SoAGrow(math::vec3& boxMin, math::vec3& boxMax, const math::vec3& p)
+{
+    boxMin.x = std::min(boxMin.x, p.x); boxMax.x = std::max(boxMax.x, p.x);
+    boxMin.y = std::min(boxMin.y, p.y); boxMax.y = std::max(boxMax.y, p.y);
+    boxMin.z = std::min(boxMin.z, p.z); boxMax.z = std::max(boxMax.z, p.z);
+}
+
+bool SoALayout()
+{
+    bool result = true;
+
+    std::vector<math::vec3> aos = { { 1.0f, 2.0f, 3.0f },{ 4.0f, 5.0f, 6.0f },{ 7.0f, 8.0f, 9.0f } };
+    math::soa_vec3 soa;
+    math::deinterleave(soa, &aos[0].x, 3, aos.size());
+    if (soa.size() != 3) result = false;
+    if (soa.x[1] != 4.0f || soa.y[1] != 5.0f || soa.z[2] != 9.0f) result = false;
+
+    // interleave into a position + uv vertex (stride 5)
+    std::vector<float> vertices(5 * 3, -1.0f);
+    math::interleave(&vertices[0], 5, soa);
+    if (vertices[5] != 4.0f || vertices[6] != 5.0f || vertices[7] != 6.0f) result = false;
+    if (vertices[3] != -1.0f || vertices[4] != -1.0f) result = false;
+
+    std::vector<math::vec2> uv = { { 0.0f, 1.0f },{ 0.5f, 0.5f },{ 1.0f, 0.0f } };
+    math::interleave(&vertices[3], 5, &uv[0].x, 2, 2, uv.size());
+    if (vertices[8] != 0.5f || vertices[9] != 0.5f || vertices[14] != 0.0f) result = false;
+
+    return result;
+}
+
+bool SoAKernels()
+{
+    bool result = true;
+
+    const std::size_t count = 1027;
+    math::soa_vec3 a, b;
+    SoAFill(a, count, 0.0f);
+    SoAFill(b, count, 0.5f);
+
+    // aabb
+    math::vec3 boxMin, boxMax;
+    math::aabb(a, boxMin, boxMax);
+    math::vec3 refMin = a.get(0), refMax = a.get(0);
+    for (std::size_t i = 0; i < count; ++i)
+        SoAGrow(refMin, refMax, a.get(i));
+    if (boxMin.x != refMin.x || boxMin.y != refMin.y || boxMin.z != refMin.z) result = false;
+    if (boxMax.x != refMax.x || boxMax.y != refMax.y || boxMax.z != refMax.z) result = false;
+
+    // dot/cross
+    std::vector<float> dots(count);
+    math::soa_vec3 crosses;
+    math::dot(&dots[0], a, b);
+    math::cross(crosses, a, b);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        math::vec3 c = math::cross(a.get(i), b.get(i));
+        if (!SoAEqual(dots[i], math::dot(a.get(i), b.get(i)))) result = false;
+        if (!SoAEqual(crosses.x[i], c.x) || !SoAEqual(crosses.y[i], c.y) || !SoAEqual(crosses.z[i], c.z)) result = false;
+    }
+
+    // transform (in-place)
+    math::mat4 translation = math::translate(math::vec3(1.0f, -2.0f, 3.0f));
+    math::mat4 scale       = math::scale(math::vec3(2.0f));
+    math::mat4 m = translation * scale;
+    math::soa_vec3 t = a;
+    math::transform(t, t, m);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        math::vec4 p   = math::vec4(a.get(i), 1.0f);
+        math::vec4 ref = m * p;
+        if (!SoAEqual(t.x[i], ref.x) || !SoAEqual(t.y[i], ref.y) || !SoAEqual(t.z[i], ref.z)) result = false;
+    }
+
+    // normalize (including a zero-length vector that should be left alone)
+    a.set(5, math::vec3(0.0f));
+    math::normalize(a);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float length = math::length(a.get(i));
+        if (i == 5 ? length != 0.0f : !SoAEqual(length, 1.0f)) result = false;
+    }
+
+    return result;
+}
+
+// NOTE(Joey): the vertex streams of a mesh w/ a full (orthonormal) tangent frame in
+// array-of-structures layout, as the mesh loader gets them; every 7th bitangent is flipped.
+static void SoAFrames(std::vector<math::vec3>& positions, std::vector<math::vec3>& normals, std::vector<math::vec3>& tangents,
+                      std::vector<math::vec3>& bitangents, std::size_t count)
+{
+    math::soa_vec3 p, n, t;
+    SoAFill(p, count, 0.0f);
+    SoAFill(n, count, 1.0f);
+    SoAFill(t, count, 2.0f);
+    math::normalize(n);
+    positions.resize(count); normals.resize(count); tangents.resize(count); bitangents.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        positions[i]  = p.get(i);
+        normals[i]    = n.get(i);
+        tangents[i]   = math::normalize(math::cross(normals[i], t.get(i)));
+        bitangents[i] = math::cross(normals[i], tangents[i]) * (i % 7 == 0 ? -1.0f : 1.0f);
+    }
+}
+
+// NOTE(Joey): the scalar reference of the strided kernels: the per-vertex loops of the mesh
+// loader and Mesh::PackVertexData before they moved to the kernels.
+static void SoAScalarBounds(const std::vector<math::vec3>& positions, math::vec3& boxMin, math::vec3& boxMax)
+{
+    boxMin = positions[0];
+    boxMax = positions[0];
+    for (std::size_t i = 1; i < positions.size(); ++i)
+        SoAGrow(boxMin, boxMax, positions[i]);
+}
+static void SoAScalarNormals(unsigned char* dst, std::size_t stride, const std::vector<math::vec3>& normals)
+{
+    for (std::size_t i = 0; i < normals.size(); ++i, dst += stride)
+    {
+        math::vec2 e = math::octEncode(normals[i]);
+        int16_t n[2] = { math::packSnorm16(e.x), math::packSnorm16(e.y) };
+        std::memcpy(dst, n, sizeof(n));
+    }
+}
+static void SoAScalarTangents(unsigned char* dst, std::size_t stride, const std::vector<math::vec3>& tangents,
+                              const std::vector<math::vec3>& normals, const std::vector<math::vec3>& bitangents)
+{
+    for (std::size_t i = 0; i < tangents.size(); ++i, dst += stride)
+    {
+        float sign = math::dot(math::cross(normals[i], tangents[i]), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+        math::vec2 e = math::octEncode(tangents[i]);
+        uint32_t t = math::packSnorm1010102(math::vec4(e.x, e.y, 0.0f, sign));
+        std::memcpy(dst, &t, sizeof(t));
+    }
+}
+
+bool SoAStridedKernels()
+{
+    bool result = true;
+
+    // odd count: the scalar tail handles the last 3 vectors
+    const std::size_t count = 1027;
+    std::vector<math::vec3> positions, normals, tangents, bitangents;
+    SoAFrames(positions, normals, tangents, bitangents, count);
+    normals[3]  = math::vec3(0.0f);                 // zero-length: encodes as (0, 0)
+    normals[9]  = math::vec3(0.0f, 0.0f, -1.0f);    // folded octant corners
+    normals[10] = math::vec3(-1.0f, 0.0f, 0.0f);
+    tangents[5] = math::vec3(0.6f, -0.0f, -0.8f);
+
+    // bounds, in place and w/ a stride (positions of an interleaved position + normal buffer)
+    math::vec3 boxMin, boxMax, refMin, refMax;
+    SoAScalarBounds(positions, refMin, refMax);
+    math::aabb(&positions[0].x, 3, count, boxMin, boxMax);
+    if (boxMin.x != refMin.x || boxMin.y != refMin.y || boxMin.z != refMin.z) result = false;
+    if (boxMax.x != refMax.x || boxMax.y != refMax.y || boxMax.z != refMax.z) result = false;
+    std::vector<float> interleaved(count * 6);
+    math::interleave(&interleaved[0], 6, &positions[0].x, 3, 3, count);
+    math::interleave(&interleaved[3], 6, &normals[0].x, 3, 3, count);
+    math::aabb(&interleaved[0], 6, count, boxMin, boxMax);
+    if (boxMin.x != refMin.x || boxMin.y != refMin.y || boxMin.z != refMin.z) result = false;
+    if (boxMax.x != refMax.x || boxMax.y != refMax.y || boxMax.z != refMax.z) result = false;
+    math::aabb(&positions[0].x, 3, 1, boxMin, boxMax);
+    if (boxMin.x != positions[0].x || boxMax.z != positions[0].z) result = false;
+
+    // packed normals and tangents (in a 24 byte compact vertex) are bit-identical to the
+    // scalar encoding
+    const std::size_t stride = 24;
+    std::vector<unsigned char> kernel(count * stride, 0), reference(count * stride, 0);
+    math::packOctSnorm16(&kernel[12], stride, &normals[0].x, 3, count);
+    SoAScalarNormals(&reference[12], stride, normals);
+    math::packOctTangents(&kernel[16], stride, &tangents[0].x, &normals[0].x, &bitangents[0].x, 3, count);
+    SoAScalarTangents(&reference[16], stride, tangents, normals, bitangents);
+    if (kernel != reference) result = false;
+
+    // w/o normals or bitangents the handedness is positive
+    std::vector<unsigned char> kernelPositive(count * 4), referencePositive(count * 4);
+    math::packOctTangents(&kernelPositive[0], 4, &tangents[0].x, nullptr, nullptr, 3, count);
+    SoAScalarTangents(&referencePositive[0], 4, tangents, normals, std::vector<math::vec3>(count, math::vec3(0.0f)));
+    if (kernelPositive != referencePositive) result = false;
+
+#ifdef MATH_SOA_SSE
+    // rounding matches std::lround, ties away from zero
+    for (int i = -20; i <= 20; ++i)
+    {
+        float v[4] = { i + 0.5f, i * 0.37f, i * 1001.5f, -i - 0.49999997f };
+        int32_t r[4];
+        _mm_storeu_si128((__m128i*)r, math::soaRound(_mm_loadu_ps(v)));
+        for (int j = 0; j < 4; ++j)
+            if (r[j] != std::lround(v[j])) result = false;
+    }
+#endif
+
+    return result;
+}
+
+// NOTE(Joey): not a correctness test, but reports the timing of the mesh loading/packing steps
+// that run through the strided kernels on a 5M vertex mesh, versus the per-vertex loops they
+// replaced (and, for the bounds, the soa_vec3 copy + aabb kernel).
+bool SoABenchmark()
+{
+    const std::size_t count = 5000000;
+    const std::size_t stride = 24; // compact vertex: position, uv, normal, tangent
+    std::vector<math::vec3> positions, normals, tangents, bitangents;
+    SoAFrames(positions, normals, tangents, bitangents, count);
+    std::vector<unsigned char> reference(count * stride), kernel(count * stride);
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    // bounds
+    math::vec3 boxMin, boxMax;
+    auto start = std::chrono::high_resolution_clock::now();
+    SoAScalarBounds(positions, boxMin, boxMax);
+    double boundsScalar = time(start);
+    start = std::chrono::high_resolution_clock::now();
+    math::soa_vec3 soaPositions;
+    math::deinterleave(soaPositions, &positions[0].x, 3, count);
+    math::aabb(soaPositions, boxMin, boxMax);
+    double boundsCopy = time(start);
+    start = std::chrono::high_resolution_clock::now();
+    math::aabb(&positions[0].x, 3, count, boxMin, boxMax);
+    double boundsStrided = time(start);
+
+    // compact normals and tangents
+    start = std::chrono::high_resolution_clock::now();
+    SoAScalarNormals(&reference[12], stride, normals);
+    SoAScalarTangents(&reference[16], stride, tangents, normals, bitangents);
+    double packScalar = time(start);
+    start = std::chrono::high_resolution_clock::now();
+    math::packOctSnorm16(&kernel[12], stride, &normals[0].x, 3, count);
+    math::packOctTangents(&kernel[16], stride, &tangents[0].x, &normals[0].x, &bitangents[0].x, 3, count);
+    double packStrided = time(start);
+
+    std::cout << "    5M vertices - bounds: " << boundsScalar << " ms per vertex | " << boundsCopy << " ms soa copy | "
+              << boundsStrided << " ms strided" << std::endl;
+    std::cout << "    5M vertices - compact normals + tangents: " << packScalar << " ms per vertex | " << packStrided
+              << " ms strided" << std::endl;
+
+    return kernel == reference;
+}
+
+#endif
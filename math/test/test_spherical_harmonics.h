@@ -0,0 +1,124 @@
+#ifndef MATH_TEST_SPHERICAL_HARMONICS_H
+#define MATH_TEST_SPHERICAL_HARMONICS_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "../math.h"
+
+// NOTE(Joey): projects an analytic RGB function through a (float RGB) cubemap of the given size.
+static math::sh9 SHProjectFunction(const std::function<math::vec3(const math::vec3&)>& f, unsigned int size)
+{
+    std::vector<float> texels(6 * size * size * 3);
+    const float* faces[6];
+    for (unsigned int face = 0; face < 6; ++face)
+    {
+        float* data = &texels[face * size * size * 3];
+        faces[face] = data;
+        for (unsigned int y = 0; y < size; ++y)
+        {
+            for (unsigned int x = 0; x < size; ++x)
+            {
+                math::vec3 value = f(math::shCubeDirection(face, x, y, size));
+                data[(y * size + x) * 3 + 0] = value.x;
+                data[(y * size + x) * 3 + 1] = value.y;
+                data[(y * size + x) * 3 + 2] = value.z;
+            }
+        }
+    }
+    return math::shProjectCube(faces, size, 3);
+}
+
+static float SHMaxError(const math::sh9& sh, const std::function<math::vec3(const math::vec3&)>& expected)
+{
+    float maxError = 0.0f;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        // fibonacci sphere
+        float z = 1.0f - 2.0f * (i + 0.5f) / 1000.0f;
+        float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        math::vec3 n(r * std::cos(i * 2.39996323f), r * std::sin(i * 2.39996323f), z);
+        math::vec3 error = math::shEvaluate(sh, n) - expected(n);
+        maxError = std::max(maxError, std::max(std::abs(error.x), std::max(std::abs(error.y), std::abs(error.z))));
+    }
+    return maxError;
+}
+
+bool SHBasis()
+{
+    bool result = true;
+
+    // the cube faces map their center texels to the faces' axes
+    const math::vec3 axes[6] = { { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+                                 { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+    for (unsigned int face = 0; face < 6; ++face)
+    {
+        if (math::length(math::shCubeDirection(face, 1, 1, 3) - axes[face]) > 1e-6f) result = false;
+    }
+    // (GL convention: +X's top-left texel (s = t = -1) lies towards +Y and +Z)
+    math::vec3 corner = math::shCubeDirection(0, 0, 0, 64);
+    if (corner.y <= 0.0f || corner.z <= 0.0f) result = false;
+
+    // the basis is orthonormal: projecting basis function i results in the i-th unit vector,
+    // regardless of the resolution (and the SIMD path's tail for non-multiples of 4).
+    const unsigned int sizes[2] = { 32, 31 };
+    for (unsigned int size : sizes)
+    {
+        for (int i = 0; i < 9; ++i)
+        {
+            math::sh9 sh = SHProjectFunction([i](const math::vec3& d) {
+                float basis[9];
+                math::shBasis(d, basis);
+                return math::vec3(basis[i], 2.0f * basis[i], 0.0f);
+            }, size);
+            for (int j = 0; j < 9; ++j)
+            {
+                float expected = i == j ? 1.0f : 0.0f;
+                if (std::abs(sh.c[j].x - expected) > 5e-3f || std::abs(sh.c[j].y - 2.0f * expected) > 1e-2f || sh.c[j].z != 0.0f) result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool SHIrradiance()
+{
+    bool result = true;
+
+    // white furnace: constant radiance is reflected unchanged by a white Lambertian surface
+    math::sh9 furnace = math::shConvolveLambert(SHProjectFunction([](const math::vec3&) { return math::vec3(1.0f, 0.5f, 2.0f); }, 16));
+    if (SHMaxError(furnace, [](const math::vec3&) { return math::vec3(1.0f, 0.5f, 2.0f); }) > 1e-3f) result = false;
+
+    // radiance 1 + z: the cosine integral over the hemisphere around n scales the linear band
+    // by 2/3, i.e. 1 + 2/3 n.z
+    math::sh9 linear = math::shConvolveLambert(SHProjectFunction([](const math::vec3& d) { return math::vec3(1.0f + d.z); }, 32));
+    if (SHMaxError(linear, [](const math::vec3& n) { return math::vec3(1.0f + 2.0f / 3.0f * n.z); }) > 2e-3f) result = false;
+
+    // radiance xy lies in band 2, which is scaled by 1/4
+    math::sh9 quadratic = math::shConvolveLambert(SHProjectFunction([](const math::vec3& d) { return math::vec3(d.x * d.y); }, 32));
+    if (SHMaxError(quadratic, [](const math::vec3& n) { return math::vec3(0.25f * n.x * n.y); }) > 2e-3f) result = false;
+
+    // a hemisphere of light (the sky above, black below): the step's higher bands vanish under
+    // the cosine convolution, s.t. the irradiance (1 + n.z) / 2 is still exact.
+    math::sh9 sky = math::shConvolveLambert(SHProjectFunction([](const math::vec3& d) { return math::vec3(d.z > 0.0f ? 1.0f : 0.0f); }, 32));
+    if (SHMaxError(sky, [](const math::vec3& n) { return math::vec3(0.5f + 0.5f * n.z); }) > 2e-3f) result = false;
+
+    // a small light source (cone of 10 degrees around +z) is where L2 approximates: the exact
+    // irradiance is close to the clamped cosine, which L2 reproduces to within ~9% of its peak
+    // (measured 9.3%; most of it around the horizon).
+    const float cosCap = std::cos(10.0f * 3.14159265f / 180.0f);
+    const float peak   = 2.0f * (1.0f - cosCap); // solid angle of the cap / pi
+    math::sh9 sun = math::shConvolveLambert(SHProjectFunction([cosCap](const math::vec3& d) { return math::vec3(d.z > cosCap ? 1.0f : 0.0f); }, 64));
+    if (SHMaxError(sun, [peak](const math::vec3& n) { return math::vec3(peak * std::max(n.z, 0.0f)); }) > 0.12f * peak) result = false;
+
+    // linearity
+    math::sh9 sum = math::shAdd(furnace, math::shScale(linear, 2.0f));
+    math::vec3 n = math::normalize(math::vec3(0.3f, -0.5f, 0.8f));
+    if (math::length(math::shEvaluate(sum, n) - (math::shEvaluate(furnace, n) + math::shEvaluate(linear, n) * 2.0f)) > 1e-5f) result = false;
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef MATH_TRIGONOMETRY_SPHERICAL_HARMONICS_H
+#define MATH_TRIGONOMETRY_SPHERICAL_HARMONICS_H
+
+#include <cmath>
+
+#include "../linear_algebra/vector.h"
+
+// NOTE(Joey): all x64 targets are guaranteed to support SSE2; 32-bit builds fall back to the
+// scalar path unless the compiler tells us otherwise.
+#if defined(_M_X64) || defined(__SSE2__)
+    #define MATH_SH_SSE
+    #include <emmintrin.h>
+#endif
+
+namespace math
+{
+    /* NOTE(Joey):
+
+      Real spherical harmonics up to band 2 (9 coefficients). An RGB function on the sphere
+      (e.g. the radiance arriving at a point) is projected onto the 9 basis functions, after
+      which its convolution w/ the clamped cosine lobe (irradiance; Ramamoorthi and Hanrahan
+      2001) is a per-band scale of its coefficients. L2 is exact for irradiance up to an error
+      of a few percent, for 9 RGB values per probe instead of a convolved cubemap.
+
+      Directions are unit vectors; the basis follows the usual ordering (l, m) = (0, 0),
+      (1, -1), (1, 0), (1, 1), (2, -2), (2, -1), (2, 0), (2, 1), (2, 2).
+
+    */
+    struct sh9
+    {
+        vec3 c[9];
+
+        sh9()
+        {
+            for (int i = 0; i < 9; ++i)
+                c[i] = vec3(0.0f);
+        }
+    };
+
+    inline void shBasis(const vec3& d, float out[9])
+    {
+        out[0] = 0.282095f;
+        out[1] = 0.488603f * d.y;
+        out[2] = 0.488603f * d.z;
+        out[3] = 0.488603f * d.x;
+        out[4] = 1.092548f * d.x * d.y;
+        out[5] = 1.092548f * d.y * d.z;
+        out[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+        out[7] = 1.092548f * d.x * d.z;
+        out[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+    }
+
+    inline vec3 shEvaluate(const sh9& sh, const vec3& d)
+    {
+        float basis[9];
+        shBasis(d, basis);
+        vec3 result(0.0f);
+        for (int i = 0; i < 9; ++i)
+            result = result + sh.c[i] * basis[i];
+        return result;
+    }
+
+    inline sh9 shAdd(const sh9& a, const sh9& b)
+    {
+        sh9 result;
+        for (int i = 0; i < 9; ++i)
+            result.c[i] = a.c[i] + b.c[i];
+        return result;
+    }
+
+    inline sh9 shScale(const sh9& sh, float scale)
+    {
+        sh9 result;
+        for (int i = 0; i < 9; ++i)
+            result.c[i] = sh.c[i] * scale;
+        return result;
+    }
+
+    // NOTE(Joey): convolves projected radiance w/ the clamped cosine lobe, divided by pi: the
+    // result evaluates to the radiance reflected by a white Lambertian surface w/ normal d, s.t.
+    // diffuse lighting is simply albedo * shEvaluate(irradiance, N).
+    inline sh9 shConvolveLambert(const sh9& radiance)
+    {
+        const float band[3] = { 1.0f, 2.0f / 3.0f, 0.25f };
+        sh9 result;
+        for (int i = 0; i < 9; ++i)
+            result.c[i] = radiance.c[i] * band[i == 0 ? 0 : i < 4 ? 1 : 2];
+        return result;
+    }
+
+    // NOTE(Joey): cubemap texel directions
+    // ------------------------------------
+    // NOTE(Joey): each component of a cubemap face's (unnormalized) direction is a*s + b*t + c
+    // w/ s, t in [-1, 1] the face coordinates (texel rows top to bottom, as OpenGL stores them)
+    // and the faces in OpenGL order (+X, -X, +Y, -Y, +Z, -Z).
+    static const float SH_CUBE_FACES[6][3][3] = {
+        { {  0.0f,  0.0f,  1.0f }, { 0.0f, -1.0f,  0.0f }, { -1.0f,  0.0f,  0.0f } },
+        { {  0.0f,  0.0f, -1.0f }, { 0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f } },
+        { {  1.0f,  0.0f,  0.0f }, { 0.0f,  0.0f,  1.0f }, {  0.0f,  1.0f,  0.0f } },
+        { {  1.0f,  0.0f,  0.0f }, { 0.0f,  0.0f, -1.0f }, {  0.0f, -1.0f,  0.0f } },
+        { {  1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, {  0.0f,  0.0f,  1.0f } },
+        { { -1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } },
+    };
+
+    // the (unit) direction through the center of texel (x, y) of a cubemap face
+    inline vec3 shCubeDirection(unsigned int face, unsigned int x, unsigned int y, unsigned int size)
+    {
+        const float s = 2.0f * (x + 0.5f) / size - 1.0f;
+        const float t = 2.0f * (y + 0.5f) / size - 1.0f;
+        const float (*f)[3] = SH_CUBE_FACES[face];
+        vec3 d(f[0][0] * s + f[0][1] * t + f[0][2],
+               f[1][0] * s + f[1][1] * t + f[1][2],
+               f[2][0] * s + f[2][1] * t + f[2][2]);
+        return d / std::sqrt(1.0f + s * s + t * t);
+    }
+
+    // NOTE(Joey): projects a cubemap of radiance (6 faces of size^2 texels w/ channels floats
+    // each, of which the first 3 are RGB) onto the SH basis. Each texel is weighted by the solid
+    // angle it subtends, s.t. the result is independent of the cubemap's resolution; the weights
+    // are normalized to sum to 4 pi. With SSE 4 texels of a row are projected at a time.
+    inline sh9 shProjectCube(const float* const faces[6], unsigned int size, unsigned int channels)
+    {
+        float acc[27] = { 0.0f }; // 9 coefficients x RGB
+        float weightSum = 0.0f;
+        const float texel = 2.0f / size;
+
+        for (unsigned int face = 0; face < 6; ++face)
+        {
+            const float (*f)[3] = SH_CUBE_FACES[face];
+            for (unsigned int y = 0; y < size; ++y)
+            {
+                const float  t   = (y + 0.5f) * texel - 1.0f;
+                const float* row = faces[face] + (std::size_t)y * size * channels;
+                unsigned int x = 0;
+#ifdef MATH_SH_SSE
+                if (size >= 4)
+                {
+                    const __m128 one = _mm_set1_ps(1.0f);
+                    __m128 vAcc[27];
+                    for (int i = 0; i < 27; ++i)
+                        vAcc[i] = _mm_setzero_ps();
+                    __m128 vWeight = _mm_setzero_ps();
+                    const __m128 vT = _mm_set1_ps(t);
+                    const __m128 vX0 = _mm_set1_ps(f[0][1] * t + f[0][2]), vXs = _mm_set1_ps(f[0][0]);
+                    const __m128 vY0 = _mm_set1_ps(f[1][1] * t + f[1][2]), vYs = _mm_set1_ps(f[1][0]);
+                    const __m128 vZ0 = _mm_set1_ps(f[2][1] * t + f[2][2]), vZs = _mm_set1_ps(f[2][0]);
+                    for (; x + 4 <= size; x += 4)
+                    {
+                        const __m128 s = _mm_sub_ps(_mm_mul_ps(_mm_set_ps(x + 3.5f, x + 2.5f, x + 1.5f, x + 0.5f), _mm_set1_ps(texel)), one);
+                        // 1 / |(s, t, 1)|, the normalization and (cubed) the solid angle weight
+                        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s, s), _mm_mul_ps(vT, vT)), one);
+                        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+                        __m128 weight = _mm_mul_ps(invLength, _mm_mul_ps(invLength, invLength));
+                        __m128 dx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(vXs, s), vX0), invLength);
+                        __m128 dy = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(vYs, s), vY0), invLength);
+                        __m128 dz = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(vZs, s), vZ0), invLength);
+
+                        __m128 basis[9];
+                        basis[0] = _mm_set1_ps(0.282095f);
+                        basis[1] = _mm_mul_ps(_mm_set1_ps(0.488603f), dy);
+                        basis[2] = _mm_mul_ps(_mm_set1_ps(0.488603f), dz);
+                        basis[3] = _mm_mul_ps(_mm_set1_ps(0.488603f), dx);
+                        basis[4] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dx, dy));
+                        basis[5] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dy, dz));
+                        basis[6] = _mm_mul_ps(_mm_set1_ps(0.315392f), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(dz, dz)), one));
+                        basis[7] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dx, dz));
+                        basis[8] = _mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+                        const float* p = row + x * channels;
+                        const __m128 r = _mm_mul_ps(weight, _mm_set_ps(p[3 * channels + 0], p[2 * channels + 0], p[channels + 0], p[0]));
+                        const __m128 g = _mm_mul_ps(weight, _mm_set_ps(p[3 * channels + 1], p[2 * channels + 1], p[channels + 1], p[1]));
+                        const __m128 b = _mm_mul_ps(weight, _mm_set_ps(p[3 * channels + 2], p[2 * channels + 2], p[channels + 2], p[2]));
+                        for (int i = 0; i < 9; ++i)
+                        {
+                            vAcc[i * 3 + 0] = _mm_add_ps(vAcc[i * 3 + 0], _mm_mul_ps(basis[i], r));
+                            vAcc[i * 3 + 1] = _mm_add_ps(vAcc[i * 3 + 1], _mm_mul_ps(basis[i], g));
+                            vAcc[i * 3 + 2] = _mm_add_ps(vAcc[i * 3 + 2], _mm_mul_ps(basis[i], b));
+                        }
+                        vWeight = _mm_add_ps(vWeight, weight);
+                    }
+                    // horizontal sums of this row's lanes
+                    float lanes[4];
+                    for (int i = 0; i < 27; ++i)
+                    {
+                        _mm_storeu_ps(lanes, vAcc[i]);
+                        acc[i] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                    }
+                    _mm_storeu_ps(lanes, vWeight);
+                    weightSum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                }
+#endif
+                for (; x < size; ++x)
+                {
+                    const float s = (x + 0.5f) * texel - 1.0f;
+                    const float invLength = 1.0f / std::sqrt(1.0f + s * s + t * t);
+                    const float weight = invLength * invLength * invLength;
+                    vec3 d(f[0][0] * s + f[0][1] * t + f[0][2],
+                           f[1][0] * s + f[1][1] * t + f[1][2],
+                           f[2][0] * s + f[2][1] * t + f[2][2]);
+                    float basis[9];
+                    shBasis(d * invLength, basis);
+                    const float* p = row + x * channels;
+                    for (int i = 0; i < 9; ++i)
+                    {
+                        acc[i * 3 + 0] += basis[i] * weight * p[0];
+                        acc[i * 3 + 1] += basis[i] * weight * p[1];
+                        acc[i * 3 + 2] += basis[i] * weight * p[2];
+                    }
+                    weightSum += weight;
+                }
+            }
+        }
+
+        sh9 result;
+        const float normalization = weightSum > 0.0f ? 4.0f * 3.14159265f / weightSum : 0.0f;
+        for (int i = 0; i < 9; ++i)
+            result.c[i] = vec3(acc[i * 3 + 0], acc[i * 3 + 1], acc[i * 3 + 2]) * normalization;
+        return result;
+    }
+} // namespace math
+
+#endif
@@ -0,0 +1,50 @@
+#include <iostream>
+
+#include "test_random.h"
+#include "test_flat_hash_map.h"
+#include "test_texture_decode.h"
+#include "test_mesh_cache.h"
+#include "test_mesh_optimizer.h"
+#include "test_marching_cubes.h"
+
+// NOTE(Joey): tests and benchmarks of the utility and cell libraries that run w/o a window or
+// GL context; the math library's tests live in the math project. Expects to be run from the
+// build directory (for the assets of the resource loading benchmarks).
+
+bool TEST_SUCCESS = true;
+#define TEST(name) \
+	if (name()) { std::cout << "|O| SUCCESS: "#name << std::endl; }                       \
+	else {        std::cout << "|X|  FAILED: "#name << std::endl; TEST_SUCCESS = false; } \
+
+int main(int argc, int *argv[])
+{
+    // run random number generation tests
+    TEST(RandomSeries);
+    TEST(RandomStatistics);
+    TEST(RandomFill);
+    TEST(RandomBenchmark);
+
+    // run container tests
+    TEST(FlatHashMapOperations);
+    TEST(FlatHashMapBenchmark);
+
+    // run mesh optimization tests
+    TEST(MeshOptimizerCacheSimulation);
+    TEST(MeshOptimizerVertexCache);
+    TEST(MeshOptimizerDeduplicate);
+    TEST(MarchingCubesBenchmark);
+
+    // run resource loading benchmarks
+    TEST(TextureDecodeBenchmark);
+    TEST(MeshCacheBenchmark);
+
+	std::cout << std::endl;
+	if (TEST_SUCCESS)
+		std::cout << "|O| Tests succesfully completed." << std::endl;
+	else
+		std::cout << "|X| Tests did not all complete succesfully, re-validate code." << std::endl;
+
+	int c;
+	std::cin >> c;
+	return 1;
+}
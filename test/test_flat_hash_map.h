@@ -0,0 +1,160 @@
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <utility/container/flat_hash_map.h>
+#include <utility/string_id.h>
+
+// NOTE(Joey): stands in for a registry entry (e.g. a Texture); 64 bytes.
+struct FlatHashMapResource
+{
+    StringID Id;
+    u32      Data[15];
+};
+
+// NOTE(Joey): maps all keys to the same slot, s.t. every key is part of one long cluster.
+struct FlatHashMapCollide
+{
+    std::size_t operator()(u32) const { return 0; }
+};
+
+// NOTE(Joey): the string IDs of count resource paths, hashed as Resources does.
+static std::vector<StringID> FlatHashMapKeys(unsigned int count)
+{
+    std::vector<StringID> keys(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        std::string path = "textures/resource_" + std::to_string(i) + ".png";
+        keys[i] = string_id_fnv1a(path.c_str(), path.size());
+    }
+    return keys;
+}
+
+bool FlatHashMapOperations()
+{
+    bool result = true;
+
+    const unsigned int count = 10000;
+    std::vector<StringID> keys = FlatHashMapKeys(count);
+    FlatHashMap<StringID, FlatHashMapResource> map;
+    std::vector<FlatHashMapResource*> pointers(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        FlatHashMapResource resource = { keys[i], {} };
+        resource.Data[0] = i;
+        pointers[i] = map.Insert(keys[i], resource);
+    }
+    if (map.Size() != count) result = false;
+
+    // values never move while the table grows
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        FlatHashMapResource* resource = map.Find(keys[i]);
+        if (resource != pointers[i] || resource->Id != keys[i] || resource->Data[0] != i) result = false;
+    }
+    if (map.Find(string_id_fnv1a("missing", 7)) != nullptr) result = false;
+
+    // overwriting keeps the value's address
+    FlatHashMapResource replacement = { keys[7], {} };
+    replacement.Data[0] = 12345;
+    if (map.Insert(keys[7], replacement) != pointers[7] || pointers[7]->Data[0] != 12345 || map.Size() != count) result = false;
+
+    // erase every 3rd key; backward-shift deletion keeps all other keys reachable
+    for (unsigned int i = 0; i < count; i += 3)
+        if (!map.Erase(keys[i])) result = false;
+    if (map.Erase(keys[0])) result = false;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        FlatHashMapResource* resource = map.Find(keys[i]);
+        if (i % 3 == 0 ? resource != nullptr : resource != pointers[i]) result = false;
+    }
+    unsigned int visited = 0;
+    map.ForEach([&](const StringID& key, FlatHashMapResource& value) { if (key == value.Id) ++visited; });
+    if (visited != map.Size() || map.Size() != count - (count + 2) / 3) result = false;
+
+    // erased value slots are recycled
+    FlatHashMapResource reinserted = { keys[0], {} };
+    FlatHashMapResource* recycled = map.Insert(keys[0], reinserted);
+    if (std::find(pointers.begin(), pointers.end(), recycled) == pointers.end()) result = false;
+
+    // colliding keys: erasing from the middle of a cluster shifts the rest of it back
+    FlatHashMap<u32, u32, FlatHashMapCollide> collisions;
+    for (u32 i = 0; i < 64; ++i)
+        collisions.Insert(i, i);
+    for (u32 i = 0; i < 64; i += 2)
+        collisions.Erase(i);
+    for (u32 i = 0; i < 64; ++i)
+    {
+        u32* value = collisions.Find(i);
+        if (i % 2 == 0 ? value != nullptr : (value == nullptr || *value != i)) result = false;
+    }
+
+    map.Clear();
+    if (map.Size() != 0 || map.Find(keys[1]) != nullptr) result = false;
+
+    return result;
+}
+
+// NOTE(Joey): not a correctness test, but reports the cost of looking up 100k resources by
+// string ID in random order in the FlatHashMap versus the std::map the registries used before
+// (and std::unordered_map).
+bool FlatHashMapBenchmark()
+{
+    const unsigned int count = 100000;
+    const unsigned int lookups = 1000000;
+    std::vector<StringID> keys = FlatHashMapKeys(count);
+
+    std::vector<StringID> order(lookups);
+    u32 state = 1;
+    for (unsigned int i = 0; i < lookups; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        order[i] = keys[(state >> 8) % count];
+    }
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start, unsigned int n)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / n;
+    };
+
+    FlatHashMap<StringID, FlatHashMapResource>          flat;
+    std::map<StringID, FlatHashMapResource>             ordered;
+    std::unordered_map<StringID, FlatHashMapResource>   unordered;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (StringID key : keys) { FlatHashMapResource r = { key, {} }; flat.Insert(key, r); }
+    double flatInsert = time(start, count);
+    start = std::chrono::high_resolution_clock::now();
+    for (StringID key : keys) { FlatHashMapResource r = { key, {} }; ordered[key] = r; }
+    double orderedInsert = time(start, count);
+    start = std::chrono::high_resolution_clock::now();
+    for (StringID key : keys) { FlatHashMapResource r = { key, {} }; unordered[key] = r; }
+    double unorderedInsert = time(start, count);
+
+    // the sum of the found IDs keeps the lookups from being optimized away
+    u64 flatSum = 0, orderedSum = 0, unorderedSum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (StringID key : order) flatSum += flat.Find(key)->Id;
+    double flatFind = time(start, lookups);
+    start = std::chrono::high_resolution_clock::now();
+    for (StringID key : order) orderedSum += ordered.find(key)->second.Id;
+    double orderedFind = time(start, lookups);
+    start = std::chrono::high_resolution_clock::now();
+    for (StringID key : order) unorderedSum += unordered.find(key)->second.Id;
+    double unorderedFind = time(start, lookups);
+
+    std::cout << "    100k resources - find: FlatHashMap " << flatFind << " ns | std::map " << orderedFind << " ns | std::unordered_map "
+              << unorderedFind << " ns" << std::endl;
+    std::cout << "    100k resources - insert: FlatHashMap " << flatInsert << " ns | std::map " << orderedInsert << " ns | std::unordered_map "
+              << unorderedInsert << " ns" << std::endl;
+
+    return flat.Size() == ordered.size() && flatSum == orderedSum && flatSum == unorderedSum;
+}
+
+#endif
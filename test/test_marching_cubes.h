@@ -0,0 +1,91 @@
+#ifndef TEST_MARCHING_CUBES_H
+#define TEST_MARCHING_CUBES_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <cell/mesh/marching_cubes.h>
+#include <utility/threading/thread_pool.h>
+
+using Cell::MarchingCubes;
+
+// NOTE(Joey): not a correctness test, but reports the cost of polygonizing a sphere (radius
+// 0.8 within [-1, 1]^3) at 64^3, 128^3 and 256^3 cells: single threaded, on a ThreadPool and
+// w/ the sparse polygonizer, next to the number of SDF evaluations each needs. The naive
+// column samples all 8 corners of every cell w/o polygonizing, i.e. a lower bound of what
+// Mesh::FromSDF cost before it moved to MarchingCubes. Also checks that all variants produce
+// the same number of triangles.
+bool MarchingCubesBenchmark()
+{
+    bool result = true;
+
+    std::atomic<unsigned long long> evaluations(0);
+    Cell::SDFBatch sphere = [&](const math::vec3* points, float* distances, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            distances[i] = std::sqrt(points[i].x * points[i].x + points[i].y * points[i].y + points[i].z * points[i].z) - 0.8f;
+        evaluations += count;
+    };
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    ThreadPool pool;
+    const unsigned int resolutions[] = { 64, 128, 256 };
+    for (unsigned int resolution : resolutions)
+    {
+        std::vector<math::vec3>   positions;
+        std::vector<unsigned int> indices;
+
+        // naive: 8 evaluations per cell, one cell at a time
+        evaluations = 0;
+        const float step = 2.0f / resolution;
+        auto start = std::chrono::high_resolution_clock::now();
+        float inside = 0.0f;
+        math::vec3 corners[8];
+        float distances[8];
+        for (unsigned int z = 0; z < resolution; ++z)
+            for (unsigned int y = 0; y < resolution; ++y)
+                for (unsigned int x = 0; x < resolution; ++x)
+                {
+                    for (unsigned int c = 0; c < 8; ++c)
+                        corners[c] = math::vec3(-1.0f + (x + (c & 1)) * step, -1.0f + (y + ((c >> 1) & 1)) * step, -1.0f + (z + (c >> 2)) * step);
+                    sphere(corners, distances, 8);
+                    inside += distances[0] < 0.0f ? 1.0f : 0.0f;
+                }
+        double naive = time(start);
+        unsigned long long naiveEvaluations = evaluations;
+
+        evaluations = 0;
+        start = std::chrono::high_resolution_clock::now();
+        MarchingCubes::Polygonize(sphere, 1.0f, resolution, positions, indices);
+        double serial = time(start);
+        unsigned long long denseEvaluations = evaluations;
+        size_t triangles = indices.size() / 3;
+
+        start = std::chrono::high_resolution_clock::now();
+        MarchingCubes::Polygonize(sphere, 1.0f, resolution, positions, indices, &pool);
+        double parallel = time(start);
+        if (indices.size() / 3 != triangles) result = false;
+
+        evaluations = 0;
+        start = std::chrono::high_resolution_clock::now();
+        unsigned int bricks = MarchingCubes::PolygonizeSparse(sphere, 1.0f, resolution, positions, indices, &pool);
+        double sparse = time(start);
+        unsigned long long sparseEvaluations = evaluations;
+        if (indices.size() / 3 != triangles || inside <= 0.0f) result = false;
+
+        std::cout << "    " << resolution << "^3 (" << triangles / 1000 << "k triangles) - naive: " << naive << " ms, "
+                  << naiveEvaluations / 1000000.0 << "M evals | Polygonize: " << serial << " ms, " << denseEvaluations / 1000000.0
+                  << "M evals | ThreadPool (" << pool.GetThreadCount() << " workers + caller): " << parallel << " ms | sparse: " << sparse
+                  << " ms, " << sparseEvaluations / 1000000.0 << "M evals, " << bricks << " bricks" << std::endl;
+    }
+
+    return result;
+}
+
+#endif
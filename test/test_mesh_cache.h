@@ -0,0 +1,63 @@
+#ifndef TEST_MESH_CACHE_H
+#define TEST_MESH_CACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <cell/resources/mesh_loader.h>
+#include <utility/io/mapped_file.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+// NOTE(Joey): not a correctness test, but reports the cost of loading Sponza by importing it
+// with Assimp (ReadFile alone, w/o any of our conversion stages) versus memory mapping and
+// validating the mesh cache MeshLoader writes for it: the part of a cached load that precedes
+// the GPU upload. Sponza is baked first, s.t. both read their file from a warm OS file cache.
+// Skipped if the Sponza assets aren't present.
+bool MeshCacheBenchmark()
+{
+    const std::string path = "meshes/sponza/sponza.obj";
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    u64 sourceTime, sourceSize;
+    if (!FileInfo(path, sourceTime, sourceSize))
+    {
+        std::cout << "    skipped: " << path << " not found." << std::endl;
+        return true;
+    }
+    if (!Cell::MeshLoader::BakeCache(path))
+        return false;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, Cell::MeshLoader::ImportFlags);
+    double import = time(start);
+    if (!scene || !scene->mRootNode)
+        return false;
+
+    // mapping is cheap enough to be dominated by noise; take the best of several runs.
+    const unsigned int runs = 16;
+    double map = 1e9;
+    u64 cacheSize = 0;
+    for (unsigned int i = 0; i < runs; ++i)
+    {
+        MappedFile file;
+        start = std::chrono::high_resolution_clock::now();
+        if (!Cell::MeshLoader::MapCache(path, file))
+            return false;
+        map = std::min(map, time(start));
+        cacheSize = file.Size();
+    }
+
+    std::cout << "    sponza (" << scene->mNumMeshes << " meshes) - Assimp ReadFile: " << import << " ms | map + validate cache ("
+              << cacheSize / (1024 * 1024) << " MB): " << map << " ms" << std::endl;
+    return true;
+}
+
+#endif
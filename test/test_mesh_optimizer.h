@@ -0,0 +1,189 @@
+#ifndef TEST_MESH_OPTIMIZER_H
+#define TEST_MESH_OPTIMIZER_H
+
+#include <algorithm>
+#include <vector>
+
+#include <cell/mesh/mesh.h>
+#include <cell/mesh/mesh_optimizer.h>
+
+using Cell::Mesh;
+using Cell::MeshOptimizer;
+
+// NOTE(Joey): a flat (size x size) vertex grid w/ its triangles in a pseudo-random order, as
+// exported meshes often come w/o any regard for the vertex cache.
+static void MeshOptimizerGrid(unsigned int size, std::vector<math::vec3>& positions, std::vector<unsigned int>& indices)
+{
+    positions.clear();
+    indices.clear();
+    for (unsigned int y = 0; y < size; ++y)
+        for (unsigned int x = 0; x < size; ++x)
+            positions.push_back(math::vec3((float)x, 0.0f, (float)y));
+    std::vector<unsigned int> triangles;
+    for (unsigned int y = 0; y < size - 1; ++y)
+    {
+        for (unsigned int x = 0; x < size - 1; ++x)
+        {
+            unsigned int a = y * size + x, b = a + 1, c = a + size, d = c + 1;
+            unsigned int quad[6] = { a, c, b, b, c, d };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+    unsigned int triangleCount = (unsigned int)triangles.size() / 3;
+    unsigned int state = 1;
+    std::vector<unsigned int> order(triangleCount);
+    for (unsigned int i = 0; i < triangleCount; ++i)
+        order[i] = i;
+    for (unsigned int i = triangleCount - 1; i > 0; --i)
+    {
+        state = state * 1664525u + 1013904223u;
+        std::swap(order[i], order[(state >> 8) % (i + 1)]);
+    }
+    for (unsigned int i = 0; i < triangleCount; ++i)
+        indices.insert(indices.end(), triangles.begin() + order[i] * 3, triangles.begin() + order[i] * 3 + 3);
+}
+
+// NOTE(Joey): the triangles of an index buffer, each rotated to start at its smallest index
+// (keeping its winding) and sorted; equal iff both index buffers hold the same triangles.
+static std::vector<unsigned int> MeshOptimizerTriangles(const std::vector<unsigned int>& indices)
+{
+    std::vector<std::vector<unsigned int>> triangles;
+    for (unsigned int i = 0; i < indices.size(); i += 3)
+    {
+        std::vector<unsigned int> triangle(indices.begin() + i, indices.begin() + i + 3);
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    std::vector<unsigned int> result;
+    for (const std::vector<unsigned int>& triangle : triangles)
+        result.insert(result.end(), triangle.begin(), triangle.end());
+    return result;
+}
+
+static bool MeshOptimizerEqual(const math::vec3& a, const math::vec3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool MeshOptimizerCacheSimulation()
+{
+    bool result = true;
+
+    // a single triangle misses on all of its vertices
+    MeshOptimizer::CacheStatistics stats = MeshOptimizer::AnalyzeVertexCache({ 0, 1, 2 }, 3);
+    if (stats.Triangles != 1 || stats.Vertices != 3 || stats.Misses != 3 || stats.ACMR != 3.0f || stats.ATVR != 1.0f) result = false;
+
+    // triangles sharing an edge only miss on the new vertex
+    stats = MeshOptimizer::AnalyzeVertexCache({ 0, 1, 2, 2, 1, 3 }, 4);
+    if (stats.Triangles != 2 || stats.Vertices != 4 || stats.Misses != 4 || stats.ACMR != 2.0f || stats.ATVR != 1.0f) result = false;
+
+    // the FIFO evicts the oldest vertices once more than cacheSize vertices were transformed
+    std::vector<unsigned int> revisit = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    stats = MeshOptimizer::AnalyzeVertexCache(revisit, 6, 3);
+    if (stats.Misses != 9 || stats.ATVR != 1.5f) result = false;
+    stats = MeshOptimizer::AnalyzeVertexCache(revisit, 6, 6);
+    if (stats.Misses != 6 || stats.ATVR != 1.0f) result = false;
+
+    return result;
+}
+
+bool MeshOptimizerVertexCache()
+{
+    bool result = true;
+
+    std::vector<math::vec3>   positions;
+    std::vector<unsigned int> indices;
+    MeshOptimizerGrid(64, positions, indices);
+    const unsigned int vertexCount = (unsigned int)positions.size();
+    std::vector<unsigned int> triangles = MeshOptimizerTriangles(indices);
+
+    // Tipsify brings a shuffled grid's ACMR (close to 3) down towards its ideal of ~0.5
+    MeshOptimizer::CacheStatistics before = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+    MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+    MeshOptimizer::CacheStatistics after = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+    if (after.ACMR >= before.ACMR || after.ACMR > 0.8f || before.ACMR < 2.0f) result = false;
+    if (MeshOptimizerTriangles(indices) != triangles) result = false;
+
+    // overdraw ordering trades at most threshold times the cache efficiency
+    MeshOptimizer::OptimizeOverdraw(indices, positions, 1.05f);
+    MeshOptimizer::CacheStatistics overdraw = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+    if (overdraw.ACMR > after.ACMR * 1.05f + 1e-4f) result = false;
+    if (MeshOptimizerTriangles(indices) != triangles) result = false;
+
+    return result;
+}
+
+bool MeshOptimizerDeduplicate()
+{
+    bool result = true;
+
+    // an unindexed triangle soup (as Mesh::FromSDF used to emit) of the grid
+    std::vector<math::vec3>   grid;
+    std::vector<unsigned int> gridIndices;
+    MeshOptimizerGrid(32, grid, gridIndices);
+    Mesh soup;
+    for (unsigned int index : gridIndices)
+    {
+        soup.Positions.push_back(grid[index]);
+        soup.UV.push_back(math::vec2(grid[index].x, grid[index].z));
+        soup.Normals.push_back(math::vec3(0.0f, 1.0f, 0.0f));
+    }
+    std::vector<math::vec3> soupPositions = soup.Positions;
+    unsigned int unique = MeshOptimizer::DeduplicateVertices(&soup);
+    if (unique != grid.size() || soup.Positions.size() != unique || soup.UV.size() != unique || soup.Normals.size() != unique) result = false;
+    if (soup.Indices.size() != soupPositions.size()) result = false;
+    for (unsigned int i = 0; i < soup.Indices.size(); ++i)
+    {
+        if (soup.Indices[i] >= unique || !MeshOptimizerEqual(soup.Positions[soup.Indices[i]], soupPositions[i]))
+        {
+            result = false;
+            break;
+        }
+    }
+
+    // tangents and bitangents are each keyed and remapped on their own; vertices that only
+    // differ in their tangent stay apart
+    for (int attribute = 0; attribute < 2; ++attribute)
+    {
+        Mesh mesh;
+        std::vector<math::vec3> directions;
+        for (unsigned int i = 0; i < 12; ++i)
+        {
+            mesh.Positions.push_back(math::vec3((float)(i % 3), 0.0f, 0.0f));
+            directions.push_back(math::vec3(i % 6 < 3 ? 1.0f : -1.0f, 0.0f, 0.0f));
+        }
+        std::vector<math::vec3>& tangents = attribute == 0 ? mesh.Tangents : mesh.Bitangents;
+        tangents = directions;
+        unique = MeshOptimizer::DeduplicateVertices(&mesh);
+        if (unique != 6 || mesh.Positions.size() != 6 || tangents.size() != 6) result = false;
+        if (!(attribute == 0 ? mesh.Bitangents : mesh.Tangents).empty()) result = false;
+        for (unsigned int i = 0; i < mesh.Indices.size(); ++i)
+        {
+            if (mesh.Indices[i] >= unique || !MeshOptimizerEqual(tangents[mesh.Indices[i]], directions[i]) ||
+                !MeshOptimizerEqual(mesh.Positions[mesh.Indices[i]], math::vec3((float)(i % 3), 0.0f, 0.0f)))
+                result = false;
+        }
+    }
+
+    // the full pipeline on the soup: valid indices, the same triangles and a better ACMR
+    Mesh mesh;
+    for (unsigned int index : gridIndices)
+        mesh.Positions.push_back(grid[index]);
+    MeshOptimizer::CacheStatistics before, after;
+    MeshOptimizer::Optimize(&mesh, &before, &after);
+    if (before.ACMR != 3.0f || after.ACMR > 0.8f || mesh.Indices.size() != gridIndices.size()) result = false;
+    std::vector<unsigned int> optimized;
+    for (unsigned int i = 0; i < mesh.Indices.size(); ++i)
+    {
+        if (mesh.Indices[i] >= mesh.Positions.size())
+            return false;
+        const math::vec3& p = mesh.Positions[mesh.Indices[i]];
+        optimized.push_back((unsigned int)p.z * 32 + (unsigned int)p.x);
+    }
+    if (MeshOptimizerTriangles(optimized) != MeshOptimizerTriangles(gridIndices)) result = false;
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef TEST_RANDOM_H
+#define TEST_RANDOM_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <utility/random/random.h>
+
+// NOTE(Joey): chi-squared statistic of bucket counts w.r.t. a uniform distribution.
+static double RandomChiSquared(const std::vector<unsigned int>& buckets, unsigned int samples)
+{
+    double expected = (double)samples / buckets.size();
+    double chi2 = 0.0;
+    for (unsigned int count : buckets)
+        chi2 += (count - expected) * (count - expected) / expected;
+    return chi2;
+}
+
+// NOTE(Joey): mean, variance and bucket uniformity of uniform [0, 1) floats; the chi-squared
+// bound is the 99.9th percentile for 63 degrees of freedom.
+static bool RandomUniform(const std::vector<float>& values)
+{
+    bool result = true;
+    std::vector<unsigned int> buckets(64, 0);
+    double mean = 0.0, m2 = 0.0;
+    for (float v : values)
+    {
+        if (v < 0.0f || v >= 1.0f) result = false;
+        buckets[std::min((unsigned int)(v * 64.0f), 63u)]++;
+        mean += v;
+        m2   += (double)v * v;
+    }
+    mean /= values.size();
+    double variance = m2 / values.size() - mean * mean;
+    if (std::abs(mean - 0.5) > 0.002) result = false;
+    if (std::abs(variance - 1.0 / 12.0) > 0.001) result = false;
+    if (RandomChiSquared(buckets, (unsigned int)values.size()) > 103.4) result = false;
+    return result;
+}
+
+bool RandomSeries()
+{
+    bool result = true;
+
+    // xoshiro128** reference output and jump for the state (1, 2, 3, 4)
+    Random::Series series = { { 1, 2, 3, 4 } };
+    const u32 reference[] = { 0x2d00, 0x0, 0x5a7080, 0x4389d80 };
+    for (u32 value : reference)
+        if (Random::NextUInt(&series) != value) result = false;
+    series = { { 1, 2, 3, 4 } };
+    Random::Jump(&series);
+    if (series.State[0] != 0xa9765206 || series.State[1] != 0x797aa168 || series.State[2] != 0x5b62e331 || series.State[3] != 0x2abd971)
+        result = false;
+
+    // seeding is deterministic; split streams start at the series' position before the jump
+    Random::Series a = Random::Seed(42), b = Random::Seed(42), c = Random::Seed(43);
+    bool different = false;
+    for (int i = 0; i < 1000; ++i)
+    {
+        u32 va = Random::NextUInt(&a);
+        if (va != Random::NextUInt(&b)) result = false;
+        if (va != Random::NextUInt(&c)) different = true;
+    }
+    if (!different) result = false;
+    Random::Series parent = Random::Seed(7), copy = parent;
+    Random::Series child = Random::Split(&parent);
+    Random::Jump(&copy);
+    for (int i = 0; i < 4; ++i)
+        if (parent.State[i] != copy.State[i]) result = false;
+    if (Random::NextUInt(&child) == Random::NextUInt(&parent)) result = false;
+
+    // each thread's global series is its own stream
+    u32 mainState = Random::GlobalSeries.State[0], threadState = mainState;
+    std::thread thread([&]() { threadState = Random::GlobalSeries.State[0]; });
+    thread.join();
+    if (threadState == mainState) result = false;
+
+    // value ranges
+    Random::Series s = Random::Seed(1);
+    int hits[2] = { 0, 0 };
+    for (int i = 0; i < 100000; ++i)
+    {
+        float f = Random::Biliteral(&s);
+        if (f < -1.0f || f >= 1.0f) result = false;
+        int n = Random::RandomBetween(-3, 3, &s);
+        if (n < -3 || n > 3) result = false;
+        if (n == -3) hits[0]++;
+        if (n ==  3) hits[1]++;
+        float r = Random::RandomBetween(2.0f, 4.0f, &s);
+        if (r < 2.0f || r > 4.0f) result = false;
+    }
+    if (hits[0] == 0 || hits[1] == 0) result = false; // both bounds are inclusive
+
+    return result;
+}
+
+bool RandomStatistics()
+{
+    bool result = true;
+    const unsigned int samples = 1 << 20;
+
+    Random::Series series = Random::Seed(1337);
+    std::vector<float> values(samples);
+    for (float& v : values)
+        v = Random::Uniliteral(&series);
+    if (!RandomUniform(values)) result = false;
+
+    // Choice: unbiased for counts that don't divide 2^32 (the chi-squared bound is the 99.9th
+    // percentile for 9 degrees of freedom)
+    std::vector<unsigned int> choices(10, 0);
+    for (unsigned int i = 0; i < samples; ++i)
+    {
+        unsigned int c = Random::Choice(10, &series);
+        if (c >= 10) result = false;
+        else         choices[c]++;
+    }
+    if (RandomChiSquared(choices, samples) > 27.9) result = false;
+
+    // consecutive values are uncorrelated
+    double correlation = 0.0;
+    for (unsigned int i = 1; i < samples; ++i)
+        correlation += (values[i] - 0.5) * (values[i - 1] - 0.5);
+    correlation /= (samples - 1) / 12.0;
+    if (std::abs(correlation) > 0.005) result = false;
+
+    return result;
+}
+
+bool RandomFill()
+{
+    bool result = true;
+
+    // Fill takes value i from the (i % 4)th of 4 successively jumped copies of the series and
+    // continues the series from the first; check w/ a multiple of the SIMD width and w/ a tail.
+    const std::size_t counts[] = { 4096, 1027, 3 };
+    for (std::size_t count : counts)
+    {
+        Random::Series series = Random::Seed(99);
+        Random::Series lanes[4];
+        lanes[0] = series;
+        for (int l = 1; l < 4; ++l)
+        {
+            lanes[l] = lanes[l - 1];
+            Random::Jump(&lanes[l]);
+        }
+        std::vector<float> values(count);
+        Random::Fill(&values[0], count, &series);
+        for (std::size_t i = 0; i < count; ++i)
+            if (values[i] != Random::Uniliteral(&lanes[i % 4])) result = false;
+        for (int i = 0; i < 4; ++i)
+            if (series.State[i] != lanes[0].State[i]) result = false;
+    }
+
+    Random::Series series = Random::Seed(2017);
+    std::vector<float> values(1 << 20);
+    Random::Fill(&values[0], values.size(), &series);
+    if (!RandomUniform(values)) result = false;
+
+    return result;
+}
+
+// NOTE(Joey): not a correctness test, but reports the throughput of uniform float generation:
+// per call, in bulk (Fill) and w/ the standard library's generators.
+bool RandomBenchmark()
+{
+    const std::size_t count = 1 << 24;
+    std::vector<float> values(count);
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / (1 << 24);
+    };
+
+    Random::Series series = Random::Seed(1);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = Random::Uniliteral(&series);
+    double uniliteral = time(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    Random::Fill(&values[0], count, &series);
+    double fill = time(start);
+
+    std::mt19937 mersenne(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = distribution(mersenne);
+    double mt = time(start);
+
+    std::default_random_engine engine(1);
+    start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        values[i] = distribution(engine);
+    double defaultEngine = time(start);
+
+    std::cout << "    16M floats - Uniliteral: " << uniliteral << " ns | Fill: " << fill << " ns | std::mt19937: " << mt
+              << " ns | std::default_random_engine: " << defaultEngine << " ns (per value)" << std::endl;
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef TEST_TEXTURE_DECODE_H
+#define TEST_TEXTURE_DECODE_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cell/resources/texture_loader.h>
+#include <utility/threading/thread_pool.h>
+
+// NOTE(Joey): the unique texture files referenced by a Wavefront material file (relative to the
+// material file's directory, as MeshLoader resolves them).
+static std::vector<std::string> TextureDecodeMaterialTextures(const std::string& mtlPath)
+{
+    std::vector<std::string> paths;
+    std::ifstream file(mtlPath);
+    std::string directory = mtlPath.substr(0, mtlPath.find_last_of('/') + 1);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream tokens(line);
+        std::string keyword, name;
+        tokens >> keyword;
+        if (keyword.compare(0, 4, "map_") != 0 && keyword != "bump" && keyword != "norm")
+            continue;
+        while (tokens >> name) { } // the file name is the last token (options precede it)
+        if (!name.empty())
+            paths.push_back(directory + name);
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+// NOTE(Joey): not a correctness test, but a headless measure of the CPU side of Sponza's cold
+// start: decoding all of its material textures w/ TextureLoader::DecodeTexture, one after
+// another (as the synchronous loader did) and spread over a ThreadPool (as TextureStreamer
+// does). The GPU uploads aren't included; TextureStreamer logs those at runtime. Expects to be
+// run from the build directory; skipped if the Sponza assets aren't there.
+bool TextureDecodeBenchmark()
+{
+    std::vector<std::string> referenced = TextureDecodeMaterialTextures("meshes/sponza/sponza.mtl");
+    if (referenced.empty())
+    {
+        std::cout << "    Sponza textures - skipped: meshes/sponza/sponza.mtl not found" << std::endl;
+        return true;
+    }
+    std::vector<std::string> paths;
+    for (const std::string& path : referenced)
+        if (std::ifstream(path).good())
+            paths.push_back(path);
+
+    auto time = [](const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    std::vector<size_t> serialBytes(paths.size(), 0), pooledBytes(paths.size(), 0);
+    auto decode = [&](std::vector<size_t>& bytes, unsigned int i)
+    {
+        Cell::TextureData data;
+        if (Cell::TextureLoader::DecodeTexture(paths[i], data))
+        {
+            bytes[i] = data.Size();
+            Cell::TextureLoader::FreeTextureData(data);
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < paths.size(); ++i)
+        decode(serialBytes, i);
+    double serial = time(start);
+
+    ThreadPool pool;
+    start = std::chrono::high_resolution_clock::now();
+    pool.ParallelFor((unsigned int)paths.size(), [&](unsigned int i) { decode(pooledBytes, i); });
+    double pooled = time(start);
+
+    size_t total = 0;
+    for (size_t bytes : serialBytes)
+        total += bytes;
+    std::cout << "    Sponza textures - " << paths.size() << " of " << referenced.size() << " present, " << total / (1024 * 1024)
+              << " MB decoded - serial: " << serial << " ms | ThreadPool (" << pool.GetThreadCount() << " workers + caller): "
+              << pooled << " ms" << std::endl;
+
+    return serialBytes == pooledBytes;
+}
+
+#endif
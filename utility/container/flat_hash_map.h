@@ -0,0 +1,230 @@
+#ifndef UTILITY_FLAT_HASH_MAP_H
+#define UTILITY_FLAT_HASH_MAP_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <assert.h>
+
+#include "../std_types.h"
+
+/* NOTE(Joey):
+
+  Open-addressing hash map with linear probing. All slots live in a single contiguous array of
+  (key, value index) pairs, s.t. a lookup is a hash, a mask and (almost always) a single cache
+  line; as opposed to the pointer chasing of node-based containers like std::map.
+
+  The values themselves are NOT stored in the slot array; they live in fixed-size pages and are
+  referenced through their value index. A value never moves once inserted: growing the slot
+  array only rehashes the small slot entries, so pointers (and indices) returned by Insert/Find
+  stay valid until the respective key is erased. Erased value slots are recycled.
+
+  Deletion uses backward-shift deletion instead of tombstones, keeping probe sequences short
+  regardless of the insert/erase history.
+
+*/
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap
+{
+public:
+    static const u32 INVALID_INDEX = 0xFFFFFFFF;
+private:
+    // NOTE(Joey): values per page; a page is only allocated when required.
+    static const u32 PAGE_SIZE = 64;
+
+    struct Slot
+    {
+        Key Id;
+        u32 Index = INVALID_INDEX; // INVALID_INDEX marks an empty slot
+    };
+    typedef typename std::aligned_storage<sizeof(Value), alignof(Value)>::type Storage;
+
+    std::vector<Slot>                       m_Slots;
+    std::vector<std::unique_ptr<Storage[]>> m_Pages;
+    std::vector<u8>                         m_Alive;    // per value index
+    std::vector<u32>                        m_FreeList; // recycled value indices
+    u32                                     m_Size = 0;
+    Hash                                    m_Hash;
+
+public:
+    FlatHashMap() { }
+    ~FlatHashMap() { Clear(); }
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    // returns a pointer to the value stored under key, or nullptr if it doesn't exist.
+    Value* Find(const Key& key)
+    {
+        u32 index = FindIndex(key);
+        return index != INVALID_INDEX ? At(index) : nullptr;
+    }
+    // returns the (stable) value index of key, or INVALID_INDEX if it doesn't exist.
+    u32 FindIndex(const Key& key) const
+    {
+        if (m_Slots.empty())
+            return INVALID_INDEX;
+        const std::size_t mask = m_Slots.size() - 1;
+        for (std::size_t i = slotOf(key); ; i = (i + 1) & mask)
+        {
+            const Slot& slot = m_Slots[i];
+            if (slot.Index == INVALID_INDEX)
+                return INVALID_INDEX;
+            if (slot.Id == key)
+                return slot.Index;
+        }
+    }
+    // returns the value at a value index as previously returned by FindIndex/Insert.
+    Value* At(u32 index)
+    {
+        assert(index < m_Alive.size() && m_Alive[index]);
+        return reinterpret_cast<Value*>(&m_Pages[index / PAGE_SIZE][index % PAGE_SIZE]);
+    }
+    // inserts value under key and returns the stored value; if key already exists, the
+    // existing value is overwritten. Optionally returns the value's index in outIndex.
+    Value* Insert(const Key& key, Value value, u32* outIndex = nullptr)
+    {
+        u32 index = FindIndex(key);
+        if (index != INVALID_INDEX)
+        {
+            Value* existing = At(index);
+            *existing = std::move(value);
+            if (outIndex)
+                *outIndex = index;
+            return existing;
+        }
+
+        // keep the load factor below 75%
+        if ((m_Size + 1) * 4 > m_Slots.size() * 3)
+            rehash(m_Slots.empty() ? 16 : m_Slots.size() * 2);
+
+        index = allocateValue(std::move(value));
+        const std::size_t mask = m_Slots.size() - 1;
+        std::size_t i = slotOf(key);
+        while (m_Slots[i].Index != INVALID_INDEX)
+            i = (i + 1) & mask;
+        m_Slots[i].Id    = key;
+        m_Slots[i].Index = index;
+        ++m_Size;
+        if (outIndex)
+            *outIndex = index;
+        return At(index);
+    }
+    // removes key and destroys its value; returns false if the key didn't exist.
+    bool Erase(const Key& key)
+    {
+        if (m_Slots.empty())
+            return false;
+        const std::size_t mask = m_Slots.size() - 1;
+        std::size_t i = slotOf(key);
+        while (true)
+        {
+            if (m_Slots[i].Index == INVALID_INDEX)
+                return false;
+            if (m_Slots[i].Id == key)
+                break;
+            i = (i + 1) & mask;
+        }
+        freeValue(m_Slots[i].Index);
+
+        // backward-shift deletion: move each following entry of the cluster that isn't at its
+        // ideal slot back into the gap.
+        std::size_t gap = i;
+        for (std::size_t j = (i + 1) & mask; m_Slots[j].Index != INVALID_INDEX; j = (j + 1) & mask)
+        {
+            std::size_t ideal = slotOf(m_Slots[j].Id);
+            // entry j may move to the gap if its ideal slot isn't cyclically within (gap, j]
+            bool inRange = gap <= j ? (gap < ideal && ideal <= j) : (gap < ideal || ideal <= j);
+            if (!inRange)
+            {
+                m_Slots[gap] = m_Slots[j];
+                gap = j;
+            }
+        }
+        m_Slots[gap].Index = INVALID_INDEX;
+        --m_Size;
+        return true;
+    }
+    // destroys all values and releases all memory.
+    void Clear()
+    {
+        for (u32 i = 0; i < m_Alive.size(); ++i)
+        {
+            if (m_Alive[i])
+                At(i)->~Value();
+        }
+        m_Slots.clear();
+        m_Pages.clear();
+        m_Alive.clear();
+        m_FreeList.clear();
+        m_Size = 0;
+    }
+    // calls func(key, value) for each stored entry (in unspecified order).
+    template <typename Func>
+    void ForEach(Func func)
+    {
+        for (std::size_t i = 0; i < m_Slots.size(); ++i)
+        {
+            if (m_Slots[i].Index != INVALID_INDEX)
+                func(m_Slots[i].Id, *At(m_Slots[i].Index));
+        }
+    }
+
+    u32 Size() const { return m_Size; }
+
+private:
+    std::size_t slotOf(const Key& key) const
+    {
+        // NOTE(Joey): fibonacci hashing on top of the key's hash; the keys we store are often
+        // already hashes (string IDs) for which std::hash is the identity, but this makes sure
+        // that badly distributed hashes still spread over the (power of 2) table.
+        const u64 h = (u64)m_Hash(key) * 11400714819323198485ull;
+        return (std::size_t)(h >> 32) & (m_Slots.size() - 1);
+    }
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old;
+        old.swap(m_Slots);
+        m_Slots.resize(capacity);
+        const std::size_t mask = capacity - 1;
+        for (std::size_t s = 0; s < old.size(); ++s)
+        {
+            if (old[s].Index == INVALID_INDEX)
+                continue;
+            std::size_t i = slotOf(old[s].Id);
+            while (m_Slots[i].Index != INVALID_INDEX)
+                i = (i + 1) & mask;
+            m_Slots[i] = old[s];
+        }
+    }
+    u32 allocateValue(Value&& value)
+    {
+        u32 index;
+        if (!m_FreeList.empty())
+        {
+            index = m_FreeList.back();
+            m_FreeList.pop_back();
+        }
+        else
+        {
+            index = (u32)m_Alive.size();
+            m_Alive.push_back(0);
+            if (index / PAGE_SIZE >= m_Pages.size())
+                m_Pages.emplace_back(new Storage[PAGE_SIZE]);
+        }
+        new (&m_Pages[index / PAGE_SIZE][index % PAGE_SIZE]) Value(std::move(value));
+        m_Alive[index] = 1;
+        return index;
+    }
+    void freeValue(u32 index)
+    {
+        At(index)->~Value();
+        m_Alive[index] = 0;
+        m_FreeList.push_back(index);
+    }
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "mapped_file.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_File    = file;
+    m_Mapping = mapping;
+    m_Data    = (const u8*)data;
+    m_Size    = (u64)size.QuadPart;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED)
+    {
+        close(file);
+        return false;
+    }
+    m_File = file;
+    m_Data = (const u8*)data;
+    m_Size = (u64)info.st_size;
+#endif
+    return true;
+}
+// ----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+    if (!m_Data)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_Data);
+    CloseHandle((HANDLE)m_Mapping);
+    CloseHandle((HANDLE)m_File);
+    m_Mapping = nullptr;
+    m_File    = nullptr;
+#else
+    munmap((void*)m_Data, (size_t)m_Size);
+    close(m_File);
+    m_File = -1;
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+}
+// ----------------------------------------------------------------------------
+bool FileInfo(const std::string& path, u64& modificationTime, u64& size)
+{
+#ifdef _WIN32
+    struct _stat64 info;
+    if (_stat64(path.c_str(), &info) != 0)
+        return false;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+#endif
+    modificationTime = (u64)info.st_mtime;
+    size             = (u64)info.st_size;
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef UTILITY_MAPPED_FILE_H
+#define UTILITY_MAPPED_FILE_H
+
+#include <string>
+
+#include "../std_types.h"
+
+/* NOTE(Joey):
+
+  Read-only memory mapped file. The file's contents are directly accessible through Data()
+  without reading them into an intermediate buffer; the OS pages the file in on demand. The
+  mapping stays valid until Close (or destruction).
+
+*/
+class MappedFile
+{
+private:
+    const u8* m_Data = nullptr;
+    u64       m_Size = 0;
+#ifdef _WIN32
+    void*     m_File    = nullptr;
+    void*     m_Mapping = nullptr;
+#else
+    int       m_File    = -1;
+#endif
+
+public:
+    MappedFile() { }
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const u8* Data() const { return m_Data; }
+    u64       Size() const { return m_Size; }
+    bool      IsOpen() const { return m_Data != nullptr; }
+};
+
+// retrieves a file's last modification time and size; returns false if the file doesn't exist.
+bool FileInfo(const std::string& path, u64& modificationTime, u64& size);
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 
 // NOTE(Joey): not too pretty, but directly define the log types as
 // strings for proper category printing. Given the small amount of 
@@ -28,8 +29,14 @@ unsigned int Log::m_Filter = LOG_TYPE::LOG_DEFAULT |
                              LOG_TYPE::LOG_WARNING |
                              LOG_TYPE::LOG_ERROR;
 
+// NOTE(Joey): messages can be logged from worker threads (e.g. asynchronous resource loading);
+// serialize access to the log queues and the standard output.
+static std::mutex logMutex;
+
 void Log::Message(const std::string& message, const LOG_TYPE type)
 {
+    std::lock_guard<std::mutex> lock(logMutex);
+
     // push message into proper log queue for later display and/or write-to-disk
     m_LogEntries[type].push_back(message);
 
@@ -50,6 +57,7 @@ void Log::SetFilter(unsigned int filter)
 
 void Log::Clear()
 {
+    std::lock_guard<std::mutex> lock(logMutex);
 	for (auto& entry : m_LogEntries) {
 		entry.clear();
 	}
@@ -60,6 +68,8 @@ void Log::Display(const LOG_TYPE type)
     const std::string divider = "=========================================================";
     const bool filter = type != LOG_DEFAULT;
 
+    std::lock_guard<std::mutex> lock(logMutex);
+
     for (std::size_t i = 0; i < m_LogEntries.size(); ++i)
     {
         if (m_LogEntries.at(i).size() > 0)
@@ -2,57 +2,118 @@
 
 #include <math/common.h>
 
+#include <atomic>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #define RANDOM_SSE
+    #include <emmintrin.h>
+#endif
+
 namespace Random
 {
-    Series GlobalSeries = { 1337, 65536 };
+    // NOTE(Joey): each thread derives its global series from the same seed, jumped ahead by the
+    // number of threads that requested one before; this keeps the main thread's sequence
+    // deterministic while guaranteeing non-overlapping streams on worker threads.
+    static Series nextThreadSeries()
+    {
+        static std::atomic<u32> threadCount(0);
+        Series series = Seed(1337);
+        u32 index = threadCount++;
+        for (u32 i = 0; i < index; ++i)
+            Jump(&series);
+        return series;
+    }
+    thread_local Series GlobalSeries = nextThreadSeries();
 
     // ------------------------------------------------------------------------
-    Series Seed(unsigned int value, unsigned int modulo)
+    static inline u32 rotl(const u32 x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+    // ------------------------------------------------------------------------
+    Series Seed(u64 value)
     {
         Series series = {};
 
-        series.Index = value;
-        series.Modulo = modulo;
+        // NOTE(Joey): expand the seed to the full 128 bits of state with splitmix64, as
+        // recommended by the xoshiro authors; this also guarantees a non-zero state for any seed.
+        for (int i = 0; i < 2; ++i)
+        {
+            u64 z = (value += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            z = z ^ (z >> 31);
+            series.State[i * 2 + 0] = (u32)z;
+            series.State[i * 2 + 1] = (u32)(z >> 32);
+        }
 
         return series;
     }
     // ------------------------------------------------------------------------
-    unsigned int NextUInt(Series *series)
+    void Jump(Series *series)
     {
-        unsigned int a = 1103515245;
-        unsigned int c = 12345;
-        if (series != nullptr)
-        {
-            series->Index = (a * series->Index + c) % series->Modulo;
-            return series->Index;
-        }
-        else
+        static const u32 jump[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+        Series *s = series != nullptr ? series : &GlobalSeries;
+        u32 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (int i = 0; i < 4; ++i)
         {
-            GlobalSeries.Index = (a * GlobalSeries.Index + c) % GlobalSeries.Modulo;
-            return GlobalSeries.Index;
+            for (int b = 0; b < 32; ++b)
+            {
+                if (jump[i] & (1u << b))
+                {
+                    s0 ^= s->State[0];
+                    s1 ^= s->State[1];
+                    s2 ^= s->State[2];
+                    s3 ^= s->State[3];
+                }
+                NextUInt(s);
+            }
         }
+        s->State[0] = s0;
+        s->State[1] = s1;
+        s->State[2] = s2;
+        s->State[3] = s3;
+    }
+    // ------------------------------------------------------------------------
+    Series Split(Series *series)
+    {
+        Series *s = series != nullptr ? series : &GlobalSeries;
+        Series result = *s;
+        Jump(s);
+        return result;
+    }
+    // ------------------------------------------------------------------------
+    u32 NextUInt(Series *series)
+    {
+        u32 *s = series != nullptr ? series->State : GlobalSeries.State;
+
+        const u32 result = rotl(s[1] * 5, 7) * 9;
+        const u32 t = s[1] << 9;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+
+        return result;
     }
     // ------------------------------------------------------------------------
     unsigned int Choice(unsigned int count, Series *series)
     {
-        unsigned int result = NextUInt(series) % count;
+        // NOTE(Joey): multiply-shift range reduction; avoids the modulo (and its bias towards
+        // the lower values) for the relatively small counts we use.
+        unsigned int result = (unsigned int)(((u64)NextUInt(series) * (u64)count) >> 32);
         return result;
     }
     // ------------------------------------------------------------------------
     float Uniliteral(Series *series)
     {
-        if (series != nullptr)
-        {
-            float divisor = 1.0f / series->Modulo;
-            float result = (float)NextUInt(series) * divisor;
-            return result;
-        }
-        else
-        {
-            float divisor = 1.0f / GlobalSeries.Modulo;
-            float result = (float)NextUInt(series) * divisor;
-            return result;
-        }
+        // NOTE(Joey): the top 24 bits fit exactly in a float's mantissa.
+        float result = (float)(NextUInt(series) >> 8) * (1.0f / 16777216.0f);
+        return result;
     }
     // ------------------------------------------------------------------------
     float Biliteral(Series *series)
@@ -63,7 +124,7 @@ namespace Random
     // ------------------------------------------------------------------------
     int RandomBetween(int min, int max, Series *series)
     {
-        int result = min + NextUInt(series) % ((max + 1)- min);
+        int result = min + (int)Choice((unsigned int)((max + 1) - min), series);
         return result;
     }
     // ------------------------------------------------------------------------
@@ -72,4 +133,63 @@ namespace Random
         float result = math::lerp(min, max, Uniliteral(series));
         return result;
     }
-}
\ No newline at end of file
+    // ------------------------------------------------------------------------
+    void Fill(float *values, std::size_t count, Series *series)
+    {
+        Series *s = series != nullptr ? series : &GlobalSeries;
+
+        // NOTE(Joey): 4 lanes, each its own stream 2^64 values apart; value i is taken from lane
+        // i % 4. Afterwards the series continues from lane 0's position (lane 0 is always the
+        // furthest along), so a next call never repeats values of the previous one.
+        Series lanes[4];
+        lanes[0] = *s;
+        for (int i = 1; i < 4; ++i)
+        {
+            lanes[i] = lanes[i - 1];
+            Jump(&lanes[i]);
+        }
+
+        std::size_t i = 0;
+#ifdef RANDOM_SSE
+        __m128i s0 = _mm_setr_epi32(lanes[0].State[0], lanes[1].State[0], lanes[2].State[0], lanes[3].State[0]);
+        __m128i s1 = _mm_setr_epi32(lanes[0].State[1], lanes[1].State[1], lanes[2].State[1], lanes[3].State[1]);
+        __m128i s2 = _mm_setr_epi32(lanes[0].State[2], lanes[1].State[2], lanes[2].State[2], lanes[3].State[2]);
+        __m128i s3 = _mm_setr_epi32(lanes[0].State[3], lanes[1].State[3], lanes[2].State[3], lanes[3].State[3]);
+        const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            // result = rotl(s1 * 5, 7) * 9; multiplications by 5 and 9 as shift + add (SSE2 has
+            // no 32-bit low multiply).
+            __m128i r = _mm_add_epi32(_mm_slli_epi32(s1, 2), s1);
+            r = _mm_or_si128(_mm_slli_epi32(r, 7), _mm_srli_epi32(r, 25));
+            r = _mm_add_epi32(_mm_slli_epi32(r, 3), r);
+
+            const __m128i t = _mm_slli_epi32(s1, 9);
+            s2 = _mm_xor_si128(s2, s0);
+            s3 = _mm_xor_si128(s3, s1);
+            s1 = _mm_xor_si128(s1, s2);
+            s0 = _mm_xor_si128(s0, s3);
+            s2 = _mm_xor_si128(s2, t);
+            s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+            _mm_storeu_ps(values + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(r, 8)), scale));
+        }
+        u32 state[4][4];
+        _mm_storeu_si128((__m128i*)state[0], s0);
+        _mm_storeu_si128((__m128i*)state[1], s1);
+        _mm_storeu_si128((__m128i*)state[2], s2);
+        _mm_storeu_si128((__m128i*)state[3], s3);
+        for (int l = 0; l < 4; ++l)
+        {
+            for (int j = 0; j < 4; ++j)
+                lanes[l].State[j] = state[j][l];
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            values[i] = (float)(NextUInt(&lanes[i % 4]) >> 8) * (1.0f / 16777216.0f);
+        }
+
+        *s = lanes[0];
+    }
+}
@@ -1,41 +1,60 @@
 #ifndef UTILITY_RANDOM_H
 #define UTILITY_RANDOM_H
 
+#include <cstddef>
+
+#include "../std_types.h"
+
 namespace Random
 {
     /* NOTE(Joey):
-    
+
       Represents a PRNG (pseudo random number generator) that generates a deterministic chain of
-      random values given some mathematical equation and the modulo operator. The PRNG we use to 
-      generate the random sequence is known as the Linear Congruential Generator (which you can 
-      find in NextUint).
+      random values from a given seed. The generator is xoshiro128** (Blackman & Vigna): 128 bits
+      of state, a period of 2^128 - 1 and good statistical quality while only requiring 32-bit
+      shifts, rotates and adds (see NextUInt).
+
+      A series is plain data and carries all of its state, so each thread can own one or more
+      series without any synchronization. Independent, non-overlapping streams are derived from
+      an existing series with Split (or Jump), which advances a series by 2^64 values.
 
     */
     struct Series
     {
-        unsigned int Index;
-        unsigned int Modulo;
+        u32 State[4];
     };
     // NOTE(Joey): always define a global random series for easy number generation (if no series
-    // is given to any of the random functions, the global series is used.
-    extern Series GlobalSeries;
+    // is given to any of the random functions, the global series is used). The global series is
+    // thread-local: each thread gets its own stream, derived from the same global seed in order
+    // of first use, so it's safe (and deterministic on the main thread) to call from anywhere.
+    extern thread_local Series GlobalSeries;
 
 
-    // NOTE(Joey): generates a new random series 
-    Series Seed(unsigned int value, unsigned int modulo = 65536);
+    // NOTE(Joey): generates a new random series from a (64-bit) seed value.
+    Series Seed(u64 value);
+    // NOTE(Joey): advances the series by 2^64 values; equivalent to 2^64 calls to NextUInt.
+    void   Jump(Series *series = nullptr);
+    // NOTE(Joey): returns a new independent series starting at series's current position and
+    // jumps series ahead, s.t. neither stream overlaps (useful for handing out per-thread series).
+    Series Split(Series *series = nullptr);
 
     // NOTE(Joey): gets the next uint in series's random series.
-    unsigned int NextUInt(Series *series = nullptr);
+    u32          NextUInt(Series *series = nullptr);
     // NOTE(Joey): gets the next uint constrained within the region specified by count.
     unsigned int Choice(unsigned int count, Series *series = nullptr);
-    // NOTE(Joey): gets the next random value as a float within the range [ 0.0, 1.0]
+    // NOTE(Joey): gets the next random value as a float within the range [ 0.0, 1.0)
     float Uniliteral(Series *series = nullptr);
-    // NOTE(Joey): gets the next random value as a float within the range [-1.0, 1.0]
+    // NOTE(Joey): gets the next random value as a float within the range [-1.0, 1.0)
     float Biliteral(Series *series = nullptr);
     // NOTE(Joey): gets the next random value as an int between a specified min and max.
-    int   RandomBetween(int min, int max, Series *series);
+    int   RandomBetween(int min, int max, Series *series = nullptr);
     // NOTE(Joey): gets the next random value as a float between a specified min and max.
-    float RandomBetween(float min, float max, Series *series);
+    float RandomBetween(float min, float max, Series *series = nullptr);
+
+    // NOTE(Joey): fills values with count uniform floats within the range [0.0, 1.0). Bulk
+    // generation runs 4 split streams of series side by side with SIMD; the result is fully
+    // deterministic given series's state, and series is advanced accordingly.
+    void Fill(float *values, std::size_t count, Series *series = nullptr);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,47 @@
+#include "string_id.h"
+
+#include "logging/log.h"
+
+#include <unordered_map>
+#include <mutex>
+
+// NOTE(Joey): function-local statics s.t. the registry is valid regardless of static
+// initialization order (string IDs may be hashed from other static initializers).
+static std::unordered_map<StringID, std::string>& registry()
+{
+    static std::unordered_map<StringID, std::string> names;
+    return names;
+}
+static std::mutex& registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// ----------------------------------------------------------------------------
+void StringIDRegister(StringID id, const char* str, std::size_t length)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    auto found = registry().find(id);
+    if (found == registry().end())
+    {
+        registry()[id] = std::string(str, length);
+    }
+    else if (found->second.compare(0, std::string::npos, str, length) != 0)
+    {
+        Log::Message("String ID collision: \"" + std::string(str, length) + "\" and \"" + found->second + "\" both hash to " + std::to_string(id) + ".", LOG_ERROR);
+    }
+}
+// ----------------------------------------------------------------------------
+std::string StringIDName(StringID id)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    auto found = registry().find(id);
+    if (found != registry().end())
+    {
+        return found->second;
+    }
+    return std::to_string(id);
+}
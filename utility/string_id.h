@@ -2,12 +2,15 @@
 #define UTILITY_STRING_ID_H
 
 #include <string>
+#include <cstddef>
+
+#include "std_types.h"
 
 /* NOTE(Joey):
 
   Transforms any string into a fixed-size 32 bit integer for
-  efficient identification purposes while keeping all the 
-  human-readable advantages of strings. This is inspired 
+  efficient identification purposes while keeping all the
+  human-readable advantages of strings. This is inspired
   from the similar approach as described by Jason Gregory
   in his book 'Game Engine Architecture'.
 
@@ -17,32 +20,77 @@
   on those 3 mentioned points deciding on a proper unique
   identification scheme is quite relevant.
 
-  We create a hash function named SID that does the string 
+  We create a hash function named SID that does the string
   to integer conversion. Note that hashing is relatively
   expensive; it's best to hash a string to get its unique
   and use the integer id for all further computations.
 
+  The hash is FNV-1a and is constexpr, s.t. string literals
+  can be hashed at compile time with the _sid literal:
+
+    Resources::GetShader("pbr"_sid);
+
+  Strings known only at run-time go through SID. In debug
+  builds every run-time hashed string is stored in a global
+  registry that reports hash collisions and maps IDs back to
+  their names (see StringIDName).
+
+  Define CELL_SID_64 (for all projects) to use 64 bit IDs.
+
 */
 
-#define SID(string) custom_simple_hash(string)
+#ifdef CELL_SID_64
+    typedef u64 StringID;
+    #define CELL_SID_OFFSET_BASIS 14695981039346656037ull
+    #define CELL_SID_PRIME        1099511628211ull
+#else
+    typedef u32 StringID;
+    #define CELL_SID_OFFSET_BASIS 2166136261u
+    #define CELL_SID_PRIME        16777619u
+#endif
+
+#define SID(string) string_id(string)
 
-inline unsigned int custom_simple_hash(const std::string &str)
+// NOTE(Joey): written as a single recursive return statement s.t. it is a valid (C++11)
+// constexpr function for MSVC 2015.
+constexpr StringID string_id_fnv1a(const char* str, std::size_t length, StringID hash = CELL_SID_OFFSET_BASIS)
 {
-    unsigned int hash = 0;
+    return length == 0 ? hash : string_id_fnv1a(str + 1, length - 1, (StringID)((hash ^ (StringID)(u8)*str) * CELL_SID_PRIME));
+}
 
-	for (auto& it : str) {
-		// NOTE(Joey): be sure to use prime numbers
-		hash = 37 * hash + 17 * static_cast<char>(it);
-	}
+// NOTE(Joey): compile-time hashed string literal; "name"_sid.
+constexpr StringID operator"" _sid(const char* str, std::size_t length)
+{
+    return string_id_fnv1a(str, length);
+}
+
+// NOTE(Joey): debug-only string registry; stores the string of each run-time hashed ID and
+// logs an error whenever two different strings hash to the same ID.
+void        StringIDRegister(StringID id, const char* str, std::size_t length);
+// NOTE(Joey): returns the name belonging to a (registered) ID; in release builds (or for IDs
+// never hashed at run-time) this returns the ID as a number.
+std::string StringIDName(StringID id);
 
-    // NOTE(Joey): hash value will automatically wrap around 
+inline StringID string_id(const char* str, std::size_t length)
+{
+    StringID hash = CELL_SID_OFFSET_BASIS;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        hash = (StringID)((hash ^ (StringID)(u8)str[i]) * CELL_SID_PRIME);
+    }
+#ifdef _DEBUG
+    StringIDRegister(hash, str, length);
+#endif
     return hash;
 }
-// NOTE(Joey): supports c string literals
-inline unsigned int custom_simple_hash(const char* cStr)
+inline StringID string_id(const std::string &str)
+{
+    return string_id(str.data(), str.size());
+}
+// NOTE(Joey): supports c string literals (without allocating a std::string)
+inline StringID string_id(const char* cStr)
 {
-    std::string str(cStr);
-    return custom_simple_hash(str);
+    return string_id(cStr, std::char_traits<char>::length(cStr));
 }
 
-#endif
\ No newline at end of file
+#endif
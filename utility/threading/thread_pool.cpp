@@ -0,0 +1,115 @@
+#include "thread_pool.h"
+
+#include <atomic>
+#include <memory>
+
+// ----------------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    m_Workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_Workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+// ----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_JobAvailable.notify_all();
+    for (unsigned int i = 0; i < m_Workers.size(); ++i)
+        m_Workers[i].join();
+}
+// ----------------------------------------------------------------------------
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobAvailable.notify_one();
+}
+// ----------------------------------------------------------------------------
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobsDone.wait(lock, [this] { return m_Jobs.empty() && m_Busy == 0; });
+}
+// ----------------------------------------------------------------------------
+void ThreadPool::ParallelFor(unsigned int count, std::function<void(unsigned int)> func)
+{
+    if (count == 0)
+        return;
+
+    // NOTE(Joey): iterations are claimed one at a time from a shared counter by whichever
+    // thread gets to them first. Helper jobs may start late (e.g. queued behind other work) or
+    // after everything is done, so the shared state lives as long as the last helper.
+    struct State
+    {
+        std::function<void(unsigned int)> Func;
+        unsigned int                      Count;
+        std::atomic<unsigned int>         Next;
+        std::atomic<unsigned int>         Done;
+        std::mutex                        Mutex;
+        std::condition_variable           Finished;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    state->Func  = std::move(func);
+    state->Count = count;
+    state->Next  = 0;
+    state->Done  = 0;
+
+    auto work = [state]()
+    {
+        unsigned int i;
+        while ((i = state->Next++) < state->Count)
+        {
+            state->Func(i);
+            if (++state->Done == state->Count)
+            {
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                state->Finished.notify_all();
+            }
+        }
+    };
+    unsigned int helpers = count - 1 < GetThreadCount() ? count - 1 : GetThreadCount();
+    for (unsigned int i = 0; i < helpers; ++i)
+        Submit(work);
+    work();
+
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->Finished.wait(lock, [&state] { return state->Done == state->Count; });
+}
+// ----------------------------------------------------------------------------
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+            // NOTE(Joey): finish all remaining jobs before shutting down
+            if (m_Jobs.empty())
+                return;
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            ++m_Busy;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            --m_Busy;
+            if (m_Jobs.empty() && m_Busy == 0)
+                m_JobsDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef UTILITY_THREAD_POOL_H
+#define UTILITY_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/* NOTE(Joey):
+
+  Fixed-size pool of worker threads that execute submitted jobs in FIFO order. Meant for coarse
+  grained CPU work that doesn't touch the graphics API (decoding images, parsing mesh data);
+  anything that requires the OpenGL context has to be handed back to the render thread.
+
+  A thread count of 0 creates one worker less than the available hardware threads (leaving a
+  core for the render thread), with a minimum of 1.
+
+*/
+class ThreadPool
+{
+private:
+    std::vector<std::thread>          m_Workers;
+    std::deque<std::function<void()>> m_Jobs;
+    std::mutex                        m_Mutex;
+    std::condition_variable           m_JobAvailable;
+    std::condition_variable           m_JobsDone;
+    unsigned int                      m_Busy = 0;
+    bool                              m_Stop = false;
+
+public:
+    ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // queues a job for execution on one of the worker threads.
+    void Submit(std::function<void()> job);
+    // blocks the calling thread until all submitted jobs have finished.
+    void Wait();
+    // calls func(i) for each i in [0, count) spread over the workers and the calling thread;
+    // returns once all iterations are done. Unlike Wait, this doesn't wait on unrelated jobs.
+    void ParallelFor(unsigned int count, std::function<void(unsigned int)> func);
+
+    unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+
+private:
+    void workerLoop();
+};
+
+#endif